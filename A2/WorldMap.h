@@ -13,33 +13,86 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <CSCI441/ShaderUtils.hpp>
+#include <CSCI441/TextureUploader.hpp>
 
 #include <cstdio>
 #include <cstdlib>
 #include <ctime>
 
+#include <condition_variable>  // for signaling our decoder thread
+#include <deque>
+#include <list>
+#include <map>
+#include <mutex>
 #include <sstream>			// I don't fully love C...let's use some C++
 #include <string>
+#include <thread>               // to decode map images in the background
+#include <vector>
 using namespace std;
 
 //////////////////////////////////////////////////////////
 //
-//	Do not modify any of these values.  They handle
-//	the world map operation.  We will eventually
-//	discuss how textures work so that we can display
-//	images like is being done here.
-
-const GLint MAP_WIDTH = 7, MAP_HEIGHT = 7;				// sets the width and height of our 2D map array
-GLint mapHandles[ MAP_WIDTH ][ MAP_HEIGHT ];			// a 2D storing the texture handles of our world map backgrounds
-GLint currMapLocationX = MAP_WIDTH / 2,
-      currMapLocationY = MAP_HEIGHT / 2;	        	// our current location within the map
+//	These values handle the world map operation.  The
+//	map is a grid of tiles of any size.  Tiles are decoded
+//	on a background thread around the current location and
+//	streamed to the GPU through pixel buffers on demand, so
+//	startup time does not depend on the size of the world.
+
+GLint mapWidth = 7, mapHeight = 7;                      // sets the width and height of our 2D map grid
+vector<GLint> mapTileImages;                            // the image number displayed at each grid location, stored row by row
+GLint currMapLocationX = 0,
+      currMapLocationY = 0;	                        	// our current location within the map
 GLuint mapShaderProgramHandle;
 GLuint mapVAO;
 
-void loadMap();
+const GLint MAP_PREFETCH_RADIUS = 1;                    // neighbors within this many tiles are decoded ahead of time
+const GLint MAP_UPLOADS_PER_FRAME = 2;                  // number of decoded tiles queued for upload each frame
+const double MAP_RETRY_DELAY = 1.0;                     // seconds before an image that failed to decode is tried again
+const double MAP_MAX_RETRY_DELAY = 32.0;                // the delay doubles with each failure up to this many seconds
+size_t mapTextureBudget = 64 * 1024 * 1024;             // bytes of texture memory the tile cache may hold
+
+// a map tile that has been uploaded to the GPU
+struct MapTile {
+    GLuint texHandle;                                   // texture handle for this tile
+    size_t byteSize;                                    // texture memory used by this tile, including mipmaps
+    bool ready;                                         // true once the uploader has finished copying the pixels
+    list<GLint>::iterator lruPosition;                  // where this tile sits in mapTileLRU
+};
+map<GLint, MapTile> mapTileCache;                       // uploaded tiles keyed by image number
+list<GLint> mapTileLRU;                                 // image numbers ordered from most to least recently used
+size_t mapTextureBytes = 0;                             // texture memory currently held by the tile cache
+GLuint mapPlaceholderHandle = 0;                        // displayed while the current tile is still loading
+CSCI441::TextureUploader *mapTextureUploader = nullptr; // copies tile pixels to the GPU a slice at a time
+
+// a map image that has been decoded but not yet uploaded to the GPU
+struct DecodedMapImage {
+    GLint imageNumber;
+    int width, height, channels;
+    unsigned char *data;
+};
+thread mapDecoderThread;
+mutex mapDecoderMutex;                                  // guards the three containers and flag below
+condition_variable mapDecoderCondition;
+deque<GLint> mapDecodeRequests;                         // image numbers waiting to be decoded
+deque<DecodedMapImage> mapDecodedImages;                // images waiting to be uploaded by the render thread
+map<GLint, bool> mapImagesInFlight;                     // image numbers requested but not yet uploaded
+bool mapDecoderRunning = false;
+
+// an image that could not be decoded, not requested again until its retry time
+struct FailedMapImage {
+    double retryTime;                                   // glfwGetTime() after which it may be requested again
+    double delay;                                       // seconds waited since the last failure
+};
+map<GLint, FailedMapImage> mapFailedImages;             // only touched by the render thread
+
+void initMap(GLint windowWidth, GLint windowHeight, GLint gridWidth = 7, GLint gridHeight = 7);
+void shutdownMap();
 void randomizeMap();
 void loadMapShader(GLint windowWidth, GLint windowHeight);
 void loadMapBuffers(GLint windowWidth, GLint windowHeight);
+void loadMapPlaceholder();
+void setMapTextureBudget(size_t bytes);
+void updateMapTiles();                                  // uploads finished tiles and requests tiles around our location
 void drawMap();	                                        // draws a rectangle with our world map background
 
 // these next four methods update the current location and loads the correct map.  they will wrap
@@ -50,120 +103,338 @@ void moveRight();										// moves our world map right one square
 void moveUp();											// moves our world map up one square
 //////////////////////////////////////////////////////////
 
+// image number displayed at grid location (x, y), wrapping around the edges of the map
+GLint mapImageAt( GLint x, GLint y ) {
+    x = ((x % mapWidth) + mapWidth) % mapWidth;
+    y = ((y % mapHeight) + mapHeight) % mapHeight;
+    return mapTileImages[ y*mapWidth + x ];
+}
+
 // draw a quad with our texture mapped to it
 void drawMap() {
-    glEnable( GL_TEXTURE_2D );
+    updateMapTiles();
+
+    GLuint texHandle = mapPlaceholderHandle;
+    map<GLint, MapTile>::iterator tile = mapTileCache.find( mapImageAt( currMapLocationX, currMapLocationY ) );
+    if( tile != mapTileCache.end() ) {
+        if( !tile->second.ready )
+            tile->second.ready = mapTextureUploader->isUploadComplete( tile->second.texHandle );
+        if( tile->second.ready )
+            texHandle = tile->second.texHandle;
+        mapTileLRU.splice( mapTileLRU.begin(), mapTileLRU, tile->second.lruPosition );
+    }
+
     glUseProgram(mapShaderProgramHandle);
     glBindVertexArray(mapVAO);
-    glBindTexture( GL_TEXTURE_2D, mapHandles[ currMapLocationX ][ currMapLocationY ] );
+    glBindTexture( GL_TEXTURE_2D, texHandle );
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-	glDisable( GL_TEXTURE_2D );
 }
 
 // I hope you can figure out what's going on here
 void moveDown() {
 	currMapLocationY++;
-	if( currMapLocationY >= MAP_HEIGHT )
+	if( currMapLocationY >= mapHeight )
 		currMapLocationY = 0;
 }
 
 void moveLeft() {
 	currMapLocationX--;
 	if( currMapLocationX < 0 )
-		currMapLocationX = MAP_WIDTH-1;
+		currMapLocationX = mapWidth-1;
 }
 
 void moveRight() {
 	currMapLocationX++;
-	if( currMapLocationX >= MAP_WIDTH )
+	if( currMapLocationX >= mapWidth )
 		currMapLocationX = 0;
 }
 
 void moveUp() {
 	currMapLocationY--;
 	if( currMapLocationY < 0 )
-		currMapLocationY = MAP_HEIGHT-1;
+		currMapLocationY = mapHeight-1;
+}
+
+// decodes requested map images until shutdownMap() is called.  runs on its own thread
+// and never touches OpenGL - the render thread uploads the decoded pixels.
+void decodeMapImages() {
+    while( true ) {
+        GLint imageNumber;
+        {
+            unique_lock<mutex> lock( mapDecoderMutex );
+            mapDecoderCondition.wait( lock, []{ return !mapDecoderRunning || !mapDecodeRequests.empty(); } );
+            if( !mapDecoderRunning )
+                return;
+            imageNumber = mapDecodeRequests.front();
+            mapDecodeRequests.pop_front();
+        }
+
+        stringstream filenameSS;
+        filenameSS << "./images/map" << imageNumber << ".png";
+        string filename = filenameSS.str();
+
+        DecodedMapImage image;
+        image.imageNumber = imageNumber;
+        image.data = stbi_load( filename.c_str(), &image.width, &image.height, &image.channels, 0);
+
+        // failed to load image
+        if( !image.data ) {
+            image.data = stbi_load( "./images/default.png", &image.width, &image.height, &image.channels, 0);
+            if( !image.data ) {
+                fprintf( stderr, "Could not load default image ./images/default.png.  Be sure to update Run > Edit Configurations and set your Working Directory to be ..\n" );
+                fflush( stderr );
+            }
+        }
+
+        lock_guard<mutex> lock( mapDecoderMutex );
+        mapDecodedImages.push_back( image );
+    }
 }
 
 // initialize our map
-void initMap(GLint windowWidth, GLint windowHeight) {
-    // I'm going to leave this uncommented for now.  Trust that it works.  It controls
-    // the loading of all the background images that get displayed
+void initMap(GLint windowWidth, GLint windowHeight, GLint gridWidth, GLint gridHeight) {
+    mapWidth = gridWidth;
+    mapHeight = gridHeight;
+    currMapLocationX = mapWidth / 2;
+    currMapLocationY = mapHeight / 2;
+
     loadMapShader(windowWidth, windowHeight);
     loadMapBuffers(windowWidth, windowHeight);
-    loadMap();
+    loadMapPlaceholder();
     randomizeMap();
-}
 
-void loadMap() {
-    glEnable( GL_TEXTURE_2D );
-    printf( "[INFO]: Loading map images..." );
-    fflush( stdout );
+    mapTextureUploader = new CSCI441::TextureUploader();
 
-    int imageWidth, imageHeight, imageChannels;
-    GLuint mapTexHandle;
+    // stb's flip setting is global, so set it once before the decoder starts
     stbi_set_flip_vertically_on_load(true);
+    mapDecoderRunning = true;
+    mapDecoderThread = thread( decodeMapImages );
 
-    for( GLint j = 0; j < MAP_HEIGHT; j++ ) {
-		for( GLint i = 0; i < MAP_WIDTH; i++ ) {
-			stringstream filenameSS;
-			filenameSS << "./images/map" << (j*MAP_WIDTH + i) << ".png";
-			string filename = filenameSS.str();
-
-            glGenTextures(1, &mapTexHandle);
-            glBindTexture(GL_TEXTURE_2D, mapTexHandle);
-            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-            mapHandles[ i ][ j ] = mapTexHandle;
-
-            unsigned char *data = stbi_load( filename.c_str(), &imageWidth, &imageHeight, &imageChannels, 0);
-
-			// failed to load image
-			if( !data ) {
-				filename = "./images/default.png";
-                data = stbi_load( filename.c_str(), &imageWidth, &imageHeight, &imageChannels, 0);
-                if( !data ) {
-                    fprintf( stderr, "Could not load default image ./images/default.png.  Be sure to update Run > Edit Configurations and set your Working Directory to be ..\n" );
-                    fflush( stderr );
-                }
-			}
-
-			const GLint STORAGE_TYPE = (imageChannels == 4 ? GL_RGBA : GL_RGB);
-            glTexImage2D( GL_TEXTURE_2D, 0, STORAGE_TYPE, imageWidth, imageHeight, 0, STORAGE_TYPE, GL_UNSIGNED_BYTE, data);
-			glGenerateMipmap(GL_TEXTURE_2D);
-
-            stbi_image_free(data);
-		}
-		printf( "." );
-		fflush( stdout );
-	}
-    printf( "...done!\n" );
+    printf( "[INFO]: Streaming a %d x %d world map with a %lu MB texture budget\n", mapWidth, mapHeight, (unsigned long)(mapTextureBudget / (1024*1024)) );
     fflush( stdout );
-    glDisable( GL_TEXTURE_2D );
+}
+
+// stop the decoder thread and release all map textures
+void shutdownMap() {
+    {
+        lock_guard<mutex> lock( mapDecoderMutex );
+        mapDecoderRunning = false;
+    }
+    mapDecoderCondition.notify_all();
+    if( mapDecoderThread.joinable() )
+        mapDecoderThread.join();
+
+    for( size_t i = 0; i < mapDecodedImages.size(); i++ ) {
+        stbi_image_free( mapDecodedImages[i].data );
+    }
+    mapDecodedImages.clear();
+    mapDecodeRequests.clear();
+    mapImagesInFlight.clear();
+    mapFailedImages.clear();
+
+    for( map<GLint, MapTile>::iterator iter = mapTileCache.begin(); iter != mapTileCache.end(); iter++ ) {
+        mapTextureUploader->cancel( iter->second.texHandle );
+        glDeleteTextures( 1, &(iter->second.texHandle) );
+        CSCI441::ResourceRegistry::releaseTexture( iter->second.texHandle );
+    }
+    delete mapTextureUploader;
+    mapTextureUploader = nullptr;
+    mapTileCache.clear();
+    mapTileLRU.clear();
+    mapTextureBytes = 0;
+
+    glDeleteTextures( 1, &mapPlaceholderHandle );
+}
+
+// a small gray checkerboard shown until the real tile arrives
+void loadMapPlaceholder() {
+    const GLint PLACEHOLDER_SIZE = 8;
+    unsigned char pixels[ PLACEHOLDER_SIZE * PLACEHOLDER_SIZE * 3 ];
+    for( GLint j = 0; j < PLACEHOLDER_SIZE; j++ ) {
+        for( GLint i = 0; i < PLACEHOLDER_SIZE; i++ ) {
+            unsigned char shade = ((i + j) % 2 == 0) ? 96 : 128;
+            pixels[ (j*PLACEHOLDER_SIZE + i)*3 + 0 ] = shade;
+            pixels[ (j*PLACEHOLDER_SIZE + i)*3 + 1 ] = shade;
+            pixels[ (j*PLACEHOLDER_SIZE + i)*3 + 2 ] = shade;
+        }
+    }
+
+    glGenTextures(1, &mapPlaceholderHandle);
+    glBindTexture(GL_TEXTURE_2D, mapPlaceholderHandle);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D( GL_TEXTURE_2D, 0, GL_RGB, PLACEHOLDER_SIZE, PLACEHOLDER_SIZE, 0, GL_RGB, GL_UNSIGNED_BYTE, pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+void setMapTextureBudget(size_t bytes) {
+    mapTextureBudget = bytes;
+}
+
+// true if the image is displayed at our location or one of the neighbors we prefetch
+bool mapImageNearby( GLint imageNumber ) {
+    for( GLint dy = -MAP_PREFETCH_RADIUS; dy <= MAP_PREFETCH_RADIUS; dy++ ) {
+        for( GLint dx = -MAP_PREFETCH_RADIUS; dx <= MAP_PREFETCH_RADIUS; dx++ ) {
+            if( mapImageAt( currMapLocationX + dx, currMapLocationY + dy ) == imageNumber )
+                return true;
+        }
+    }
+    return false;
+}
+
+// queue an image to be decoded unless it is already on the GPU or on its way there,
+// or failed recently.  urgent requests jump to the front of the line.
+void requestMapImage( GLint imageNumber, bool urgent ) {
+    if( mapTileCache.count( imageNumber ) != 0 )
+        return;
+
+    map<GLint, FailedMapImage>::iterator failed = mapFailedImages.find( imageNumber );
+    if( failed != mapFailedImages.end() && glfwGetTime() < failed->second.retryTime )
+        return;
+
+    lock_guard<mutex> lock( mapDecoderMutex );
+    if( mapImagesInFlight.count( imageNumber ) != 0 )
+        return;
+    mapImagesInFlight[ imageNumber ] = true;
+    if( urgent )
+        mapDecodeRequests.push_front( imageNumber );
+    else
+        mapDecodeRequests.push_back( imageNumber );
+    mapDecoderCondition.notify_one();
+}
+
+// release least recently used tiles until we fit within our budget.  the tile we are
+// standing on and its prefetched neighbors are pinned, so the budget may be exceeded
+// rather than evicting a tile that is about to be shown
+void evictMapTiles() {
+    list<GLint>::iterator victim = mapTileLRU.end();
+    while( mapTextureBytes > mapTextureBudget && victim != mapTileLRU.begin() ) {
+        --victim;
+        if( mapImageNearby( *victim ) )
+            continue;
+
+        GLint imageNumber = *victim;
+        victim = mapTileLRU.erase( victim );
+
+        map<GLint, MapTile>::iterator tile = mapTileCache.find( imageNumber );
+        mapTextureUploader->cancel( tile->second.texHandle );
+        glDeleteTextures( 1, &(tile->second.texHandle) );
+        CSCI441::ResourceRegistry::releaseTexture( tile->second.texHandle );
+        mapTextureBytes -= tile->second.byteSize;
+        mapTileCache.erase( tile );
+    }
+}
+
+void uploadMapImage( const DecodedMapImage &image ) {
+    MapTile tile;
+    glGenTextures(1, &tile.texHandle);
+    glBindTexture(GL_TEXTURE_2D, tile.texHandle);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // the uploader frees the pixels once they have been copied and builds the mipmaps after the last slice
+    mapTextureUploader->upload2DTexture( tile.texHandle, image.data, image.width, image.height, image.channels, true, stbi_image_free );
+    tile.ready = false;
+
+    // a full mipmap chain adds one third to the base level
+    tile.byteSize = (size_t)image.width * image.height * image.channels * 4 / 3;
+
+    mapTileLRU.push_front( image.imageNumber );
+    tile.lruPosition = mapTileLRU.begin();
+    mapTileCache[ image.imageNumber ] = tile;
+    mapTextureBytes += tile.byteSize;
+}
+
+// remember an image that could not be decoded and back off before trying it again
+void markMapImageFailed( GLint imageNumber ) {
+    map<GLint, FailedMapImage>::iterator failed = mapFailedImages.find( imageNumber );
+    double delay = MAP_RETRY_DELAY;
+    if( failed != mapFailedImages.end() ) {
+        delay = failed->second.delay * 2.0;
+        if( delay > MAP_MAX_RETRY_DELAY )
+            delay = MAP_MAX_RETRY_DELAY;
+    }
+
+    FailedMapImage &entry = mapFailedImages[ imageNumber ];
+    entry.delay = delay;
+    entry.retryTime = glfwGetTime() + delay;
+}
+
+void updateMapTiles() {
+    {
+        // we may have moved on since these were requested, don't spend the decoder on them
+        lock_guard<mutex> lock( mapDecoderMutex );
+        for( deque<GLint>::iterator request = mapDecodeRequests.begin(); request != mapDecodeRequests.end(); ) {
+            if( mapImageNearby( *request ) ) {
+                ++request;
+            } else {
+                mapImagesInFlight.erase( *request );
+                request = mapDecodeRequests.erase( request );
+            }
+        }
+    }
+
+    // queue a few finished images so a burst of tiles doesn't pile up in one frame
+    for( GLint uploads = 0; uploads < MAP_UPLOADS_PER_FRAME; ) {
+        DecodedMapImage image;
+        {
+            lock_guard<mutex> lock( mapDecoderMutex );
+            if( mapDecodedImages.empty() )
+                break;
+            image = mapDecodedImages.front();
+            mapDecodedImages.pop_front();
+            mapImagesInFlight.erase( image.imageNumber );
+        }
+
+        if( !image.data ) {
+            markMapImageFailed( image.imageNumber );
+        } else if( !mapImageNearby( image.imageNumber ) ) {
+            // out of range by the time it was decoded, it would only be evicted again
+            stbi_image_free( image.data );
+        } else {
+            mapFailedImages.erase( image.imageNumber );
+            uploadMapImage( image );
+            uploads++;
+        }
+    }
+    mapTextureUploader->update();
+
+    // the tile we are on is needed now, the neighbors are prefetched behind it
+    requestMapImage( mapImageAt( currMapLocationX, currMapLocationY ), true );
+    for( GLint dy = -MAP_PREFETCH_RADIUS; dy <= MAP_PREFETCH_RADIUS; dy++ ) {
+        for( GLint dx = -MAP_PREFETCH_RADIUS; dx <= MAP_PREFETCH_RADIUS; dx++ ) {
+            requestMapImage( mapImageAt( currMapLocationX + dx, currMapLocationY + dy ), false );
+        }
+    }
+
+    // keep the current tile at the front of the LRU list, the neighbors are pinned while evicting
+    map<GLint, MapTile>::iterator tile = mapTileCache.find( mapImageAt( currMapLocationX, currMapLocationY ) );
+    if( tile != mapTileCache.end() ) {
+        mapTileLRU.splice( mapTileLRU.begin(), mapTileLRU, tile->second.lruPosition );
+    }
+    evictMapTiles();
 }
 
 void randomizeMap() {
     srand( time(nullptr) );
     printf( "[INFO]: Randomizing map locations..." );
-    const GLint RAND_ITERATIONS = MAP_HEIGHT * MAP_WIDTH * 1000;
-    for( GLint k = 0; k < RAND_ITERATIONS; k++ ) {
-        GLint x1, y1, x2, y2;
-        x1 = rand() % MAP_WIDTH;
-        y1 = rand() % MAP_HEIGHT;
-        x2 = rand() % MAP_WIDTH;
-        y2 = rand() % MAP_HEIGHT;
-
-        GLint tempTexHandle = mapHandles[ x1 ][ y1 ];
-        mapHandles[ x1 ][ y1 ] = mapHandles[ x2 ][ y2 ];
-        mapHandles[ x2 ][ y2 ] = tempTexHandle;
-
-        if( k % 2500 == 0 ) {
-            printf( "." );
-            fflush( stdout );
-        }
+
+    mapTileImages.resize( mapWidth * mapHeight );
+    for( GLint k = 0; k < mapWidth * mapHeight; k++ ) {
+        mapTileImages[k] = k;
+    }
+
+    // Fisher-Yates shuffle of the image numbers
+    for( GLint k = mapWidth * mapHeight - 1; k > 0; k-- ) {
+        GLint swapIndex = rand() % (k + 1);
+        GLint tempImage = mapTileImages[ k ];
+        mapTileImages[ k ] = mapTileImages[ swapIndex ];
+        mapTileImages[ swapIndex ] = tempImage;
     }
     printf( "...done!\n" );
     fflush( stdout );
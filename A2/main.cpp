@@ -559,5 +559,7 @@ int main( ) {
         }
 	}
 
+	shutdownMap();                  // stop loading map tiles and free their textures
+
 	return 0;
 }
@@ -50,11 +50,9 @@ GLfloat arcBallRadius = 5.0;
 GLdouble fpovTheta, fpovPhi;
 glm::vec3 fpovCamPos, fpovCamDir;
 
-struct BuildingData {                       // keeps track of an individual building's attributes
-    glm::mat4 modelMatrix;                      // its position and size
-    glm::vec3 color;                            // its color
-};
-std::vector<BuildingData> buildings;        // stores all of our building information
+std::vector<glm::mat4> buildingModelMatrices;   // the position and size of each building
+std::vector<glm::vec3> buildingColors;          // the color of each building
+std::vector<glm::mat3> buildingNormalMatrices;  // the normal matrix of each building
 //Used for animation of arms and legs
 GLfloat leftArmAngle = -0.1, rightArmAngle = 0.1, armRate = 0.01;
 GLfloat leftLegAngle = 0, rightLegAngle = 0, legRate = 0.02;
@@ -258,10 +256,10 @@ void generateEnvironment() {
                 glm::mat4 scaleMatx = glm::scale(glm::mat4(1.0), glm::vec3(1, sizeScale, 1));
                 glm::mat4 heightTrans = glm::translate(glm::mat4(1.0), glm::vec3(0, 0.5 * sizeScale, 0));
                 glm::vec3 colorMatx = glm::vec3(getRand(), getRand(), getRand());
-                BuildingData temp;
-                temp.modelMatrix = heightTrans * scaleMatx * transMatx;
-                temp.color = colorMatx;
-                buildings.emplace_back(temp);
+                glm::mat4 modelMatx = heightTrans * scaleMatx * transMatx;
+                buildingModelMatrices.emplace_back(modelMatx);
+                buildingColors.emplace_back(colorMatx);
+                buildingNormalMatrices.emplace_back( glm::transpose( glm::inverse( glm::mat3( modelMatx ) ) ) );
             }
         }
     }
@@ -410,13 +408,12 @@ void drawCharacter() {
 //
 ////////////////////////////////////////////////////////////////////////////////
 void renderScene() {
-    // LOOK HERE #1 draw all the buildings
-    for( BuildingData currentBuilding : buildings ) {
-        CSCI441::SimpleShader3::pushTransformation( currentBuilding.modelMatrix );
-            CSCI441::SimpleShader3::setMaterialColor( currentBuilding.color );
-            CSCI441::drawSolidCube(1.0);
-        CSCI441::SimpleShader3::popTransformation();
-    }
+    // LOOK HERE #1 draw all the buildings, every building is the same cube so the whole city is one call
+    CSCI441::SimpleShader3::enableInstancing();
+        CSCI441::drawSolidCubeInstanced(1.0, (GLsizei)buildingModelMatrices.size(),
+                                        (const GLfloat*)buildingModelMatrices.data(), (const GLfloat*)buildingColors.data(),
+                                        (const GLfloat*)buildingNormalMatrices.data());
+    CSCI441::SimpleShader3::disableInstancing();
 
     //draw our character, and transform it based on user input (and scale down to fit in the scene)
     glm::mat4 transMatx = glm::translate(glm::mat4(1.0), glm::vec3(charX, charY - 1, charZ));
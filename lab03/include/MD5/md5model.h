@@ -66,6 +66,12 @@ struct md5_triangle_t
     int index[3];
 };
 
+/* What turns a triangle's edges into its tangent, see BuildMeshNormals() */
+struct md5_tri_tangent_t
+{
+    float tan1, tan2; /* tangent = tan1 * (v1 - v0) + tan2 * (v2 - v0) */
+};
+
 /* Weight */
 struct md5_weight_t
 {
@@ -75,6 +81,42 @@ struct md5_weight_t
     vec3_t pos;
 };
 
+/* Skinning weights laid out as structure-of-arrays, sorted by vertex */
+struct md5_skin_t
+{
+    int num_verts;
+    int num_weights;
+
+    int *start; /* first weight of each vertex */
+    int *count; /* weight count of each vertex */
+    int *joint;
+    float *bias;
+    float *posX, *posY, *posZ;
+
+    /* bind pose normal and tangent of the vertex in each weight's joint
+       space, null until BuildSkinNormals() */
+    float *normX, *normY, *normZ;
+    float *tanX, *tanY, *tanZ;
+};
+
+/* Joint transform as the four columns of a 3x4 matrix, padded to vec4 */
+struct md5_joint_mat_t
+{
+    float col[4][4];
+};
+
+/* Skinning kernels */
+enum {
+    MD5_SKIN_SCALAR, MD5_SKIN_SSE, MD5_SKIN_AVX2, MD5_SKIN_NUM_KERNELS
+};
+
+/* Where skinned normals come from */
+enum {
+    MD5_NORMALS_NONE,       /* positions only */
+    MD5_NORMALS_SKINNED,    /* bind pose normals skinned with the positions */
+    MD5_NORMALS_RECOMPUTED  /* rebuilt from the skinned triangles */
+};
+
 /* Texture Handles */
 struct md5_texture_t
 {
@@ -95,11 +137,19 @@ struct md5_mesh_t
     struct md5_triangle_t *triangles;
     struct md5_weight_t *weights;
     struct md5_texture_t textures[4];
+    struct md5_skin_t skin;
+
+    /* one per triangle, null until BuildMeshNormals() */
+    struct md5_tri_tangent_t *triTangents;
 
     int num_verts;
     int num_tris;
     int num_weights;
 
+    /* where this mesh starts in the model's vertex and index buffers */
+    int firstVertex;
+    int firstIndex;
+
     char shader[256];
 };
 
@@ -113,6 +163,36 @@ struct md5_model_t
     int num_meshes;
 };
 
+/* Joint info */
+struct joint_info_t
+{
+    char name[64];
+    int parent;
+    unsigned int flags;
+    int startIndex;
+};
+
+/* Base frame joint */
+struct baseframe_joint_t
+{
+    vec3_t pos;
+    quat4_t orient;
+};
+
+/* Contents of an md5anim file before any frame skeleton is built */
+struct md5_anim_data_t
+{
+    int num_frames;
+    int num_joints;
+    int frameRate;
+    int numAnimatedComponents;
+
+    struct joint_info_t *jointInfos;
+    struct baseframe_joint_t *baseFrame;
+    struct md5_bbox_t *bboxes;
+    float *frameData; /* numAnimatedComponents per frame */
+};
+
 /* Animation data */
 struct md5_anim_t
 {
@@ -120,8 +200,69 @@ struct md5_anim_t
     int num_joints;
     int frameRate;
 
-    struct md5_joint_t **skelFrames;
+    struct md5_joint_t **skelFrames; /* null when frames come from a clip */
     struct md5_bbox_t *bboxes;
+
+    struct md5_clip_t *clip; /* compiled clip the frames are decoded from */
+};
+
+/* Compiled clip file header, md5clip.cpp describes the layout */
+#define MD5_CLIP_VERSION 3
+static const char MD5_CLIP_MAGIC[4] = { 'M', 'D', '5', 'C' };
+
+enum {
+    MD5_CLIP_FRAMES, /* every animated component of every frame */
+    MD5_CLIP_KEYS    /* reduced keys per joint track */
+};
+
+struct md5_clip_header_t
+{
+    char magic[4];
+    int version;
+    int format;
+
+    int num_frames;
+    int num_joints;
+    int frameRate;
+    int numAnimatedComponents;
+
+    int numTranslations; /* per frame, or in all tracks for keys */
+    int numRotations;    /* per frame, or in all tracks for keys */
+
+    int jointInfosOffset;
+    int baseFrameOffset;
+    int bboxesOffset;
+    int tracksOffset;
+    int translationsOffset;
+    int rotationsOffset;
+    int translationFramesOffset;
+    int rotationFramesOffset;
+    int size;
+};
+
+/* Keys of one joint in a keyed clip, no keys keeps the base frame and
+   num_frames keys is every frame, which stores no frame numbers */
+struct md5_clip_track_t
+{
+    int firstTranslation;
+    int numTranslations;
+    int firstRotation;
+    int numRotations;
+};
+
+/* Decoded frames most recently asked for, one cache per thread */
+#define MD5_FRAME_CACHE_SIZE 4
+
+struct md5_frame_cache_t
+{
+    const struct md5_anim_t *anim;
+
+    int frames[MD5_FRAME_CACHE_SIZE];
+    unsigned int lastUse[MD5_FRAME_CACHE_SIZE];
+    unsigned int clock;
+
+    struct md5_joint_t *skelFrames[MD5_FRAME_CACHE_SIZE];
+    float *frameData; /* scratch for the dequantized components */
 };
 
 /* Animation info */
@@ -134,6 +275,137 @@ struct anim_info_t
     double max_time;
 };
 
+/* Orientations with a larger dot product are nlerped rather than slerped */
+#define MD5_NLERP_MIN_DOT 0.995f
+
+/* Skeletons handed out and taken back without allocating every frame */
+struct md5_pose_pool_t
+{
+    int num_joints;
+
+    struct md5_joint_t **freePoses;
+    int num_free;
+    int capacity; /* poses allocated in all */
+
+    struct md5_joint_t **blocks;
+    int num_blocks;
+
+    /* one frame cache per layer, so layers sampling different clips
+       never evict each other's frames */
+    struct md5_frame_cache_t *layerCaches;
+    int num_layers;
+};
+
+/* One clip feeding EvaluatePose() */
+struct md5_pose_layer_t
+{
+    const struct md5_anim_t *anim;
+    double time;   /* seconds, wraps around the clip */
+    float weight;
+
+    /* additive layers add how far the clip has moved from its pose at
+       referenceTime on top of the blended layers */
+    int additive;
+    double referenceTime;
+};
+
+/* Animated copy of a model inside a crowd */
+struct md5_instance_t
+{
+    struct anim_info_t animInfo;
+
+    float speed; /* playback rate, 1.0 plays the clip as authored */
+    float blend; /* 0.0 holds the bind pose, 1.0 plays the animation */
+
+    vec3_t pos;  /* offset from the model origin */
+
+    /* animation LOD, kept up to date by UpdateCrowd() */
+    int rate;        /* skinned every 1 << rate updates */
+    int sinceUpdate; /* updates since it was last skinned */
+    int culled;      /* outside the view, not skinned */
+    int reduced;     /* skinned with the reduced joint set */
+    int skinned;     /* its vertices hold a pose */
+    float distance;  /* from the eye, in model units */
+
+    /* drawn blended between its last two skinned poses, see md5lod.cpp */
+    int pose;         /* which of the crowd's pose arrays holds the last one */
+    int sinceSkinned; /* updates since it was last skinned, sinceUpdate starts staggered */
+    int interval;     /* updates between its last two skinnings, 0 after the first */
+};
+
+/* Update rates of the animation LOD, every update down to every 8th */
+#define MD5_LOD_RATES 4
+
+/* Animation level of detail of a crowd, zero turns a setting off */
+struct md5_crowd_lod_t
+{
+    float rateDistance[MD5_LOD_RATES - 1]; /* past each, skin half as often */
+    float reducedDistance; /* past this, skin with the reduced joint set */
+    float reducedReach;    /* joints moving no vertex this far are folded into their parent */
+    int weightBudget;      /* most weights skinned in one update */
+    int blendPoses;        /* draw instances below full rate blended between their last two poses */
+};
+
+/* What the last UpdateCrowd() did */
+struct md5_crowd_stats_t
+{
+    int atRate[MD5_LOD_RATES]; /* visible instances at each rate */
+    int culled;   /* not skinned, outside the view */
+    int updated;  /* skinned */
+    int blended;  /* drawn between its last two skinned poses */
+    int reduced;  /* skinned with the reduced joint set */
+    int deferred; /* due but left for a later update by the budget */
+    long weights; /* weights skinned */
+};
+
+/* Instances sharing one model and animation, skinned into one vertex array */
+struct md5_crowd_t
+{
+    const struct md5_model_t *mdl;
+    const struct md5_anim_t *anim;
+
+    struct md5_instance_t *instances;
+    int num_instances;
+
+    /* vertices are grouped by mesh, then by instance */
+    vec3_t *vertexArray;
+    vec3_t *normalArray; /* null without normals */
+    int normals;         /* MD5_NORMALS_* */
+    int num_verts;
+    int *meshFirstVertex;
+    int *meshFirstIndex;
+
+    struct md5_crowd_pool_t *pool;
+
+    /* fixed simulation step in seconds, 0 updates on every call */
+    double step;
+    double pending;
+
+    /* animation LOD, see md5lod.cpp */
+    struct md5_crowd_lod_t lod;
+    struct md5_crowd_stats_t stats;
+    int hasView;
+    float frustum[6][4]; /* planes in model space, inside is positive */
+    vec3_t eye;
+    struct md5_bbox_t bindBounds;
+    struct md5_skin_t *reducedSkins; /* per mesh, null without a reduced distance */
+    int fullWeights, reducedWeights; /* per instance */
+    int *tasks; /* instances to skin this update, then those to blend as -1 - index */
+    int num_tasks;
+    int num_blends;
+    vec3_t *poseVertices[2]; /* last two skinned poses, laid out as vertexArray, null at full rate */
+    vec3_t *poseNormals[2];  /* null without normals */
+    int *drawCounts; /* runs of visible instances handed to the draw */
+    const void **drawOffsets;
+
+    unsigned int vao, texVBO, ibo;
+    unsigned int posAttribLoc, normalAttribLoc;
+    struct md5_stream_t *stream;
+};
+
+/* Frames a streamed vertex buffer can have in flight */
+#define MD5_STREAM_FRAMES 3
+
 /**
  * Quaternion prototypes
  */
@@ -144,24 +416,144 @@ void Quat_multVec (const quat4_t q, const vec3_t v, quat4_t out);
 void Quat_rotatePoint (const quat4_t q, const vec3_t in, vec3_t out);
 float Quat_dotProduct (const quat4_t qa, const quat4_t qb);
 void Quat_slerp (const quat4_t qa, const quat4_t qb, float t, quat4_t out);
+void Quat_nlerp (const quat4_t qa, const quat4_t qb, float t, quat4_t out);
+void Quat_packSmallestThree (const quat4_t q, unsigned short out[3]);
+void Quat_unpackSmallestThree (const unsigned short in[3], quat4_t out);
 
 /**
  * md5mesh prototypes
  */
 int ReadMD5Model (const char *filename, struct md5_model_t *mdl);
+int ScanMD5Model (const char *filename, struct md5_model_t *mdl);
 void FreeModel (struct md5_model_t *mdl);
 void PrepareMesh (const struct md5_mesh_t *mesh,
                   const struct md5_joint_t *skeleton);
-void AllocVertexArrays (unsigned int vPosAttribLoc, unsigned int vColorAttribLoc, unsigned int vTexCoordAttribLoc, int num_joints);
+void PrepareSkinnedMesh (const struct md5_mesh_t *mesh,
+                         const struct md5_joint_mat_t *jointMats);
+void SetMeshNormals (int normals);
+void AllocMeshArrays (const struct md5_model_t *mdl);
+void FreeMeshArrays ();
+const vec3_t *GetMeshVertices ();
+const vec3_t *GetMeshNormals ();
+void AllocVertexArrays (const struct md5_model_t *mdl, unsigned int vPosAttribLoc, unsigned int vColorAttribLoc,
+                        unsigned int vTexCoordAttribLoc, unsigned int vNormalAttribLoc);
 void FreeVertexArrays ();
 void DrawSkeleton (const struct md5_joint_t *skeleton, int num_joints);
 void DrawMesh ( const struct md5_mesh_t *mesh );
+void EndMeshFrame ();
+unsigned long GetMeshBytesUploaded ();
+
+/**
+ * md5parse prototypes
+ */
+int ParseMD5Model (const char *filename, struct md5_model_t *mdl);
+int ReadMD5AnimData (const char *filename, struct md5_anim_data_t *data);
+
+/**
+ * md5skin prototypes
+ */
+void BuildMeshSkin (const struct md5_mesh_t *mesh, struct md5_skin_t *skin);
+void BuildReducedMeshSkin (const struct md5_mesh_t *mesh, const struct md5_joint_t *bindSkel,
+                           const int *jointMap, struct md5_skin_t *skin);
+void FreeMeshSkin (struct md5_skin_t *skin);
+void BuildJointMatrices (const struct md5_joint_t *skeleton, int num_joints,
+                         struct md5_joint_mat_t *out);
+int SkinKernelSupported (int kernel);
+int GetSkinKernel ();
+void SetSkinKernel (int kernel);
+const char *GetSkinKernelName (int kernel);
+void SkinMesh (const struct md5_skin_t *skin,
+               const struct md5_joint_mat_t *jointMats, vec3_t *out);
+void BuildMeshNormals (struct md5_mesh_t *mesh, const struct md5_joint_t *bindSkel);
+void BuildSkinNormals (const struct md5_mesh_t *mesh, const struct md5_joint_t *bindSkel,
+                       struct md5_skin_t *skin);
+void SkinMeshNormals (const struct md5_skin_t *skin, const struct md5_joint_mat_t *jointMats,
+                      vec3_t *out, vec3_t *normals, vec3_t *tangents);
+void RecomputeNormals (const struct md5_mesh_t *mesh, const vec3_t *positions,
+                       vec3_t *normals, vec3_t *tangents);
+
+/**
+ * md5stream prototypes
+ */
+struct md5_stream_t *AllocStream (long frameSize);
+void FreeStream (struct md5_stream_t *stream);
+unsigned long StreamWrite (struct md5_stream_t *stream, long offset, const void *data, long size);
+void EndStreamFrame (struct md5_stream_t *stream);
+unsigned int GetStreamBuffer (const struct md5_stream_t *stream);
+unsigned long GetStreamBytesUploaded (const struct md5_stream_t *stream);
+
+/**
+ * md5crowd prototypes
+ */
+int InitCrowd (struct md5_crowd_t *crowd, const struct md5_model_t *mdl,
+               const struct md5_anim_t *anim, int num_instances, float spacing);
+void FreeCrowd (struct md5_crowd_t *crowd);
+void SetCrowdThreads (struct md5_crowd_t *crowd, int num_threads);
+int GetCrowdThreads (const struct md5_crowd_t *crowd);
+void SetCrowdRate (struct md5_crowd_t *crowd, double hz);
+void SetCrowdNormals (struct md5_crowd_t *crowd, int normals);
+int UpdateCrowd (struct md5_crowd_t *crowd, double dt);
+void AllocCrowdArrays (struct md5_crowd_t *crowd, unsigned int vPosAttribLoc, unsigned int vTexCoordAttribLoc,
+                       unsigned int vNormalAttribLoc);
+void FreeCrowdArrays (struct md5_crowd_t *crowd);
+void DrawCrowd (const struct md5_crowd_t *crowd);
+
+/**
+ * md5lod prototypes
+ */
+void SetCrowdLOD (struct md5_crowd_t *crowd, const struct md5_crowd_lod_t *lod);
+void SetCrowdView (struct md5_crowd_t *crowd, const float modelViewProjection[16], const vec3_t eye);
+const struct md5_crowd_stats_t *GetCrowdStats (const struct md5_crowd_t *crowd);
+void ScheduleCrowd (struct md5_crowd_t *crowd, double dt);
+
+/**
+ * md5clip prototypes
+ */
+int CompileMD5Anim (const char *md5animFile, const char *clipFile);
+int ReadMD5Clip (const char *filename, struct md5_anim_t *anim);
+void FreeClip (struct md5_clip_t *clip);
+void DecodeClipFrame (const struct md5_clip_t *clip, int frame,
+                      float *frameData, struct md5_joint_t *skelFrame);
+int SampleClip (const struct md5_clip_t *clip, float frame,
+                struct md5_joint_t *skelFrame);
+void InitFrameCache (struct md5_frame_cache_t *cache);
+void FreeFrameCache (struct md5_frame_cache_t *cache);
+const struct md5_joint_t *GetAnimFrame (const struct md5_anim_t *anim,
+                                        struct md5_frame_cache_t *cache,
+                                        int frame);
+unsigned long GetAnimBytes (const struct md5_anim_t *anim);
+
+/**
+ * md5compress prototypes
+ */
+int CompressMD5Anim (const struct md5_model_t *mdl, const char *md5animFile,
+                     const char *clipFile, float maxVertexError, float maxRotationError);
+
+/**
+ * md5pose prototypes
+ */
+void InitPosePool (struct md5_pose_pool_t *pool, int num_joints, int num_poses);
+void FreePosePool (struct md5_pose_pool_t *pool);
+struct md5_joint_t *AcquirePose (struct md5_pose_pool_t *pool);
+void ReleasePose (struct md5_pose_pool_t *pool, struct md5_joint_t *pose);
+void ReservePoseLayers (struct md5_pose_pool_t *pool, int num_layers);
+void SampleAnim (const struct md5_anim_t *anim, struct md5_frame_cache_t *cache,
+                 double time, struct md5_joint_t *out);
+void BlendSkeletons (const struct md5_joint_t *const *skels, const float *weights,
+                     int count, int num_joints, struct md5_joint_t *out);
+void AddSkeleton (const struct md5_joint_t *base, const struct md5_joint_t *additive,
+                  const struct md5_joint_t *reference, float weight,
+                  int num_joints, struct md5_joint_t *out);
+void EvaluatePose (const struct md5_pose_layer_t *layers, int count,
+                   struct md5_pose_pool_t *pool, struct md5_joint_t *out);
 
 /**
  * md5anim prototypes
  */
 int CheckAnimValidity (const struct md5_model_t *mdl,
                        const struct md5_anim_t *anim);
+int ScanMD5AnimData (const char *filename, struct md5_anim_data_t *data);
+void FreeAnimData (struct md5_anim_data_t *data);
 int ReadMD5Anim (const char *filename, struct md5_anim_t *anim);
 void BuildFrameSkeleton (const struct joint_info_t *jointInfos,
                          const struct baseframe_joint_t *baseFrame,
@@ -175,5 +567,6 @@ void InterpolateSkeletons (const struct md5_joint_t *skelA,
                            struct md5_joint_t *out);
 void Animate (const struct md5_anim_t *anim,
               struct anim_info_t *animInfo, double dt);
+double GetAnimTime (const struct anim_info_t *animInfo);
 
 #endif /* __MD5MODEL_H__ */
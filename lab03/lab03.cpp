@@ -93,12 +93,15 @@ void setupMD5Shader_internal() {
               \n \
               layout(location=0) in vec3 vPos;\n \
               layout(location=2) in vec2 vTexCoord;\n \
+              layout(location=3) in vec3 vNormal;\n \
               \n \
               layout(location=0) out vec2 texCoord;\n \
+              layout(location=1) out vec3 normal;\n \
               \n \
               void main() {\n \
                 gl_Position = projection * view * model * vec4(vPos, 1.0);\n \
                 texCoord = vTexCoord;\n \
+                normal = mat3(model) * vNormal;\n \
               }\n";
 
     const std::string MD5_FRAGMENT_SHADER_SRC =
@@ -107,11 +110,17 @@ void setupMD5Shader_internal() {
               uniform sampler2D md5Texture;\
               \n \
               layout(location=0) in vec2 texCoord;\n \
+              layout(location=1) in vec3 normal;\n \
               \n \
               layout(location=0) out vec4 fragColorOut;\n \
               \n \
               void main() {\n \
-                fragColorOut = texture(md5Texture, texCoord);\n \
+                vec4 texel = texture(md5Texture, texCoord);\n \
+                float light = 1.0;\n \
+                if( dot(normal, normal) > 0.0 ) {\n \
+                  light = 0.3 + 0.7 * max( dot( normalize(normal), normalize(vec3(0.4, 1.0, 0.6)) ), 0.0 );\n \
+                }\n \
+                fragColorOut = vec4(texel.rgb * light, texel.a);\n \
               }\n";
 
     md5ShaderHandle = registerShader( MD5_VERTEX_SHADER_SRC, MD5_FRAGMENT_SHADER_SRC );
@@ -182,8 +191,7 @@ void Lab03BlackMagic::setMVPMatrices( glm::mat4 projMtx, glm::mat4 viewMtx ) {
     glUniformMatrix4fv(passThroughUniforms.projection, 1, GL_FALSE, &projMtx[0][0]);
 
     glUseProgram( md5ShaderHandle );
-    m = glm::rotate( glm::mat4(1.0f), -90.0f * 3.14159f / 180.0f, glm::vec3( 1.0f, 0.0f, 0.0f ) );
-    m = glm::scale( m, glm::vec3( 0.09f, 0.09f, 0.09f ) );
+    m = getMD5ModelMatrix();
     glUniformMatrix4fv(md5Uniforms.model, 1, GL_FALSE, &m[0][0]);
     glUniformMatrix4fv(md5Uniforms.view, 1, GL_FALSE, &viewMtx[0][0]);
     glUniformMatrix4fv(md5Uniforms.projection, 1, GL_FALSE, &projMtx[0][0]);
@@ -196,6 +204,11 @@ void Lab03BlackMagic::setMVPMatrices( glm::mat4 projMtx, glm::mat4 viewMtx ) {
     glUseProgram( passThroughShaderHandle );
 }
 
+glm::mat4 Lab03BlackMagic::getMD5ModelMatrix() {
+    glm::mat4 m = glm::rotate( glm::mat4(1.0f), -90.0f * 3.14159f / 180.0f, glm::vec3( 1.0f, 0.0f, 0.0f ) );
+    return glm::scale( m, glm::vec3( 0.09f, 0.09f, 0.09f ) );
+}
+
 void Lab03BlackMagic::deleteShaders() {
     glDeleteProgram( passThroughShaderHandle );
     glDeleteProgram( md5ShaderHandle );
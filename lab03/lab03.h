@@ -8,6 +8,7 @@
 namespace Lab03BlackMagic {
     void setupShaders();
     void setMVPMatrices( glm::mat4 projMtx, glm::mat4 viewMtx );
+    glm::mat4 getMD5ModelMatrix();
     void setMD5Shader();
     void setSkeletonShader();
     void deleteShaders();
@@ -16,8 +17,9 @@ namespace Lab03BlackMagic {
         GLint vertexPosition;
         GLint vertexColor;
         GLint vertexTextureCoord;
+        GLint vertexNormal;
     };
-    static const ShaderAttributes SHADER_ATTRIBUTES = {0, 1, 2 };
+    static const ShaderAttributes SHADER_ATTRIBUTES = {0, 1, 2, 3 };
 }
 
 #endif // __CSCI441_LAB03_BLACK_MAGIC_H___
@@ -10,6 +10,9 @@
  *
  *  Author: Dr. Paone, Colorado School of Mines, 2020
  *
+ *  Usage: lab03 [--clip]
+ *      --clip  map the clip md5animc compiled instead of reading the text animation
+ *
  */
 
 //******************************************************************************
@@ -26,6 +29,9 @@
 
 #include <cstdio>				    // for printf functionality
 #include <cstdlib>				    // for exit functionality
+#include <cstring>				    // for strcmp functionality
+
+#include <sys/stat.h>			    // for file modification times
 
 #include "lab03.h"                  // for Lab03BlackMagic
 #include <MD5/md5model.h>	// for our MD5 Model
@@ -49,12 +55,31 @@ md5_model_t md5model;
 md5_anim_t md5animation;
 
 md5_joint_t *skeleton = nullptr;
+md5_joint_mat_t *jointMatrices = nullptr;
 anim_info_t animInfo;
+md5_frame_cache_t frameCache;
+
+// set by --clip to map the clip md5animc compiled, when it is newer than the animation
+bool useClip = false;
+
+// many hellknights sharing the model above, updated on every hardware thread
+// at a fixed rate whatever the frame rate
+const int CROWD_SIZE = 100;
+const float CROWD_SPACING = 120.0f;
+const double CROWD_RATE = 30.0;
+
+// in model units: slower updates and fewer joints further out, at most about
+// 35 hellknights' worth of weights skinned in one update, and the slower ones
+// drawn blended between their last two poses so they do not jump
+const md5_crowd_lod_t CROWD_LOD = { { 600.0f, 1000.0f, 1400.0f }, 800.0f, 8.0f, 150000, 1 };
+md5_crowd_t crowd;
 
 bool animated = false;
 bool displaySkeleton = false;
 bool displayWireframe = false;
 bool displayMesh = true;
+int normalSource = MD5_NORMALS_SKINNED;
+bool displayCrowd = false;
 
 //******************************************************************************
 //
@@ -98,6 +123,23 @@ static void key_callback(GLFWwindow* window, int key, int scancode, int action,
                 displayMesh = !displayMesh;
                 break;
 
+            case GLFW_KEY_C:
+                displayCrowd = !displayCrowd;
+                break;
+
+            case GLFW_KEY_N:
+                normalSource = (normalSource + 1) % 3;
+                SetMeshNormals( normalSource );
+                SetCrowdNormals( &crowd, normalSource );
+                printf( "[INFO]: normals %s\n", normalSource == MD5_NORMALS_SKINNED ? "skinned"
+                                               : normalSource == MD5_NORMALS_RECOMPUTED ? "recomputed" : "off" );
+                break;
+
+            case GLFW_KEY_U:
+                printf( "[INFO]: %lu bytes of vertices uploaded last frame\n",
+                        displayCrowd && crowd.stream ? GetStreamBytesUploaded( crowd.stream ) : GetMeshBytesUploaded() );
+                break;
+
             default: break;
         }
     }
@@ -233,25 +275,55 @@ void setupBuffers() {
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(quadIndexArray), quadIndexArray, GL_STATIC_DRAW);
 }
 
+// clipIsCurrent() /////////////////////////////////////////////////////////////
+//
+//      True when the compiled clip exists and is no older than the animation
+//  it was compiled from
+//
+////////////////////////////////////////////////////////////////////////////////
+bool clipIsCurrent( const char *md5clip, const char *md5anim ) {
+	struct stat clipInfo, animInfo;
+
+	if( stat( md5clip, &clipInfo ) != 0 ) return false;
+	if( stat( md5anim, &animInfo ) != 0 ) return true;
+
+	return clipInfo.st_mtime >= animInfo.st_mtime;
+}
+
 // loadMD5Model() //////////////////////////////////////////////////////////////
 //
 //      Load in the MD5 Model
 //
 ////////////////////////////////////////////////////////////////////////////////
-void loadMD5Model( const char *md5mesh, const char *md5anim ) {
+void loadMD5Model( const char *md5mesh, const char *md5anim, const char *md5clip ) {
 	/* Load MD5 model file */
 	if (!ReadMD5Model (md5mesh, &md5model))
 			exit (EXIT_FAILURE);
 
+	/* Allocate memory for the per frame joint matrices */
+	jointMatrices = (md5_joint_mat_t *)malloc (sizeof (md5_joint_mat_t) * md5model.num_joints);
+
     // allocate memory for arrays and create VAO for MD5 Model
-	AllocVertexArrays (Lab03BlackMagic::SHADER_ATTRIBUTES.vertexPosition,
+	AllocVertexArrays (&md5model,
+                       Lab03BlackMagic::SHADER_ATTRIBUTES.vertexPosition,
                        Lab03BlackMagic::SHADER_ATTRIBUTES.vertexColor,
                        Lab03BlackMagic::SHADER_ATTRIBUTES.vertexTextureCoord,
-                       md5model.num_joints);
+                       Lab03BlackMagic::SHADER_ATTRIBUTES.vertexNormal);
 
 	if( md5anim ) {
-		/* Load MD5 animation file */
-		if (!ReadMD5Anim (md5anim, &md5animation)) {
+		/* Map the compiled clip when asked to and it is up to date, or else load the MD5 animation file */
+		bool loaded = false;
+		if( useClip ) {
+			if( clipIsCurrent( md5clip, md5anim ) ) {
+				loaded = ReadMD5Clip (md5clip, &md5animation);
+			} else {
+				printf ("[.md5anim]: %s is missing or older than %s, reading the animation instead\n", md5clip, md5anim);
+				printf ("[.md5anim]: compile it with: md5animc -m %s %s %s\n", md5mesh, md5anim, md5clip);
+			}
+		}
+		loaded = loaded || ReadMD5Anim (md5anim, &md5animation);
+
+		if (!loaded) {
 				exit (EXIT_FAILURE);
 		} else {
 				// successful loading...set up animation parameters
@@ -274,6 +346,18 @@ void loadMD5Model( const char *md5mesh, const char *md5anim ) {
 			printf ("[.md5anim]: no animation loaded.\n");
 	}
 
+	// set up the crowd to share this model and animation
+	if( InitCrowd( &crowd, &md5model, animated ? &md5animation : nullptr, CROWD_SIZE, CROWD_SPACING ) ) {
+		SetCrowdThreads( &crowd, 0 );
+		SetCrowdRate( &crowd, CROWD_RATE );
+		SetCrowdLOD( &crowd, &CROWD_LOD );
+		SetCrowdNormals( &crowd, normalSource );
+		AllocCrowdArrays( &crowd,
+						  Lab03BlackMagic::SHADER_ATTRIBUTES.vertexPosition,
+						  Lab03BlackMagic::SHADER_ATTRIBUTES.vertexTextureCoord,
+						  Lab03BlackMagic::SHADER_ATTRIBUTES.vertexNormal );
+	}
+
 	printf("\n");
 }
 
@@ -299,16 +383,15 @@ void renderScene( glm::mat4 viewMatrix, glm::mat4 projectionMatrix, double dt )
 		/* Calculate current and next frames */
 		Animate (&md5animation, &animInfo, dt);
 
-		/* Interpolate skeletons between two frames */
-		InterpolateSkeletons (md5animation.skelFrames[animInfo.curr_frame],
-													md5animation.skelFrames[animInfo.next_frame],
-													md5animation.num_joints,
-													animInfo.last_time * md5animation.frameRate,
-													skeleton);
+		/* Skeleton at the current time, between two frames */
+		SampleAnim (&md5animation, &frameCache, GetAnimTime (&animInfo), skeleton);
     } else {
 		skeleton = md5model.baseSkel;
 	}
 
+	/* Skin every mesh from the same joint matrices */
+	BuildJointMatrices( skeleton, md5model.num_joints, jointMatrices );
+
 	if( displaySkeleton ) {
         Lab03BlackMagic::setSkeletonShader();
 		DrawSkeleton( skeleton, md5model.num_joints );
@@ -316,10 +399,27 @@ void renderScene( glm::mat4 viewMatrix, glm::mat4 projectionMatrix, double dt )
 
     Lab03BlackMagic::setMD5Shader();
 
+	if( displayCrowd && crowd.num_instances > 0 ) {
+		/* Cull and pick update rates in the crowd's own model space */
+		glm::mat4 modelView = viewMatrix * Lab03BlackMagic::getMD5ModelMatrix();
+		glm::mat4 mvp = projectionMatrix * modelView;
+		glm::vec3 eye = glm::vec3( glm::inverse( modelView ) * glm::vec4( 0.0f, 0.0f, 0.0f, 1.0f ) );
+		SetCrowdView( &crowd, &mvp[0][0], &eye[0] );
+
+		UpdateCrowd( &crowd, dt );
+
+		if( displayWireframe )
+			glPolygonMode (GL_FRONT_AND_BACK, GL_LINE);
+
+		if( displayMesh )
+			DrawCrowd( &crowd );
+		return;
+	}
+
 	/* Draw each mesh of the model */
 	for( int i = 0; i < md5model.num_meshes; ++i ) {
 			md5_mesh_t mesh = md5model.meshes[i];
-			PrepareMesh( &mesh, skeleton );
+			PrepareSkinnedMesh( &mesh, jointMatrices );
 
 			if( displayWireframe )
 				glPolygonMode (GL_FRONT_AND_BACK, GL_LINE);
@@ -327,6 +427,7 @@ void renderScene( glm::mat4 viewMatrix, glm::mat4 projectionMatrix, double dt )
 			if( displayMesh )
 				DrawMesh( &mesh );
 	}
+	EndMeshFrame();
 }
 
 ///*****************************************************************************
@@ -335,7 +436,13 @@ void renderScene( glm::mat4 viewMatrix, glm::mat4 projectionMatrix, double dt )
 
 // main() ///////////////////////////////////////////////////////////////
 //
-int main() {
+int main( int argc, char *argv[] ) {
+	for( int i = 1; i < argc; i++ ) {
+		if( strcmp( argv[i], "--clip" ) == 0 ) {
+			useClip = true;
+		}
+	}
+
 	// GLFW sets up our OpenGL context so must be done first
 	GLFWwindow *window = setupGLFW();	                // initialize all of the GLFW specific information releated to OpenGL and our window
     setupGLEW();										// initialize all of the GLEW specific information
@@ -350,7 +457,8 @@ int main() {
 	setupBuffers();										// load all our VAOs and VBOs into memory
 
     // load the MD5 Model & animation
-	loadMD5Model("models/monsters/hellknight/mesh/hellknight.md5mesh","models/monsters/hellknight/animations/idle2.md5anim" );
+	loadMD5Model("models/monsters/hellknight/mesh/hellknight.md5mesh","models/monsters/hellknight/animations/idle2.md5anim",
+				 "models/monsters/hellknight/animations/idle2.md5clip" );
 
 	// used to keep track of the time between frames rendered
 	double current_time = glfwGetTime(), last_time = 0;
@@ -401,8 +509,12 @@ int main() {
     glDeleteBuffers(1, &platformVAOd);
 	// free up memory used by the MD5 model
 	FreeVertexArrays();
+	FreeCrowdArrays(&crowd);
+	FreeCrowd(&crowd);
+	FreeFrameCache (&frameCache);
 	FreeAnim (&md5animation);
 	FreeModel(&md5model);
+	free(jointMatrices);
 
 	return EXIT_SUCCESS;				                // exit our program successfully!
 }
@@ -0,0 +1,53 @@
+/*
+ *  CSCI 441, Computer Graphics, Fall 2020
+ *
+ *  Project: lab03
+ *  File: md5animc.cpp
+ *
+ *  Description:
+ *      Compiles an md5anim file to the binary clip read by ReadMD5Clip().
+ *      Given the model it animates, the clip is compressed to the keys
+ *      needed to keep its skinned vertices within the error bound.
+ *
+ *  Usage: md5animc [-m model.md5mesh [-e vertexError] [-r rotationError]]
+ *                  input.md5anim output.md5clip
+ *
+ */
+
+#include <MD5/md5model.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int main( int argc, char *argv[] ) {
+    const char *md5mesh = nullptr;
+    float vertexError = 0.02f;          // model units
+    float rotationError = 0.01f;        // radians
+    int arg = 1;
+
+    for( ; arg + 1 < argc && argv[arg][0] == '-'; arg += 2 ) {
+        if( strcmp( argv[arg], "-m" ) == 0 )      md5mesh = argv[arg + 1];
+        else if( strcmp( argv[arg], "-e" ) == 0 ) vertexError = (float)atof( argv[arg + 1] );
+        else if( strcmp( argv[arg], "-r" ) == 0 ) rotationError = (float)atof( argv[arg + 1] );
+        else break;
+    }
+
+    if( argc - arg != 2 || vertexError <= 0.0f || rotationError <= 0.0f ) {
+        fprintf( stderr, "Usage: %s [-m model.md5mesh [-e vertexError] [-r rotationError]] input.md5anim output.md5clip\n", argv[0] );
+        return EXIT_FAILURE;
+    }
+
+    if( !md5mesh ) {
+        return CompileMD5Anim( argv[arg], argv[arg + 1] ) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // only the skin is needed to bound the error, so the parser alone reads the mesh
+    md5_model_t model = {};
+    bool compressed = ParseMD5Model( md5mesh, &model )
+                   && CompressMD5Anim( &model, argv[arg], argv[arg + 1], vertexError, rotationError );
+
+    FreeModel( &model );
+
+    return compressed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,103 @@
+/*
+ *  CSCI 441, Computer Graphics, Fall 2020
+ *
+ *  Project: lab03
+ *  File: md5clipBench.cpp
+ *
+ *  Description:
+ *      Compiles the hellknight animation to a clip, checks every decoded
+ *      frame against the skeletons ReadMD5Anim() builds, and compares the
+ *      memory and load time of both.
+ *
+ *  Usage: md5clipBench [loads]
+ *
+ */
+
+#include <MD5/md5model.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+const char *MD5_ANIM = "models/monsters/hellknight/animations/idle2.md5anim";
+const char *MD5_CLIP = "models/monsters/hellknight/animations/idle2.md5clip";
+
+// largest differences allowed from the text animation.  16 bit rotations are
+// within a few thousandths of a radian, about 0.02 units at the hellknight's
+// finger tips, which stands nearly 120 units tall
+const float POSITION_TOLERANCE = 5e-2f;      // model units
+const float ORIENT_TOLERANCE = 1e-5f;        // 1 - |cos| between the orientations
+
+int main( int argc, char *argv[] ) {
+    int loads = argc > 1 ? atoi( argv[1] ) : 20;
+    typedef std::chrono::high_resolution_clock Clock;
+
+    if( !CompileMD5Anim( MD5_ANIM, MD5_CLIP ) ) {
+        exit( EXIT_FAILURE );
+    }
+
+    // load both a few times over, keeping the last of each
+    md5_anim_t text = {}, clip = {};
+    double textSeconds = 0.0, clipSeconds = 0.0;
+    for( int l = 0; l < loads; ++l ) {
+        FreeAnim( &text );
+        FreeAnim( &clip );
+
+        Clock::time_point start = Clock::now();
+        if( !ReadMD5Anim( MD5_ANIM, &text ) ) exit( EXIT_FAILURE );
+        Clock::time_point middle = Clock::now();
+        if( !ReadMD5Clip( MD5_CLIP, &clip ) ) exit( EXIT_FAILURE );
+        Clock::time_point end = Clock::now();
+
+        textSeconds += std::chrono::duration<double>( middle - start ).count();
+        clipSeconds += std::chrono::duration<double>( end - middle ).count();
+    }
+
+    // every decoded frame against the built one
+    md5_frame_cache_t cache;
+    InitFrameCache( &cache );
+
+    float maxPosError = 0.0f, maxOrientError = 0.0f;
+    bool namesMatch = text.num_frames == clip.num_frames && text.num_joints == clip.num_joints;
+    for( int f = 0; namesMatch && f < text.num_frames; ++f ) {
+        const md5_joint_t *expected = text.skelFrames[f];
+        const md5_joint_t *actual = GetAnimFrame( &clip, &cache, f );
+
+        for( int j = 0; j < text.num_joints; ++j ) {
+            namesMatch = namesMatch && expected[j].parent == actual[j].parent && strcmp( expected[j].name, actual[j].name ) == 0;
+
+            for( int k = 0; k < 3; ++k ) {
+                float error = fabsf( expected[j].pos[k] - actual[j].pos[k] );
+                if( !(error <= maxPosError) ) maxPosError = error;      // also catches NaN
+            }
+            float error = 1.0f - fabsf( Quat_dotProduct( expected[j].orient, actual[j].orient ) );
+            if( !(error <= maxOrientError) ) maxOrientError = error;
+        }
+    }
+    bool passed = namesMatch && maxPosError <= POSITION_TOLERANCE && maxOrientError <= ORIENT_TOLERANCE;
+
+    // how long a decode takes when the cache misses every time
+    const int DECODES = 10000;
+    Clock::time_point start = Clock::now();
+    for( int d = 0; d < DECODES; ++d ) {
+        GetAnimFrame( &clip, &cache, (d * 7) % clip.num_frames );
+    }
+    double decodeSeconds = std::chrono::duration<double>( Clock::now() - start ).count();
+
+    unsigned long cacheBytes = MD5_FRAME_CACHE_SIZE * sizeof( md5_joint_t ) * clip.num_joints;
+    printf( "[INFO]: %d frames of %d joints  %s  max position error: %.2e  max orientation error: %.2e\n",
+            text.num_frames, text.num_joints, passed ? "PASS" : "FAIL", maxPosError, maxOrientError );
+    printf( "[INFO]: text  %8lu bytes                  %8.3f ms/load\n", GetAnimBytes( &text ), textSeconds / loads * 1e3 );
+    printf( "[INFO]: clip  %8lu bytes + %6lu cache  %8.3f ms/load  %.2f us/decoded frame\n",
+            GetAnimBytes( &clip ), cacheBytes, clipSeconds / loads * 1e3, decodeSeconds / DECODES * 1e6 );
+    printf( "[INFO]: %.1fx less memory, %.0fx faster to load\n",
+            (double)GetAnimBytes( &text ) / ( GetAnimBytes( &clip ) + cacheBytes ), textSeconds / clipSeconds );
+
+    FreeFrameCache( &cache );
+    FreeAnim( &text );
+    FreeAnim( &clip );
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,180 @@
+/*
+ *  CSCI 441, Computer Graphics, Fall 2020
+ *
+ *  Project: lab03
+ *  File: md5compressBench.cpp
+ *
+ *  Description:
+ *      Compresses the hellknight animation at several error bounds and
+ *      reports the clip size, the skinned vertex error against the text
+ *      animation, and the cost of sampling a pose from each clip next to
+ *      decoding every frame clip and interpolating built frames.  A clip
+ *      fails if it is larger than the every frame clip.
+ *
+ *  Usage: md5compressBench [samples]
+ *
+ */
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <MD5/md5model.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+const char *MD5_MESH = "models/monsters/hellknight/mesh/hellknight.md5mesh";
+const char *MD5_ANIM = "models/monsters/hellknight/animations/idle2.md5anim";
+const char *MD5_CLIP = "models/monsters/hellknight/animations/idle2.md5clip";
+
+// the hellknight stands nearly 120 units tall.  48 bit rotations alone are
+// about 0.015 units off at its finger tips, so tighter bounds keep every key
+const float VERTEX_ERRORS[] = { 0.02f, 0.05f, 0.1f, 0.5f };
+const float MAX_ROTATION_ERROR = 0.05f;      // radians
+
+// largest distance between the vertices skinned from two skeletons
+float skinnedError( const md5_model_t &model, const md5_joint_t *expected, const md5_joint_t *actual ) {
+    std::vector<md5_joint_mat_t> expectedMats( model.num_joints ), actualMats( model.num_joints );
+    BuildJointMatrices( expected, model.num_joints, &expectedMats[0] );
+    BuildJointMatrices( actual, model.num_joints, &actualMats[0] );
+
+    float maxError = 0.0f;
+    for( int m = 0; m < model.num_meshes; ++m ) {
+        std::vector<float> a( model.meshes[m].num_verts * 3 ), b( model.meshes[m].num_verts * 3 );
+        SkinMesh( &model.meshes[m].skin, &expectedMats[0], (vec3_t *)&a[0] );
+        SkinMesh( &model.meshes[m].skin, &actualMats[0], (vec3_t *)&b[0] );
+        for( int i = 0; i < model.meshes[m].num_verts; ++i ) {
+            float dx = a[i*3] - b[i*3], dy = a[i*3+1] - b[i*3+1], dz = a[i*3+2] - b[i*3+2];
+            float error = sqrtf( dx*dx + dy*dy + dz*dz );
+            if( !(error <= maxError) ) maxError = error;      // also catches NaN
+        }
+    }
+    return maxError;
+}
+
+int main( int argc, char *argv[] ) {
+    int samples = argc > 1 ? atoi( argv[1] ) : 20000;
+    typedef std::chrono::high_resolution_clock Clock;
+
+    // ReadMD5Model() loads the textures too, so it needs a context
+    if( !glfwInit() ) {
+        fprintf( stderr, "[ERROR]: Could not initialize GLFW\n" );
+        exit( EXIT_FAILURE );
+    }
+    glfwWindowHint( GLFW_VISIBLE, GLFW_FALSE );
+    glfwWindowHint( GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE );
+    glfwWindowHint( GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE );
+    glfwWindowHint( GLFW_CONTEXT_VERSION_MAJOR, 4 );
+    glfwWindowHint( GLFW_CONTEXT_VERSION_MINOR, 1 );
+    GLFWwindow *window = glfwCreateWindow( 64, 64, "MD5 Compression Benchmark", nullptr, nullptr );
+    if( !window ) {
+        fprintf( stderr, "[ERROR]: Could not open window\n" );
+        glfwTerminate();
+        exit( EXIT_FAILURE );
+    }
+    glfwMakeContextCurrent( window );
+
+    glewExperimental = GL_TRUE;
+    if( glewInit() != GLEW_OK ) {
+        fprintf( stderr, "[ERROR]: Could not initialize GLEW\n" );
+        exit( EXIT_FAILURE );
+    }
+
+    md5_model_t model = {};
+    md5_anim_t text = {};
+    if( !ReadMD5Model( MD5_MESH, &model ) || !ReadMD5Anim( MD5_ANIM, &text ) || !CheckAnimValidity( &model, &text ) ) {
+        fprintf( stderr, "[ERROR]: Could not load %s with %s\n", MD5_MESH, MD5_ANIM );
+        exit( EXIT_FAILURE );
+    }
+
+    // the same fractional frames for every clip
+    std::vector<float> times( samples );
+    srand( 441 );
+    for( int s = 0; s < samples; ++s ) {
+        times[s] = (float)rand() / RAND_MAX * (text.num_frames - 1);
+    }
+    std::vector<md5_joint_t> pose( text.num_joints ), expected( text.num_joints );
+
+    // built frames, interpolated as Animate() and InterpolateSkeletons() do today
+    Clock::time_point start = Clock::now();
+    for( int s = 0; s < samples; ++s ) {
+        int frame = (int)times[s];
+        InterpolateSkeletons( text.skelFrames[frame], text.skelFrames[(frame + 1) % text.num_frames],
+                              text.num_joints, times[s] - frame, &pose[0] );
+    }
+    double textSeconds = std::chrono::duration<double>( Clock::now() - start ).count();
+    printf( "[INFO]: %-22s %8lu bytes                    %6.2f us/sample\n", "text frames", GetAnimBytes( &text ),
+            textSeconds / samples * 1e6 );
+
+    // every frame clip, two frames decoded per sample once the cache misses
+    bool passed = true;
+    unsigned long everyFrameBytes = 0;
+    if( CompileMD5Anim( MD5_ANIM, MD5_CLIP ) ) {
+        md5_anim_t clip = {};
+        md5_frame_cache_t cache;
+        InitFrameCache( &cache );
+        ReadMD5Clip( MD5_CLIP, &clip );
+
+        start = Clock::now();
+        for( int s = 0; s < samples; ++s ) {
+            int frame = (int)times[s];
+            InterpolateSkeletons( GetAnimFrame( &clip, &cache, frame ), GetAnimFrame( &clip, &cache, (frame + 1) % clip.num_frames ),
+                                  clip.num_joints, times[s] - frame, &pose[0] );
+        }
+        double seconds = std::chrono::duration<double>( Clock::now() - start ).count();
+        everyFrameBytes = GetAnimBytes( &clip );
+        printf( "[INFO]: %-22s %8lu bytes                    %6.2f us/sample\n", "every frame clip", everyFrameBytes,
+                seconds / samples * 1e6 );
+
+        FreeFrameCache( &cache );
+        FreeAnim( &clip );
+    } else {
+        passed = false;
+    }
+
+    for( size_t e = 0; e < sizeof( VERTEX_ERRORS ) / sizeof( VERTEX_ERRORS[0] ); ++e ) {
+        md5_anim_t clip = {};
+        if( !CompressMD5Anim( &model, MD5_ANIM, MD5_CLIP, VERTEX_ERRORS[e], MAX_ROTATION_ERROR ) || !ReadMD5Clip( MD5_CLIP, &clip ) ) {
+            passed = false;
+            continue;
+        }
+
+        // the key frames against the text, the compressor only checks those
+        float maxError = 0.0f;
+        for( int f = 0; f < text.num_frames; ++f ) {
+            SampleClip( clip.clip, (float)f, &pose[0] );
+            float error = skinnedError( model, text.skelFrames[f], &pose[0] );
+            if( !(error <= maxError) ) maxError = error;
+        }
+        // keys are only worth keeping when they take less room than every frame
+        bool clipPassed = maxError <= VERTEX_ERRORS[e] && GetAnimBytes( &clip ) <= everyFrameBytes;
+        passed = passed && clipPassed;
+
+        start = Clock::now();
+        for( int s = 0; s < samples; ++s ) {
+            SampleClip( clip.clip, times[s], &pose[0] );
+        }
+        double seconds = std::chrono::duration<double>( Clock::now() - start ).count();
+
+        char name[32];
+        snprintf( name, sizeof( name ), "keys within %g", VERTEX_ERRORS[e] );
+        printf( "[INFO]: %-22s %8lu bytes  %5.1fx  %s %.2e  %6.2f us/sample\n", name, GetAnimBytes( &clip ),
+                (double)GetAnimBytes( &text ) / GetAnimBytes( &clip ), clipPassed ? "PASS" : "FAIL", maxError,
+                seconds / samples * 1e6 );
+
+        FreeAnim( &clip );
+    }
+
+    FreeAnim( &text );
+    FreeModel( &model );
+    glfwDestroyWindow( window );
+    glfwTerminate();
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,295 @@
+/*
+ *  CSCI 441, Computer Graphics, Fall 2020
+ *
+ *  Project: lab03
+ *  File: md5crowdBench.cpp
+ *
+ *  Description:
+ *      Animates and skins crowds of up to 1,000 hellknights with 1 to N
+ *      threads and reports the CPU time per frame.  The skinned vertices of
+ *      every thread count are compared with the single threaded result.
+ *      The largest crowd is then run again seen from one corner with the
+ *      animation LOD on, holding poses between skinnings and then blending
+ *      them, and its reduced joint set is checked against the full one in
+ *      the bind pose.  The largest distance a drawn vertex moves in one
+ *      update is reported for each, blending must bring it down.
+ *
+ *  Usage: md5crowdBench [maxInstances] [frames]
+ *
+ */
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <MD5/md5model.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+const char *MD5_MESH = "models/monsters/hellknight/mesh/hellknight.md5mesh";
+const char *MD5_ANIM = "models/monsters/hellknight/animations/idle2.md5anim";
+
+const double FRAME_TIME = 1.0 / 60.0;
+const int WARMUP_FRAMES = 5;
+
+// model units, the hellknight stands about 120 tall
+const md5_crowd_lod_t CROWD_LOD = { { 1000.0f, 1800.0f, 2600.0f }, 1400.0f, 8.0f, 0 };
+
+// most the reduced joint set may move a vertex of the bind pose
+const float BIND_TOLERANCE = 1e-3f;
+
+// updates the largest jump of a drawn vertex is looked for over, two of the slowest rate
+const int JUMP_FRAMES = 2 << (MD5_LOD_RATES - 1);
+
+// largest distance any vertex of an instance drawn in both updates moved between them
+float largestJump( const md5_crowd_t &crowd, const std::vector<float> &before, const std::vector<char> &drawnBefore ) {
+    float largest = 0.0f;
+    for( int m = 0; m < crowd.mdl->num_meshes; ++m ) {
+        int numVerts = crowd.mdl->meshes[m].num_verts;
+        for( int i = 0; i < crowd.num_instances; ++i ) {
+            const md5_instance_t &inst = crowd.instances[i];
+            if( !drawnBefore[i] || inst.culled || !inst.skinned ) continue;
+            for( int v = crowd.meshFirstVertex[m] + i * numVerts; v < crowd.meshFirstVertex[m] + (i + 1) * numVerts; ++v ) {
+                float dx = crowd.vertexArray[v][0] - before[v*3 + 0];
+                float dy = crowd.vertexArray[v][1] - before[v*3 + 1];
+                float dz = crowd.vertexArray[v][2] - before[v*3 + 2];
+                largest = fmaxf( largest, sqrtf( dx * dx + dy * dy + dz * dz ) );
+            }
+        }
+    }
+    return largest;
+}
+
+// clip space from the crowd's model space, Z up, column major
+void viewProjection( const float eye[3], const float target[3], float fovy, float aspect, float zNear, float zFar, float out[16] ) {
+    float f[3] = { target[0] - eye[0], target[1] - eye[1], target[2] - eye[2] };
+    float len = sqrtf( f[0] * f[0] + f[1] * f[1] + f[2] * f[2] );
+    for( int i = 0; i < 3; ++i ) f[i] /= len;
+
+    // side is forward x up, with up along Z
+    float side[3] = { f[1], -f[0], 0.0f };
+    len = sqrtf( side[0] * side[0] + side[1] * side[1] );
+    side[0] /= len; side[1] /= len;
+    float up[3] = { side[1] * f[2] - side[2] * f[1], side[2] * f[0] - side[0] * f[2], side[0] * f[1] - side[1] * f[0] };
+
+    float t = 1.0f / tanf( fovy * 0.5f );
+    float rows[4][4] = {
+        { side[0], side[1], side[2], -( side[0] * eye[0] + side[1] * eye[1] + side[2] * eye[2] ) },
+        { up[0], up[1], up[2], -( up[0] * eye[0] + up[1] * eye[1] + up[2] * eye[2] ) },
+        { -f[0], -f[1], -f[2], f[0] * eye[0] + f[1] * eye[1] + f[2] * eye[2] },
+        { 0.0f, 0.0f, 0.0f, 1.0f }
+    };
+
+    for( int c = 0; c < 4; ++c ) {
+        out[c * 4 + 0] = t / aspect * rows[0][c];
+        out[c * 4 + 1] = t * rows[1][c];
+        out[c * 4 + 2] = -( zFar + zNear ) / ( zFar - zNear ) * rows[2][c] - 2.0f * zFar * zNear / ( zFar - zNear ) * rows[3][c];
+        out[c * 4 + 3] = -rows[2][c];
+    }
+}
+
+int main( int argc, char *argv[] ) {
+    int maxInstances = argc > 1 ? atoi( argv[1] ) : 1000;
+    int frames = argc > 2 ? atoi( argv[2] ) : 60;
+    typedef std::chrono::high_resolution_clock Clock;
+
+    // ReadMD5Model() loads the textures too, so it needs a context
+    if( !glfwInit() ) {
+        fprintf( stderr, "[ERROR]: Could not initialize GLFW\n" );
+        exit( EXIT_FAILURE );
+    }
+    glfwWindowHint( GLFW_VISIBLE, GLFW_FALSE );
+    glfwWindowHint( GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE );
+    glfwWindowHint( GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE );
+    glfwWindowHint( GLFW_CONTEXT_VERSION_MAJOR, 4 );
+    glfwWindowHint( GLFW_CONTEXT_VERSION_MINOR, 1 );
+    GLFWwindow *window = glfwCreateWindow( 64, 64, "MD5 Crowd Benchmark", nullptr, nullptr );
+    if( !window ) {
+        fprintf( stderr, "[ERROR]: Could not open window\n" );
+        glfwTerminate();
+        exit( EXIT_FAILURE );
+    }
+    glfwMakeContextCurrent( window );
+
+    glewExperimental = GL_TRUE;
+    if( glewInit() != GLEW_OK ) {
+        fprintf( stderr, "[ERROR]: Could not initialize GLEW\n" );
+        exit( EXIT_FAILURE );
+    }
+
+    md5_model_t model = {};
+    md5_anim_t anim = {};
+    if( !ReadMD5Model( MD5_MESH, &model ) || !ReadMD5Anim( MD5_ANIM, &anim ) || !CheckAnimValidity( &model, &anim ) ) {
+        fprintf( stderr, "[ERROR]: Could not load %s with %s\n", MD5_MESH, MD5_ANIM );
+        exit( EXIT_FAILURE );
+    }
+
+    // 1, 2, 4, ... up to every hardware thread
+    int hardwareThreads = (int)std::thread::hardware_concurrency();
+    if( hardwareThreads < 1 ) hardwareThreads = 1;
+    std::vector<int> threadCounts;
+    for( int t = 1; t < hardwareThreads; t *= 2 ) threadCounts.push_back( t );
+    threadCounts.push_back( hardwareThreads );
+
+    std::vector<int> instanceCounts;
+    for( int n = 10; n < maxInstances; n *= 10 ) instanceCounts.push_back( n );
+    instanceCounts.push_back( maxInstances );
+
+    printf( "[INFO]: skinning with the %s kernel, %d hardware threads\n", GetSkinKernelName( GetSkinKernel() ), hardwareThreads );
+
+    bool passed = true;
+    for( size_t c = 0; c < instanceCounts.size(); ++c ) {
+        std::vector<float> expected;
+        double singleThreaded = 0.0;
+
+        for( size_t t = 0; t < threadCounts.size(); ++t ) {
+            // a fresh crowd each run so every thread count animates the same frames
+            md5_crowd_t crowd;
+            if( !InitCrowd( &crowd, &model, &anim, instanceCounts[c], 120.0f ) ) {
+                exit( EXIT_FAILURE );
+            }
+            SetCrowdThreads( &crowd, threadCounts[t] );
+
+            for( int f = 0; f < WARMUP_FRAMES; ++f ) {
+                UpdateCrowd( &crowd, FRAME_TIME );
+            }
+
+            Clock::time_point start = Clock::now();
+            for( int f = 0; f < frames; ++f ) {
+                UpdateCrowd( &crowd, FRAME_TIME );
+            }
+            double msPerFrame = std::chrono::duration<double, std::milli>( Clock::now() - start ).count() / frames;
+
+            // instances never share data, so any thread count must give the same vertices
+            const float *vertices = &crowd.vertexArray[0][0];
+            bool matches = true;
+            if( t == 0 ) {
+                expected.assign( vertices, vertices + crowd.num_verts * 3 );
+                singleThreaded = msPerFrame;
+            } else {
+                matches = memcmp( &expected[0], vertices, sizeof( float ) * expected.size() ) == 0;
+                passed = passed && matches;
+            }
+
+            printf( "[INFO]: %5d instances  %2d threads  %8.3f ms/frame  %5.2fx  %7.2f Mverts/s  %s\n",
+                    instanceCounts[c], threadCounts[t], msPerFrame, singleThreaded / msPerFrame,
+                    crowd.num_verts / msPerFrame / 1e3, matches ? "" : "MISMATCH" );
+
+            FreeCrowd( &crowd );
+        }
+    }
+
+    // the largest crowd from above one corner, full rate and then with the LOD
+    md5_crowd_t crowd;
+    if( !InitCrowd( &crowd, &model, &anim, maxInstances, 120.0f ) ) {
+        exit( EXIT_FAILURE );
+    }
+    SetCrowdThreads( &crowd, hardwareThreads );
+
+    float halfWidth = (float)ceil( sqrt( (double)maxInstances ) ) * 60.0f;
+    float eye[3] = { -halfWidth - 300.0f, -halfWidth - 300.0f, 500.0f };
+    float target[3] = { 0.0f, 0.0f, 60.0f };
+    float mvp[16];
+    viewProjection( eye, target, 45.0f * 3.14159265f / 180.0f, 16.0f / 9.0f, 1.0f, 20000.0f, mvp );
+
+    // full rate, then the LOD holding each pose until the next skinning, then blending them
+    double msPerFrame[3] = { 0.0, 0.0, 0.0 };
+    float jump[3] = { 0.0f, 0.0f, 0.0f };
+    md5_crowd_stats_t totals = {}, blendedTotals = {};
+    for( int lod = 0; lod < 3; ++lod ) {
+        if( lod ) {
+            md5_crowd_lod_t settings = CROWD_LOD;
+            settings.blendPoses = lod == 2;
+            SetCrowdLOD( &crowd, &settings );
+            SetCrowdView( &crowd, mvp, eye );
+        }
+
+        for( int f = 0; f < WARMUP_FRAMES; ++f ) {
+            UpdateCrowd( &crowd, FRAME_TIME );
+        }
+
+        md5_crowd_stats_t &passTotals = lod == 2 ? blendedTotals : totals;
+        if( lod ) passTotals = md5_crowd_stats_t();
+
+        Clock::time_point start = Clock::now();
+        for( int f = 0; f < frames; ++f ) {
+            UpdateCrowd( &crowd, FRAME_TIME );
+
+            const md5_crowd_stats_t *stats = GetCrowdStats( &crowd );
+            for( int r = 0; r < MD5_LOD_RATES; ++r ) passTotals.atRate[r] += stats->atRate[r];
+            passTotals.culled += stats->culled;
+            passTotals.updated += stats->updated;
+            passTotals.blended += stats->blended;
+            passTotals.reduced += stats->reduced;
+            passTotals.deferred += stats->deferred;
+            passTotals.weights += stats->weights;
+        }
+        msPerFrame[lod] = std::chrono::duration<double, std::milli>( Clock::now() - start ).count() / frames;
+
+        // untimed, how far the drawn vertices move from one update to the next
+        std::vector<float> before( crowd.num_verts * 3 );
+        std::vector<char> drawnBefore( crowd.num_instances );
+        for( int f = 0; f < JUMP_FRAMES; ++f ) {
+            memcpy( &before[0], &crowd.vertexArray[0][0], sizeof( float ) * before.size() );
+            for( int i = 0; i < crowd.num_instances; ++i )
+                drawnBefore[i] = !crowd.instances[i].culled && crowd.instances[i].skinned;
+            UpdateCrowd( &crowd, FRAME_TIME );
+            jump[lod] = fmaxf( jump[lod], largestJump( crowd, before, drawnBefore ) );
+        }
+    }
+
+    printf( "[INFO]: %5d instances  %2d threads  %8.3f ms/frame at full rate, vertices move at most %.2f units an update\n",
+            maxInstances, hardwareThreads, msPerFrame[0], jump[0] );
+    printf( "[INFO]: %5d instances  %2d threads  %8.3f ms/frame with the LOD, %.2fx faster, vertices move at most %.2f units an update\n",
+            maxInstances, hardwareThreads, msPerFrame[1], msPerFrame[0] / msPerFrame[1], jump[1] );
+    printf( "[INFO]:   per frame %.0f culled, %.0f / %.0f / %.0f / %.0f at full / 1/2 / 1/4 / 1/8 rate\n",
+            (double)totals.culled / frames, (double)totals.atRate[0] / frames, (double)totals.atRate[1] / frames,
+            (double)totals.atRate[2] / frames, (double)totals.atRate[3] / frames );
+    printf( "[INFO]:   per frame %.0f skinned, %.0f with reduced joints, %.0f deferred, %.0f weights\n",
+            (double)totals.updated / frames, (double)totals.reduced / frames, (double)totals.deferred / frames,
+            (double)totals.weights / frames );
+
+    // held poses jump by several updates of motion when skinned, blended ones by about one
+    bool smoother = jump[2] < jump[1];
+    passed = passed && smoother;
+    printf( "[INFO]: %5d instances  %2d threads  %8.3f ms/frame blending poses, %.2fx faster, vertices move at most %.2f units an update  %s\n",
+            maxInstances, hardwareThreads, msPerFrame[2], msPerFrame[0] / msPerFrame[2], jump[2], smoother ? "PASS" : "FAIL" );
+    printf( "[INFO]:   per frame %.0f skinned, %.0f blended between their last two poses\n",
+            (double)blendedTotals.updated / frames, (double)blendedTotals.blended / frames );
+
+    // the reduced weights must give the same bind pose
+    std::vector<md5_joint_mat_t> bindMats( model.num_joints );
+    BuildJointMatrices( model.baseSkel, model.num_joints, &bindMats[0] );
+    float maxBindError = 0.0f;
+    for( int m = 0; m < model.num_meshes; ++m ) {
+        std::vector<vec3_t> full( model.meshes[m].num_verts ), reduced( model.meshes[m].num_verts );
+        SkinMesh( &model.meshes[m].skin, &bindMats[0], &full[0] );
+        SkinMesh( &crowd.reducedSkins[m], &bindMats[0], &reduced[0] );
+        for( int v = 0; v < model.meshes[m].num_verts; ++v ) {
+            for( int k = 0; k < 3; ++k ) {
+                float error = fabsf( full[v][k] - reduced[v][k] );
+                if( !(error <= maxBindError) ) maxBindError = error;      // also catches NaN
+            }
+        }
+    }
+    bool bindMatches = maxBindError <= BIND_TOLERANCE;
+    passed = passed && bindMatches;
+    printf( "[INFO]:   reduced joints off the bind pose by at most %.2e  %s\n", maxBindError, bindMatches ? "PASS" : "FAIL" );
+
+    FreeCrowd( &crowd );
+
+    FreeAnim( &anim );
+    FreeModel( &model );
+    glfwDestroyWindow( window );
+    glfwTerminate();
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,281 @@
+/*
+ *  CSCI 441, Computer Graphics, Fall 2020
+ *
+ *  Project: lab03
+ *  File: md5headlessBench.cpp
+ *
+ *  Description:
+ *      Runs the hellknight's animation for a number of simulated seconds
+ *      at several instance counts with no window or GL context, timing
+ *      Animate(), InterpolateSkeletons() and PrepareMesh() separately
+ *      along with the matrix skinning kernel.  Every skinned vertex is
+ *      hashed, and the hashes plus the last pose of the first instance
+ *      are written to a golden file on the first run.  Later runs are
+ *      checked against it, bit for bit or within a tolerance.
+ *
+ *  Usage: md5headlessBench [seconds] [golden file] [tolerance]
+ *         a tolerance of 0 asks for bit-exact output
+ *
+ */
+
+#include <MD5/md5model.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+const char *MD5_MESH = "models/monsters/hellknight/mesh/hellknight.md5mesh";
+const char *MD5_ANIM = "models/monsters/hellknight/animations/idle2.md5anim";
+
+const char *GOLDEN_FILE = "md5headless.golden";
+const int GOLDEN_VERSION = 1;
+
+const double FRAME_TIME = 1.0 / 60.0;
+const int INSTANCE_COUNTS[] = { 1, 10, 100 };
+const int NUM_RUNS = sizeof( INSTANCE_COUNTS ) / sizeof( INSTANCE_COUNTS[0] );
+
+// largest difference allowed from the golden pose or between the two skinning paths, in model units
+const float DEFAULT_TOLERANCE = 1e-3f;
+
+typedef std::chrono::high_resolution_clock Clock;
+
+// FNV-1a over the bits of every skinned coordinate, in the order they were written
+struct Checksum {
+    unsigned long long hash = 0xcbf29ce484222325ULL;
+
+    void add( const vec3_t *vertices, int count ) {
+        const unsigned char *bytes = (const unsigned char *)vertices;
+        for( size_t i = 0; i < sizeof( vec3_t ) * count; ++i ) {
+            hash = ( hash ^ bytes[i] ) * 0x100000001b3ULL;
+        }
+    }
+};
+
+struct RunResult {
+    int instances;
+    int frames;
+    double animateSeconds, interpolateSeconds, prepareSeconds, skinnedSeconds;
+    unsigned long long prepareHash, skinnedHash;
+    float maxSkinnedError;
+};
+
+struct Golden {
+    double seconds;
+    int instances[NUM_RUNS];
+    unsigned long long hashes[NUM_RUNS];
+    std::vector<float> pose;
+};
+
+double since( Clock::time_point start ) {
+    return std::chrono::duration<double>( Clock::now() - start ).count();
+}
+
+float maxDifference( const float *a, const float *b, size_t count ) {
+    float maxError = 0.0f;
+    for( size_t i = 0; i < count; ++i ) {
+        float error = fabsf( a[i] - b[i] );
+        if( !(error <= maxError) ) maxError = error;      // also catches NaN
+    }
+    return maxError;
+}
+
+// every instance through the same frames, the pose of instance 0 on the last one is kept
+RunResult simulate( const md5_model_t &model, const md5_anim_t &anim, int numInstances, int frames, std::vector<float> &lastPose ) {
+    RunResult result = {};
+    result.instances = numInstances;
+    result.frames = frames;
+
+    // spread over the clip as InitCrowd() does so the instances are not in step
+    std::vector<anim_info_t> infos( numInstances );
+    for( int i = 0; i < numInstances; ++i ) {
+        infos[i].curr_frame = ( i * 7 ) % anim.num_frames;
+        infos[i].next_frame = ( infos[i].curr_frame + 1 ) % anim.num_frames;
+        infos[i].last_time = 0.0;
+        infos[i].max_time = 1.0 / anim.frameRate;
+    }
+
+    std::vector<md5_joint_t> skeletons( (size_t)numInstances * model.num_joints );
+    std::vector<md5_joint_mat_t> jointMats( model.num_joints );
+    std::vector<float> reference;
+    Checksum prepareSum, skinnedSum;
+
+    for( int f = 0; f < frames; ++f ) {
+        Clock::time_point start = Clock::now();
+        for( int i = 0; i < numInstances; ++i ) {
+            Animate( &anim, &infos[i], FRAME_TIME );
+        }
+        result.animateSeconds += since( start );
+
+        start = Clock::now();
+        for( int i = 0; i < numInstances; ++i ) {
+            InterpolateSkeletons( anim.skelFrames[infos[i].curr_frame], anim.skelFrames[infos[i].next_frame], anim.num_joints,
+                                  (float)( infos[i].last_time * anim.frameRate ), &skeletons[(size_t)i * model.num_joints] );
+        }
+        result.interpolateSeconds += since( start );
+
+        // PrepareMesh() and PrepareSkinnedMesh() share one vertex array, so each is hashed and compared as it comes out
+        for( int i = 0; i < numInstances; ++i ) {
+            const md5_joint_t *skeleton = &skeletons[(size_t)i * model.num_joints];
+            bool keep = i == 0 && f == frames - 1;
+
+            for( int m = 0; m < model.num_meshes; ++m ) {
+                const md5_mesh_t *mesh = &model.meshes[m];
+                const float *vertices = GetMeshVertices()[0];
+
+                start = Clock::now();
+                PrepareMesh( mesh, skeleton );
+                result.prepareSeconds += since( start );
+
+                prepareSum.add( GetMeshVertices(), mesh->num_verts );
+                reference.assign( vertices, vertices + mesh->num_verts * 3 );
+                if( keep ) lastPose.insert( lastPose.end(), reference.begin(), reference.end() );
+
+                start = Clock::now();
+                BuildJointMatrices( skeleton, model.num_joints, &jointMats[0] );
+                PrepareSkinnedMesh( mesh, &jointMats[0] );
+                result.skinnedSeconds += since( start );
+
+                skinnedSum.add( GetMeshVertices(), mesh->num_verts );
+                result.maxSkinnedError = fmaxf( result.maxSkinnedError, maxDifference( vertices, &reference[0], reference.size() ) );
+            }
+        }
+    }
+
+    result.prepareHash = prepareSum.hash;
+    result.skinnedHash = skinnedSum.hash;
+    return result;
+}
+
+bool readGolden( const char *filename, Golden &golden ) {
+    FILE *fp = fopen( filename, "r" );
+    if( !fp ) return false;
+
+    int version = 0, numVerts = 0;
+    bool ok = fscanf( fp, " md5headlessBench %d", &version ) == 1 && version == GOLDEN_VERSION
+           && fscanf( fp, " seconds %lf", &golden.seconds ) == 1;
+    for( int r = 0; ok && r < NUM_RUNS; ++r ) {
+        ok = fscanf( fp, " instances %d checksum %llx", &golden.instances[r], &golden.hashes[r] ) == 2;
+    }
+    ok = ok && fscanf( fp, " pose %d", &numVerts ) == 1 && numVerts > 0;
+    if( ok ) {
+        golden.pose.resize( numVerts * 3 );
+        for( int i = 0; ok && i < numVerts * 3; ++i ) {
+            ok = fscanf( fp, "%f", &golden.pose[i] ) == 1;
+        }
+    }
+    fclose( fp );
+
+    if( !ok ) fprintf( stderr, "[ERROR]: %s is not a golden file of this benchmark\n", filename );
+    return ok;
+}
+
+bool writeGolden( const char *filename, double seconds, const RunResult *results, const std::vector<float> &pose ) {
+    FILE *fp = fopen( filename, "w" );
+    if( !fp ) {
+        fprintf( stderr, "[ERROR]: Could not write %s\n", filename );
+        return false;
+    }
+
+    fprintf( fp, "md5headlessBench %d\n", GOLDEN_VERSION );
+    fprintf( fp, "seconds %.17g\n", seconds );
+    for( int r = 0; r < NUM_RUNS; ++r ) {
+        fprintf( fp, "instances %d checksum %016llx\n", results[r].instances, results[r].prepareHash );
+    }
+
+    // enough digits to read back the same floats
+    fprintf( fp, "pose %d\n", (int)pose.size() / 3 );
+    for( size_t i = 0; i < pose.size(); i += 3 ) {
+        fprintf( fp, "%.9g %.9g %.9g\n", pose[i], pose[i + 1], pose[i + 2] );
+    }
+    fclose( fp );
+    return true;
+}
+
+int main( int argc, char *argv[] ) {
+    double seconds = argc > 1 ? atof( argv[1] ) : 5.0;
+    const char *goldenFile = argc > 2 ? argv[2] : GOLDEN_FILE;
+    float tolerance = argc > 3 ? (float)atof( argv[3] ) : DEFAULT_TOLERANCE;
+    int frames = (int)( seconds / FRAME_TIME + 0.5 );
+    if( frames < 1 ) frames = 1;
+
+    // no window, so no textures: the parser alone reads the mesh
+    md5_model_t model = {};
+    md5_anim_t anim = {};
+    if( !ParseMD5Model( MD5_MESH, &model ) || !ReadMD5Anim( MD5_ANIM, &anim ) || !CheckAnimValidity( &model, &anim ) ) {
+        fprintf( stderr, "[ERROR]: Could not load %s with %s\n", MD5_MESH, MD5_ANIM );
+        exit( EXIT_FAILURE );
+    }
+    AllocMeshArrays( &model );
+    SetMeshNormals( MD5_NORMALS_NONE );
+
+    int vertsPerPose = 0;
+    for( int m = 0; m < model.num_meshes; ++m ) {
+        vertsPerPose += model.meshes[m].num_verts;
+    }
+
+    printf( "[INFO]: %.2f simulated seconds, %d frames, skinning with the %s kernel\n", seconds, frames, GetSkinKernelName( GetSkinKernel() ) );
+    printf( "[INFO]:                   ms/frame   Animate  Interpolate  PrepareMesh   %s matrices\n", GetSkinKernelName( GetSkinKernel() ) );
+
+    RunResult results[NUM_RUNS];
+    std::vector<float> lastPose;
+    bool passed = true;
+    for( int r = 0; r < NUM_RUNS; ++r ) {
+        std::vector<float> pose;
+        results[r] = simulate( model, anim, INSTANCE_COUNTS[r], frames, pose );
+        if( r == 0 ) lastPose = pose;
+
+        const RunResult &result = results[r];
+        bool skinnedMatches = result.maxSkinnedError <= ( tolerance > 0.0f ? tolerance : DEFAULT_TOLERANCE );
+        passed = passed && skinnedMatches;
+
+        printf( "[INFO]: %5d instances          %9.3f  %11.3f  %11.3f  %11.3f   %.1fx faster, %.1f Mverts/s\n", result.instances,
+                result.animateSeconds / frames * 1e3, result.interpolateSeconds / frames * 1e3,
+                result.prepareSeconds / frames * 1e3, result.skinnedSeconds / frames * 1e3,
+                result.prepareSeconds / result.skinnedSeconds, (double)vertsPerPose * result.instances * frames / result.skinnedSeconds / 1e6 );
+        printf( "[INFO]:         checksum %016llx PrepareMesh, %016llx %s, off by at most %.2e  %s\n",
+                result.prepareHash, result.skinnedHash, GetSkinKernelName( GetSkinKernel() ),
+                result.maxSkinnedError, skinnedMatches ? "PASS" : "FAIL" );
+    }
+
+    // the first run writes the golden file, later ones are held to it
+    Golden golden;
+    FILE *existing = fopen( goldenFile, "r" );
+    if( !existing ) {
+        if( writeGolden( goldenFile, seconds, results, lastPose ) ) {
+            printf( "[INFO]: wrote %s, later runs will be checked against it\n", goldenFile );
+        } else {
+            passed = false;
+        }
+    } else {
+        fclose( existing );
+
+        if( !readGolden( goldenFile, golden ) ) {
+            passed = false;
+        } else if( golden.seconds != seconds || golden.pose.size() != lastPose.size() ) {
+            fprintf( stderr, "[ERROR]: %s was written for %g seconds, run with the same to compare\n", goldenFile, golden.seconds );
+            passed = false;
+        } else {
+            bool exact = true;
+            for( int r = 0; r < NUM_RUNS; ++r ) {
+                exact = exact && golden.instances[r] == results[r].instances && golden.hashes[r] == results[r].prepareHash;
+            }
+            float poseError = maxDifference( &golden.pose[0], &lastPose[0], lastPose.size() );
+            bool goldenMatches = tolerance > 0.0f ? poseError <= tolerance : exact;
+            passed = passed && goldenMatches;
+
+            printf( "[INFO]: against %s: checksums %s, last pose off by at most %.2e  %s\n", goldenFile,
+                    exact ? "identical" : "differ", poseError, goldenMatches ? "PASS" : "FAIL" );
+        }
+    }
+
+    printf( "[INFO]: %s\n", passed ? "PASS" : "FAIL" );
+
+    FreeMeshArrays();
+    FreeAnim( &anim );
+    FreeModel( &model );
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
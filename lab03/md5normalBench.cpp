@@ -0,0 +1,299 @@
+/*
+ *  CSCI 441, Computer Graphics, Fall 2020
+ *
+ *  Project: lab03
+ *  File: md5normalBench.cpp
+ *
+ *  Description:
+ *      Skins the hellknight's normals and tangents with every supported
+ *      kernel and rebuilds them from the skinned triangles, checks both
+ *      against a naive full recompute, and times all three.  A crowd is
+ *      then updated on every hardware thread with each kind of normals.
+ *
+ *  Usage: md5normalBench [iterations] [instances]
+ *
+ */
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <MD5/md5model.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+const char *MD5_MESH = "models/monsters/hellknight/mesh/hellknight.md5mesh";
+const char *MD5_ANIM = "models/monsters/hellknight/animations/idle2.md5anim";
+
+// largest difference allowed between unit vectors that should be the same, tangents
+// are looser as triangles with little texture across them give long ones to sum
+const float NORMAL_TOLERANCE = 1e-4f;
+const float TANGENT_TOLERANCE = 1e-3f;
+
+const double FRAME_TIME = 1.0 / 60.0;
+
+typedef std::chrono::high_resolution_clock Clock;
+
+void normalize( float *v ) {
+    float len = sqrtf( v[0] * v[0] + v[1] * v[1] + v[2] * v[2] );
+    float s = len > 0.0f ? 1.0f / len : 0.0f;
+    v[0] *= s; v[1] *= s; v[2] *= s;
+}
+
+// every triangle's normal and tangent added to its three corners, then normalized
+void recomputeNaive( const md5_mesh_t *mesh, const vec3_t *positions, vec3_t *normals, vec3_t *tangents ) {
+    for( int i = 0; i < mesh->num_verts; ++i ) {
+        for( int k = 0; k < 3; ++k ) normals[i][k] = tangents[i][k] = 0.0f;
+    }
+
+    for( int t = 0; t < mesh->num_tris; ++t ) {
+        const int *index = mesh->triangles[t].index;
+        const float *p0 = positions[index[0]], *p1 = positions[index[1]], *p2 = positions[index[2]];
+        const float *st0 = mesh->vertices[index[0]].st, *st1 = mesh->vertices[index[1]].st, *st2 = mesh->vertices[index[2]].st;
+
+        float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+        float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+        float ds1 = st1[0] - st0[0], dt1 = st1[1] - st0[1];
+        float ds2 = st2[0] - st0[0], dt2 = st2[1] - st0[1];
+        float det = ds1 * dt2 - ds2 * dt1;
+
+        // clockwise, as Doom 3 winds them
+        float n[3] = { e2[1] * e1[2] - e2[2] * e1[1], e2[2] * e1[0] - e2[0] * e1[2], e2[0] * e1[1] - e2[1] * e1[0] };
+
+        for( int c = 0; c < 3; ++c ) {
+            for( int k = 0; k < 3; ++k ) {
+                normals[index[c]][k] += n[k];
+                tangents[index[c]][k] += det != 0.0f ? ( dt2 * e1[k] - dt1 * e2[k] ) / det : 0.0f;
+            }
+        }
+    }
+
+    for( int i = 0; i < mesh->num_verts; ++i ) {
+        float *n = normals[i], *t = tangents[i];
+        normalize( n );
+        float d = n[0] * t[0] + n[1] * t[1] + n[2] * t[2];
+        for( int k = 0; k < 3; ++k ) t[k] -= n[k] * d;
+        normalize( t );
+    }
+}
+
+float maxDifference( const vec3_t *a, const vec3_t *b, int count ) {
+    float maxError = 0.0f;
+    for( int i = 0; i < count; ++i ) {
+        for( int k = 0; k < 3; ++k ) {
+            float error = fabsf( a[i][k] - b[i][k] );
+            if( !(error <= maxError) ) maxError = error;      // also catches NaN
+        }
+    }
+    return maxError;
+}
+
+int main( int argc, char *argv[] ) {
+    int iterations = argc > 1 ? atoi( argv[1] ) : 200;
+    int instances = argc > 2 ? atoi( argv[2] ) : 100;
+    if( iterations < 1 ) iterations = 1;
+    if( instances < 1 ) instances = 1;
+
+    // ReadMD5Model() loads the textures too, so it needs a context
+    if( !glfwInit() ) {
+        fprintf( stderr, "[ERROR]: Could not initialize GLFW\n" );
+        exit( EXIT_FAILURE );
+    }
+    glfwWindowHint( GLFW_VISIBLE, GLFW_FALSE );
+    glfwWindowHint( GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE );
+    glfwWindowHint( GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE );
+    glfwWindowHint( GLFW_CONTEXT_VERSION_MAJOR, 4 );
+    glfwWindowHint( GLFW_CONTEXT_VERSION_MINOR, 1 );
+    GLFWwindow *window = glfwCreateWindow( 64, 64, "MD5 Normal Benchmark", nullptr, nullptr );
+    if( !window ) {
+        fprintf( stderr, "[ERROR]: Could not open window\n" );
+        glfwTerminate();
+        exit( EXIT_FAILURE );
+    }
+    glfwMakeContextCurrent( window );
+
+    glewExperimental = GL_TRUE;
+    if( glewInit() != GLEW_OK ) {
+        fprintf( stderr, "[ERROR]: Could not initialize GLEW\n" );
+        exit( EXIT_FAILURE );
+    }
+
+    md5_model_t model = {};
+    md5_anim_t anim = {};
+    if( !ReadMD5Model( MD5_MESH, &model ) || !ReadMD5Anim( MD5_ANIM, &anim ) || !CheckAnimValidity( &model, &anim ) ) {
+        fprintf( stderr, "[ERROR]: Could not load %s with %s\n", MD5_MESH, MD5_ANIM );
+        exit( EXIT_FAILURE );
+    }
+
+    // the bind pose first, then every key frame
+    std::vector< std::vector<md5_joint_t> > poses;
+    poses.push_back( std::vector<md5_joint_t>( model.baseSkel, model.baseSkel + model.num_joints ) );
+    for( int f = 0; f < anim.num_frames; ++f ) {
+        poses.push_back( std::vector<md5_joint_t>( anim.skelFrames[f], anim.skelFrames[f] + anim.num_joints ) );
+    }
+
+    int maxVerts = 0;
+    for( int m = 0; m < model.num_meshes; ++m ) {
+        if( model.meshes[m].num_verts > maxVerts ) maxVerts = model.meshes[m].num_verts;
+    }
+    std::vector<md5_joint_mat_t> jointMats( model.num_joints );
+    std::vector<float> buffers[6];
+    for( int b = 0; b < 6; ++b ) buffers[b].resize( maxVerts * 3 );
+    vec3_t *positions = (vec3_t *)&buffers[0][0], *normals = (vec3_t *)&buffers[1][0], *tangents = (vec3_t *)&buffers[2][0];
+    vec3_t *expectedPositions = (vec3_t *)&buffers[3][0], *expectedNormals = (vec3_t *)&buffers[4][0], *expectedTangents = (vec3_t *)&buffers[5][0];
+
+    // the recompute with its tangent terms worked out at load against the naive one, in every pose
+    float recomputeError = 0.0f, recomputeTangentError = 0.0f;
+    for( size_t p = 0; p < poses.size(); ++p ) {
+        BuildJointMatrices( &poses[p][0], model.num_joints, &jointMats[0] );
+        for( int m = 0; m < model.num_meshes; ++m ) {
+            SkinMesh( &model.meshes[m].skin, &jointMats[0], expectedPositions );
+            recomputeNaive( &model.meshes[m], expectedPositions, expectedNormals, expectedTangents );
+            RecomputeNormals( &model.meshes[m], expectedPositions, normals, tangents );
+            recomputeError = fmaxf( recomputeError, maxDifference( normals, expectedNormals, model.meshes[m].num_verts ) );
+            recomputeTangentError = fmaxf( recomputeTangentError, maxDifference( tangents, expectedTangents, model.meshes[m].num_verts ) );
+        }
+    }
+    bool passed = recomputeError <= NORMAL_TOLERANCE && recomputeTangentError <= TANGENT_TOLERANCE;
+    printf( "[INFO]: recomputed   max error against the naive recompute: %.2e normals, %.2e tangents  %s\n",
+            recomputeError, recomputeTangentError, passed ? "PASS" : "FAIL" );
+
+    // the naive recompute every frame
+    Clock::time_point start = Clock::now();
+    for( int it = 0; it < iterations; ++it ) {
+        BuildJointMatrices( &poses[it % poses.size()][0], model.num_joints, &jointMats[0] );
+        for( int m = 0; m < model.num_meshes; ++m ) {
+            SkinMesh( &model.meshes[m].skin, &jointMats[0], positions );
+            recomputeNaive( &model.meshes[m], positions, normals, tangents );
+        }
+    }
+    double naiveSeconds = std::chrono::duration<double>( Clock::now() - start ).count();
+    printf( "[INFO]: %-10s   %8.2f us/pose\n", "naive", naiveSeconds / iterations * 1e6 );
+
+    start = Clock::now();
+    for( int it = 0; it < iterations; ++it ) {
+        BuildJointMatrices( &poses[it % poses.size()][0], model.num_joints, &jointMats[0] );
+        for( int m = 0; m < model.num_meshes; ++m ) {
+            SkinMesh( &model.meshes[m].skin, &jointMats[0], positions );
+            RecomputeNormals( &model.meshes[m], positions, normals, tangents );
+        }
+    }
+    double recomputeSeconds = std::chrono::duration<double>( Clock::now() - start ).count();
+    printf( "[INFO]: %-10s   %8.2f us/pose  %.1fx faster\n", "recomputed",
+            recomputeSeconds / iterations * 1e6, naiveSeconds / recomputeSeconds );
+
+    for( int kernel = 0; kernel < MD5_SKIN_NUM_KERNELS; ++kernel ) {
+        if( !SkinKernelSupported( kernel ) ) {
+            printf( "[INFO]: %-10s   not supported on this machine\n", GetSkinKernelName( kernel ) );
+            continue;
+        }
+        SetSkinKernel( kernel );
+
+        // the bind pose must come back exactly, later poses only drift from the recompute as joints bend
+        float bindError = 0.0f, bindTangentError = 0.0f, positionError = 0.0f;
+        double angleSum = 0.0;
+        long angleCount = 0;
+        for( size_t p = 0; p < poses.size(); ++p ) {
+            BuildJointMatrices( &poses[p][0], model.num_joints, &jointMats[0] );
+            for( int m = 0; m < model.num_meshes; ++m ) {
+                const md5_mesh_t *mesh = &model.meshes[m];
+                SkinMesh( &mesh->skin, &jointMats[0], expectedPositions );
+                recomputeNaive( mesh, expectedPositions, expectedNormals, expectedTangents );
+                SkinMeshNormals( &mesh->skin, &jointMats[0], positions, normals, tangents );
+
+                positionError = fmaxf( positionError, maxDifference( positions, expectedPositions, mesh->num_verts ) );
+                if( p == 0 ) {
+                    bindError = fmaxf( bindError, maxDifference( normals, expectedNormals, mesh->num_verts ) );
+                    bindTangentError = fmaxf( bindTangentError, maxDifference( tangents, expectedTangents, mesh->num_verts ) );
+                }
+                for( int i = 0; i < mesh->num_verts; ++i ) {
+                    float d = normals[i][0] * expectedNormals[i][0] + normals[i][1] * expectedNormals[i][1] + normals[i][2] * expectedNormals[i][2];
+                    angleSum += acos( fmin( fmax( d, -1.0 ), 1.0 ) );
+                    angleCount++;
+                }
+            }
+        }
+        bool kernelPassed = bindError <= NORMAL_TOLERANCE && bindTangentError <= TANGENT_TOLERANCE && positionError <= 1e-3f;
+        passed = passed && kernelPassed;
+
+        start = Clock::now();
+        for( int it = 0; it < iterations; ++it ) {
+            BuildJointMatrices( &poses[it % poses.size()][0], model.num_joints, &jointMats[0] );
+            for( int m = 0; m < model.num_meshes; ++m ) {
+                SkinMeshNormals( &model.meshes[m].skin, &jointMats[0], positions, normals, tangents );
+            }
+        }
+        double skinnedSeconds = std::chrono::duration<double>( Clock::now() - start ).count();
+
+        start = Clock::now();
+        for( int it = 0; it < iterations; ++it ) {
+            BuildJointMatrices( &poses[it % poses.size()][0], model.num_joints, &jointMats[0] );
+            for( int m = 0; m < model.num_meshes; ++m ) {
+                SkinMeshNormals( &model.meshes[m].skin, &jointMats[0], positions, normals, nullptr );
+            }
+        }
+        double normalsOnlySeconds = std::chrono::duration<double>( Clock::now() - start ).count();
+
+        start = Clock::now();
+        for( int it = 0; it < iterations; ++it ) {
+            BuildJointMatrices( &poses[it % poses.size()][0], model.num_joints, &jointMats[0] );
+            for( int m = 0; m < model.num_meshes; ++m ) {
+                SkinMesh( &model.meshes[m].skin, &jointMats[0], positions );
+            }
+        }
+        double positionsSeconds = std::chrono::duration<double>( Clock::now() - start ).count();
+
+        printf( "[INFO]: %-10s   %8.2f us/pose  %.1fx faster  %8.2f without tangents, %8.2f positions only\n",
+                GetSkinKernelName( kernel ), skinnedSeconds / iterations * 1e6, naiveSeconds / skinnedSeconds,
+                normalsOnlySeconds / iterations * 1e6, positionsSeconds / iterations * 1e6 );
+        printf( "[INFO]:                bind pose error: %.2e normals, %.2e tangents  %s\n",
+                bindError, bindTangentError, kernelPassed ? "PASS" : "FAIL" );
+        printf( "[INFO]:                normals %.2f degrees off the recompute on average over %d poses\n",
+                angleSum / angleCount * 180.0 / 3.14159265, (int)poses.size() );
+    }
+
+    // whole crowds on every hardware thread, normals skinned by each worker or rebuilt by it
+    int hardwareThreads = (int)std::thread::hardware_concurrency();
+    if( hardwareThreads < 1 ) hardwareThreads = 1;
+    const char *SOURCE_NAMES[] = { "positions", "skinned", "recomputed" };
+
+    md5_crowd_t crowd;
+    if( !InitCrowd( &crowd, &model, &anim, instances, 120.0f ) ) {
+        exit( EXIT_FAILURE );
+    }
+    SetCrowdThreads( &crowd, hardwareThreads );
+
+    double baseline = 0.0;
+    for( int source = MD5_NORMALS_NONE; source <= MD5_NORMALS_RECOMPUTED; ++source ) {
+        SetCrowdNormals( &crowd, source );
+        UpdateCrowd( &crowd, FRAME_TIME );
+
+        int frames = iterations / 10 > 0 ? iterations / 10 : 1;
+        start = Clock::now();
+        for( int f = 0; f < frames; ++f ) {
+            UpdateCrowd( &crowd, FRAME_TIME );
+        }
+        double ms = std::chrono::duration<double, std::milli>( Clock::now() - start ).count() / frames;
+        if( source == MD5_NORMALS_NONE ) baseline = ms;
+
+        printf( "[INFO]: %5d instances  %2d threads  %-10s  %8.3f ms/frame  %.2fx the positions alone\n",
+                instances, hardwareThreads, SOURCE_NAMES[source], ms, ms / baseline );
+    }
+    FreeCrowd( &crowd );
+
+    printf( "[INFO]: %s\n", passed ? "PASS" : "FAIL" );
+
+    FreeAnim( &anim );
+    FreeModel( &model );
+    glfwDestroyWindow( window );
+    glfwTerminate();
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,160 @@
+/*
+ *  CSCI 441, Computer Graphics, Fall 2020
+ *
+ *  Project: lab03
+ *  File: md5parseBench.cpp
+ *
+ *  Description:
+ *      Parses the hellknight mesh and animation with the mapped tokenizer
+ *      and with the sscanf parsers it replaced, checks both give exactly
+ *      the same data, and compares how long they take.
+ *
+ *  Usage: md5parseBench [loads]
+ *
+ */
+
+#include <MD5/md5model.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+const char *MD5_MESH = "models/monsters/hellknight/mesh/hellknight.md5mesh";
+const char *MD5_ANIM = "models/monsters/hellknight/animations/idle2.md5anim";
+
+typedef std::chrono::high_resolution_clock Clock;
+
+// the same bits, not just close
+bool sameBytes( const void *a, const void *b, size_t bytes ) {
+    return bytes == 0 || ( a && b && memcmp( a, b, bytes ) == 0 );
+}
+
+bool sameJoints( const md5_joint_t *a, const md5_joint_t *b, int numJoints ) {
+    for( int j = 0; j < numJoints; ++j ) {
+        if( strcmp( a[j].name, b[j].name ) != 0 || a[j].parent != b[j].parent
+            || !sameBytes( a[j].pos, b[j].pos, sizeof( vec3_t ) ) || !sameBytes( a[j].orient, b[j].orient, sizeof( quat4_t ) ) ) {
+            fprintf( stderr, "[ERROR]: joint %d differs\n", j );
+            return false;
+        }
+    }
+    return true;
+}
+
+bool sameModel( const md5_model_t &a, const md5_model_t &b ) {
+    if( a.num_joints != b.num_joints || a.num_meshes != b.num_meshes || !sameJoints( a.baseSkel, b.baseSkel, a.num_joints ) ) {
+        return false;
+    }
+
+    for( int i = 0; i < a.num_meshes; ++i ) {
+        const md5_mesh_t &ma = a.meshes[i], &mb = b.meshes[i];
+        bool same = strcmp( ma.shader, mb.shader ) == 0
+                 && ma.num_verts == mb.num_verts && ma.num_tris == mb.num_tris && ma.num_weights == mb.num_weights
+                 && ma.firstVertex == mb.firstVertex && ma.firstIndex == mb.firstIndex
+                 && sameBytes( ma.vertices, mb.vertices, sizeof( md5_vertex_t ) * ma.num_verts )
+                 && sameBytes( ma.triangles, mb.triangles, sizeof( md5_triangle_t ) * ma.num_tris )
+                 && sameBytes( ma.weights, mb.weights, sizeof( md5_weight_t ) * ma.num_weights );
+        if( !same ) {
+            fprintf( stderr, "[ERROR]: mesh %d differs\n", i );
+            return false;
+        }
+    }
+    return true;
+}
+
+bool sameAnimData( const md5_anim_data_t &a, const md5_anim_data_t &b ) {
+    if( a.num_frames != b.num_frames || a.num_joints != b.num_joints
+        || a.frameRate != b.frameRate || a.numAnimatedComponents != b.numAnimatedComponents ) {
+        fprintf( stderr, "[ERROR]: animation counts differ\n" );
+        return false;
+    }
+
+    for( int j = 0; j < a.num_joints; ++j ) {
+        const joint_info_t &ja = a.jointInfos[j], &jb = b.jointInfos[j];
+        if( strcmp( ja.name, jb.name ) != 0 || ja.parent != jb.parent || ja.flags != jb.flags || ja.startIndex != jb.startIndex ) {
+            fprintf( stderr, "[ERROR]: hierarchy joint %d differs\n", j );
+            return false;
+        }
+    }
+
+    bool same = sameBytes( a.baseFrame, b.baseFrame, sizeof( baseframe_joint_t ) * a.num_joints )
+             && sameBytes( a.bboxes, b.bboxes, sizeof( md5_bbox_t ) * a.num_frames )
+             && sameBytes( a.frameData, b.frameData, sizeof( float ) * a.num_frames * a.numAnimatedComponents );
+    if( !same ) {
+        fprintf( stderr, "[ERROR]: base frame, bounds or frame data differ\n" );
+    }
+    return same;
+}
+
+long fileBytes( const char *filename ) {
+    FILE *fp = fopen( filename, "rb" );
+    long bytes = 0;
+    if( fp ) {
+        fseek( fp, 0, SEEK_END );
+        bytes = ftell( fp );
+        fclose( fp );
+    }
+    return bytes;
+}
+
+void report( const char *filename, double scanSeconds, double parseSeconds, int loads, bool same ) {
+    double megabytes = fileBytes( filename ) / ( 1024.0 * 1024.0 );
+    printf( "[INFO]: %s  %s\n", filename, same ? "identical" : "DIFFERENT" );
+    printf( "[INFO]:   sscanf     %8.3f ms/load  %7.1f MB/s\n", scanSeconds / loads * 1e3, megabytes * loads / scanSeconds );
+    printf( "[INFO]:   tokenizer  %8.3f ms/load  %7.1f MB/s  %.1fx faster\n",
+            parseSeconds / loads * 1e3, megabytes * loads / parseSeconds, scanSeconds / parseSeconds );
+}
+
+int main( int argc, char *argv[] ) {
+    int loads = argc > 1 ? atoi( argv[1] ) : 20;
+    if( loads < 1 ) loads = 1;
+
+    // each parser a few times over, keeping the last of each
+    md5_model_t scanned = {}, parsed = {};
+    double scanSeconds = 0.0, parseSeconds = 0.0;
+    for( int l = 0; l < loads; ++l ) {
+        FreeModel( &scanned );
+        FreeModel( &parsed );
+        memset( &scanned, 0, sizeof( scanned ) );
+
+        Clock::time_point start = Clock::now();
+        if( !ScanMD5Model( MD5_MESH, &scanned ) ) exit( EXIT_FAILURE );
+        Clock::time_point middle = Clock::now();
+        if( !ParseMD5Model( MD5_MESH, &parsed ) ) exit( EXIT_FAILURE );
+        Clock::time_point end = Clock::now();
+
+        scanSeconds += std::chrono::duration<double>( middle - start ).count();
+        parseSeconds += std::chrono::duration<double>( end - middle ).count();
+    }
+    bool meshSame = sameModel( scanned, parsed );
+    report( MD5_MESH, scanSeconds, parseSeconds, loads, meshSame );
+
+    FreeModel( &scanned );
+    FreeModel( &parsed );
+
+    md5_anim_data_t scannedAnim = {}, parsedAnim = {};
+    scanSeconds = parseSeconds = 0.0;
+    for( int l = 0; l < loads; ++l ) {
+        FreeAnimData( &scannedAnim );
+        FreeAnimData( &parsedAnim );
+
+        Clock::time_point start = Clock::now();
+        if( !ScanMD5AnimData( MD5_ANIM, &scannedAnim ) ) exit( EXIT_FAILURE );
+        Clock::time_point middle = Clock::now();
+        if( !ReadMD5AnimData( MD5_ANIM, &parsedAnim ) ) exit( EXIT_FAILURE );
+        Clock::time_point end = Clock::now();
+
+        scanSeconds += std::chrono::duration<double>( middle - start ).count();
+        parseSeconds += std::chrono::duration<double>( end - middle ).count();
+    }
+    bool animSame = sameAnimData( scannedAnim, parsedAnim );
+    report( MD5_ANIM, scanSeconds, parseSeconds, loads, animSame );
+
+    FreeAnimData( &scannedAnim );
+    FreeAnimData( &parsedAnim );
+
+    bool passed = meshSame && animSame;
+    printf( "[INFO]: %s\n", passed ? "PASS" : "FAIL" );
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,198 @@
+/*
+ *  CSCI 441, Computer Graphics, Fall 2020
+ *
+ *  Project: lab03
+ *  File: md5poseBench.cpp
+ *
+ *  Description:
+ *      Times InterpolateSkeletons() against plain slerp and checks the
+ *      nlerp fast path stays close to it, checks one long Animate() step
+ *      lands where many short ones do, and times EvaluatePose() blending
+ *      three layers plus an additive one, checking the pose pool stops
+ *      growing once warm.  Then blends two compiled clips through the
+ *      wrap frame, checking no layer's frame cache is reallocated.
+ *
+ *  Usage: md5poseBench [evaluations]
+ *
+ */
+
+#include <MD5/md5model.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+const char *MD5_ANIM = "models/monsters/hellknight/animations/idle2.md5anim";
+const char *MD5_CLIP = "models/monsters/hellknight/animations/idle2.md5clip";
+
+// largest difference allowed between nlerp and slerp, 1 - |cos| between the orientations
+const float ORIENT_TOLERANCE = 1e-6f;
+
+// largest difference allowed between one long step and many short ones, in seconds
+const double TIME_TOLERANCE = 1e-9;
+
+// InterpolateSkeletons() as it was, slerp on every joint
+void slerpSkeletons( const md5_joint_t *skelA, const md5_joint_t *skelB, int numJoints, float interp, md5_joint_t *out ) {
+    for( int i = 0; i < numJoints; ++i ) {
+        out[i].parent = skelA[i].parent;
+        for( int k = 0; k < 3; ++k ) {
+            out[i].pos[k] = skelA[i].pos[k] + interp * ( skelB[i].pos[k] - skelA[i].pos[k] );
+        }
+        Quat_slerp( skelA[i].orient, skelB[i].orient, interp, out[i].orient );
+    }
+}
+
+int main( int argc, char *argv[] ) {
+    int evaluations = argc > 1 ? atoi( argv[1] ) : 10000;
+    typedef std::chrono::high_resolution_clock Clock;
+
+    md5_anim_t anim = {};
+    if( !ReadMD5Anim( MD5_ANIM, &anim ) ) {
+        exit( EXIT_FAILURE );
+    }
+
+    const int numJoints = anim.num_joints;
+    std::vector<md5_joint_t> expected( numJoints ), actual( numJoints );
+
+    // nlerp where the orientations are close against slerp everywhere, between every pair of frames
+    float maxOrientError = 0.0f;
+    double slerpSeconds = 0.0, mixedSeconds = 0.0;
+    int interpolations = 0;
+    for( int f = 0; f < anim.num_frames; ++f ) {
+        const md5_joint_t *a = anim.skelFrames[f];
+        const md5_joint_t *b = anim.skelFrames[(f + 7) % anim.num_frames];
+
+        for( int s = 1; s < 8; ++s, ++interpolations ) {
+            float t = s / 8.0f;
+
+            Clock::time_point start = Clock::now();
+            slerpSkeletons( a, b, numJoints, t, &expected[0] );
+            Clock::time_point middle = Clock::now();
+            InterpolateSkeletons( a, b, numJoints, t, &actual[0] );
+            Clock::time_point end = Clock::now();
+
+            slerpSeconds += std::chrono::duration<double>( middle - start ).count();
+            mixedSeconds += std::chrono::duration<double>( end - middle ).count();
+
+            for( int j = 0; j < numJoints; ++j ) {
+                // Quat_slerp() does not normalize what it lerps between very close orientations
+                Quat_normalize( expected[j].orient );
+                float error = 1.0f - fabsf( Quat_dotProduct( expected[j].orient, actual[j].orient ) );
+                if( !(error <= maxOrientError) ) maxOrientError = error;      // also catches NaN
+            }
+        }
+    }
+
+    // one long step against a frame's worth of short ones, and a step several loops long
+    anim_info_t shortSteps = {}, longStep = {}, manyLoops = {};
+    shortSteps.max_time = longStep.max_time = manyLoops.max_time = 1.0 / anim.frameRate;
+    shortSteps.next_frame = longStep.next_frame = manyLoops.next_frame = 1;
+
+    const double FRAME_TIME = 1.0 / 60.0;
+    const int STEPS = 45;
+    for( int s = 0; s < STEPS; ++s ) {
+        Animate( &anim, &shortSteps, FRAME_TIME );
+    }
+    Animate( &anim, &longStep, STEPS * FRAME_TIME );
+    Animate( &anim, &manyLoops, 3.0 * anim.num_frames / anim.frameRate + STEPS * FRAME_TIME );
+
+    double timeError = fabs( GetAnimTime( &shortSteps ) - GetAnimTime( &longStep ) );
+    double loopError = fabs( GetAnimTime( &manyLoops ) - GetAnimTime( &longStep ) );
+    bool stepsMatch = timeError <= TIME_TOLERANCE && loopError <= TIME_TOLERANCE
+                   && shortSteps.curr_frame == longStep.curr_frame && longStep.curr_frame == manyLoops.curr_frame
+                   && longStep.next_frame == ( longStep.curr_frame + 1 ) % anim.num_frames;
+
+    // three clips out of step blended by weight, and one added on top
+    md5_pose_layer_t layers[4] = {};
+    for( int l = 0; l < 4; ++l ) {
+        layers[l].anim = &anim;
+        layers[l].time = l * 0.37;
+    }
+    layers[0].weight = 0.5f;
+    layers[1].weight = 0.3f;
+    layers[2].weight = 0.2f;
+    layers[3].weight = 0.5f;
+    layers[3].additive = 1;
+    layers[3].referenceTime = 0.0;
+
+    md5_pose_pool_t pool;
+    InitPosePool( &pool, numJoints, 0 );
+    ReservePoseLayers( &pool, 4 );
+
+    EvaluatePose( layers, 4, &pool, &actual[0] );
+    int warmCapacity = pool.capacity;
+
+    Clock::time_point start = Clock::now();
+    for( int e = 0; e < evaluations; ++e ) {
+        for( int l = 0; l < 4; ++l ) {
+            layers[l].time += 1.0 / 60.0;
+        }
+        EvaluatePose( layers, 4, &pool, &actual[0] );
+    }
+    double evaluateSeconds = std::chrono::duration<double>( Clock::now() - start ).count();
+    bool poolSteady = pool.capacity == warmCapacity && pool.num_free == pool.capacity;
+
+    // two clips decoded on demand, blended across the last frame where the
+    // frames on both sides of the wrap come from the frame caches
+    md5_anim_t clips[2] = {};
+    if( !CompileMD5Anim( MD5_ANIM, MD5_CLIP ) || !ReadMD5Clip( MD5_CLIP, &clips[0] ) || !ReadMD5Clip( MD5_CLIP, &clips[1] ) ) {
+        exit( EXIT_FAILURE );
+    }
+    md5_pose_layer_t clipLayers[2] = {};
+    for( int l = 0; l < 2; ++l ) {
+        clipLayers[l].anim = &clips[l];
+        clipLayers[l].weight = 0.5f;
+    }
+
+    md5_pose_pool_t clipPool;
+    InitPosePool( &clipPool, numJoints, 0 );
+    ReservePoseLayers( &clipPool, 2 );
+
+    EvaluatePose( clipLayers, 2, &clipPool, &actual[0] );
+    int warmClipCapacity = clipPool.capacity;
+    const md5_joint_t *warmFrames[2] = { clipPool.layerCaches[0].skelFrames[0], clipPool.layerCaches[1].skelFrames[0] };
+
+    double clipLength = anim.num_frames / anim.frameRate;
+    start = Clock::now();
+    for( int e = 0; e < evaluations; ++e ) {
+        // each evaluation lands within the last frame, where the clips fall back to the frame caches
+        double wrapTime = clipLength - ( 0.5 + 0.4 * ( e % 2 ) ) / anim.frameRate;
+        clipLayers[0].time = wrapTime;
+        clipLayers[1].time = wrapTime + clipLength * ( e % 3 );
+        EvaluatePose( clipLayers, 2, &clipPool, &actual[0] );
+    }
+    double clipSeconds = std::chrono::duration<double>( Clock::now() - start ).count();
+    bool cachesSteady = clipPool.capacity == warmClipCapacity && clipPool.num_free == clipPool.capacity;
+    for( int l = 0; l < 2; ++l ) {
+        cachesSteady = cachesSteady && clipPool.layerCaches[l].anim == &clips[l] && clipPool.layerCaches[l].skelFrames[0] == warmFrames[l];
+    }
+
+    bool finite = true;
+    for( int j = 0; j < numJoints; ++j ) {
+        for( int k = 0; k < 3; ++k ) finite = finite && std::isfinite( actual[j].pos[k] );
+        for( int k = 0; k < 4; ++k ) finite = finite && std::isfinite( actual[j].orient[k] );
+    }
+
+    bool passed = maxOrientError <= ORIENT_TOLERANCE && stepsMatch && poolSteady && cachesSteady && finite;
+
+    printf( "[INFO]: %d frames of %d joints  %s\n", anim.num_frames, numJoints, passed ? "PASS" : "FAIL" );
+    printf( "[INFO]: slerp          %8.2f us/skeleton\n", slerpSeconds / interpolations * 1e6 );
+    printf( "[INFO]: nlerp + slerp  %8.2f us/skeleton  %.1fx faster  max orientation error: %.2e\n",
+            mixedSeconds / interpolations * 1e6, slerpSeconds / mixedSeconds, maxOrientError );
+    printf( "[INFO]: long Animate() step off by %.2e s, %.2e s after 3 loops\n", timeError, loopError );
+    printf( "[INFO]: 3 blended + 1 additive layer  %8.2f us/pose  %d pooled skeletons, %s after warm up\n",
+            evaluateSeconds / evaluations * 1e6, pool.capacity, poolSteady ? "none allocated" : "still allocating" );
+    printf( "[INFO]: 2 clips blended at the wrap      %8.2f us/pose  frame caches %s after warm up\n",
+            clipSeconds / evaluations * 1e6, cachesSteady ? "kept" : "reallocated" );
+
+    FreePosePool( &clipPool );
+    FreeAnim( &clips[0] );
+    FreeAnim( &clips[1] );
+    FreePosePool( &pool );
+    FreeAnim( &anim );
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
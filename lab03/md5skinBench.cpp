@@ -0,0 +1,170 @@
+/*
+ *  CSCI 441, Computer Graphics, Fall 2020
+ *
+ *  Project: lab03
+ *  File: md5skinBench.cpp
+ *
+ *  Description:
+ *      Skins the hellknight with every supported kernel, checks the positions
+ *      against the quaternion path used by PrepareMesh(), and reports how many
+ *      vertices per second each kernel skins.
+ *
+ *  Usage: md5skinBench [iterations]
+ *
+ */
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <MD5/md5model.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+const char *MD5_MESH = "models/monsters/hellknight/mesh/hellknight.md5mesh";
+const char *MD5_ANIM = "models/monsters/hellknight/animations/idle2.md5anim";
+
+// largest difference allowed from the quaternion path, in model units
+const float TOLERANCE = 1e-3f;
+
+// the per weight loop from PrepareMesh()
+void skinReference( const md5_mesh_t *mesh, const md5_joint_t *skeleton, vec3_t *out ) {
+    for( int i = 0; i < mesh->num_verts; ++i ) {
+        vec3_t finalVertex = { 0.0f, 0.0f, 0.0f };
+
+        for( int j = 0; j < mesh->vertices[i].count; ++j ) {
+            const md5_weight_t *weight = &mesh->weights[mesh->vertices[i].start + j];
+            const md5_joint_t  *joint  = &skeleton[weight->joint];
+
+            vec3_t wv;
+            Quat_rotatePoint( joint->orient, weight->pos, wv );
+
+            finalVertex[0] += (joint->pos[0] + wv[0]) * weight->bias;
+            finalVertex[1] += (joint->pos[1] + wv[1]) * weight->bias;
+            finalVertex[2] += (joint->pos[2] + wv[2]) * weight->bias;
+        }
+
+        out[i][0] = finalVertex[0];
+        out[i][1] = finalVertex[1];
+        out[i][2] = finalVertex[2];
+    }
+}
+
+int main( int argc, char *argv[] ) {
+    int iterations = argc > 1 ? atoi( argv[1] ) : 200;
+    typedef std::chrono::high_resolution_clock Clock;
+
+    // ReadMD5Model() loads the textures too, so it needs a context
+    if( !glfwInit() ) {
+        fprintf( stderr, "[ERROR]: Could not initialize GLFW\n" );
+        exit( EXIT_FAILURE );
+    }
+    glfwWindowHint( GLFW_VISIBLE, GLFW_FALSE );
+    glfwWindowHint( GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE );
+    glfwWindowHint( GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE );
+    glfwWindowHint( GLFW_CONTEXT_VERSION_MAJOR, 4 );
+    glfwWindowHint( GLFW_CONTEXT_VERSION_MINOR, 1 );
+    GLFWwindow *window = glfwCreateWindow( 64, 64, "MD5 Skinning Benchmark", nullptr, nullptr );
+    if( !window ) {
+        fprintf( stderr, "[ERROR]: Could not open window\n" );
+        glfwTerminate();
+        exit( EXIT_FAILURE );
+    }
+    glfwMakeContextCurrent( window );
+
+    glewExperimental = GL_TRUE;
+    if( glewInit() != GLEW_OK ) {
+        fprintf( stderr, "[ERROR]: Could not initialize GLEW\n" );
+        exit( EXIT_FAILURE );
+    }
+
+    md5_model_t model = {};
+    md5_anim_t anim = {};
+    if( !ReadMD5Model( MD5_MESH, &model ) || !ReadMD5Anim( MD5_ANIM, &anim ) || !CheckAnimValidity( &model, &anim ) ) {
+        fprintf( stderr, "[ERROR]: Could not load %s with %s\n", MD5_MESH, MD5_ANIM );
+        exit( EXIT_FAILURE );
+    }
+
+    // every key frame plus the halfway pose to the next one
+    std::vector< std::vector<md5_joint_t> > poses;
+    for( int f = 0; f < anim.num_frames; ++f ) {
+        poses.push_back( std::vector<md5_joint_t>( anim.skelFrames[f], anim.skelFrames[f] + anim.num_joints ) );
+
+        std::vector<md5_joint_t> halfway( anim.num_joints );
+        InterpolateSkeletons( anim.skelFrames[f], anim.skelFrames[(f + 1) % anim.num_frames], anim.num_joints, 0.5f, &halfway[0] );
+        poses.push_back( halfway );
+    }
+    poses.push_back( std::vector<md5_joint_t>( model.baseSkel, model.baseSkel + model.num_joints ) );
+
+    int maxVerts = 0, vertsPerPose = 0;
+    for( int m = 0; m < model.num_meshes; ++m ) {
+        if( model.meshes[m].num_verts > maxVerts ) maxVerts = model.meshes[m].num_verts;
+        vertsPerPose += model.meshes[m].num_verts;
+    }
+    std::vector<md5_joint_mat_t> jointMats( model.num_joints );
+    std::vector<float> expected( maxVerts * 3 ), actual( maxVerts * 3 );
+    vec3_t *expectedVerts = (vec3_t *)&expected[0], *actualVerts = (vec3_t *)&actual[0];
+
+    bool passed = true;
+    for( int kernel = 0; kernel < MD5_SKIN_NUM_KERNELS; ++kernel ) {
+        if( !SkinKernelSupported( kernel ) ) {
+            printf( "[INFO]: %-10s not supported on this machine\n", GetSkinKernelName( kernel ) );
+            continue;
+        }
+        SetSkinKernel( kernel );
+
+        // correctness against the quaternion path
+        float maxError = 0.0f;
+        for( size_t p = 0; p < poses.size(); ++p ) {
+            BuildJointMatrices( &poses[p][0], model.num_joints, &jointMats[0] );
+            for( int m = 0; m < model.num_meshes; ++m ) {
+                skinReference( &model.meshes[m], &poses[p][0], expectedVerts );
+                SkinMesh( &model.meshes[m].skin, &jointMats[0], actualVerts );
+                for( int i = 0; i < model.meshes[m].num_verts * 3; ++i ) {
+                    float error = fabsf( expected[i] - actual[i] );
+                    if( !(error <= maxError) ) maxError = error;      // also catches NaN
+                }
+            }
+        }
+        bool kernelPassed = maxError <= TOLERANCE;
+        passed = passed && kernelPassed;
+
+        // throughput, joint matrices built once per pose as a frame would
+        Clock::time_point start = Clock::now();
+        for( int it = 0; it < iterations; ++it ) {
+            const std::vector<md5_joint_t> &pose = poses[it % poses.size()];
+            BuildJointMatrices( &pose[0], model.num_joints, &jointMats[0] );
+            for( int m = 0; m < model.num_meshes; ++m ) {
+                SkinMesh( &model.meshes[m].skin, &jointMats[0], actualVerts );
+            }
+        }
+        double seconds = std::chrono::duration<double>( Clock::now() - start ).count();
+
+        printf( "[INFO]: %-10s %s  max error: %.2e  %8.2f Mverts/s\n", GetSkinKernelName( kernel ),
+                kernelPassed ? "PASS" : "FAIL", maxError, (double)vertsPerPose * iterations / seconds / 1e6 );
+    }
+
+    // the path PrepareMesh() takes today
+    Clock::time_point start = Clock::now();
+    for( int it = 0; it < iterations; ++it ) {
+        const std::vector<md5_joint_t> &pose = poses[it % poses.size()];
+        for( int m = 0; m < model.num_meshes; ++m ) {
+            skinReference( &model.meshes[m], &pose[0], expectedVerts );
+        }
+    }
+    double seconds = std::chrono::duration<double>( Clock::now() - start ).count();
+    printf( "[INFO]: %-10s            %8.2f Mverts/s\n", "quaternion", (double)vertsPerPose * iterations / seconds / 1e6 );
+
+    FreeAnim( &anim );
+    FreeModel( &model );
+    glfwDestroyWindow( window );
+    glfwTerminate();
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -3,7 +3,7 @@
  * last modification: aug. 14, 2007
  *
  * Doom3's md5mesh viewer with animation.  Animation portion.
- * Dependences: md5model.h, md5mesh.c.
+ * Dependences: md5model.h, md5parse.cpp.
  *
  * Copyright (c) 2005-2007 David HENRY
  *
@@ -28,6 +28,8 @@
  *
  */
 
+#include <chrono>
+
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -36,21 +38,65 @@
 
 #include "MD5/md5model.h"
 
-/* Joint info */
-struct joint_info_t
-{
-    char name[64];
-    int parent;
-    unsigned int flags;
-    int startIndex;
-};
-
-/* Base frame joint */
-struct baseframe_joint_t
-{
-    vec3_t pos;
-    quat4_t orient;
-};
+/**
+ * Basic quaternion operations.
+ */
+
+void Quat_computeW (quat4_t q) {
+	float t = 1.0f - (q[X] * q[X]) - (q[Y] * q[Y]) - (q[Z] * q[Z]);
+
+	if (t < 0.0f)
+		q[W] = 0.0f;
+	else
+		q[W] = -sqrt (t);
+}
+
+void Quat_normalize (quat4_t q) {
+	/* compute magnitude of the quaternion */
+	float mag = sqrt ((q[X] * q[X]) + (q[Y] * q[Y])
+			+ (q[Z] * q[Z]) + (q[W] * q[W]));
+
+	/* check for bogus length, to protect against divide by zero */
+	if (mag > 0.0f) {
+		/* normalize it */
+		float oneOverMag = 1.0f / mag;
+
+		q[X] *= oneOverMag;
+		q[Y] *= oneOverMag;
+		q[Z] *= oneOverMag;
+		q[W] *= oneOverMag;
+	}
+}
+
+void Quat_multQuat (const quat4_t qa, const quat4_t qb, quat4_t out) {
+	out[W] = (qa[W] * qb[W]) - (qa[X] * qb[X]) - (qa[Y] * qb[Y]) - (qa[Z] * qb[Z]);
+	out[X] = (qa[X] * qb[W]) + (qa[W] * qb[X]) + (qa[Y] * qb[Z]) - (qa[Z] * qb[Y]);
+	out[Y] = (qa[Y] * qb[W]) + (qa[W] * qb[Y]) + (qa[Z] * qb[X]) - (qa[X] * qb[Z]);
+	out[Z] = (qa[Z] * qb[W]) + (qa[W] * qb[Z]) + (qa[X] * qb[Y]) - (qa[Y] * qb[X]);
+}
+
+void Quat_multVec (const quat4_t q, const vec3_t v, quat4_t out) {
+	out[W] = - (q[X] * v[X]) - (q[Y] * v[Y]) - (q[Z] * v[Z]);
+	out[X] =   (q[W] * v[X]) + (q[Y] * v[Z]) - (q[Z] * v[Y]);
+	out[Y] =   (q[W] * v[Y]) + (q[Z] * v[X]) - (q[X] * v[Z]);
+	out[Z] =   (q[W] * v[Z]) + (q[X] * v[Y]) - (q[Y] * v[X]);
+}
+
+void Quat_rotatePoint (const quat4_t q, const vec3_t in, vec3_t out) {
+	quat4_t tmp, inv, final;
+
+	inv[X] = -q[X]; inv[Y] = -q[Y];
+	inv[Z] = -q[Z]; inv[W] =  q[W];
+
+	Quat_normalize (inv);
+
+	Quat_multVec (q, in, tmp);
+	Quat_multQuat (tmp, inv, final);
+
+	out[X] = final[X];
+	out[Y] = final[Y];
+	out[Z] = final[Z];
+}
 
 /**
  * More quaternion operations for skeletal animation.
@@ -139,6 +185,24 @@ Quat_slerp (const quat4_t qa, const quat4_t qb, float t, quat4_t out)
     out[Z] = (k0 * qa[2]) + (k1 * q1z);
 }
 
+/**
+ * Normalized linear interpolation on the shorter arc.  Within a few
+ * degrees it is as good as slerp, without the trigonometry.
+ */
+void
+Quat_nlerp (const quat4_t qa, const quat4_t qb, float t, quat4_t out)
+{
+    float k0 = 1.0f - t;
+    float k1 = (Quat_dotProduct (qa, qb) < 0.0f) ? -t : t;
+
+    out[X] = (k0 * qa[X]) + (k1 * qb[X]);
+    out[Y] = (k0 * qa[Y]) + (k1 * qb[Y]);
+    out[Z] = (k0 * qa[Z]) + (k1 * qb[Z]);
+    out[W] = (k0 * qa[W]) + (k1 * qb[W]);
+
+    Quat_normalize (out);
+}
+
 /**
  * Check if an animation can be used for a given model.  Model's
  * skeleton and animation's skeleton must match.
@@ -147,6 +211,9 @@ int
 CheckAnimValidity (const struct md5_model_t *mdl,
                    const struct md5_anim_t *anim)
 {
+    struct md5_frame_cache_t cache;
+    const struct md5_joint_t *frame0;
+    int valid = 1;
     int i;
 
     /* md5mesh and md5anim must have the same number of joints */
@@ -156,21 +223,29 @@ CheckAnimValidity (const struct md5_model_t *mdl,
     }
 
     /* We just check with frame[0] */
-    for (i = 0; i < mdl->num_joints; ++i)
+    InitFrameCache (&cache);
+    frame0 = GetAnimFrame (anim, &cache, 0);
+
+    for (i = 0; i < mdl->num_joints && valid; ++i)
     {
         /* Joints must have the same parent index */
-        if (mdl->baseSkel[i].parent != anim->skelFrames[0][i].parent) {
+        if (mdl->baseSkel[i].parent != frame0[i].parent) {
             printf("\n[.md5anim]: skeleton and animation joints do not have same parent index.  cannot apply animation to skeleton\n\n");
-            return 0;
+            valid = 0;
         }
 
         /* Joints must have the same name */
-        if (strcmp (mdl->baseSkel[i].name, anim->skelFrames[0][i].name) != 0) {
+        else if (strcmp (mdl->baseSkel[i].name, frame0[i].name) != 0) {
             printf("\n[.md5anim]: skeleton and animation joints do not have same name.  cannot apply animation to skeleton\n\n");
-            return 0;
+            valid = 0;
         }
     }
 
+    FreeFrameCache (&cache);
+
+    if (!valid)
+        return 0;
+
     printf("\n[.md5anim]: skeleton and animation match.  animation can be applied to skeleton\n\n");
     return 1;
 }
@@ -269,21 +344,18 @@ BuildFrameSkeleton (const struct joint_info_t *jointInfos,
 }
 
 /**
- * Load an MD5 animation from file.
+ * Read an md5anim a line at a time with sscanf().  This is the parser
+ * ReadMD5AnimData() replaced, kept to check it against.
  */
 int
-ReadMD5Anim (const char *filename, struct md5_anim_t *anim)
+ScanMD5AnimData (const char *filename, struct md5_anim_data_t *data)
 {
     char buff[512];
-    struct joint_info_t *jointInfos = nullptr;
-    struct baseframe_joint_t *baseFrame = nullptr;
-    float *animFrameData = nullptr;
     int version;
-    int numAnimatedComponents;
     int frame_index;
     int i;
 
-    printf( "[.md5anim]: about to read %s\n", filename );
+    memset (data, 0, sizeof (struct md5_anim_data_t));
 
     FILE *fp = fopen (filename, "rb");
     if (!fp)
@@ -304,122 +376,171 @@ ReadMD5Anim (const char *filename, struct md5_anim_t *anim)
                 /* Bad version */
                 fprintf (stderr, "[.md5anim]: Error: bad animation version\n");
                 fclose (fp);
+                FreeAnimData (data);
                 return 0;
             }
         }
-        else if (sscanf (buff, " numFrames %d", &anim->num_frames) == 1)
+        else if (sscanf (buff, " numFrames %d", &data->num_frames) == 1)
         {
-            /* Allocate memory for skeleton frames and bounding boxes */
-            if (anim->num_frames > 0)
+            /* Allocate memory for bounding boxes */
+            if (data->num_frames > 0)
             {
-                anim->skelFrames = (struct md5_joint_t **)
-                malloc (sizeof (struct md5_joint_t*) * anim->num_frames);
-                anim->bboxes = (struct md5_bbox_t *)
-                malloc (sizeof (struct md5_bbox_t) * anim->num_frames);
+                data->bboxes = (struct md5_bbox_t *)
+                malloc (sizeof (struct md5_bbox_t) * data->num_frames);
             }
         }
-        else if (sscanf (buff, " numJoints %d", &anim->num_joints) == 1)
+        else if (sscanf (buff, " numJoints %d", &data->num_joints) == 1)
         {
-            if (anim->num_joints > 0)
+            if (data->num_joints > 0)
             {
-                for (i = 0; i < anim->num_frames; ++i)
-                {
-                    /* Allocate memory for joints of each frame */
-                    anim->skelFrames[i] = (struct md5_joint_t *)
-                    malloc (sizeof (struct md5_joint_t) * anim->num_joints);
-                }
-
-                /* Allocate temporary memory for building skeleton frames */
-                jointInfos = (struct joint_info_t *)
-                malloc (sizeof (struct joint_info_t) * anim->num_joints);
+                data->jointInfos = (struct joint_info_t *)
+                calloc (data->num_joints, sizeof (struct joint_info_t));
 
-                baseFrame = (struct baseframe_joint_t *)
-                malloc (sizeof (struct baseframe_joint_t) * anim->num_joints);
+                data->baseFrame = (struct baseframe_joint_t *)
+                calloc (data->num_joints, sizeof (struct baseframe_joint_t));
             }
         }
-        else if (sscanf (buff, " frameRate %d", &anim->frameRate) == 1)
+        else if (sscanf (buff, " frameRate %d", &data->frameRate) == 1)
         {
 
         }
-        else if (sscanf (buff, " numAnimatedComponents %d", &numAnimatedComponents) == 1)
+        else if (sscanf (buff, " numAnimatedComponents %d", &data->numAnimatedComponents) == 1)
         {
-            if (numAnimatedComponents > 0)
+            if (data->numAnimatedComponents > 0 && data->num_frames > 0)
             {
-                /* Allocate memory for animation frame data */
-                animFrameData = (float *)malloc (sizeof (float) * numAnimatedComponents);
+                /* Allocate memory for every frame's components */
+                data->frameData = (float *)calloc (data->num_frames * data->numAnimatedComponents, sizeof (float));
             }
         }
         else if (strncmp (buff, "hierarchy {", 11) == 0)
         {
-            for (i = 0; i < anim->num_joints; ++i)
+            for (i = 0; i < data->num_joints; ++i)
             {
+                struct joint_info_t *jointInfo = &data->jointInfos[i];
+
                 /* Read whole line */
                 fgets (buff, sizeof (buff), fp);
 
                 /* Read joint info */
-                sscanf (buff, " %s %d %d %d", jointInfos[i].name, &jointInfos[i].parent,
-                        &jointInfos[i].flags, &jointInfos[i].startIndex);
+                sscanf (buff, " %s %d %d %d", jointInfo->name, &jointInfo->parent,
+                        &jointInfo->flags, &jointInfo->startIndex);
             }
         }
         else if (strncmp (buff, "bounds {", 8) == 0)
         {
-            for (i = 0; i < anim->num_frames; ++i)
+            for (i = 0; i < data->num_frames; ++i)
             {
                 /* Read whole line */
                 fgets (buff, sizeof (buff), fp);
 
                 /* Read bounding box */
                 sscanf (buff, " ( %f %f %f ) ( %f %f %f )",
-                        &anim->bboxes[i].min[0], &anim->bboxes[i].min[1],
-                        &anim->bboxes[i].min[2], &anim->bboxes[i].max[0],
-                        &anim->bboxes[i].max[1], &anim->bboxes[i].max[2]);
+                        &data->bboxes[i].min[0], &data->bboxes[i].min[1],
+                        &data->bboxes[i].min[2], &data->bboxes[i].max[0],
+                        &data->bboxes[i].max[1], &data->bboxes[i].max[2]);
             }
         }
         else if (strncmp (buff, "baseframe {", 10) == 0)
         {
-            for (i = 0; i < anim->num_joints; ++i)
+            for (i = 0; i < data->num_joints; ++i)
             {
+                struct baseframe_joint_t *baseJoint = &data->baseFrame[i];
+
                 /* Read whole line */
                 fgets (buff, sizeof (buff), fp);
 
                 /* Read base frame joint */
                 if (sscanf (buff, " ( %f %f %f ) ( %f %f %f )",
-                            &baseFrame[i].pos[0], &baseFrame[i].pos[1],
-                            &baseFrame[i].pos[2], &baseFrame[i].orient[0],
-                            &baseFrame[i].orient[1], &baseFrame[i].orient[2]) == 6)
+                            &baseJoint->pos[0], &baseJoint->pos[1],
+                            &baseJoint->pos[2], &baseJoint->orient[0],
+                            &baseJoint->orient[1], &baseJoint->orient[2]) == 6)
                 {
                     /* Compute the w component */
-                    Quat_computeW (baseFrame[i].orient);
+                    Quat_computeW (baseJoint->orient);
                 }
             }
         }
         else if (sscanf (buff, " frame %d", &frame_index) == 1)
         {
-            /* Read frame data */
-            for (i = 0; i < numAnimatedComponents; ++i)
-                fscanf (fp, "%f", &animFrameData[i]);
+            if (frame_index < 0 || frame_index >= data->num_frames)
+                continue;
+
+            float *frameData = data->frameData + frame_index * data->numAnimatedComponents;
 
-            /* Build frame skeleton from the collected data */
-            BuildFrameSkeleton (jointInfos, baseFrame, animFrameData,
-                                anim->skelFrames[frame_index], anim->num_joints);
+            /* Read frame data */
+            for (i = 0; i < data->numAnimatedComponents; ++i)
+                fscanf (fp, "%f", &frameData[i]);
         }
     }
 
     fclose (fp);
 
-    printf( "[.md5anim]: finished reading %s\n", filename );
-    printf( "[.md5anim]: read in %d frames of %d joints with %d animated components\n", anim->num_frames, anim->num_joints, numAnimatedComponents );
-    printf ("[.md5anim]: animation's frame rate is %d\n", anim->frameRate);
+    return 1;
+}
 
-    /* Free temporary data allocated */
-    if (animFrameData)
-        free (animFrameData);
+/**
+ * Free resources allocated by ReadMD5AnimData() or ScanMD5AnimData().
+ */
+void
+FreeAnimData (struct md5_anim_data_t *data)
+{
+    free (data->jointInfos);
+    free (data->baseFrame);
+    free (data->bboxes);
+    free (data->frameData);
+
+    memset (data, 0, sizeof (struct md5_anim_data_t));
+}
+
+/**
+ * Load an MD5 animation from file.
+ */
+int
+ReadMD5Anim (const char *filename, struct md5_anim_t *anim)
+{
+    struct md5_anim_data_t data;
+    int i;
+
+    printf( "[.md5anim]: about to read %s\n", filename );
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+    if (!ReadMD5AnimData (filename, &data))
+        return 0;
+    double parseSeconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+
+    anim->num_frames = data.num_frames;
+    anim->num_joints = data.num_joints;
+    anim->frameRate = data.frameRate;
+    anim->clip = nullptr;
+
+    /* The bounding boxes are kept as they were read */
+    anim->bboxes = data.bboxes;
+    data.bboxes = nullptr;
+
+    /* Build every frame skeleton from the collected data */
+    anim->skelFrames = nullptr;
+    if (anim->num_frames > 0)
+    {
+        anim->skelFrames = (struct md5_joint_t **)
+        malloc (sizeof (struct md5_joint_t*) * anim->num_frames);
+
+        for (i = 0; i < anim->num_frames; ++i)
+        {
+            anim->skelFrames[i] = (struct md5_joint_t *)
+            malloc (sizeof (struct md5_joint_t) * anim->num_joints);
 
-    if (baseFrame)
-        free (baseFrame);
+            BuildFrameSkeleton (data.jointInfos, data.baseFrame,
+                                data.frameData + i * data.numAnimatedComponents,
+                                anim->skelFrames[i], anim->num_joints);
+        }
+    }
+
+    printf( "[.md5anim]: finished reading %s, parsed in %.2f ms\n", filename, parseSeconds * 1e3 );
+    printf( "[.md5anim]: read in %d frames of %d joints with %d animated components\n", anim->num_frames, anim->num_joints, data.numAnimatedComponents );
+    printf ("[.md5anim]: animation's frame rate is %d\n", anim->frameRate);
 
-    if (jointInfos)
-        free (jointInfos);
+    /* Free temporary data allocated */
+    FreeAnimData (&data);
 
     return 1;
 }
@@ -447,6 +568,14 @@ FreeAnim (struct md5_anim_t *anim)
         anim->skelFrames = nullptr;
     }
 
+    /* A clip's bounding boxes live in its mapping */
+    if (anim->clip)
+    {
+        FreeClip (anim->clip);
+        anim->clip = nullptr;
+        anim->bboxes = nullptr;
+    }
+
     if (anim->bboxes)
     {
         free (anim->bboxes);
@@ -465,6 +594,19 @@ InterpolateSkeletons (const struct md5_joint_t *skelA,
 {
     int i;
 
+    /* Nothing to blend at either end */
+    if (interp <= 0.0f)
+    {
+        memcpy (out, skelA, sizeof (struct md5_joint_t) * num_joints);
+        return;
+    }
+
+    if (interp >= 1.0f)
+    {
+        memcpy (out, skelB, sizeof (struct md5_joint_t) * num_joints);
+        return;
+    }
+
     for (i = 0; i < num_joints; ++i)
     {
         /* Copy parent index */
@@ -475,34 +617,44 @@ InterpolateSkeletons (const struct md5_joint_t *skelA,
         out[i].pos[1] = skelA[i].pos[1] + interp * (skelB[i].pos[1] - skelA[i].pos[1]);
         out[i].pos[2] = skelA[i].pos[2] + interp * (skelB[i].pos[2] - skelA[i].pos[2]);
 
-        /* Spherical linear interpolation for orientation */
-        Quat_slerp (skelA[i].orient, skelB[i].orient, interp, out[i].orient);
+        /* Spherical linear interpolation for orientation, unless
+         the two are close enough for nlerp */
+        if (fabsf (Quat_dotProduct (skelA[i].orient, skelB[i].orient)) > MD5_NLERP_MIN_DOT)
+            Quat_nlerp (skelA[i].orient, skelB[i].orient, interp, out[i].orient);
+        else
+            Quat_slerp (skelA[i].orient, skelB[i].orient, interp, out[i].orient);
     }
 }
 
 /**
  * Perform animation related computations.  Calculate the current and
- * next frames, given a delta time.
+ * next frames, given a delta time, moving on as many frames as dt
+ * covers.
  */
 void
 Animate (const struct md5_anim_t *anim,
          struct anim_info_t *animInfo, double dt)
 {
-    int maxFrames = anim->num_frames - 1;
+    int frames;
 
     animInfo->last_time += dt;
 
-    /* move to next frame */
+    /* move to next frame, or further for a long step */
     if (animInfo->last_time >= animInfo->max_time)
     {
-        animInfo->curr_frame++;
-        animInfo->next_frame++;
-        animInfo->last_time = 0.0;
+        frames = (int)(animInfo->last_time / animInfo->max_time);
+        animInfo->last_time -= frames * animInfo->max_time;
 
-        if (animInfo->curr_frame > maxFrames)
-            animInfo->curr_frame = 0;
-
-        if (animInfo->next_frame > maxFrames)
-            animInfo->next_frame = 0;
+        animInfo->curr_frame = (animInfo->curr_frame + frames) % anim->num_frames;
+        animInfo->next_frame = (animInfo->curr_frame + 1) % anim->num_frames;
     }
 }
+
+/**
+ * Time in seconds animInfo has reached within the animation.
+ */
+double
+GetAnimTime (const struct anim_info_t *animInfo)
+{
+    return animInfo->curr_frame * animInfo->max_time + animInfo->last_time;
+}
@@ -0,0 +1,796 @@
+/*
+ * md5clip.c -- md5mesh model loader + animation
+ *
+ * Compiled animation clips.  CompileMD5Anim() turns an md5anim into a
+ * binary file that holds only the components each joint animates, with
+ * rotations quantized to 16 bits.  CompressMD5Anim() writes the keyed
+ * format instead.  ReadMD5Clip() maps either file as is, so loading does
+ * no parsing, and frame skeletons are built when they are first asked
+ * for through a small per thread cache.
+ * Dependencies: md5model.h, md5anim.cpp.
+ *
+ */
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+#include "MD5/md5model.h"
+
+/**
+ * Clip file layout, native byte order, every section aligned for its type:
+ *   md5_clip_header_t  header
+ *   joint_info_t       jointInfos[num_joints]
+ *   baseframe_joint_t  baseFrame[num_joints]
+ *   md5_bbox_t         bboxes[num_frames]
+ *
+ * MD5_CLIP_FRAMES then stores every frame's animated components, joint
+ * by joint in Tx Ty Tz Qx Qy Qz order:
+ *   float              translations[num_frames][numTranslations]
+ *   short              rotations[num_frames][numRotations]
+ *
+ * MD5_CLIP_KEYS stores the keys kept for each joint's local translation
+ * and rotation, rotations packed smallest three in 48 bits.  Tracks that
+ * keep a key at every frame store no frame numbers:
+ *   md5_clip_track_t   tracks[num_joints]
+ *   vec3_t             translations[numTranslations]
+ *   unsigned short     rotations[numRotations][3]
+ *   unsigned short     translationFrames[keys of the other tracks]
+ *   unsigned short     rotationFrames[keys of the other tracks]
+ */
+
+/* Mapped clip */
+struct md5_clip_t
+{
+    const unsigned char *data;
+    long size;
+
+    const struct md5_clip_header_t *header;
+    const struct joint_info_t *jointInfos;
+    const struct baseframe_joint_t *baseFrame;
+    const float *translations;
+    const short *rotations;
+
+    /* MD5_CLIP_KEYS only */
+    const struct md5_clip_track_t *tracks;
+    const unsigned short *packedRotations;
+    const unsigned short *translationFrames;
+    const unsigned short *rotationFrames;
+
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+};
+
+/**
+ * Pack a unit quaternion into 48 bits: the index of its largest
+ * component and the other three in 15 bits each.  The largest is
+ * rebuilt from the others, its sign is dropped since q and -q give
+ * the same rotation.
+ */
+void Quat_packSmallestThree (const quat4_t q, unsigned short out[3]) {
+	float sign;
+	int largest = 0;
+	int i, n = 0;
+
+	for (i = 1; i < 4; ++i) {
+		if (fabsf (q[i]) > fabsf (q[largest]))
+			largest = i;
+	}
+	sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+
+	for (i = 0; i < 4; ++i) {
+		if (i == largest)
+			continue;
+
+		/* the smaller three lie within +-1/sqrt(2) */
+		float value = (sign * q[i] * 0.70710678f + 0.5f) * 32767.0f;
+		if (value < 0.0f)
+			value = 0.0f;
+		else if (value > 32767.0f)
+			value = 32767.0f;
+
+		out[n++] = (unsigned short)lroundf (value);
+	}
+
+	out[0] |= (largest & 1) << 15;
+	out[1] |= (largest >> 1) << 15;
+}
+
+void Quat_unpackSmallestThree (const unsigned short in[3], quat4_t out) {
+	int largest = (in[0] >> 15) | ((in[1] >> 15) << 1);
+	float sum = 0.0f;
+	int i, n = 0;
+
+	for (i = 0; i < 4; ++i) {
+		if (i == largest)
+			continue;
+
+		out[i] = ((in[n++] & 0x7fff) * (1.0f / 32767.0f) - 0.5f) * 1.41421356f;
+		sum += out[i] * out[i];
+	}
+
+	out[largest] = sum < 1.0f ? sqrtf (1.0f - sum) : 0.0f;
+}
+
+/**
+ * Quantize a joint's animated rotation components.  w is rebuilt from
+ * x, y and z when decoding, which magnifies their error as w nears 0, so
+ * each component is rounded up or down, whichever combination rebuilds
+ * the quaternion closest to the original.
+ */
+static void QuantizeOrient (const struct baseframe_joint_t *baseJoint, unsigned int flags,
+                            const float *frameData, int component, short *out) {
+	quat4_t orient, candidate;
+	int axes[3], lower[3];
+	int count = 0;
+	float bestError = 2.0f;
+	int i, mask;
+
+	memcpy (orient, baseJoint->orient, sizeof (quat4_t));
+
+	/* Skip the translation components */
+	for (i = 0; i < 3; ++i) {
+		if (flags & (1 << i))
+			++component;
+	}
+
+	for (i = 0; i < 3; ++i) {
+		if (flags & (8 << i)) {
+			float scaled = frameData[component++] * 32767.0f;
+
+			orient[i] = frameData[component - 1];
+			axes[count] = i;
+			lower[count] = (int)floorf (scaled);
+			++count;
+		}
+	}
+	Quat_computeW (orient);
+
+	for (mask = 0; mask < (1 << count); ++mask) {
+		short quantized[3];
+		float error;
+
+		memcpy (candidate, baseJoint->orient, sizeof (quat4_t));
+		for (i = 0; i < count; ++i) {
+			int value = lower[i] + ((mask >> i) & 1);
+
+			if (value > 32767)
+				value = 32767;
+			else if (value < -32767)
+				value = -32767;
+
+			quantized[i] = (short)value;
+			candidate[axes[i]] = value * (1.0f / 32767.0f);
+		}
+		Quat_computeW (candidate);
+
+		/* x, y and z may be a little longer than 1 with w clamped to 0 */
+		error = 1.0f - fabsf (Quat_dotProduct (orient, candidate))
+		        / sqrtf (Quat_dotProduct (orient, orient) * Quat_dotProduct (candidate, candidate));
+		if (error < bestError) {
+			bestError = error;
+			memcpy (out, quantized, sizeof (short) * count);
+		}
+	}
+}
+
+/**
+ * Compile an md5anim file to a clip.
+ */
+int CompileMD5Anim (const char *md5animFile, const char *clipFile) {
+	struct md5_anim_data_t data;
+	struct md5_clip_header_t header;
+	float *translations;
+	short *rotations;
+	int numTranslations = 0, numRotations = 0;
+	int i, j, f;
+
+	if (!ReadMD5AnimData (md5animFile, &data))
+		return 0;
+
+	/* Each set flag bit is one animated component */
+	for (i = 0; i < data.num_joints; ++i) {
+		for (j = 0; j < 6; ++j) {
+			if (data.jointInfos[i].flags & (1 << j)) {
+				if (j < 3)
+					++numTranslations;
+				else
+					++numRotations;
+			}
+		}
+	}
+
+	if (numTranslations + numRotations != data.numAnimatedComponents) {
+		fprintf (stderr, "[.md5anim]: Error: joint flags of \"%s\" do not match its %d animated components\n",
+		         md5animFile, data.numAnimatedComponents);
+		FreeAnimData (&data);
+		return 0;
+	}
+
+	memset (&header, 0, sizeof (struct md5_clip_header_t));
+	memcpy (header.magic, MD5_CLIP_MAGIC, sizeof (MD5_CLIP_MAGIC));
+	header.version = MD5_CLIP_VERSION;
+	header.format = MD5_CLIP_FRAMES;
+	header.num_frames = data.num_frames;
+	header.num_joints = data.num_joints;
+	header.frameRate = data.frameRate;
+	header.numAnimatedComponents = data.numAnimatedComponents;
+	header.numTranslations = numTranslations;
+	header.numRotations = numRotations;
+
+	header.jointInfosOffset = sizeof (struct md5_clip_header_t);
+	header.baseFrameOffset = header.jointInfosOffset + sizeof (struct joint_info_t) * data.num_joints;
+	header.bboxesOffset = header.baseFrameOffset + sizeof (struct baseframe_joint_t) * data.num_joints;
+	header.translationsOffset = header.bboxesOffset + sizeof (struct md5_bbox_t) * data.num_frames;
+	header.rotationsOffset = header.translationsOffset + sizeof (float) * numTranslations * data.num_frames;
+	header.size = header.rotationsOffset + sizeof (short) * numRotations * data.num_frames;
+	header.tracksOffset = header.translationFramesOffset = header.rotationFramesOffset = header.size;
+
+	translations = (float *)malloc (sizeof (float) * (numTranslations * data.num_frames + 1));
+	rotations = (short *)malloc (sizeof (short) * (numRotations * data.num_frames + 1));
+
+	/* Split every frame into its translation and quantized rotation streams */
+	for (f = 0; f < data.num_frames; ++f) {
+		const float *frameData = data.frameData + f * data.numAnimatedComponents;
+		float *frameTranslations = translations + f * numTranslations;
+		short *frameRotations = rotations + f * numRotations;
+
+		for (i = 0; i < data.num_joints; ++i) {
+			const struct joint_info_t *jointInfo = &data.jointInfos[i];
+			int component = jointInfo->startIndex;
+
+			for (j = 0; j < 3; ++j) {
+				if (jointInfo->flags & (1 << j))
+					*frameTranslations++ = frameData[component++];
+			}
+
+			if (jointInfo->flags & 56) {
+				QuantizeOrient (&data.baseFrame[i], jointInfo->flags, frameData, jointInfo->startIndex, frameRotations);
+				for (j = 3; j < 6; ++j) {
+					if (jointInfo->flags & (1 << j))
+						++frameRotations;
+				}
+			}
+		}
+	}
+
+	FILE *fp = fopen (clipFile, "wb");
+	int written = 0;
+
+	if (!fp) {
+		fprintf (stderr, "[.md5anim]: Error: couldn't create \"%s\"!\n", clipFile);
+	} else {
+		written = fwrite (&header, sizeof (struct md5_clip_header_t), 1, fp) == 1
+		       && fwrite (data.jointInfos, sizeof (struct joint_info_t), data.num_joints, fp) == (size_t)data.num_joints
+		       && fwrite (data.baseFrame, sizeof (struct baseframe_joint_t), data.num_joints, fp) == (size_t)data.num_joints
+		       && fwrite (data.bboxes, sizeof (struct md5_bbox_t), data.num_frames, fp) == (size_t)data.num_frames
+		       && fwrite (translations, sizeof (float), numTranslations * data.num_frames, fp) == (size_t)(numTranslations * data.num_frames)
+		       && fwrite (rotations, sizeof (short), numRotations * data.num_frames, fp) == (size_t)(numRotations * data.num_frames);
+
+		if (fclose (fp) != 0)
+			written = 0;
+
+		if (written)
+			printf ("[.md5anim]: compiled %s to %s, %d bytes\n", md5animFile, clipFile, header.size);
+		else
+			fprintf (stderr, "[.md5anim]: Error: couldn't write \"%s\"!\n", clipFile);
+	}
+
+	free (translations);
+	free (rotations);
+	FreeAnimData (&data);
+
+	return written;
+}
+
+/**
+ * Map a compiled clip into memory.
+ */
+static struct md5_clip_t *MapClip (const char *filename) {
+	struct md5_clip_t *clip = (struct md5_clip_t *)calloc (1, sizeof (struct md5_clip_t));
+
+#ifdef _WIN32
+	LARGE_INTEGER size;
+
+	clip->file = CreateFileA (filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (clip->file == INVALID_HANDLE_VALUE || !GetFileSizeEx (clip->file, &size) || size.QuadPart == 0) {
+		if (clip->file != INVALID_HANDLE_VALUE)
+			CloseHandle (clip->file);
+		free (clip);
+		return nullptr;
+	}
+
+	clip->mapping = CreateFileMappingA (clip->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	clip->data = clip->mapping ? (const unsigned char *)MapViewOfFile (clip->mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	clip->size = (long)size.QuadPart;
+
+	if (!clip->data) {
+		if (clip->mapping)
+			CloseHandle (clip->mapping);
+		CloseHandle (clip->file);
+		free (clip);
+		return nullptr;
+	}
+#else
+	struct stat st;
+	int fd = open (filename, O_RDONLY);
+
+	if (fd < 0 || fstat (fd, &st) != 0 || st.st_size == 0) {
+		if (fd >= 0)
+			close (fd);
+		free (clip);
+		return nullptr;
+	}
+
+	void *data = mmap (nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close (fd);
+
+	if (data == MAP_FAILED) {
+		free (clip);
+		return nullptr;
+	}
+
+	clip->data = (const unsigned char *)data;
+	clip->size = (long)st.st_size;
+#endif
+
+	return clip;
+}
+
+/**
+ * Unmap a clip.  ReadMD5Clip() hands the clip to its animation, which
+ * frees it in FreeAnim().
+ */
+void FreeClip (struct md5_clip_t *clip) {
+	if (!clip)
+		return;
+
+#ifdef _WIN32
+	UnmapViewOfFile (clip->data);
+	CloseHandle (clip->mapping);
+	CloseHandle (clip->file);
+#else
+	munmap ((void *)clip->data, clip->size);
+#endif
+
+	free (clip);
+}
+
+/**
+ * True when count elements of elementSize bytes, aligned to align,
+ * start at offset and end within the mapped clip.
+ */
+static int SectionFits (const struct md5_clip_t *clip, long offset, long long count,
+                        size_t elementSize, size_t align) {
+	if (offset < (long)sizeof (struct md5_clip_header_t) || offset % align != 0 || count < 0)
+		return 0;
+
+	/* every element takes at least a byte, so this cannot overflow */
+	if (count > clip->size)
+		return 0;
+
+	return offset + count * (long long)elementSize <= clip->size;
+}
+
+/**
+ * Check the frame numbers of count tracks' keys lie within the clip and
+ * rise within each track.  frames must hold every key of those tracks
+ * that keep fewer than num_frames.
+ */
+static int KeyFramesValid (const unsigned short *frames, const int *counts, int num_frames) {
+	int k;
+
+	for (; *counts >= 0; ++counts) {
+		if (*counts == 0 || *counts == num_frames)
+			continue;
+
+		for (k = 0; k < *counts; ++k) {
+			if (frames[k] >= num_frames || (k > 0 && frames[k] <= frames[k - 1]))
+				return 0;
+		}
+		frames += *counts;
+	}
+
+	return 1;
+}
+
+/**
+ * Check a mapped clip before anything indexes it: every section has to
+ * lie within the file, and the joints and tracks may only refer to
+ * components, keys and parents that exist.
+ */
+static int CheckClip (const struct md5_clip_t *clip) {
+	const struct md5_clip_header_t *header = (const struct md5_clip_header_t *)clip->data;
+	const struct joint_info_t *jointInfos = (const struct joint_info_t *)(clip->data + header->jointInfosOffset);
+	int numTranslations = 0, numRotations = 0;
+	int i, j;
+
+	if (header->num_frames < 1 || header->num_joints < 0 || header->frameRate < 1
+	    || header->numAnimatedComponents < 0 || header->numTranslations < 0 || header->numRotations < 0)
+		return 0;
+
+	if (!SectionFits (clip, header->jointInfosOffset, header->num_joints, sizeof (struct joint_info_t), sizeof (int))
+	    || !SectionFits (clip, header->baseFrameOffset, header->num_joints, sizeof (struct baseframe_joint_t), sizeof (float))
+	    || !SectionFits (clip, header->bboxesOffset, header->num_frames, sizeof (struct md5_bbox_t), sizeof (float))
+	    || header->numAnimatedComponents > header->num_joints * 6)
+		return 0;
+
+	/* joints are built in order, each under an earlier parent, from the components their flags select */
+	for (i = 0; i < header->num_joints; ++i) {
+		const struct joint_info_t *jointInfo = &jointInfos[i];
+		int count = 0;
+
+		for (j = 0; j < 6; ++j) {
+			if (jointInfo->flags & (1 << j)) {
+				++count;
+				if (j < 3)
+					++numTranslations;
+				else
+					++numRotations;
+			}
+		}
+
+		if (!memchr (jointInfo->name, '\0', sizeof (jointInfo->name))
+		    || jointInfo->parent < -1 || jointInfo->parent >= i
+		    || jointInfo->startIndex < 0 || jointInfo->startIndex > header->numAnimatedComponents - count)
+			return 0;
+	}
+
+	if (header->format == MD5_CLIP_FRAMES) {
+		return numTranslations == header->numTranslations && numRotations == header->numRotations
+		    && SectionFits (clip, header->translationsOffset, (long long)header->num_frames * header->numTranslations, sizeof (float), sizeof (float))
+		    && SectionFits (clip, header->rotationsOffset, (long long)header->num_frames * header->numRotations, sizeof (short), sizeof (short));
+	}
+
+	/* keyed clips store frame numbers as unsigned shorts */
+	if (header->num_frames > 65536
+	    || !SectionFits (clip, header->tracksOffset, header->num_joints, sizeof (struct md5_clip_track_t), sizeof (int))
+	    || !SectionFits (clip, header->translationsOffset, header->numTranslations, sizeof (vec3_t), sizeof (float))
+	    || !SectionFits (clip, header->rotationsOffset, header->numRotations, sizeof (unsigned short) * 3, sizeof (unsigned short)))
+		return 0;
+
+	const struct md5_clip_track_t *tracks = (const struct md5_clip_track_t *)(clip->data + header->tracksOffset);
+	long long numTranslationFrames = 0, numRotationFrames = 0;
+	int *translationCounts = (int *)malloc (sizeof (int) * (header->num_joints + 1));
+	int *rotationCounts = (int *)malloc (sizeof (int) * (header->num_joints + 1));
+	int valid = 1;
+
+	for (i = 0; valid && i < header->num_joints; ++i) {
+		const struct md5_clip_track_t *track = &tracks[i];
+
+		valid = track->numTranslations >= 0 && track->numTranslations <= header->num_frames
+		     && track->firstTranslation >= 0 && track->firstTranslation <= header->numTranslations - track->numTranslations
+		     && track->numRotations >= 0 && track->numRotations <= header->num_frames
+		     && track->firstRotation >= 0 && track->firstRotation <= header->numRotations - track->numRotations;
+
+		translationCounts[i] = track->numTranslations;
+		rotationCounts[i] = track->numRotations;
+		if (track->numTranslations < header->num_frames)
+			numTranslationFrames += track->numTranslations;
+		if (track->numRotations < header->num_frames)
+			numRotationFrames += track->numRotations;
+	}
+	translationCounts[header->num_joints] = rotationCounts[header->num_joints] = -1;
+
+	valid = valid
+	     && SectionFits (clip, header->translationFramesOffset, numTranslationFrames, sizeof (unsigned short), sizeof (unsigned short))
+	     && SectionFits (clip, header->rotationFramesOffset, numRotationFrames, sizeof (unsigned short), sizeof (unsigned short))
+	     && KeyFramesValid ((const unsigned short *)(clip->data + header->translationFramesOffset), translationCounts, header->num_frames)
+	     && KeyFramesValid ((const unsigned short *)(clip->data + header->rotationFramesOffset), rotationCounts, header->num_frames);
+
+	free (translationCounts);
+	free (rotationCounts);
+
+	return valid;
+}
+
+/**
+ * Load a compiled clip.  The animation's frames are decoded on demand
+ * through GetAnimFrame() rather than built here.
+ */
+int ReadMD5Clip (const char *filename, struct md5_anim_t *anim) {
+	struct md5_clip_t *clip = MapClip (filename);
+	const struct md5_clip_header_t *header;
+
+	if (!clip) {
+		fprintf (stderr, "[.md5anim]: Error: couldn't open \"%s\"!\n", filename);
+		return 0;
+	}
+
+	header = (const struct md5_clip_header_t *)clip->data;
+
+	if (clip->size < (long)sizeof (struct md5_clip_header_t)
+	    || memcmp (header->magic, MD5_CLIP_MAGIC, sizeof (MD5_CLIP_MAGIC)) != 0
+	    || header->version != MD5_CLIP_VERSION
+	    || header->size != clip->size
+	    || (header->format != MD5_CLIP_FRAMES && header->format != MD5_CLIP_KEYS)) {
+		fprintf (stderr, "[.md5anim]: Error: \"%s\" is not a version %d clip\n", filename, MD5_CLIP_VERSION);
+		FreeClip (clip);
+		return 0;
+	}
+
+	if (!CheckClip (clip)) {
+		fprintf (stderr, "[.md5anim]: Error: \"%s\" is truncated or corrupt\n", filename);
+		FreeClip (clip);
+		return 0;
+	}
+
+	clip->header = header;
+	clip->jointInfos = (const struct joint_info_t *)(clip->data + header->jointInfosOffset);
+	clip->baseFrame = (const struct baseframe_joint_t *)(clip->data + header->baseFrameOffset);
+	clip->translations = (const float *)(clip->data + header->translationsOffset);
+	clip->rotations = (const short *)(clip->data + header->rotationsOffset);
+
+	if (header->format == MD5_CLIP_KEYS) {
+		clip->tracks = (const struct md5_clip_track_t *)(clip->data + header->tracksOffset);
+		clip->packedRotations = (const unsigned short *)(clip->data + header->rotationsOffset);
+		clip->translationFrames = (const unsigned short *)(clip->data + header->translationFramesOffset);
+		clip->rotationFrames = (const unsigned short *)(clip->data + header->rotationFramesOffset);
+	}
+
+	anim->num_frames = header->num_frames;
+	anim->num_joints = header->num_joints;
+	anim->frameRate = header->frameRate;
+	anim->skelFrames = nullptr;
+	anim->bboxes = (struct md5_bbox_t *)(clip->data + header->bboxesOffset);
+	anim->clip = clip;
+
+	printf ("[.md5anim]: mapped %s, %d frames of %d joints in %ld bytes\n",
+	        filename, anim->num_frames, anim->num_joints, clip->size);
+
+	return 1;
+}
+
+/**
+ * Dequantize one frame's components into frameData, which holds
+ * numAnimatedComponents floats, and build its skeleton.
+ */
+void DecodeClipFrame (const struct md5_clip_t *clip, int frame,
+                      float *frameData, struct md5_joint_t *skelFrame) {
+	const struct md5_clip_header_t *header = clip->header;
+	const float *translations = clip->translations + frame * header->numTranslations;
+	const short *rotations = clip->rotations + frame * header->numRotations;
+	int i, j;
+
+	if (header->format == MD5_CLIP_KEYS) {
+		SampleClip (clip, (float)frame, skelFrame);
+		return;
+	}
+
+	for (i = 0; i < header->num_joints; ++i) {
+		const struct joint_info_t *jointInfo = &clip->jointInfos[i];
+		int component = jointInfo->startIndex;
+
+		for (j = 0; j < 6; ++j) {
+			if (!(jointInfo->flags & (1 << j)))
+				continue;
+
+			if (j < 3)
+				frameData[component] = *translations++;
+			else
+				frameData[component] = *rotations++ * (1.0f / 32767.0f);
+			++component;
+		}
+	}
+
+	BuildFrameSkeleton (clip->jointInfos, clip->baseFrame, frameData, skelFrame, header->num_joints);
+}
+
+/**
+ * Find the keys around frame in one track.  Returns the first key and
+ * sets interp to how far frame is towards the second.  A track with a
+ * key at each of the clip's num_frames frames has no frame numbers.
+ */
+static int FindKey (const unsigned short *frames, int count, int num_frames, float frame, float *interp) {
+	int lo = 0, hi = count - 1;
+
+	*interp = 0.0f;
+
+	/* a key at every frame needs no search */
+	if (count == num_frames) {
+		if (frame <= 0.0f)
+			return 0;
+		if (frame >= hi)
+			return hi;
+
+		lo = (int)frame;
+		*interp = frame - lo;
+		return lo;
+	}
+
+	if (count == 1 || frame <= frames[0])
+		return 0;
+	if (frame >= frames[hi])
+		return hi;
+
+	/* frames[lo] <= frame < frames[hi] */
+	while (hi - lo > 1) {
+		int mid = (lo + hi) / 2;
+
+		if (frames[mid] <= frame)
+			lo = mid;
+		else
+			hi = mid;
+	}
+
+	*interp = (frame - frames[lo]) / (float)(frames[lo + 1] - frames[lo]);
+	return lo;
+}
+
+/**
+ * Build the skeleton of a keyed clip at any frame, including between
+ * frames.  Translations are lerped and rotations nlerped between the
+ * keys on either side.  Returns 0 for clips that store every frame.
+ */
+int SampleClip (const struct md5_clip_t *clip, float frame,
+                struct md5_joint_t *skelFrame) {
+	const struct md5_clip_header_t *header = clip->header;
+	const unsigned short *translationFrames = clip->translationFrames;
+	const unsigned short *rotationFrames = clip->rotationFrames;
+	int i, k;
+
+	if (header->format != MD5_CLIP_KEYS)
+		return 0;
+
+	for (i = 0; i < header->num_joints; ++i) {
+		const struct md5_clip_track_t *track = &clip->tracks[i];
+		const struct joint_info_t *jointInfo = &clip->jointInfos[i];
+		struct md5_joint_t *thisJoint = &skelFrame[i];
+		vec3_t animatedPos;
+		quat4_t animatedOrient;
+		float interp;
+
+		memcpy (animatedPos, clip->baseFrame[i].pos, sizeof (vec3_t));
+		memcpy (animatedOrient, clip->baseFrame[i].orient, sizeof (quat4_t));
+
+		if (track->numTranslations > 0) {
+			const float *a;
+
+			k = FindKey (translationFrames, track->numTranslations, header->num_frames, frame, &interp);
+			a = clip->translations + (track->firstTranslation + k) * 3;
+
+			if (interp > 0.0f) {
+				const float *b = a + 3;
+
+				animatedPos[0] = a[0] + interp * (b[0] - a[0]);
+				animatedPos[1] = a[1] + interp * (b[1] - a[1]);
+				animatedPos[2] = a[2] + interp * (b[2] - a[2]);
+			} else {
+				memcpy (animatedPos, a, sizeof (vec3_t));
+			}
+
+			/* frame numbers follow on from the last track that has them */
+			if (track->numTranslations < header->num_frames)
+				translationFrames += track->numTranslations;
+		}
+
+		if (track->numRotations > 0) {
+			const unsigned short *packed;
+
+			k = FindKey (rotationFrames, track->numRotations, header->num_frames, frame, &interp);
+			packed = clip->packedRotations + (track->firstRotation + k) * 3;
+			Quat_unpackSmallestThree (packed, animatedOrient);
+
+			if (interp > 0.0f) {
+				quat4_t next;
+				float scale;
+				int c;
+
+				Quat_unpackSmallestThree (packed + 3, next);
+
+				/* keys are close, so nlerp on the shorter arc is enough */
+				scale = Quat_dotProduct (animatedOrient, next) < 0.0f ? -interp : interp;
+				for (c = 0; c < 4; ++c)
+					animatedOrient[c] = animatedOrient[c] * (1.0f - interp) + next[c] * scale;
+				Quat_normalize (animatedOrient);
+			}
+
+			if (track->numRotations < header->num_frames)
+				rotationFrames += track->numRotations;
+		}
+
+		thisJoint->parent = jointInfo->parent;
+		strcpy (thisJoint->name, jointInfo->name);
+
+		if (thisJoint->parent < 0) {
+			memcpy (thisJoint->pos, animatedPos, sizeof (vec3_t));
+			memcpy (thisJoint->orient, animatedOrient, sizeof (quat4_t));
+		} else {
+			const struct md5_joint_t *parentJoint = &skelFrame[thisJoint->parent];
+			vec3_t rpos;
+
+			Quat_rotatePoint (parentJoint->orient, animatedPos, rpos);
+			thisJoint->pos[0] = rpos[0] + parentJoint->pos[0];
+			thisJoint->pos[1] = rpos[1] + parentJoint->pos[1];
+			thisJoint->pos[2] = rpos[2] + parentJoint->pos[2];
+
+			Quat_multQuat (parentJoint->orient, animatedOrient, thisJoint->orient);
+			Quat_normalize (thisJoint->orient);
+		}
+	}
+
+	return 1;
+}
+
+void InitFrameCache (struct md5_frame_cache_t *cache) {
+	memset (cache, 0, sizeof (struct md5_frame_cache_t));
+}
+
+void FreeFrameCache (struct md5_frame_cache_t *cache) {
+	int i;
+
+	for (i = 0; i < MD5_FRAME_CACHE_SIZE; ++i)
+		free (cache->skelFrames[i]);
+	free (cache->frameData);
+
+	InitFrameCache (cache);
+}
+
+/**
+ * Skeleton of one frame.  Animations read from text return their built
+ * frame.  Clips decode the frame into the least recently used slot of
+ * the cache, so the frames from the last MD5_FRAME_CACHE_SIZE calls stay
+ * valid.  A cache must only be used by one thread at a time.
+ */
+const struct md5_joint_t *GetAnimFrame (const struct md5_anim_t *anim,
+                                        struct md5_frame_cache_t *cache,
+                                        int frame) {
+	int i, slot = 0;
+
+	if (anim->skelFrames)
+		return anim->skelFrames[frame];
+
+	/* Start over when the cache last served another animation */
+	if (cache->anim != anim) {
+		FreeFrameCache (cache);
+		cache->anim = anim;
+
+		for (i = 0; i < MD5_FRAME_CACHE_SIZE; ++i) {
+			cache->frames[i] = -1;
+			cache->skelFrames[i] = (struct md5_joint_t *)malloc (sizeof (struct md5_joint_t) * anim->num_joints);
+		}
+		cache->frameData = (float *)malloc (sizeof (float) * (anim->clip->header->numAnimatedComponents + 1));
+	}
+
+	++cache->clock;
+
+	for (i = 0; i < MD5_FRAME_CACHE_SIZE; ++i) {
+		if (cache->frames[i] == frame) {
+			cache->lastUse[i] = cache->clock;
+			return cache->skelFrames[i];
+		}
+
+		if (cache->lastUse[i] < cache->lastUse[slot])
+			slot = i;
+	}
+
+	DecodeClipFrame (anim->clip, frame, cache->frameData, cache->skelFrames[slot]);
+	cache->frames[slot] = frame;
+	cache->lastUse[slot] = cache->clock;
+
+	return cache->skelFrames[slot];
+}
+
+/**
+ * Bytes the animation keeps resident for its frames, not counting any
+ * frame cache.
+ */
+unsigned long GetAnimBytes (const struct md5_anim_t *anim) {
+	if (anim->clip)
+		return anim->clip->size;
+
+	return anim->num_frames * (sizeof (struct md5_joint_t *) + sizeof (struct md5_joint_t) * anim->num_joints
+	                           + sizeof (struct md5_bbox_t));
+}
@@ -0,0 +1,486 @@
+/*
+ * md5compress.c -- md5mesh model loader + animation
+ *
+ * Offline compression of md5anim files to keyed clips.  Every joint's
+ * local translation and rotation keeps only the keys it needs to stay
+ * within an error bound, measured as how far the skinned vertices move,
+ * and rotations are packed smallest three in 48 bits.  The clip is then
+ * decoded and skinned against the original frames, and compressed again
+ * with tighter bounds when errors added up along the hierarchy.  A track
+ * whose keys and frame numbers would take more room than a key at every
+ * frame keeps every frame, which needs no frame numbers.
+ * Dependencies: md5model.h, md5anim.cpp, md5clip.cpp, md5skin.cpp.
+ *
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+#include "MD5/md5model.h"
+
+/* Tries at tighter bounds before settling for the last clip */
+#define MD5_COMPRESS_ATTEMPTS 6
+
+/* One joint track being reduced */
+struct md5_track_fit_t
+{
+    int num_frames;
+    int stride;             /* 3 for translations, 4 for rotations */
+
+    const float *values;    /* original value of every frame */
+    const float *keys;      /* value every frame would be stored as */
+    const float *base;      /* base frame value, used when no key is kept */
+
+    float reach;            /* farthest skinned vertex the joint moves */
+    float maxVertexError;
+    float maxRotationError;
+};
+
+/**
+ * Local translation and rotation of every joint in every frame,
+ * indexed [frame * num_joints + joint].
+ */
+static void BuildLocalTracks (const struct md5_anim_data_t *data, vec3_t *pos, quat4_t *orient) {
+	int f, i, j;
+
+	for (f = 0; f < data->num_frames; ++f) {
+		const float *frameData = data->frameData + f * data->numAnimatedComponents;
+
+		for (i = 0; i < data->num_joints; ++i) {
+			const struct joint_info_t *jointInfo = &data->jointInfos[i];
+			float *p = pos[f * data->num_joints + i];
+			float *q = orient[f * data->num_joints + i];
+			int component = jointInfo->startIndex;
+
+			memcpy (p, data->baseFrame[i].pos, sizeof (vec3_t));
+			memcpy (q, data->baseFrame[i].orient, sizeof (quat4_t));
+
+			for (j = 0; j < 3; ++j) {
+				if (jointInfo->flags & (1 << j))
+					p[j] = frameData[component++];
+			}
+			for (j = 0; j < 3; ++j) {
+				if (jointInfo->flags & (8 << j))
+					q[j] = frameData[component++];
+			}
+
+			Quat_computeW (q);
+			Quat_normalize (q);
+		}
+	}
+}
+
+/**
+ * How far each joint's rotation can move a skinned vertex: the largest
+ * distance, in the bind pose, from the joint to any vertex weighted to
+ * it or to one of its children.
+ */
+static void ComputeJointReach (const struct md5_model_t *mdl, float *reach) {
+	struct md5_joint_mat_t *jointMats = (struct md5_joint_mat_t *)malloc (sizeof (struct md5_joint_mat_t) * mdl->num_joints);
+	int i, j, k;
+
+	memset (reach, 0, sizeof (float) * mdl->num_joints);
+	BuildJointMatrices (mdl->baseSkel, mdl->num_joints, jointMats);
+
+	for (i = 0; i < mdl->num_meshes; ++i) {
+		const struct md5_mesh_t *mesh = &mdl->meshes[i];
+		vec3_t *verts = (vec3_t *)malloc (sizeof (vec3_t) * (mesh->num_verts + 1));
+
+		SkinMesh (&mesh->skin, jointMats, verts);
+
+		for (j = 0; j < mesh->num_verts; ++j) {
+			for (k = 0; k < mesh->vertices[j].count; ++k) {
+				int joint = mesh->weights[mesh->vertices[j].start + k].joint;
+
+				for (; joint >= 0; joint = mdl->baseSkel[joint].parent) {
+					const float *jointPos = mdl->baseSkel[joint].pos;
+					float dx = verts[j][0] - jointPos[0];
+					float dy = verts[j][1] - jointPos[1];
+					float dz = verts[j][2] - jointPos[2];
+					float dist = sqrtf (dx * dx + dy * dy + dz * dz);
+
+					if (dist > reach[joint])
+						reach[joint] = dist;
+				}
+			}
+		}
+
+		free (verts);
+	}
+
+	free (jointMats);
+}
+
+/**
+ * Error at frame f when rebuilt from the keys at frames a and b, as a
+ * fraction of the allowed error.  a == -1 rebuilds from the base frame.
+ */
+static float FitError (const struct md5_track_fit_t *fit, int a, int b, int f) {
+	const float *value = fit->values + f * fit->stride;
+	float rebuilt[4];
+	int c;
+
+	if (a < 0) {
+		memcpy (rebuilt, fit->base, sizeof (float) * fit->stride);
+	} else if (a == b || a == f) {
+		memcpy (rebuilt, fit->keys + a * fit->stride, sizeof (float) * fit->stride);
+	} else {
+		const float *keyA = fit->keys + a * fit->stride;
+		const float *keyB = fit->keys + b * fit->stride;
+		float interp = (float)(f - a) / (float)(b - a);
+		float scale = interp;
+
+		/* the same nlerp on the shorter arc SampleClip() does */
+		if (fit->stride == 4 && Quat_dotProduct (keyA, keyB) < 0.0f)
+			scale = -interp;
+
+		for (c = 0; c < fit->stride; ++c)
+			rebuilt[c] = keyA[c] * (1.0f - interp) + keyB[c] * scale;
+		if (fit->stride == 4)
+			Quat_normalize (rebuilt);
+	}
+
+	if (fit->stride == 3) {
+		float dx = rebuilt[0] - value[0];
+		float dy = rebuilt[1] - value[1];
+		float dz = rebuilt[2] - value[2];
+
+		/* a translation moves everything below the joint as far */
+		return sqrtf (dx * dx + dy * dy + dz * dz) / fit->maxVertexError;
+	} else {
+		/* acos of the dot product can't resolve small angles in floats,
+		   the chord between the two quaternions can */
+		float sign = Quat_dotProduct (rebuilt, value) < 0.0f ? -1.0f : 1.0f;
+		float chord = 0.0f;
+
+		for (c = 0; c < 4; ++c)
+			chord += (rebuilt[c] - sign * value[c]) * (rebuilt[c] - sign * value[c]);
+		chord = 0.5f * sqrtf (chord);
+
+		float angle = 4.0f * asinf (chord < 1.0f ? chord : 1.0f);
+		float vertexError = 2.0f * sinf (0.5f * angle) * fit->reach;
+		float rotationError = angle / fit->maxRotationError;
+
+		vertexError /= fit->maxVertexError;
+		return vertexError > rotationError ? vertexError : rotationError;
+	}
+}
+
+/**
+ * Pick the keys of one track.  Keeps no key when the base frame is close
+ * enough, one key for a still track, and otherwise adds the worst frame
+ * as a key until every frame is within bounds.  Returns the key count.
+ */
+static int ReduceTrack (const struct md5_track_fit_t *fit, unsigned char *keep) {
+	int last = fit->num_frames - 1;
+	int f, a, b, count;
+
+	memset (keep, 0, fit->num_frames);
+
+	for (f = 0; f <= last && FitError (fit, -1, -1, f) <= 1.0f; ++f)
+		;
+	if (f > last)
+		return 0;
+
+	keep[0] = 1;
+	for (f = 0; f <= last && FitError (fit, 0, 0, f) <= 1.0f; ++f)
+		;
+	if (f > last)
+		return 1;
+
+	keep[last] = 1;
+	for (;;) {
+		float worstError = 1.0f;
+		int worst = -1;
+
+		for (a = 0, b = 1; b <= last; ++b) {
+			if (!keep[b])
+				continue;
+
+			for (f = a + 1; f < b; ++f) {
+				float error = FitError (fit, a, b, f);
+
+				if (error > worstError) {
+					worstError = error;
+					worst = f;
+				}
+			}
+			a = b;
+		}
+
+		if (worst < 0)
+			break;
+		keep[worst] = 1;
+	}
+
+	for (f = 0, count = 0; f <= last; ++f)
+		count += keep[f];
+	return count;
+}
+
+/**
+ * Keep every frame of a track when that takes no more room than its
+ * keys with their frame numbers.  Returns the key count.
+ */
+static int KeepEveryFrameIfSmaller (int count, int num_frames, int keySize, unsigned char *keep) {
+	if (count == 0 || count * (keySize + (int)sizeof (unsigned short)) < num_frames * keySize)
+		return count;
+
+	memset (keep, 1, num_frames);
+	return num_frames;
+}
+
+/**
+ * Largest distance between the vertices skinned from the original frames
+ * and from the compressed clip.
+ */
+static float MeasureClipError (const struct md5_model_t *mdl, const struct md5_anim_data_t *data,
+                               const struct md5_anim_t *clip) {
+	struct md5_joint_t *expected = (struct md5_joint_t *)malloc (sizeof (struct md5_joint_t) * data->num_joints);
+	struct md5_joint_mat_t *expectedMats = (struct md5_joint_mat_t *)malloc (sizeof (struct md5_joint_mat_t) * data->num_joints);
+	struct md5_joint_mat_t *actualMats = (struct md5_joint_mat_t *)malloc (sizeof (struct md5_joint_mat_t) * data->num_joints);
+	struct md5_frame_cache_t cache;
+	float maxError = 0.0f;
+	int maxVerts = 0;
+	int f, i, j;
+
+	for (i = 0; i < mdl->num_meshes; ++i) {
+		if (mdl->meshes[i].num_verts > maxVerts)
+			maxVerts = mdl->meshes[i].num_verts;
+	}
+	vec3_t *expectedVerts = (vec3_t *)malloc (sizeof (vec3_t) * (maxVerts + 1));
+	vec3_t *actualVerts = (vec3_t *)malloc (sizeof (vec3_t) * (maxVerts + 1));
+
+	InitFrameCache (&cache);
+
+	for (f = 0; f < data->num_frames; ++f) {
+		BuildFrameSkeleton (data->jointInfos, data->baseFrame, data->frameData + f * data->numAnimatedComponents,
+		                    expected, data->num_joints);
+		BuildJointMatrices (expected, data->num_joints, expectedMats);
+		BuildJointMatrices (GetAnimFrame (clip, &cache, f), data->num_joints, actualMats);
+
+		for (i = 0; i < mdl->num_meshes; ++i) {
+			const struct md5_mesh_t *mesh = &mdl->meshes[i];
+
+			SkinMesh (&mesh->skin, expectedMats, expectedVerts);
+			SkinMesh (&mesh->skin, actualMats, actualVerts);
+
+			for (j = 0; j < mesh->num_verts; ++j) {
+				float dx = expectedVerts[j][0] - actualVerts[j][0];
+				float dy = expectedVerts[j][1] - actualVerts[j][1];
+				float dz = expectedVerts[j][2] - actualVerts[j][2];
+				float error = sqrtf (dx * dx + dy * dy + dz * dz);
+
+				if (!(error <= maxError))
+					maxError = error;
+			}
+		}
+	}
+
+	FreeFrameCache (&cache);
+	free (expected);
+	free (expectedMats);
+	free (actualMats);
+	free (expectedVerts);
+	free (actualVerts);
+
+	return maxError;
+}
+
+/**
+ * Compress an md5anim for the given model to a keyed clip.  Skinned
+ * vertices stay within maxVertexError model units of the original frames
+ * and no joint turns more than maxRotationError radians from its own.
+ */
+int CompressMD5Anim (const struct md5_model_t *mdl, const char *md5animFile,
+                     const char *clipFile, float maxVertexError, float maxRotationError) {
+	struct md5_anim_data_t data;
+	struct md5_clip_header_t header;
+	int i, f, attempt;
+	int written = 0;
+
+	if (!ReadMD5AnimData (md5animFile, &data))
+		return 0;
+
+	if (data.num_joints != mdl->num_joints || data.num_frames <= 0 || data.num_frames > 65535) {
+		fprintf (stderr, "[.md5anim]: Error: can't compress \"%s\" for a model of %d joints\n", md5animFile, mdl->num_joints);
+		FreeAnimData (&data);
+		return 0;
+	}
+
+	int num_joints = data.num_joints;
+	int num_frames = data.num_frames;
+	vec3_t *pos = (vec3_t *)malloc (sizeof (vec3_t) * num_frames * num_joints);
+	quat4_t *orient = (quat4_t *)malloc (sizeof (quat4_t) * num_frames * num_joints);
+	float *reach = (float *)malloc (sizeof (float) * num_joints);
+
+	BuildLocalTracks (&data, pos, orient);
+	ComputeJointReach (mdl, reach);
+
+	/* per track scratch, and the kept keys of every track */
+	float *trackValues = (float *)malloc (sizeof (quat4_t) * num_frames);
+	float *trackKeys = (float *)malloc (sizeof (quat4_t) * num_frames);
+	unsigned short *trackPacked = (unsigned short *)malloc (sizeof (unsigned short) * 3 * num_frames);
+	unsigned char *keep = (unsigned char *)malloc (num_frames);
+
+	struct md5_clip_track_t *tracks = (struct md5_clip_track_t *)malloc (sizeof (struct md5_clip_track_t) * num_joints);
+	vec3_t *translations = (vec3_t *)malloc (sizeof (vec3_t) * num_frames * num_joints);
+	unsigned short *rotations = (unsigned short *)malloc (sizeof (unsigned short) * 3 * num_frames * num_joints);
+	unsigned short *translationFrames = (unsigned short *)malloc (sizeof (unsigned short) * num_frames * num_joints);
+	unsigned short *rotationFrames = (unsigned short *)malloc (sizeof (unsigned short) * num_frames * num_joints);
+
+	float scale = 1.0f;
+
+	for (attempt = 0; attempt < MD5_COMPRESS_ATTEMPTS; ++attempt) {
+		int numTranslations = 0, numRotations = 0;
+		int numTranslationFrames = 0, numRotationFrames = 0;
+		struct md5_track_fit_t fit;
+
+		fit.num_frames = num_frames;
+		fit.values = trackValues;
+		fit.keys = trackKeys;
+		fit.maxVertexError = maxVertexError * scale;
+		fit.maxRotationError = maxRotationError * scale;
+
+		for (i = 0; i < num_joints; ++i) {
+			const struct joint_info_t *jointInfo = &data.jointInfos[i];
+			struct md5_clip_track_t *track = &tracks[i];
+
+			track->firstTranslation = numTranslations;
+			track->numTranslations = 0;
+			track->firstRotation = numRotations;
+			track->numRotations = 0;
+			fit.reach = reach[i];
+
+			/* Translations keep full precision */
+			if (jointInfo->flags & 7) {
+				for (f = 0; f < num_frames; ++f)
+					memcpy (trackValues + f * 3, pos[f * num_joints + i], sizeof (vec3_t));
+
+				fit.stride = 3;
+				fit.keys = trackValues;
+				fit.base = data.baseFrame[i].pos;
+				track->numTranslations = KeepEveryFrameIfSmaller (ReduceTrack (&fit, keep), num_frames, sizeof (vec3_t), keep);
+
+				for (f = 0; f < num_frames && track->numTranslations > 0; ++f) {
+					if (keep[f]) {
+						memcpy (translations[numTranslations++], trackValues + f * 3, sizeof (vec3_t));
+						if (track->numTranslations < num_frames)
+							translationFrames[numTranslationFrames++] = (unsigned short)f;
+					}
+				}
+			}
+
+			/* Rotations are fitted with the values they unpack to */
+			if (jointInfo->flags & 56) {
+				for (f = 0; f < num_frames; ++f) {
+					memcpy (trackValues + f * 4, orient[f * num_joints + i], sizeof (quat4_t));
+					Quat_packSmallestThree (orient[f * num_joints + i], trackPacked + f * 3);
+					Quat_unpackSmallestThree (trackPacked + f * 3, trackKeys + f * 4);
+				}
+
+				fit.stride = 4;
+				fit.keys = trackKeys;
+				fit.base = data.baseFrame[i].orient;
+				track->numRotations = KeepEveryFrameIfSmaller (ReduceTrack (&fit, keep), num_frames, sizeof (unsigned short) * 3, keep);
+
+				for (f = 0; f < num_frames && track->numRotations > 0; ++f) {
+					if (keep[f]) {
+						memcpy (rotations + numRotations++ * 3, trackPacked + f * 3, sizeof (unsigned short) * 3);
+						if (track->numRotations < num_frames)
+							rotationFrames[numRotationFrames++] = (unsigned short)f;
+					}
+				}
+			}
+		}
+
+		memset (&header, 0, sizeof (struct md5_clip_header_t));
+		memcpy (header.magic, MD5_CLIP_MAGIC, sizeof (MD5_CLIP_MAGIC));
+		header.version = MD5_CLIP_VERSION;
+		header.format = MD5_CLIP_KEYS;
+		header.num_frames = num_frames;
+		header.num_joints = num_joints;
+		header.frameRate = data.frameRate;
+		header.numAnimatedComponents = data.numAnimatedComponents;
+		header.numTranslations = numTranslations;
+		header.numRotations = numRotations;
+
+		header.jointInfosOffset = sizeof (struct md5_clip_header_t);
+		header.baseFrameOffset = header.jointInfosOffset + sizeof (struct joint_info_t) * num_joints;
+		header.bboxesOffset = header.baseFrameOffset + sizeof (struct baseframe_joint_t) * num_joints;
+		header.tracksOffset = header.bboxesOffset + sizeof (struct md5_bbox_t) * num_frames;
+		header.translationsOffset = header.tracksOffset + sizeof (struct md5_clip_track_t) * num_joints;
+		header.rotationsOffset = header.translationsOffset + sizeof (vec3_t) * numTranslations;
+		header.translationFramesOffset = header.rotationsOffset + sizeof (unsigned short) * 3 * numRotations;
+		header.rotationFramesOffset = header.translationFramesOffset + sizeof (unsigned short) * numTranslationFrames;
+		header.size = header.rotationFramesOffset + sizeof (unsigned short) * numRotationFrames;
+
+		FILE *fp = fopen (clipFile, "wb");
+		if (!fp) {
+			fprintf (stderr, "[.md5anim]: Error: couldn't create \"%s\"!\n", clipFile);
+			written = 0;
+			break;
+		}
+
+		written = fwrite (&header, sizeof (struct md5_clip_header_t), 1, fp) == 1
+		       && fwrite (data.jointInfos, sizeof (struct joint_info_t), num_joints, fp) == (size_t)num_joints
+		       && fwrite (data.baseFrame, sizeof (struct baseframe_joint_t), num_joints, fp) == (size_t)num_joints
+		       && fwrite (data.bboxes, sizeof (struct md5_bbox_t), num_frames, fp) == (size_t)num_frames
+		       && fwrite (tracks, sizeof (struct md5_clip_track_t), num_joints, fp) == (size_t)num_joints
+		       && fwrite (translations, sizeof (vec3_t), numTranslations, fp) == (size_t)numTranslations
+		       && fwrite (rotations, sizeof (unsigned short) * 3, numRotations, fp) == (size_t)numRotations
+		       && fwrite (translationFrames, sizeof (unsigned short), numTranslationFrames, fp) == (size_t)numTranslationFrames
+		       && fwrite (rotationFrames, sizeof (unsigned short), numRotationFrames, fp) == (size_t)numRotationFrames;
+
+		if (fclose (fp) != 0 || !written) {
+			fprintf (stderr, "[.md5anim]: Error: couldn't write \"%s\"!\n", clipFile);
+			written = 0;
+			break;
+		}
+
+		/* Check the whole hierarchy at the vertices */
+		struct md5_anim_t clip;
+		float error;
+
+		memset (&clip, 0, sizeof (struct md5_anim_t));
+		if (!ReadMD5Clip (clipFile, &clip)) {
+			written = 0;
+			break;
+		}
+		error = MeasureClipError (mdl, &data, &clip);
+		FreeAnim (&clip);
+
+		printf ("[.md5anim]: kept %d of %d translation and %d of %d rotation keys, %d bytes, max vertex error %g\n",
+		        numTranslations, num_frames * num_joints, numRotations, num_frames * num_joints, header.size, error);
+
+		if (error <= maxVertexError)
+			break;
+
+		if (attempt + 1 == MD5_COMPRESS_ATTEMPTS) {
+			fprintf (stderr, "[.md5anim]: Warning: \"%s\" is still %g from the original, above the %g asked for\n",
+			         clipFile, error, maxVertexError);
+			break;
+		}
+
+		/* Errors of parents and children added up, tighten every track */
+		scale *= 0.9f * maxVertexError / error;
+	}
+
+	free (pos);
+	free (orient);
+	free (reach);
+	free (trackValues);
+	free (trackKeys);
+	free (trackPacked);
+	free (keep);
+	free (tracks);
+	free (translations);
+	free (rotations);
+	free (translationFrames);
+	free (rotationFrames);
+	FreeAnimData (&data);
+
+	return written;
+}
@@ -0,0 +1,617 @@
+/*
+ * md5crowd.c -- md5mesh model loader + animation
+ *
+ * Many instances of one model and one animation.  Every instance keeps
+ * its own animation time, speed and blend.  Each frame the skeletons are
+ * evaluated and skinned in parallel on a small work-stealing pool, and
+ * the results are written into one vertex array for the whole crowd.
+ * Which instances are skinned each frame is up to md5lod.cpp.
+ * Dependencies: md5model.h, md5mesh.cpp, md5anim.cpp, md5clip.cpp,
+ * md5pose.cpp, md5skin.cpp, md5lod.cpp.
+ *
+ */
+
+#include <GL/glew.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+#include "MD5/md5model.h"
+
+/* Worker of the pool, with its own task queue and scratch skeleton */
+struct md5_crowd_worker_t
+{
+    std::mutex lock;
+    std::deque<int> tasks; /* instance indices */
+
+    std::vector<md5_joint_t> animSkel;
+    std::vector<md5_joint_t> skeleton;
+    std::vector<md5_joint_mat_t> jointMats;
+    md5_frame_cache_t frameCache; /* decoded frames of a compiled clip */
+
+    std::thread thread;
+};
+
+/* Work-stealing pool.  Worker 0 is the thread that calls UpdateCrowd() */
+struct md5_crowd_pool_t
+{
+    std::vector<md5_crowd_worker_t *> workers;
+
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable done;
+    unsigned int generation = 0;
+    bool quit = false;
+
+    std::atomic<int> remaining;
+
+    struct md5_crowd_t *crowd = nullptr;
+};
+
+/**
+ * t of the way from one array of coordinates to another.
+ */
+static void LerpCoords (const float *from, const float *to, float t, float *out, int count) {
+	int i;
+
+	for (i = 0; i < count; ++i)
+		out[i] = from[i] + t * (to[i] - from[i]);
+}
+
+/**
+ * Write an instance's drawn vertices, sinceSkinned / interval of the way
+ * from the pose before its last skinning to the last one.
+ */
+static void BlendInstance (struct md5_crowd_t *crowd, int index) {
+	const struct md5_model_t *mdl = crowd->mdl;
+	const struct md5_instance_t *inst = &crowd->instances[index];
+	const vec3_t *lastVertices = crowd->poseVertices[inst->pose], *lastNormals = crowd->poseNormals[inst->pose];
+	const vec3_t *prevVertices = crowd->poseVertices[1 - inst->pose], *prevNormals = crowd->poseNormals[1 - inst->pose];
+	float t = (inst->interval > 1 && inst->sinceSkinned < inst->interval) ? (float)inst->sinceSkinned / inst->interval : 1.0f;
+	int normals = crowd->normals != MD5_NORMALS_NONE && lastNormals;
+	int i;
+
+	for (i = 0; i < mdl->num_meshes; ++i) {
+		int first = crowd->meshFirstVertex[i] + index * mdl->meshes[i].num_verts;
+		int count = mdl->meshes[i].num_verts;
+
+		if (t >= 1.0f) {
+			memcpy (crowd->vertexArray + first, lastVertices + first, sizeof (vec3_t) * count);
+			if (normals)
+				memcpy (crowd->normalArray + first, lastNormals + first, sizeof (vec3_t) * count);
+			continue;
+		}
+
+		LerpCoords (prevVertices[first], lastVertices[first], t, crowd->vertexArray[first], count * 3);
+
+		/* left unnormalized, the shaders normalize what they are given */
+		if (normals)
+			LerpCoords (prevNormals[first], lastNormals[first], t, crowd->normalArray[first], count * 3);
+	}
+}
+
+/**
+ * Pose one instance at its current time and skin it into the crowd
+ * vertex array, or into its pose array and blend from there when the
+ * crowd runs below full rate.
+ */
+static void UpdateInstance (struct md5_crowd_t *crowd, struct md5_crowd_worker_t *worker, int index) {
+	const struct md5_model_t *mdl = crowd->mdl;
+	const struct md5_anim_t *anim = crowd->anim;
+	struct md5_instance_t *inst = &crowd->instances[index];
+	const struct md5_joint_t *skeleton = mdl->baseSkel;
+	vec3_t *vertices = crowd->poseVertices[0] ? crowd->poseVertices[inst->pose] : crowd->vertexArray;
+	vec3_t *normals = crowd->poseVertices[0] ? crowd->poseNormals[inst->pose] : crowd->normalArray;
+	int i;
+
+	if (anim && inst->blend > 0.0f) {
+		SampleAnim (anim, &worker->frameCache, GetAnimTime (&inst->animInfo), &worker->animSkel[0]);
+		skeleton = &worker->animSkel[0];
+
+		/* Partly blended back to the bind pose */
+		if (inst->blend < 1.0f) {
+			InterpolateSkeletons (mdl->baseSkel, skeleton, mdl->num_joints, inst->blend, &worker->skeleton[0]);
+			skeleton = &worker->skeleton[0];
+		}
+	}
+
+	BuildJointMatrices (skeleton, mdl->num_joints, &worker->jointMats[0]);
+
+	/* Move the whole instance by offsetting every joint */
+	for (i = 0; i < mdl->num_joints; ++i) {
+		worker->jointMats[i].col[3][0] += inst->pos[0];
+		worker->jointMats[i].col[3][1] += inst->pos[1];
+		worker->jointMats[i].col[3][2] += inst->pos[2];
+	}
+
+	for (i = 0; i < mdl->num_meshes; ++i) {
+		const struct md5_mesh_t *mesh = &mdl->meshes[i];
+		const struct md5_skin_t *skin = inst->reduced ? &crowd->reducedSkins[i] : &mesh->skin;
+		int first = crowd->meshFirstVertex[i] + index * mesh->num_verts;
+
+		switch (crowd->normals) {
+			case MD5_NORMALS_SKINNED:
+				SkinMeshNormals (skin, &worker->jointMats[0], vertices + first, normals + first, nullptr);
+				break;
+
+			case MD5_NORMALS_RECOMPUTED:
+				SkinMesh (skin, &worker->jointMats[0], vertices + first);
+				RecomputeNormals (mesh, vertices + first, normals + first, nullptr);
+				break;
+
+			default:
+				SkinMesh (skin, &worker->jointMats[0], vertices + first);
+				break;
+		}
+	}
+
+	if (crowd->poseVertices[0])
+		BlendInstance (crowd, index);
+}
+
+/**
+ * Take the next instance from our own queue, or steal one from the front
+ * of another worker's queue once ours is empty.
+ */
+static bool NextCrowdTask (struct md5_crowd_pool_t *pool, int self, int *index) {
+	int n = (int)pool->workers.size();
+	int i;
+
+	for (i = 0; i < n; ++i) {
+		struct md5_crowd_worker_t *victim = pool->workers[(self + i) % n];
+		std::lock_guard<std::mutex> guard (victim->lock);
+
+		if (!victim->tasks.empty ()) {
+			if (i == 0) {
+				*index = victim->tasks.back ();
+				victim->tasks.pop_back ();
+			} else {
+				*index = victim->tasks.front ();
+				victim->tasks.pop_front ();
+			}
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void RunCrowdTasks (struct md5_crowd_pool_t *pool, int self) {
+	struct md5_crowd_worker_t *worker = pool->workers[self];
+	int index;
+
+	while (NextCrowdTask (pool, self, &index)) {
+		if (index < 0)
+			BlendInstance (pool->crowd, -1 - index);
+		else
+			UpdateInstance (pool->crowd, worker, index);
+
+		if (pool->remaining.fetch_sub (1) == 1) {
+			std::lock_guard<std::mutex> guard (pool->lock);
+			pool->done.notify_one ();
+		}
+	}
+}
+
+static void CrowdWorkerLoop (struct md5_crowd_pool_t *pool, int self) {
+	unsigned int seen = 0;
+
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> guard (pool->lock);
+			pool->wake.wait (guard, [&] { return pool->quit || pool->generation != seen; });
+
+			if (pool->quit)
+				return;
+			seen = pool->generation;
+		}
+
+		RunCrowdTasks (pool, self);
+	}
+}
+
+static void StopCrowdPool (struct md5_crowd_t *crowd) {
+	struct md5_crowd_pool_t *pool = crowd->pool;
+	size_t i;
+
+	if (!pool)
+		return;
+
+	{
+		std::lock_guard<std::mutex> guard (pool->lock);
+		pool->quit = true;
+	}
+	pool->wake.notify_all ();
+
+	/* every helper has to be gone before any queue is freed, they steal */
+	for (i = 0; i < pool->workers.size (); ++i) {
+		if (pool->workers[i]->thread.joinable ())
+			pool->workers[i]->thread.join ();
+	}
+
+	for (i = 0; i < pool->workers.size (); ++i) {
+		FreeFrameCache (&pool->workers[i]->frameCache);
+		delete pool->workers[i];
+	}
+
+	delete pool;
+	crowd->pool = nullptr;
+}
+
+/**
+ * Use num_threads threads to update the crowd, including the caller.
+ * 0 uses one per hardware thread.
+ */
+void SetCrowdThreads (struct md5_crowd_t *crowd, int num_threads) {
+	struct md5_crowd_pool_t *pool;
+	int i;
+
+	if (num_threads <= 0)
+		num_threads = (int)std::thread::hardware_concurrency ();
+	if (num_threads <= 0)
+		num_threads = 1;
+
+	if (crowd->pool && (int)crowd->pool->workers.size () == num_threads)
+		return;
+
+	StopCrowdPool (crowd);
+
+	pool = new md5_crowd_pool_t;
+	pool->remaining = 0;
+	pool->crowd = crowd;
+
+	for (i = 0; i < num_threads; ++i) {
+		struct md5_crowd_worker_t *worker = new md5_crowd_worker_t;
+		worker->animSkel.resize (crowd->mdl->num_joints);
+		worker->skeleton.resize (crowd->mdl->num_joints);
+		worker->jointMats.resize (crowd->mdl->num_joints);
+		InitFrameCache (&worker->frameCache);
+		pool->workers.push_back (worker);
+	}
+
+	/* start the helpers once every worker exists, they may steal from any of them */
+	for (i = 1; i < num_threads; ++i)
+		pool->workers[i]->thread = std::thread (CrowdWorkerLoop, pool, i);
+
+	crowd->pool = pool;
+}
+
+int GetCrowdThreads (const struct md5_crowd_t *crowd) {
+	return crowd->pool ? (int)crowd->pool->workers.size () : 0;
+}
+
+/**
+ * Set up num_instances copies of a model on a square grid, spacing
+ * units apart.  anim may be null to keep every instance in its bind pose.
+ */
+int InitCrowd (struct md5_crowd_t *crowd, const struct md5_model_t *mdl,
+               const struct md5_anim_t *anim, int num_instances, float spacing) {
+	int side = (int)ceil (sqrt ((double)num_instances));
+	int i, numIndices = 0;
+
+	memset (crowd, 0, sizeof (struct md5_crowd_t));
+
+	if (num_instances <= 0) {
+		fprintf (stderr, "[.md5crowd]: Error: a crowd needs at least one instance\n");
+		return 0;
+	}
+
+	if (anim && !CheckAnimValidity (mdl, anim))
+		anim = nullptr;
+
+	crowd->mdl = mdl;
+	crowd->anim = anim;
+	crowd->num_instances = num_instances;
+
+	crowd->instances = (struct md5_instance_t *)
+			calloc (num_instances, sizeof (struct md5_instance_t));
+
+	for (i = 0; i < num_instances; ++i) {
+		struct md5_instance_t *inst = &crowd->instances[i];
+
+		/* Spread the instances over the clip and vary their speed so they do not march in step */
+		if (anim) {
+			inst->animInfo.curr_frame = (i * 7) % anim->num_frames;
+			inst->animInfo.next_frame = (inst->animInfo.curr_frame + 1) % anim->num_frames;
+			inst->animInfo.last_time = 0.0;
+			inst->animInfo.max_time = 1.0 / anim->frameRate;
+		}
+		inst->speed = 0.75f + 0.5f * ((i * 37) % 100) / 100.0f;
+		inst->blend = 1.0f;
+
+		/* Grid centered on the origin, MD5 models stand on the XY plane */
+		inst->pos[0] = ((i % side) - (side - 1) * 0.5f) * spacing;
+		inst->pos[1] = ((i / side) - (side - 1) * 0.5f) * spacing;
+		inst->pos[2] = 0.0f;
+	}
+
+	crowd->meshFirstVertex = (int *)malloc (sizeof (int) * mdl->num_meshes);
+	crowd->meshFirstIndex = (int *)malloc (sizeof (int) * mdl->num_meshes);
+
+	for (i = 0; i < mdl->num_meshes; ++i) {
+		crowd->meshFirstVertex[i] = crowd->num_verts;
+		crowd->meshFirstIndex[i] = numIndices;
+
+		crowd->num_verts += mdl->meshes[i].num_verts * num_instances;
+		numIndices += mdl->meshes[i].num_tris * 3 * num_instances;
+	}
+
+	crowd->vertexArray = (vec3_t *)calloc (crowd->num_verts, sizeof (vec3_t));
+
+	crowd->tasks = (int *)malloc (sizeof (int) * num_instances);
+	for (i = 0; i < mdl->num_meshes; ++i)
+		crowd->fullWeights += mdl->meshes[i].skin.num_weights;
+
+	SetCrowdThreads (crowd, 1);
+
+	printf ("[.md5crowd]: %d instances, %d vertices and %d triangles in total\n",
+			num_instances, crowd->num_verts, numIndices / 3);
+
+	return 1;
+}
+
+/**
+ * Free resources allocated for the crowd.
+ */
+void FreeCrowd (struct md5_crowd_t *crowd) {
+	int i;
+
+	StopCrowdPool (crowd);
+
+	free (crowd->instances);
+	free (crowd->vertexArray);
+	free (crowd->normalArray);
+	for (i = 0; i < 2; ++i) {
+		free (crowd->poseVertices[i]);
+		free (crowd->poseNormals[i]);
+		crowd->poseVertices[i] = crowd->poseNormals[i] = nullptr;
+	}
+	free (crowd->meshFirstVertex);
+	free (crowd->meshFirstIndex);
+	free (crowd->tasks);
+
+	if (crowd->reducedSkins) {
+		for (i = 0; i < crowd->mdl->num_meshes; ++i)
+			FreeMeshSkin (&crowd->reducedSkins[i]);
+		free (crowd->reducedSkins);
+	}
+
+	crowd->instances = nullptr;
+	crowd->vertexArray = nullptr;
+	crowd->normalArray = nullptr;
+	crowd->meshFirstVertex = nullptr;
+	crowd->meshFirstIndex = nullptr;
+	crowd->tasks = nullptr;
+	crowd->reducedSkins = nullptr;
+	crowd->num_instances = 0;
+	crowd->num_verts = 0;
+}
+
+/**
+ * Simulate the crowd hz times a second whatever the frame rate, 0 to
+ * simulate on every UpdateCrowd().
+ */
+void SetCrowdRate (struct md5_crowd_t *crowd, double hz) {
+	crowd->step = (hz > 0.0) ? 1.0 / hz : 0.0;
+	crowd->pending = 0.0;
+}
+
+/**
+ * Pick where the crowd's normals come from.  Skinned normals ride along
+ * in the skinning loop, recomputed ones are rebuilt from each instance's
+ * triangles by the worker that skinned it.  Instances pick the change up
+ * the next time they are skinned.
+ */
+void SetCrowdNormals (struct md5_crowd_t *crowd, int normals) {
+	int i;
+
+	if (normals != MD5_NORMALS_NONE && !crowd->normalArray)
+		crowd->normalArray = (vec3_t *)calloc (crowd->num_verts, sizeof (vec3_t));
+
+	for (i = 0; i < 2; ++i) {
+		if (normals != MD5_NORMALS_NONE && crowd->poseVertices[i] && !crowd->poseNormals[i])
+			crowd->poseNormals[i] = (vec3_t *)calloc (crowd->num_verts, sizeof (vec3_t));
+	}
+
+	/* the ring needs room for the normals too */
+	if (normals != MD5_NORMALS_NONE && crowd->normals == MD5_NORMALS_NONE && crowd->stream) {
+		FreeStream (crowd->stream);
+		crowd->stream = AllocStream (sizeof (vec3_t) * crowd->num_verts * 2);
+	}
+
+	crowd->normals = normals;
+}
+
+/**
+ * Animate every instance, skin those ScheduleCrowd() picks and blend
+ * those it lists between skinnings.  They are dealt out to the workers
+ * in contiguous runs, idle workers then steal what is left.
+ * With a fixed rate, dt is banked until a step is due and the steps
+ * due are simulated at once.  Returns 1 when the vertices changed.
+ */
+int UpdateCrowd (struct md5_crowd_t *crowd, double dt) {
+	struct md5_crowd_pool_t *pool = crowd->pool;
+	int n = (int)pool->workers.size ();
+	int w, i, numTasks;
+
+	if (crowd->step > 0.0) {
+		double steps;
+
+		crowd->pending += dt;
+		if (crowd->pending < crowd->step)
+			return 0;
+
+		steps = floor (crowd->pending / crowd->step);
+		crowd->pending -= steps * crowd->step;
+		dt = steps * crowd->step;
+	}
+
+	ScheduleCrowd (crowd, dt);
+	numTasks = crowd->num_tasks + crowd->num_blends;
+	if (numTasks == 0)
+		return 0;
+
+	/* set before any task is queued, a helper still finishing the last
+	   frame may pick up one of these right away */
+	pool->remaining = numTasks;
+
+	for (w = 0; w < n; ++w) {
+		std::lock_guard<std::mutex> guard (pool->workers[w]->lock);
+		for (i = w * numTasks / n; i < (w + 1) * numTasks / n; ++i)
+			pool->workers[w]->tasks.push_back (crowd->tasks[i]);
+	}
+
+	{
+		std::lock_guard<std::mutex> guard (pool->lock);
+		pool->generation++;
+	}
+	pool->wake.notify_all ();
+
+	RunCrowdTasks (pool, 0);
+
+	std::unique_lock<std::mutex> guard (pool->lock);
+	pool->done.wait (guard, [&] { return pool->remaining.load () == 0; });
+
+	return 1;
+}
+
+/**
+ * Create the buffers for the crowd.  Texture coordinates and indices
+ * never change and are sent once, positions and any normals are
+ * streamed every frame.
+ */
+void AllocCrowdArrays (struct md5_crowd_t *crowd, unsigned int vPosAttribLoc, unsigned int vTexCoordAttribLoc,
+                       unsigned int vNormalAttribLoc) {
+	const struct md5_model_t *mdl = crowd->mdl;
+	vec2_t *texels = (vec2_t *)malloc (sizeof (vec2_t) * crowd->num_verts);
+	GLuint *indices;
+	int numIndices = 0;
+	int i, m, v, t, k;
+
+	for (m = 0; m < mdl->num_meshes; ++m)
+		numIndices += mdl->meshes[m].num_tris * 3 * crowd->num_instances;
+	indices = (GLuint *)malloc (sizeof (GLuint) * numIndices);
+
+	for (m = 0; m < mdl->num_meshes; ++m) {
+		const struct md5_mesh_t *mesh = &mdl->meshes[m];
+
+		for (i = 0; i < crowd->num_instances; ++i) {
+			int firstVertex = crowd->meshFirstVertex[m] + i * mesh->num_verts;
+			GLuint *out = indices + crowd->meshFirstIndex[m] + i * mesh->num_tris * 3;
+
+			for (v = 0; v < mesh->num_verts; ++v) {
+				texels[firstVertex + v][0] = mesh->vertices[v].st[0];
+				texels[firstVertex + v][1] = mesh->vertices[v].st[1];
+			}
+
+			for (k = 0, t = 0; t < mesh->num_tris; ++t) {
+				out[k++] = firstVertex + mesh->triangles[t].index[0];
+				out[k++] = firstVertex + mesh->triangles[t].index[1];
+				out[k++] = firstVertex + mesh->triangles[t].index[2];
+			}
+		}
+	}
+
+	glGenVertexArrays (1, &crowd->vao);
+	glBindVertexArray (crowd->vao);
+
+	/* positions are pointed at this frame's region of the ring when drawn,
+	   the normals after them */
+	crowd->stream = AllocStream (sizeof (vec3_t) * crowd->num_verts * (crowd->normals != MD5_NORMALS_NONE ? 2 : 1));
+	crowd->posAttribLoc = vPosAttribLoc;
+	crowd->normalAttribLoc = vNormalAttribLoc;
+	glEnableVertexAttribArray (vPosAttribLoc);
+	glVertexAttribPointer (vPosAttribLoc, 3, GL_FLOAT, GL_FALSE, 0, (void *)0);
+
+	glGenBuffers (1, &crowd->texVBO);
+	glBindBuffer (GL_ARRAY_BUFFER, crowd->texVBO);
+	glBufferData (GL_ARRAY_BUFFER, sizeof (vec2_t) * crowd->num_verts, texels, GL_STATIC_DRAW);
+	glEnableVertexAttribArray (vTexCoordAttribLoc);
+	glVertexAttribPointer (vTexCoordAttribLoc, 2, GL_FLOAT, GL_FALSE, 0, (void *)0);
+
+	glGenBuffers (1, &crowd->ibo);
+	glBindBuffer (GL_ELEMENT_ARRAY_BUFFER, crowd->ibo);
+	glBufferData (GL_ELEMENT_ARRAY_BUFFER, sizeof (GLuint) * numIndices, indices, GL_STATIC_DRAW);
+
+	/* at most one run per instance */
+	crowd->drawCounts = (int *)malloc (sizeof (int) * crowd->num_instances);
+	crowd->drawOffsets = (const void **)malloc (sizeof (void *) * crowd->num_instances);
+
+	free (texels);
+	free (indices);
+}
+
+void FreeCrowdArrays (struct md5_crowd_t *crowd) {
+	glDeleteVertexArrays (1, &crowd->vao);
+	glDeleteBuffers (1, &crowd->texVBO);
+	glDeleteBuffers (1, &crowd->ibo);
+	FreeStream (crowd->stream);
+	free (crowd->drawCounts);
+	free (crowd->drawOffsets);
+
+	crowd->vao = crowd->texVBO = crowd->ibo = 0;
+	crowd->stream = nullptr;
+	crowd->drawCounts = nullptr;
+	crowd->drawOffsets = nullptr;
+}
+
+/**
+ * Send this frame's positions and any normals, and draw every skinned
+ * instance in view, one draw per mesh.  Runs of visible instances are
+ * drawn together.
+ */
+void DrawCrowd (const struct md5_crowd_t *crowd) {
+	const struct md5_model_t *mdl = crowd->mdl;
+	unsigned long offset;
+	int m, i, numRuns;
+
+	glBindVertexArray (crowd->vao);
+
+	offset = StreamWrite (crowd->stream, 0, crowd->vertexArray, sizeof (vec3_t) * crowd->num_verts);
+	glVertexAttribPointer (crowd->posAttribLoc, 3, GL_FLOAT, GL_FALSE, 0, (void *)offset);
+
+	/* without normals the attribute reads as zero, which draws unlit */
+	if (crowd->normals != MD5_NORMALS_NONE) {
+		offset = StreamWrite (crowd->stream, sizeof (vec3_t) * crowd->num_verts, crowd->normalArray,
+		                      sizeof (vec3_t) * crowd->num_verts);
+		glEnableVertexAttribArray (crowd->normalAttribLoc);
+		glVertexAttribPointer (crowd->normalAttribLoc, 3, GL_FLOAT, GL_FALSE, 0, (void *)offset);
+	} else {
+		glDisableVertexAttribArray (crowd->normalAttribLoc);
+	}
+
+	for (m = 0; m < mdl->num_meshes; ++m) {
+		int instanceIndices = mdl->meshes[m].num_tris * 3;
+
+		for (numRuns = 0, i = 0; i < crowd->num_instances; ++i) {
+			const struct md5_instance_t *inst = &crowd->instances[i];
+
+			if (inst->culled || !inst->skinned)
+				continue;
+
+			if (i > 0 && numRuns > 0 && !crowd->instances[i - 1].culled && crowd->instances[i - 1].skinned) {
+				crowd->drawCounts[numRuns - 1] += instanceIndices;
+			} else {
+				crowd->drawCounts[numRuns] = instanceIndices;
+				crowd->drawOffsets[numRuns] = (const void *)(sizeof (GLuint) * (crowd->meshFirstIndex[m] + i * instanceIndices));
+				numRuns++;
+			}
+		}
+
+		if (numRuns > 0) {
+			glBindTexture (GL_TEXTURE_2D, mdl->meshes[m].textures[0].texHandle);
+			glMultiDrawElements (GL_TRIANGLES, crowd->drawCounts, GL_UNSIGNED_INT, crowd->drawOffsets, numRuns);
+		}
+	}
+
+	EndStreamFrame (crowd->stream);
+}
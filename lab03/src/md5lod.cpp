@@ -0,0 +1,406 @@
+/*
+ * md5lod.c -- md5mesh model loader + animation
+ *
+ * Animation level of detail for crowds.  Before every update each
+ * instance is culled against the view by its animation's bounding box,
+ * and the visible ones are given an update rate and joint set by their
+ * distance from the eye.  Instances due an update are skinned, most
+ * overdue and nearest first, until the weight budget is spent.  Time
+ * keeps moving for every instance, so one skinned every 8th update
+ * still lands on the right pose.  Left alone, an instance holds its
+ * last pose until it is skinned again and then jumps ahead.  With
+ * blendPoses set it is drawn blended from the pose before its last
+ * skinning to the last one instead, reaching it as the next skinning is
+ * due.  It then trails its animation by one interval but moves on every
+ * update, at the cost of reading two poses and writing the drawn one.
+ * Dependencies: md5model.h, md5anim.cpp, md5skin.cpp.
+ *
+ */
+
+#include <algorithm>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+#include "MD5/md5model.h"
+
+/**
+ * Fold every joint that moves no vertex of its subtree reach units or
+ * more into its nearest kept ancestor.  Returns the joints kept.
+ */
+static int ReduceJoints (const struct md5_model_t *mdl, float reach, int *jointMap) {
+	struct md5_joint_mat_t *jointMats = (struct md5_joint_mat_t *)
+			malloc (sizeof (struct md5_joint_mat_t) * mdl->num_joints);
+	float *jointReach = (float *)calloc (mdl->num_joints, sizeof (float));
+	int i, j, k, m, kept = 0;
+
+	BuildJointMatrices (mdl->baseSkel, mdl->num_joints, jointMats);
+
+	/* how far each joint is from the bind pose vertices it or its children move */
+	for (m = 0; m < mdl->num_meshes; ++m) {
+		const struct md5_skin_t *skin = &mdl->meshes[m].skin;
+		vec3_t *verts = (vec3_t *)malloc (sizeof (vec3_t) * (skin->num_verts > 0 ? skin->num_verts : 1));
+
+		SkinMesh (skin, jointMats, verts);
+
+		for (i = 0; i < skin->num_verts; ++i) {
+			for (k = skin->start[i]; k < skin->start[i] + skin->count[i]; ++k) {
+				for (j = skin->joint[k]; j >= 0; j = mdl->baseSkel[j].parent) {
+					const float *pos = mdl->baseSkel[j].pos;
+					float dx = verts[i][0] - pos[0], dy = verts[i][1] - pos[1], dz = verts[i][2] - pos[2];
+					float d = sqrtf (dx * dx + dy * dy + dz * dz);
+
+					if (d > jointReach[j])
+						jointReach[j] = d;
+				}
+			}
+		}
+
+		free (verts);
+	}
+
+	/* parents come before their children */
+	for (j = 0; j < mdl->num_joints; ++j) {
+		int parent = mdl->baseSkel[j].parent;
+
+		if (parent < 0 || jointReach[j] >= reach) {
+			jointMap[j] = j;
+			kept++;
+		} else {
+			jointMap[j] = jointMap[parent];
+		}
+	}
+
+	free (jointReach);
+	free (jointMats);
+
+	return kept;
+}
+
+static void FreeReducedSkins (struct md5_crowd_t *crowd) {
+	int m;
+
+	if (!crowd->reducedSkins)
+		return;
+
+	for (m = 0; m < crowd->mdl->num_meshes; ++m)
+		FreeMeshSkin (&crowd->reducedSkins[m]);
+
+	free (crowd->reducedSkins);
+	crowd->reducedSkins = nullptr;
+	crowd->reducedWeights = 0;
+}
+
+/**
+ * The two pose arrays instances below full rate are blended between, or
+ * none when every instance is skinned on every update.  Instances are
+ * skinned afresh so neither array holds a stale pose.
+ */
+static void SetPoseArrays (struct md5_crowd_t *crowd, int blended) {
+	int i;
+
+	if (blended == (crowd->poseVertices[0] != nullptr))
+		return;
+
+	for (i = 0; i < 2; ++i) {
+		free (crowd->poseVertices[i]);
+		free (crowd->poseNormals[i]);
+		crowd->poseVertices[i] = crowd->poseNormals[i] = nullptr;
+
+		if (blended) {
+			crowd->poseVertices[i] = (vec3_t *)calloc (crowd->num_verts, sizeof (vec3_t));
+			if (crowd->normals != MD5_NORMALS_NONE)
+				crowd->poseNormals[i] = (vec3_t *)calloc (crowd->num_verts, sizeof (vec3_t));
+		}
+	}
+
+	for (i = 0; i < crowd->num_instances; ++i)
+		crowd->instances[i].skinned = 0;
+}
+
+/**
+ * Set the crowd's animation LOD.  The reduced joint set is built here
+ * when a reduced distance and reach are given, and the pose arrays
+ * when poses are blended and any rate distance is given.
+ */
+void SetCrowdLOD (struct md5_crowd_t *crowd, const struct md5_crowd_lod_t *lod) {
+	const struct md5_model_t *mdl = crowd->mdl;
+	int m;
+
+	crowd->lod = *lod;
+	FreeReducedSkins (crowd);
+	SetPoseArrays (crowd, lod->blendPoses && lod->rateDistance[0] > 0.0f);
+
+	if (lod->reducedDistance > 0.0f && lod->reducedReach > 0.0f) {
+		int *jointMap = (int *)malloc (sizeof (int) * mdl->num_joints);
+		int kept = ReduceJoints (mdl, lod->reducedReach, jointMap);
+
+		crowd->reducedSkins = (struct md5_skin_t *)calloc (mdl->num_meshes, sizeof (struct md5_skin_t));
+		for (m = 0; m < mdl->num_meshes; ++m) {
+			BuildReducedMeshSkin (&mdl->meshes[m], mdl->baseSkel, jointMap, &crowd->reducedSkins[m]);
+			crowd->reducedWeights += crowd->reducedSkins[m].num_weights;
+		}
+
+		printf ("[.md5crowd]: distant instances skin %d of %d joints, %d of %d weights\n",
+				kept, mdl->num_joints, crowd->reducedWeights, crowd->fullWeights);
+
+		free (jointMap);
+	}
+}
+
+/**
+ * Bounds of the model in its bind pose, for instances not animated.
+ */
+static void ComputeBindBounds (struct md5_crowd_t *crowd) {
+	const struct md5_model_t *mdl = crowd->mdl;
+	struct md5_joint_mat_t *jointMats = (struct md5_joint_mat_t *)
+			malloc (sizeof (struct md5_joint_mat_t) * mdl->num_joints);
+	struct md5_bbox_t *box = &crowd->bindBounds;
+	int i, m, c;
+
+	BuildJointMatrices (mdl->baseSkel, mdl->num_joints, jointMats);
+
+	for (c = 0; c < 3; ++c) {
+		box->min[c] =  1e30f;
+		box->max[c] = -1e30f;
+	}
+
+	for (m = 0; m < mdl->num_meshes; ++m) {
+		const struct md5_skin_t *skin = &mdl->meshes[m].skin;
+		vec3_t *verts = (vec3_t *)malloc (sizeof (vec3_t) * (skin->num_verts > 0 ? skin->num_verts : 1));
+
+		SkinMesh (skin, jointMats, verts);
+
+		for (i = 0; i < skin->num_verts; ++i) {
+			for (c = 0; c < 3; ++c) {
+				if (verts[i][c] < box->min[c]) box->min[c] = verts[i][c];
+				if (verts[i][c] > box->max[c]) box->max[c] = verts[i][c];
+			}
+		}
+
+		free (verts);
+	}
+
+	free (jointMats);
+}
+
+/**
+ * View the crowd is drawn with, as the matrix taking the crowd's model
+ * space to clip space, column major, and the eye in model space.  Until
+ * a view is set nothing is culled and every instance runs at full rate.
+ */
+void SetCrowdView (struct md5_crowd_t *crowd, const float modelViewProjection[16], const vec3_t eye) {
+	const float *m = modelViewProjection;
+	int p, c;
+
+	if (!crowd->hasView)
+		ComputeBindBounds (crowd);
+
+	/* each plane is the last row of the matrix plus or minus another row */
+	for (p = 0; p < 6; ++p) {
+		int row = p / 2;
+		float sign = (p & 1) ? -1.0f : 1.0f;
+		float len;
+
+		for (c = 0; c < 4; ++c)
+			crowd->frustum[p][c] = m[c * 4 + 3] + sign * m[c * 4 + row];
+
+		len = sqrtf (crowd->frustum[p][0] * crowd->frustum[p][0] +
+		             crowd->frustum[p][1] * crowd->frustum[p][1] +
+		             crowd->frustum[p][2] * crowd->frustum[p][2]);
+		if (len > 0.0f)
+			for (c = 0; c < 4; ++c)
+				crowd->frustum[p][c] /= len;
+	}
+
+	memcpy (crowd->eye, eye, sizeof (vec3_t));
+	crowd->hasView = 1;
+}
+
+const struct md5_crowd_stats_t *GetCrowdStats (const struct md5_crowd_t *crowd) {
+	return &crowd->stats;
+}
+
+/**
+ * Whether any of a box is inside the frustum.  Boxes near a corner may
+ * pass without being seen, which only costs a skinning.
+ */
+static int BoxInFrustum (const float frustum[6][4], const vec3_t min, const vec3_t max) {
+	int p;
+
+	for (p = 0; p < 6; ++p) {
+		const float *plane = frustum[p];
+
+		/* the corner furthest along the plane's normal */
+		float d = plane[0] * (plane[0] > 0.0f ? max[0] : min[0])
+		        + plane[1] * (plane[1] > 0.0f ? max[1] : min[1])
+		        + plane[2] * (plane[2] > 0.0f ? max[2] : min[2]) + plane[3];
+
+		if (d < 0.0f)
+			return 0;
+	}
+
+	return 1;
+}
+
+/**
+ * Instance bounds in model space: the animation's bounding box for its
+ * current frame, grown to the bind pose's while it is blended towards it.
+ */
+static void InstanceBounds (const struct md5_crowd_t *crowd, const struct md5_instance_t *inst,
+                            vec3_t min, vec3_t max) {
+	const struct md5_anim_t *anim = crowd->anim;
+	const struct md5_bbox_t *bind = &crowd->bindBounds;
+	int c;
+
+	if (anim && anim->bboxes && inst->blend > 0.0f) {
+		const struct md5_bbox_t *box = &anim->bboxes[inst->animInfo.curr_frame];
+
+		for (c = 0; c < 3; ++c) {
+			min[c] = box->min[c];
+			max[c] = box->max[c];
+
+			if (inst->blend < 1.0f) {
+				if (bind->min[c] < min[c]) min[c] = bind->min[c];
+				if (bind->max[c] > max[c]) max[c] = bind->max[c];
+			}
+		}
+	} else {
+		memcpy (min, bind->min, sizeof (vec3_t));
+		memcpy (max, bind->max, sizeof (vec3_t));
+	}
+
+	for (c = 0; c < 3; ++c) {
+		min[c] += inst->pos[c];
+		max[c] += inst->pos[c];
+	}
+}
+
+/* Orders due instances: never skinned, then most overdue, then nearest */
+struct md5_task_order_t
+{
+    const struct md5_instance_t *instances;
+
+    bool operator() (int a, int b) const {
+        const struct md5_instance_t *ia = &instances[a], *ib = &instances[b];
+        float overdueA = (float)ia->sinceUpdate / (1 << ia->rate);
+        float overdueB = (float)ib->sinceUpdate / (1 << ib->rate);
+
+        if (ia->skinned != ib->skinned)
+            return !ia->skinned;
+        if (overdueA != overdueB)
+            return overdueA > overdueB;
+        return ia->distance < ib->distance;
+    }
+};
+
+/**
+ * Advance every instance by dt, cull it and pick its rate, then list the
+ * instances to skin this update in crowd->tasks, followed by those to
+ * blend between their last two poses.
+ */
+void ScheduleCrowd (struct md5_crowd_t *crowd, double dt) {
+	const struct md5_anim_t *anim = crowd->anim;
+	const struct md5_crowd_lod_t *lod = &crowd->lod;
+	struct md5_crowd_stats_t *stats = &crowd->stats;
+	long weights = 0;
+	int i, c;
+
+	memset (stats, 0, sizeof (struct md5_crowd_stats_t));
+	crowd->num_tasks = 0;
+	crowd->num_blends = 0;
+
+	for (i = 0; i < crowd->num_instances; ++i) {
+		struct md5_instance_t *inst = &crowd->instances[i];
+
+		if (anim && inst->blend > 0.0f)
+			Animate (anim, &inst->animInfo, dt * inst->speed);
+		inst->sinceUpdate++;
+		inst->sinceSkinned++;
+
+		if (crowd->hasView) {
+			vec3_t min, max, center;
+
+			InstanceBounds (crowd, inst, min, max);
+			inst->culled = !BoxInFrustum (crowd->frustum, min, max);
+
+			/* its vertices go stale while it is out of view */
+			if (inst->culled) {
+				inst->skinned = 0;
+				stats->culled++;
+				continue;
+			}
+
+			for (c = 0; c < 3; ++c)
+				center[c] = 0.5f * (min[c] + max[c]) - crowd->eye[c];
+			inst->distance = sqrtf (center[0] * center[0] + center[1] * center[1] + center[2] * center[2]);
+
+			inst->rate = 0;
+			while (inst->rate < MD5_LOD_RATES - 1 && lod->rateDistance[inst->rate] > 0.0f
+			       && inst->distance > lod->rateDistance[inst->rate])
+				inst->rate++;
+
+			inst->reduced = crowd->reducedSkins && inst->distance > lod->reducedDistance;
+		}
+
+		stats->atRate[inst->rate]++;
+
+		if (!inst->skinned || inst->sinceUpdate >= (1 << inst->rate)) {
+			crowd->tasks[crowd->num_tasks++] = i;
+			weights += inst->reduced ? crowd->reducedWeights : crowd->fullWeights;
+		}
+	}
+
+	/* over budget, skin as many of the most pressing as fit, at least one */
+	if (lod->weightBudget > 0 && weights > lod->weightBudget) {
+		struct md5_task_order_t order = { crowd->instances };
+		int n = crowd->num_tasks;
+
+		std::sort (crowd->tasks, crowd->tasks + n, order);
+
+		weights = 0;
+		for (crowd->num_tasks = 0; crowd->num_tasks < n; ++crowd->num_tasks) {
+			const struct md5_instance_t *inst = &crowd->instances[crowd->tasks[crowd->num_tasks]];
+			int cost = inst->reduced ? crowd->reducedWeights : crowd->fullWeights;
+
+			if (crowd->num_tasks > 0 && weights + cost > lod->weightBudget)
+				break;
+			weights += cost;
+		}
+
+		stats->deferred = n - crowd->num_tasks;
+	}
+
+	for (i = 0; i < crowd->num_tasks; ++i) {
+		struct md5_instance_t *inst = &crowd->instances[crowd->tasks[i]];
+
+		/* the new pose goes over the older of the two */
+		inst->interval = inst->skinned ? inst->sinceSkinned : 0;
+		if (inst->skinned)
+			inst->pose = 1 - inst->pose;
+		inst->sinceSkinned = 0;
+
+		/* spread the first updates of a rate over its frames */
+		inst->sinceUpdate = inst->skinned ? 0 : crowd->tasks[i] % (1 << inst->rate);
+		inst->skinned = 1;
+
+		if (inst->reduced)
+			stats->reduced++;
+	}
+
+	/* the rest still on their way to their last pose */
+	if (crowd->poseVertices[0]) {
+		for (i = 0; i < crowd->num_instances; ++i) {
+			const struct md5_instance_t *inst = &crowd->instances[i];
+
+			if (inst->skinned && !inst->culled && inst->sinceSkinned > 0 && inst->sinceSkinned <= inst->interval)
+				crowd->tasks[crowd->num_tasks + crowd->num_blends++] = -1 - i;
+		}
+	}
+
+	stats->updated = crowd->num_tasks;
+	stats->blended = crowd->num_blends;
+	stats->weights = weights;
+}
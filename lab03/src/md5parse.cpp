@@ -0,0 +1,818 @@
+/*
+ * md5parse.c -- md5mesh model loader + animation
+ *
+ * One pass parsers for md5mesh and md5anim text.  The file is mapped
+ * rather than read a line at a time, split into tokens in place, and
+ * numbers are converted without going through sscanf.  Arrays are sized
+ * from the counts given before them.  ScanMD5Model() and
+ * ScanMD5AnimData() are the sscanf parsers these replace, kept to check
+ * against.
+ * Dependencies: md5model.h, md5anim.cpp, md5skin.cpp.
+ *
+ */
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+#include "MD5/md5model.h"
+
+/* Mapped text and where the lexer has got to */
+struct md5_lexer_t
+{
+    const char *text;
+    const char *p;
+    const char *end;
+    long size;
+
+    const char *filename;
+    const char *prefix; /* for error messages */
+
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+};
+
+/* Powers of ten a double holds exactly */
+static const double POW10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * Map a text file for the lexer.
+ */
+static int OpenLexer (struct md5_lexer_t *lex, const char *filename, const char *prefix) {
+	memset (lex, 0, sizeof (struct md5_lexer_t));
+	lex->filename = filename;
+	lex->prefix = prefix;
+
+#ifdef _WIN32
+	LARGE_INTEGER size;
+
+	lex->file = CreateFileA (filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (lex->file == INVALID_HANDLE_VALUE || !GetFileSizeEx (lex->file, &size) || size.QuadPart == 0) {
+		if (lex->file != INVALID_HANDLE_VALUE)
+			CloseHandle (lex->file);
+		fprintf (stderr, "%s: Error: couldn't open \"%s\"!\n", prefix, filename);
+		return 0;
+	}
+
+	lex->mapping = CreateFileMappingA (lex->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	lex->text = lex->mapping ? (const char *)MapViewOfFile (lex->mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	lex->size = (long)size.QuadPart;
+
+	if (!lex->text) {
+		if (lex->mapping)
+			CloseHandle (lex->mapping);
+		CloseHandle (lex->file);
+		fprintf (stderr, "%s: Error: couldn't map \"%s\"!\n", prefix, filename);
+		return 0;
+	}
+#else
+	struct stat st;
+	int fd = open (filename, O_RDONLY);
+
+	if (fd < 0 || fstat (fd, &st) != 0 || st.st_size == 0) {
+		if (fd >= 0)
+			close (fd);
+		fprintf (stderr, "%s: Error: couldn't open \"%s\"!\n", prefix, filename);
+		return 0;
+	}
+
+	void *text = mmap (nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close (fd);
+
+	if (text == MAP_FAILED) {
+		fprintf (stderr, "%s: Error: couldn't map \"%s\"!\n", prefix, filename);
+		return 0;
+	}
+
+	/* read front to back, once */
+	madvise (text, st.st_size, MADV_SEQUENTIAL);
+
+	lex->text = (const char *)text;
+	lex->size = (long)st.st_size;
+#endif
+
+	lex->p = lex->text;
+	lex->end = lex->text + lex->size;
+
+	return 1;
+}
+
+static void CloseLexer (struct md5_lexer_t *lex) {
+#ifdef _WIN32
+	UnmapViewOfFile (lex->text);
+	CloseHandle (lex->mapping);
+	CloseHandle (lex->file);
+#else
+	munmap ((void *)lex->text, lex->size);
+#endif
+	lex->text = lex->p = lex->end = nullptr;
+}
+
+/**
+ * Report what was expected where the lexer is.  Lines are only counted
+ * here, the lexer does not track them.
+ */
+static int LexError (const struct md5_lexer_t *lex, const char *expected) {
+	const char *c;
+	int line = 1;
+
+	for (c = lex->text; c < lex->p; ++c)
+		if (*c == '\n')
+			line++;
+
+	fprintf (stderr, "%s: Error: %s:%d: expected %s\n", lex->prefix, lex->filename, line, expected);
+	return 0;
+}
+
+static inline int IsSpace (char c) {
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+static inline int IsDigit (char c) {
+	return c >= '0' && c <= '9';
+}
+
+/**
+ * Skip white space and // comments.
+ */
+static void SkipSpace (struct md5_lexer_t *lex) {
+	const char *p = lex->p;
+
+	while (p < lex->end) {
+		if (IsSpace (*p)) {
+			p++;
+		} else if (*p == '/' && p + 1 < lex->end && p[1] == '/') {
+			while (p < lex->end && *p != '\n')
+				p++;
+		} else {
+			break;
+		}
+	}
+
+	lex->p = p;
+}
+
+static void SkipLine (struct md5_lexer_t *lex) {
+	while (lex->p < lex->end && *lex->p != '\n')
+		lex->p++;
+}
+
+/**
+ * Next white space separated word, not terminated.  Returns its length,
+ * 0 at the end of the text.
+ */
+static int NextWord (struct md5_lexer_t *lex, const char **word) {
+	const char *p;
+
+	SkipSpace (lex);
+	p = *word = lex->p;
+
+	while (p < lex->end && !IsSpace (*p))
+		p++;
+
+	lex->p = p;
+	return (int)(p - *word);
+}
+
+static inline int IsWord (const char *word, int len, const char *keyword) {
+	return strncmp (word, keyword, len) == 0 && keyword[len] == '\0';
+}
+
+static int ExpectChar (struct md5_lexer_t *lex, char c) {
+	char expected[4] = { '\'', c, '\'', '\0' };
+
+	SkipSpace (lex);
+	if (lex->p >= lex->end || *lex->p != c)
+		return LexError (lex, expected);
+
+	lex->p++;
+	return 1;
+}
+
+static int ReadInt (struct md5_lexer_t *lex, int *out) {
+	const char *p;
+	int negative = 0, value = 0;
+
+	SkipSpace (lex);
+	p = lex->p;
+
+	if (p < lex->end && (*p == '-' || *p == '+'))
+		negative = (*p++ == '-');
+
+	if (p >= lex->end || !IsDigit (*p))
+		return LexError (lex, "an integer");
+
+	for (; p < lex->end && IsDigit (*p); ++p)
+		value = value * 10 + (*p - '0');
+
+	*out = negative ? -value : value;
+	lex->p = p;
+	return 1;
+}
+
+/**
+ * Read a float, rounded as strtof() would.  Up to 15 significant digits
+ * and a power of ten up to 22 make one exact double operation, then one
+ * rounding to float, which is right unless the double landed exactly
+ * half way between two floats.  Anything else goes through strtof().
+ */
+static int ReadFloat (struct md5_lexer_t *lex, float *out) {
+	const char *p, *start;
+	unsigned long long mantissa = 0, bits;
+	int negative = 0, digits = 0, exponent = 0, any = 0, slow = 0;
+	double value;
+
+	SkipSpace (lex);
+	p = start = lex->p;
+
+	if (p < lex->end && (*p == '-' || *p == '+'))
+		negative = (*p++ == '-');
+
+	for (; p < lex->end && IsDigit (*p); ++p, any = 1) {
+		if (mantissa == 0 && *p == '0')
+			continue;
+		if (digits < 19) {
+			mantissa = mantissa * 10 + (*p - '0');
+			digits++;
+		} else {
+			slow = 1;
+		}
+	}
+
+	if (p < lex->end && *p == '.') {
+		for (++p; p < lex->end && IsDigit (*p); ++p, any = 1) {
+			if (digits < 19) {
+				mantissa = mantissa * 10 + (*p - '0');
+				exponent--;
+				if (mantissa)
+					digits++;
+			} else {
+				slow = 1;
+			}
+		}
+	}
+
+	if (!any)
+		return LexError (lex, "a number");
+
+	if (p < lex->end && (*p == 'e' || *p == 'E')) {
+		int expNegative = 0, e = 0;
+
+		p++;
+		if (p < lex->end && (*p == '-' || *p == '+'))
+			expNegative = (*p++ == '-');
+		if (p >= lex->end || !IsDigit (*p))
+			return LexError (lex, "an exponent");
+		for (; p < lex->end && IsDigit (*p); ++p)
+			if (e < 10000)
+				e = e * 10 + (*p - '0');
+
+		exponent += expNegative ? -e : e;
+	}
+
+	if (!slow && mantissa < (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+		value = (double)mantissa;
+		value = (exponent < 0) ? value / POW10[-exponent] : value * POW10[exponent];
+
+		/* the low 29 bits are what rounding to float drops */
+		memcpy (&bits, &value, sizeof (bits));
+		slow = (bits & 0x1fffffffULL) == 0x10000000ULL;
+	} else {
+		slow = 1;
+	}
+
+	if (slow) {
+		char buff[64];
+		int len = (int)(p - start);
+
+		if (len >= (int)sizeof (buff))
+			return LexError (lex, "a shorter number");
+
+		memcpy (buff, start, len);
+		buff[len] = '\0';
+		*out = strtof (buff, nullptr);
+	} else {
+		*out = negative ? -(float)value : (float)value;
+	}
+
+	lex->p = p;
+	return 1;
+}
+
+static int ReadVec (struct md5_lexer_t *lex, float *v, int n) {
+	int i;
+
+	if (!ExpectChar (lex, '('))
+		return 0;
+
+	for (i = 0; i < n; ++i)
+		if (!ReadFloat (lex, &v[i]))
+			return 0;
+
+	return ExpectChar (lex, ')');
+}
+
+/**
+ * Read a quoted string into out, keeping the quote marks or not.  Names
+ * keep them, as the sscanf parsers always did.
+ */
+static int ReadString (struct md5_lexer_t *lex, char *out, int size, int keepQuotes) {
+	const char *p, *start;
+	int len;
+
+	SkipSpace (lex);
+	p = lex->p;
+
+	if (p >= lex->end || *p != '\"')
+		return LexError (lex, "a quoted string");
+
+	for (++p; p < lex->end && *p != '\"' && *p != '\n'; ++p)
+		;
+
+	if (p >= lex->end || *p != '\"')
+		return LexError (lex, "a closing quote");
+
+	start = keepQuotes ? lex->p : lex->p + 1;
+	len = (int)(keepQuotes ? p + 1 - start : p - start);
+	if (len >= size)
+		len = size - 1;
+
+	memcpy (out, start, len);
+	out[len] = '\0';
+
+	lex->p = p + 1;
+	return 1;
+}
+
+static int ReadCount (struct md5_lexer_t *lex, int *out, const char *what) {
+	if (!ReadInt (lex, out))
+		return 0;
+
+	if (*out < 0)
+		return LexError (lex, what);
+
+	return 1;
+}
+
+static int ReadIndex (struct md5_lexer_t *lex, int *out, int count) {
+	if (!ReadInt (lex, out))
+		return 0;
+
+	if (*out < 0 || *out >= count)
+		return LexError (lex, "an index within the count given");
+
+	return 1;
+}
+
+/**
+ * One mesh { } block.
+ */
+static int ParseMesh (struct md5_lexer_t *lex, struct md5_mesh_t *mesh, int *totVert, int *totTris) {
+	const char *word;
+	int len, index;
+
+	if (!ExpectChar (lex, '{'))
+		return 0;
+
+	while ((len = NextWord (lex, &word)) > 0) {
+		if (IsWord (word, len, "}")) {
+			return 1;
+		} else if (IsWord (word, len, "shader")) {
+			if (!ReadString (lex, mesh->shader, sizeof (mesh->shader), 0))
+				return 0;
+		} else if (IsWord (word, len, "numverts")) {
+			if (mesh->vertices)
+				return LexError (lex, "one numverts");
+			if (!ReadCount (lex, &mesh->num_verts, "a vertex count"))
+				return 0;
+
+			if (mesh->num_verts > 0)
+				mesh->vertices = (struct md5_vertex_t *)
+						malloc (sizeof (struct md5_vertex_t) * mesh->num_verts);
+
+			mesh->firstVertex = *totVert;
+			*totVert += mesh->num_verts;
+		} else if (IsWord (word, len, "numtris")) {
+			if (mesh->triangles)
+				return LexError (lex, "one numtris");
+			if (!ReadCount (lex, &mesh->num_tris, "a triangle count"))
+				return 0;
+
+			if (mesh->num_tris > 0)
+				mesh->triangles = (struct md5_triangle_t *)
+						malloc (sizeof (struct md5_triangle_t) * mesh->num_tris);
+
+			mesh->firstIndex = *totTris * 3;
+			*totTris += mesh->num_tris;
+		} else if (IsWord (word, len, "numweights")) {
+			if (mesh->weights)
+				return LexError (lex, "one numweights");
+			if (!ReadCount (lex, &mesh->num_weights, "a weight count"))
+				return 0;
+
+			if (mesh->num_weights > 0)
+				mesh->weights = (struct md5_weight_t *)
+						malloc (sizeof (struct md5_weight_t) * mesh->num_weights);
+		} else if (IsWord (word, len, "vert")) {
+			struct md5_vertex_t *vert;
+
+			if (!ReadIndex (lex, &index, mesh->num_verts))
+				return 0;
+
+			vert = &mesh->vertices[index];
+			if (!ReadVec (lex, vert->st, 2) || !ReadInt (lex, &vert->start) || !ReadInt (lex, &vert->count))
+				return 0;
+		} else if (IsWord (word, len, "tri")) {
+			struct md5_triangle_t *tri;
+
+			if (!ReadIndex (lex, &index, mesh->num_tris))
+				return 0;
+
+			tri = &mesh->triangles[index];
+			if (!ReadInt (lex, &tri->index[0]) || !ReadInt (lex, &tri->index[1]) || !ReadInt (lex, &tri->index[2]))
+				return 0;
+		} else if (IsWord (word, len, "weight")) {
+			struct md5_weight_t *weight;
+
+			if (!ReadIndex (lex, &index, mesh->num_weights))
+				return 0;
+
+			weight = &mesh->weights[index];
+			if (!ReadInt (lex, &weight->joint) || !ReadFloat (lex, &weight->bias) || !ReadVec (lex, weight->pos, 3))
+				return 0;
+		} else {
+			SkipLine (lex);
+		}
+	}
+
+	return LexError (lex, "'}' closing the mesh");
+}
+
+/**
+ * Parse an md5mesh into mdl.  Textures are left to ReadMD5Model().
+ */
+int ParseMD5Model (const char *filename, struct md5_model_t *mdl) {
+	struct md5_lexer_t lex;
+	const char *word;
+	int len, version, i;
+	int curr_mesh = 0, totVert = 0, totTris = 0;
+	int ok = 1;
+
+	memset (mdl, 0, sizeof (struct md5_model_t));
+
+	if (!OpenLexer (&lex, filename, "[.md5mesh]"))
+		return 0;
+
+	while (ok && (len = NextWord (&lex, &word)) > 0) {
+		if (IsWord (word, len, "MD5Version")) {
+			ok = ReadInt (&lex, &version);
+			if (ok && version != 10) {
+				/* Bad version */
+				fprintf (stderr, "[.md5mesh]: Error: bad model version\n");
+				ok = 0;
+			}
+		} else if (IsWord (word, len, "numJoints")) {
+			ok = !mdl->baseSkel && ReadCount (&lex, &mdl->num_joints, "a joint count");
+			if (ok && mdl->num_joints > 0)
+				mdl->baseSkel = (struct md5_joint_t *)
+						calloc (mdl->num_joints, sizeof (struct md5_joint_t));
+		} else if (IsWord (word, len, "numMeshes")) {
+			ok = !mdl->meshes && ReadCount (&lex, &mdl->num_meshes, "a mesh count");
+			if (ok && mdl->num_meshes > 0)
+				mdl->meshes = (struct md5_mesh_t *)
+						calloc (mdl->num_meshes, sizeof (struct md5_mesh_t));
+		} else if (IsWord (word, len, "joints")) {
+			ok = ExpectChar (&lex, '{');
+			for (i = 0; ok && i < mdl->num_joints; ++i) {
+				struct md5_joint_t *joint = &mdl->baseSkel[i];
+
+				ok = ReadString (&lex, joint->name, sizeof (joint->name), 1)
+						&& ReadInt (&lex, &joint->parent)
+						&& ReadVec (&lex, joint->pos, 3)
+						&& ReadVec (&lex, joint->orient, 3);
+
+				/* Compute the w component */
+				if (ok)
+					Quat_computeW (joint->orient);
+			}
+			ok = ok && ExpectChar (&lex, '}');
+		} else if (IsWord (word, len, "mesh")) {
+			if (curr_mesh >= mdl->num_meshes) {
+				ok = LexError (&lex, "no more meshes than numMeshes");
+			} else {
+				struct md5_mesh_t *mesh = &mdl->meshes[curr_mesh++];
+
+				ok = ParseMesh (&lex, mesh, &totVert, &totTris);
+
+				/* Lay out the weights for the skinning kernels */
+				if (ok)
+					BuildMeshSkin (mesh, &mesh->skin);
+			}
+		} else {
+			SkipLine (&lex);
+		}
+	}
+
+	CloseLexer (&lex);
+
+	if (!ok)
+		FreeModel (mdl);
+
+	return ok;
+}
+
+/**
+ * Parse an md5mesh a line at a time with sscanf().  This is the parser
+ * ParseMD5Model() replaced, kept to check it against.  No textures are
+ * loaded.
+ */
+int ScanMD5Model (const char *filename, struct md5_model_t *mdl) {
+	FILE *fp;
+	char buff[512];
+	int version;
+	int curr_mesh = 0;
+	int i;
+
+	int totVert = 0;
+	int totTris = 0;
+
+	fp = fopen (filename, "rb");
+	if (!fp) {
+		fprintf (stderr, "[.md5mesh]: Error: couldn't open \"%s\"!\n", filename);
+		return 0;
+	}
+
+	while (!feof (fp)) {
+		/* Read whole line */
+		fgets (buff, sizeof (buff), fp);
+
+		if (sscanf (buff, " MD5Version %d", &version) == 1) {
+			if (version != 10) {
+				/* Bad version */
+				fprintf (stderr, "[.md5mesh]: Error: bad model version\n");
+				fclose (fp);
+				return 0;
+			}
+		} else if (sscanf (buff, " numJoints %d", &mdl->num_joints) == 1) {
+			if (mdl->num_joints > 0) {
+				/* Allocate memory for base skeleton joints */
+				mdl->baseSkel = (struct md5_joint_t *)
+                		calloc (mdl->num_joints, sizeof (struct md5_joint_t));
+			}
+		} else if (sscanf (buff, " numMeshes %d", &mdl->num_meshes) == 1) {
+			if (mdl->num_meshes > 0) {
+				/* Allocate memory for meshes */
+				mdl->meshes = (struct md5_mesh_t *)
+                		calloc (mdl->num_meshes, sizeof (struct md5_mesh_t));
+			}
+		} else if (strncmp (buff, "joints {", 8) == 0) {
+			/* Read each joint */
+			for (i = 0; i < mdl->num_joints; ++i) {
+				struct md5_joint_t *joint = &mdl->baseSkel[i];
+
+				/* Read whole line */
+				fgets (buff, sizeof (buff), fp);
+
+				if (sscanf (buff, "%s %d ( %f %f %f ) ( %f %f %f )",
+						joint->name, &joint->parent, &joint->pos[0],
+						&joint->pos[1], &joint->pos[2], &joint->orient[0],
+						&joint->orient[1], &joint->orient[2]) == 8) {
+					/* Compute the w component */
+					Quat_computeW (joint->orient);
+				}
+			}
+		} else if (strncmp (buff, "mesh {", 6) == 0) {
+			struct md5_mesh_t *mesh = &mdl->meshes[curr_mesh];
+			int vert_index = 0;
+			int tri_index = 0;
+			int weight_index = 0;
+			float fdata[4];
+			int idata[3];
+
+			while ((buff[0] != '}') && !feof (fp)) {
+				/* Read whole line */
+				fgets (buff, sizeof (buff), fp);
+
+				if (strstr (buff, "shader ")) {
+					int quote = 0, j = 0;
+
+					/* Copy the shader name without the quote marks */
+					for (i = 0; i < sizeof (buff) && (quote < 2); ++i) {
+						if (buff[i] == '\"')
+							quote++;
+
+						if ((quote == 1) && (buff[i] != '\"')) {
+							mesh->shader[j] = buff[i];
+							j++;
+						}
+					}
+				} else if (sscanf (buff, " numverts %d", &mesh->num_verts) == 1) {
+					if (mesh->num_verts > 0) {
+						/* Allocate memory for vertices */
+						mesh->vertices = (struct md5_vertex_t *)
+                        		malloc (sizeof (struct md5_vertex_t) * mesh->num_verts);
+					}
+
+					mesh->firstVertex = totVert;
+					totVert += mesh->num_verts;
+				} else if (sscanf (buff, " numtris %d", &mesh->num_tris) == 1) {
+					if (mesh->num_tris > 0) {
+						/* Allocate memory for triangles */
+						mesh->triangles = (struct md5_triangle_t *)
+                        		malloc (sizeof (struct md5_triangle_t) * mesh->num_tris);
+					}
+
+					mesh->firstIndex = totTris * 3;
+					totTris += mesh->num_tris;
+				} else if (sscanf (buff, " numweights %d", &mesh->num_weights) == 1) {
+					if (mesh->num_weights > 0) {
+						/* Allocate memory for vertex weights */
+						mesh->weights = (struct md5_weight_t *)
+                        		malloc (sizeof (struct md5_weight_t) * mesh->num_weights);
+					}
+				} else if (sscanf (buff, " vert %d ( %f %f ) %d %d", &vert_index,
+						&fdata[0], &fdata[1], &idata[0], &idata[1]) == 5) {
+					/* Copy vertex data */
+					mesh->vertices[vert_index].st[0] = fdata[0];
+					mesh->vertices[vert_index].st[1] = fdata[1];
+					mesh->vertices[vert_index].start = idata[0];
+					mesh->vertices[vert_index].count = idata[1];
+				} else if (sscanf (buff, " tri %d %d %d %d", &tri_index,
+						&idata[0], &idata[1], &idata[2]) == 4) {
+					/* Copy triangle data */
+					mesh->triangles[tri_index ].index[0] = idata[0];
+					mesh->triangles[tri_index ].index[1] = idata[1];
+					mesh->triangles[tri_index ].index[2] = idata[2];
+				} else if (sscanf (buff, " weight %d %d %f ( %f %f %f )",
+						&weight_index, &idata[0], &fdata[3],
+						&fdata[0], &fdata[1], &fdata[2]) == 6) {
+					/* Copy vertex data */
+					mesh->weights[weight_index].joint  = idata[0];
+					mesh->weights[weight_index].bias   = fdata[3];
+					mesh->weights[weight_index].pos[0] = fdata[0];
+					mesh->weights[weight_index].pos[1] = fdata[1];
+					mesh->weights[weight_index].pos[2] = fdata[2];
+				}
+			}
+
+			/* Lay out the weights for the skinning kernels */
+			BuildMeshSkin (mesh, &mesh->skin);
+
+			curr_mesh++;
+		}
+	}
+
+	fclose (fp);
+
+	return 1;
+}
+
+/**
+ * Free resources allocated for the model.
+ */
+void FreeModel (struct md5_model_t *mdl) {
+	int i;
+
+	if (mdl->baseSkel) {
+		free (mdl->baseSkel);
+		mdl->baseSkel = nullptr;
+	}
+
+	if (mdl->meshes) {
+		/* Free mesh data */
+		for (i = 0; i < mdl->num_meshes; ++i) {
+			if (mdl->meshes[i].vertices) {
+				free (mdl->meshes[i].vertices);
+				mdl->meshes[i].vertices = nullptr;
+			}
+
+			if (mdl->meshes[i].triangles) {
+				free (mdl->meshes[i].triangles);
+				mdl->meshes[i].triangles = nullptr;
+			}
+
+			if (mdl->meshes[i].weights) {
+				free (mdl->meshes[i].weights);
+				mdl->meshes[i].weights = nullptr;
+			}
+
+			free (mdl->meshes[i].triTangents);
+			mdl->meshes[i].triTangents = nullptr;
+
+			FreeMeshSkin (&mdl->meshes[i].skin);
+		}
+
+		free (mdl->meshes);
+		mdl->meshes = nullptr;
+	}
+}
+
+/**
+ * Read the hierarchy, base frame, bounds and raw frame components of an
+ * MD5 animation without building any skeleton.
+ */
+int ReadMD5AnimData (const char *filename, struct md5_anim_data_t *data) {
+	struct md5_lexer_t lex;
+	const char *word;
+	int len, version, frame_index, i;
+	int ok = 1;
+
+	memset (data, 0, sizeof (struct md5_anim_data_t));
+
+	if (!OpenLexer (&lex, filename, "[.md5anim]"))
+		return 0;
+
+	while (ok && (len = NextWord (&lex, &word)) > 0) {
+		if (IsWord (word, len, "MD5Version")) {
+			ok = ReadInt (&lex, &version);
+			if (ok && version != 10) {
+				/* Bad version */
+				fprintf (stderr, "[.md5anim]: Error: bad animation version\n");
+				ok = 0;
+			}
+		} else if (IsWord (word, len, "numFrames")) {
+			ok = !data->bboxes && ReadCount (&lex, &data->num_frames, "a frame count");
+			if (ok && data->num_frames > 0)
+				data->bboxes = (struct md5_bbox_t *)
+						malloc (sizeof (struct md5_bbox_t) * data->num_frames);
+		} else if (IsWord (word, len, "numJoints")) {
+			ok = !data->jointInfos && ReadCount (&lex, &data->num_joints, "a joint count");
+			if (ok && data->num_joints > 0) {
+				data->jointInfos = (struct joint_info_t *)
+						calloc (data->num_joints, sizeof (struct joint_info_t));
+				data->baseFrame = (struct baseframe_joint_t *)
+						calloc (data->num_joints, sizeof (struct baseframe_joint_t));
+			}
+		} else if (IsWord (word, len, "frameRate")) {
+			ok = ReadInt (&lex, &data->frameRate);
+		} else if (IsWord (word, len, "numAnimatedComponents")) {
+			ok = !data->frameData && ReadCount (&lex, &data->numAnimatedComponents, "a component count");
+			if (ok && data->numAnimatedComponents > 0 && data->num_frames > 0)
+				data->frameData = (float *)
+						calloc (data->num_frames * data->numAnimatedComponents, sizeof (float));
+		} else if (IsWord (word, len, "hierarchy")) {
+			ok = ExpectChar (&lex, '{');
+			for (i = 0; ok && i < data->num_joints; ++i) {
+				struct joint_info_t *jointInfo = &data->jointInfos[i];
+				int flags = 0;
+
+				ok = ReadString (&lex, jointInfo->name, sizeof (jointInfo->name), 1)
+						&& ReadInt (&lex, &jointInfo->parent)
+						&& ReadInt (&lex, &flags)
+						&& ReadInt (&lex, &jointInfo->startIndex);
+				jointInfo->flags = (unsigned int)flags;
+			}
+			ok = ok && ExpectChar (&lex, '}');
+		} else if (IsWord (word, len, "bounds")) {
+			ok = ExpectChar (&lex, '{');
+			for (i = 0; ok && i < data->num_frames; ++i)
+				ok = ReadVec (&lex, data->bboxes[i].min, 3) && ReadVec (&lex, data->bboxes[i].max, 3);
+			ok = ok && ExpectChar (&lex, '}');
+		} else if (IsWord (word, len, "baseframe")) {
+			ok = ExpectChar (&lex, '{');
+			for (i = 0; ok && i < data->num_joints; ++i) {
+				struct baseframe_joint_t *baseJoint = &data->baseFrame[i];
+
+				ok = ReadVec (&lex, baseJoint->pos, 3) && ReadVec (&lex, baseJoint->orient, 3);
+
+				/* Compute the w component */
+				if (ok)
+					Quat_computeW (baseJoint->orient);
+			}
+			ok = ok && ExpectChar (&lex, '}');
+		} else if (IsWord (word, len, "frame")) {
+			ok = ReadIndex (&lex, &frame_index, data->num_frames) && ExpectChar (&lex, '{');
+			if (ok && data->frameData) {
+				float *frameData = data->frameData + frame_index * data->numAnimatedComponents;
+
+				for (i = 0; ok && i < data->numAnimatedComponents; ++i)
+					ok = ReadFloat (&lex, &frameData[i]);
+			}
+			ok = ok && ExpectChar (&lex, '}');
+		} else {
+			SkipLine (&lex);
+		}
+	}
+
+	CloseLexer (&lex);
+
+	if (!ok)
+		FreeAnimData (data);
+
+	return ok;
+}
@@ -0,0 +1,342 @@
+/*
+ * md5pose.c -- md5mesh model loader + animation
+ *
+ * Pose evaluation.  Animations are sampled at any time rather than
+ * stepped a frame at a time, several clips can be blended by weight,
+ * and additive clips layered on top.  Scratch skeletons and each
+ * layer's decoded clip frames come from a pool, so evaluating a pose
+ * allocates nothing once the pool is warm.
+ * Dependencies: md5model.h, md5anim.cpp, md5clip.cpp.
+ *
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+#include "MD5/md5model.h"
+
+/**
+ * Add count free skeletons to the pool.
+ */
+static void GrowPosePool (struct md5_pose_pool_t *pool, int count) {
+	struct md5_joint_t *block = (struct md5_joint_t *)
+			malloc (sizeof (struct md5_joint_t) * pool->num_joints * count);
+	int i;
+
+	pool->blocks = (struct md5_joint_t **)
+			realloc (pool->blocks, sizeof (struct md5_joint_t *) * (pool->num_blocks + 1));
+	pool->blocks[pool->num_blocks++] = block;
+
+	pool->capacity += count;
+	pool->freePoses = (struct md5_joint_t **)
+			realloc (pool->freePoses, sizeof (struct md5_joint_t *) * pool->capacity);
+
+	for (i = 0; i < count; ++i)
+		pool->freePoses[pool->num_free++] = block + i * pool->num_joints;
+}
+
+/**
+ * Set up a pool of skeletons of num_joints joints, with num_poses
+ * allocated up front.
+ */
+void InitPosePool (struct md5_pose_pool_t *pool, int num_joints, int num_poses) {
+	memset (pool, 0, sizeof (struct md5_pose_pool_t));
+	pool->num_joints = num_joints;
+
+	if (num_poses > 0)
+		GrowPosePool (pool, num_poses);
+}
+
+/**
+ * Free every pose of the pool, including any still acquired.
+ */
+void FreePosePool (struct md5_pose_pool_t *pool) {
+	int i;
+
+	for (i = 0; i < pool->num_blocks; ++i)
+		free (pool->blocks[i]);
+
+	free (pool->blocks);
+	free (pool->freePoses);
+
+	for (i = 0; i < pool->num_layers; ++i)
+		FreeFrameCache (&pool->layerCaches[i]);
+	free (pool->layerCaches);
+
+	memset (pool, 0, sizeof (struct md5_pose_pool_t));
+}
+
+/**
+ * Take a skeleton from the pool.  An empty pool doubles in size, so
+ * a steady workload stops allocating after its first frame.
+ */
+struct md5_joint_t *AcquirePose (struct md5_pose_pool_t *pool) {
+	if (pool->num_free == 0)
+		GrowPosePool (pool, pool->capacity > 0 ? pool->capacity : 4);
+
+	return pool->freePoses[--pool->num_free];
+}
+
+void ReleasePose (struct md5_pose_pool_t *pool, struct md5_joint_t *pose) {
+	pool->freePoses[pool->num_free++] = pose;
+}
+
+/**
+ * Give the pool a frame cache for each of num_layers layers.  Call it
+ * when the layers are set up; a layer's cache allocates its frames the
+ * first time it samples a clip and keeps them while the layer plays
+ * that clip.
+ */
+void ReservePoseLayers (struct md5_pose_pool_t *pool, int num_layers) {
+	int i;
+
+	if (num_layers <= pool->num_layers)
+		return;
+
+	pool->layerCaches = (struct md5_frame_cache_t *)
+			realloc (pool->layerCaches, sizeof (struct md5_frame_cache_t) * num_layers);
+	for (i = pool->num_layers; i < num_layers; ++i)
+		InitFrameCache (&pool->layerCaches[i]);
+
+	pool->num_layers = num_layers;
+}
+
+/**
+ * Skeleton of an animation at any time in seconds, looping.  Keyed clips
+ * are sampled directly, otherwise the frames on either side are blended.
+ */
+void SampleAnim (const struct md5_anim_t *anim, struct md5_frame_cache_t *cache,
+                 double time, struct md5_joint_t *out) {
+	double frame = fmod (time * anim->frameRate, (double)anim->num_frames);
+	int curr, next;
+
+	if (frame < 0.0)
+		frame += anim->num_frames;
+
+	curr = (int)frame;
+	if (curr >= anim->num_frames)
+		curr = anim->num_frames - 1;
+	next = (curr + 1) % anim->num_frames;
+
+	/* a keyed clip has no key past its last frame to wrap to */
+	if (anim->clip && curr + 1 < anim->num_frames && SampleClip (anim->clip, (float)frame, out))
+		return;
+
+	InterpolateSkeletons (GetAnimFrame (anim, cache, curr), GetAnimFrame (anim, cache, next),
+	                      anim->num_joints, (float)(frame - curr), out);
+}
+
+/**
+ * Weighted blend of count skeletons.  Two skeletons go through
+ * InterpolateSkeletons(), more are averaged, orientations on the same
+ * hemisphere as the first skeleton's and renormalized.
+ */
+void BlendSkeletons (const struct md5_joint_t *const *skels, const float *weights,
+                     int count, int num_joints, struct md5_joint_t *out) {
+	float total = 0.0f;
+	int i, j, c;
+
+	for (j = 0; j < count; ++j)
+		total += weights[j];
+
+	if (count == 1 || total <= 0.0f) {
+		memcpy (out, skels[0], sizeof (struct md5_joint_t) * num_joints);
+		return;
+	}
+
+	if (count == 2) {
+		InterpolateSkeletons (skels[0], skels[1], num_joints, weights[1] / total, out);
+		return;
+	}
+
+	for (i = 0; i < num_joints; ++i) {
+		const float *first = skels[0][i].orient;
+
+		out[i].parent = skels[0][i].parent;
+		memset (out[i].pos, 0, sizeof (vec3_t));
+		memset (out[i].orient, 0, sizeof (quat4_t));
+
+		for (j = 0; j < count; ++j) {
+			const struct md5_joint_t *joint = &skels[j][i];
+			float w = weights[j] / total;
+			float q = Quat_dotProduct (first, joint->orient) < 0.0f ? -w : w;
+
+			for (c = 0; c < 3; ++c)
+				out[i].pos[c] += w * joint->pos[c];
+			for (c = 0; c < 4; ++c)
+				out[i].orient[c] += q * joint->orient[c];
+		}
+
+		Quat_normalize (out[i].orient);
+	}
+}
+
+/**
+ * Joint i of skel relative to its parent.
+ */
+static void LocalJoint (const struct md5_joint_t *skel, int i, vec3_t pos, quat4_t orient) {
+	const struct md5_joint_t *joint = &skel[i];
+
+	if (joint->parent < 0) {
+		memcpy (pos, joint->pos, sizeof (vec3_t));
+		memcpy (orient, joint->orient, sizeof (quat4_t));
+	} else {
+		const struct md5_joint_t *parent = &skel[joint->parent];
+		quat4_t inv;
+		vec3_t offset;
+
+		inv[X] = -parent->orient[X]; inv[Y] = -parent->orient[Y];
+		inv[Z] = -parent->orient[Z]; inv[W] =  parent->orient[W];
+		Quat_normalize (inv);
+
+		offset[0] = joint->pos[0] - parent->pos[0];
+		offset[1] = joint->pos[1] - parent->pos[1];
+		offset[2] = joint->pos[2] - parent->pos[2];
+
+		Quat_rotatePoint (inv, offset, pos);
+		Quat_multQuat (inv, joint->orient, orient);
+	}
+}
+
+/**
+ * Layer an additive pose on base: each joint gets weight times how far
+ * additive's joint has moved from reference's, relative to its parent.
+ * out must not be base, additive or reference.
+ */
+void AddSkeleton (const struct md5_joint_t *base, const struct md5_joint_t *additive,
+                  const struct md5_joint_t *reference, float weight,
+                  int num_joints, struct md5_joint_t *out) {
+	static const quat4_t IDENTITY = { 0.0f, 0.0f, 0.0f, 1.0f };
+	int i;
+
+	for (i = 0; i < num_joints; ++i) {
+		vec3_t basePos, addPos, refPos, localPos;
+		quat4_t baseOrient, addOrient, refOrient, refInv, delta, localOrient;
+
+		LocalJoint (base, i, basePos, baseOrient);
+		LocalJoint (additive, i, addPos, addOrient);
+		LocalJoint (reference, i, refPos, refOrient);
+
+		/* delta takes the reference to the additive pose */
+		refInv[X] = -refOrient[X]; refInv[Y] = -refOrient[Y];
+		refInv[Z] = -refOrient[Z]; refInv[W] =  refOrient[W];
+		Quat_multQuat (addOrient, refInv, delta);
+		Quat_normalize (delta);
+		if (weight < 1.0f)
+			Quat_nlerp (IDENTITY, delta, weight, delta);
+
+		Quat_multQuat (delta, baseOrient, localOrient);
+		localPos[0] = basePos[0] + weight * (addPos[0] - refPos[0]);
+		localPos[1] = basePos[1] + weight * (addPos[1] - refPos[1]);
+		localPos[2] = basePos[2] + weight * (addPos[2] - refPos[2]);
+
+		/* back to model space under the already built parent */
+		strcpy (out[i].name, base[i].name);
+		out[i].parent = base[i].parent;
+
+		if (out[i].parent < 0) {
+			memcpy (out[i].pos, localPos, sizeof (vec3_t));
+			memcpy (out[i].orient, localOrient, sizeof (quat4_t));
+			Quat_normalize (out[i].orient);
+		} else {
+			const struct md5_joint_t *parent = &out[out[i].parent];
+			vec3_t rpos;
+
+			Quat_rotatePoint (parent->orient, localPos, rpos);
+			out[i].pos[0] = rpos[0] + parent->pos[0];
+			out[i].pos[1] = rpos[1] + parent->pos[1];
+			out[i].pos[2] = rpos[2] + parent->pos[2];
+
+			Quat_multQuat (parent->orient, localOrient, out[i].orient);
+			Quat_normalize (out[i].orient);
+		}
+	}
+}
+
+/**
+ * Sample every layer, blend the regular layers by weight and add the
+ * additive ones on top in order.  All the layers must animate the
+ * pool's skeleton.  Layer i samples through the pool's i-th frame
+ * cache, see ReservePoseLayers().  out is left as it was when no layer
+ * has weight.
+ */
+void EvaluatePose (const struct md5_pose_layer_t *layers, int count,
+                   struct md5_pose_pool_t *pool, struct md5_joint_t *out) {
+	const struct md5_joint_t *skels[8];
+	struct md5_joint_t *sampled[8];
+	float weights[8];
+	struct md5_joint_t *pose;
+	int num_joints = pool->num_joints;
+	int numBlended = 0;
+	int i, j;
+
+	ReservePoseLayers (pool, count);
+
+	/* blended layers, in batches of 8 folded into the running pose */
+	pose = AcquirePose (pool);
+	for (i = 0; i < count; ++i) {
+		if (layers[i].additive || layers[i].weight <= 0.0f)
+			continue;
+
+		if (numBlended == 8) {
+			struct md5_joint_t *partial = AcquirePose (pool);
+			float total = 0.0f;
+
+			BlendSkeletons (skels, weights, numBlended, num_joints, partial);
+			for (j = 0; j < numBlended; ++j) {
+				total += weights[j];
+				ReleasePose (pool, sampled[j]);
+			}
+
+			skels[0] = sampled[0] = partial;
+			weights[0] = total;
+			numBlended = 1;
+		}
+
+		sampled[numBlended] = AcquirePose (pool);
+		SampleAnim (layers[i].anim, &pool->layerCaches[i], layers[i].time, sampled[numBlended]);
+		skels[numBlended] = sampled[numBlended];
+		weights[numBlended] = layers[i].weight;
+		++numBlended;
+	}
+
+	if (numBlended > 0) {
+		BlendSkeletons (skels, weights, numBlended, num_joints, pose);
+		for (j = 0; j < numBlended; ++j)
+			ReleasePose (pool, sampled[j]);
+	} else {
+		/* nothing to add to but the first layer's reference */
+		for (i = 0; i < count && !layers[i].additive; ++i)
+			;
+		if (i == count) {
+			ReleasePose (pool, pose);
+			return;
+		}
+		SampleAnim (layers[i].anim, &pool->layerCaches[i], layers[i].referenceTime, pose);
+	}
+
+	for (i = 0; i < count; ++i) {
+		struct md5_joint_t *additive, *reference, *layered;
+
+		if (!layers[i].additive || layers[i].weight <= 0.0f)
+			continue;
+
+		additive = AcquirePose (pool);
+		reference = AcquirePose (pool);
+		layered = AcquirePose (pool);
+
+		SampleAnim (layers[i].anim, &pool->layerCaches[i], layers[i].time, additive);
+		SampleAnim (layers[i].anim, &pool->layerCaches[i], layers[i].referenceTime, reference);
+		AddSkeleton (pose, additive, reference, layers[i].weight, num_joints, layered);
+
+		ReleasePose (pool, additive);
+		ReleasePose (pool, reference);
+		ReleasePose (pool, pose);
+		pose = layered;
+	}
+
+	memcpy (out, pose, sizeof (struct md5_joint_t) * num_joints);
+	ReleasePose (pool, pose);
+}
@@ -0,0 +1,903 @@
+/*
+ * md5skin.c -- md5mesh model loader + animation
+ *
+ * Skinning backend.  Joints are turned into 3x4 matrices once per
+ * frame and the weights of each mesh are stored as structure-of-arrays
+ * in vertex order, so the kernels below can stream through them with
+ * SSE/AVX2 where the CPU supports it and plain C++ otherwise.
+ * Normals and tangents are skinned the same way from bind pose ones
+ * kept per weight, or rebuilt from the skinned triangles.
+ * PrepareMesh() and PrepareSkinnedMesh() skin into arrays of their own
+ * that need no GL context, DrawMesh() in md5mesh.cpp uploads them.
+ * Dependencies: md5model.h, md5anim.cpp.
+ *
+ */
+
+#include <atomic>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+#include "MD5/md5model.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#define MD5_SKIN_HAS_SSE
+#include <immintrin.h>
+
+/* AVX2 is compiled per function and only used if the CPU reports it */
+#if defined(__GNUC__) || defined(__clang__)
+#define MD5_SKIN_HAS_AVX2
+#define MD5_SKIN_TARGET_AVX2 __attribute__ ((target ("avx2,fma")))
+#endif
+#endif
+
+/* kernel used by SkinMesh(), picked on first use.  Crowd workers read
+   it concurrently, so it is atomic. */
+static std::atomic<int> skinKernel (-1);
+
+/* vertex arrays of the mesh last prepared, which DrawMesh() uploads */
+vec3_t *vertexArray = nullptr;
+vec3_t *normalArray = nullptr;
+int meshNormals = MD5_NORMALS_SKINNED;
+
+/**
+ * Lay out the weights of a mesh for the skinning kernels.
+ */
+void BuildMeshSkin (const struct md5_mesh_t *mesh, struct md5_skin_t *skin) {
+	int i, j, k;
+
+	memset (skin, 0, sizeof (struct md5_skin_t));
+	skin->num_verts = mesh->num_verts;
+
+	/* Weights a vertex does not reference are dropped */
+	for (i = 0; i < mesh->num_verts; ++i)
+		skin->num_weights += mesh->vertices[i].count;
+
+	if (skin->num_verts > 0) {
+		skin->start = (int *)malloc (sizeof (int) * skin->num_verts);
+		skin->count = (int *)malloc (sizeof (int) * skin->num_verts);
+	}
+
+	if (skin->num_weights > 0) {
+		skin->joint = (int *)malloc (sizeof (int) * skin->num_weights);
+		skin->bias = (float *)malloc (sizeof (float) * skin->num_weights);
+		skin->posX = (float *)malloc (sizeof (float) * skin->num_weights);
+		skin->posY = (float *)malloc (sizeof (float) * skin->num_weights);
+		skin->posZ = (float *)malloc (sizeof (float) * skin->num_weights);
+	}
+
+	for (k = 0, i = 0; i < mesh->num_verts; ++i) {
+		skin->start[i] = k;
+		skin->count[i] = mesh->vertices[i].count;
+
+		for (j = 0; j < mesh->vertices[i].count; ++j, ++k) {
+			const struct md5_weight_t *weight = &mesh->weights[mesh->vertices[i].start + j];
+
+			skin->joint[k] = weight->joint;
+			skin->bias[k] = weight->bias;
+			skin->posX[k] = weight->pos[0];
+			skin->posY[k] = weight->pos[1];
+			skin->posZ[k] = weight->pos[2];
+		}
+	}
+}
+
+/**
+ * Lay out the weights of a mesh with some joints folded into others:
+ * jointMap gives the joint each one is skinned by instead.  Weights are
+ * moved into their new joint's space in the bind pose, and the weights
+ * a vertex then has on one joint are merged into a single weight, which
+ * is exact since sum (b * (R p + t)) = R sum (b p) + sum (b) t.
+ */
+void BuildReducedMeshSkin (const struct md5_mesh_t *mesh, const struct md5_joint_t *bindSkel,
+                           const int *jointMap, struct md5_skin_t *skin) {
+	int i, j, k, n;
+
+	BuildMeshSkin (mesh, skin);
+
+	for (k = 0, n = 0, i = 0; i < mesh->num_verts; ++i) {
+		int first = n;
+
+		for (j = 0; j < mesh->vertices[i].count; ++j, ++k) {
+			int from = skin->joint[k];
+			int to = jointMap[from];
+			float bias = skin->bias[k];
+			vec3_t pos = { skin->posX[k], skin->posY[k], skin->posZ[k] };
+			int m;
+
+			if (to != from) {
+				const struct md5_joint_t *src = &bindSkel[from];
+				const struct md5_joint_t *dst = &bindSkel[to];
+				quat4_t inv;
+				vec3_t model;
+
+				Quat_rotatePoint (src->orient, pos, model);
+				model[0] += src->pos[0] - dst->pos[0];
+				model[1] += src->pos[1] - dst->pos[1];
+				model[2] += src->pos[2] - dst->pos[2];
+
+				inv[X] = -dst->orient[X]; inv[Y] = -dst->orient[Y];
+				inv[Z] = -dst->orient[Z]; inv[W] =  dst->orient[W];
+				Quat_normalize (inv);
+				Quat_rotatePoint (inv, model, pos);
+			}
+
+			/* weights are written back in place, behind the one being read */
+			for (m = first; m < n && skin->joint[m] != to; ++m)
+				;
+
+			if (m == n) {
+				skin->joint[n] = to;
+				skin->bias[n] = 0.0f;
+				skin->posX[n] = skin->posY[n] = skin->posZ[n] = 0.0f;
+				n++;
+			}
+
+			/* bias weighted sum for now, divided out below */
+			skin->bias[m] += bias;
+			skin->posX[m] += bias * pos[0];
+			skin->posY[m] += bias * pos[1];
+			skin->posZ[m] += bias * pos[2];
+		}
+
+		for (j = first; j < n; ++j) {
+			if (skin->bias[j] != 0.0f) {
+				skin->posX[j] /= skin->bias[j];
+				skin->posY[j] /= skin->bias[j];
+				skin->posZ[j] /= skin->bias[j];
+			}
+		}
+
+		skin->start[i] = first;
+		skin->count[i] = n - first;
+	}
+
+	skin->num_weights = n;
+
+	/* the merged weights need their own normals */
+	BuildSkinNormals (mesh, bindSkel, skin);
+}
+
+/**
+ * Free resources allocated for the skinning data.
+ */
+void FreeMeshSkin (struct md5_skin_t *skin) {
+	free (skin->start);
+	free (skin->count);
+	free (skin->joint);
+	free (skin->bias);
+	free (skin->posX);
+	free (skin->posY);
+	free (skin->posZ);
+	free (skin->normX);
+	free (skin->normY);
+	free (skin->normZ);
+	free (skin->tanX);
+	free (skin->tanY);
+	free (skin->tanZ);
+
+	memset (skin, 0, sizeof (struct md5_skin_t));
+}
+
+/**
+ * Normalize a summed normal, and make the summed tangent unit length
+ * and square to it.  Either is left zero if there is no direction.
+ */
+static void FinishTangentSpace (const vec3_t n, const vec3_t t, float *normal, float *tangent) {
+	float len = sqrt (n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+	float s = (len > 0.0f) ? 1.0f / len : 0.0f;
+	vec3_t u;
+	float d;
+
+	normal[0] = n[0] * s;
+	normal[1] = n[1] * s;
+	normal[2] = n[2] * s;
+
+	if (!tangent)
+		return;
+
+	d = normal[0] * t[0] + normal[1] * t[1] + normal[2] * t[2];
+	u[0] = t[0] - normal[0] * d;
+	u[1] = t[1] - normal[1] * d;
+	u[2] = t[2] - normal[2] * d;
+
+	len = sqrt (u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+	s = (len > 0.0f) ? 1.0f / len : 0.0f;
+
+	tangent[0] = u[0] * s;
+	tangent[1] = u[1] * s;
+	tangent[2] = u[2] * s;
+}
+
+/**
+ * Rebuild the normals, and tangents unless null, of a mesh from skinned
+ * positions.  Each triangle adds its normal, as long as twice its area,
+ * and its tangent to its three vertices once, then every vertex is
+ * normalized.  Needs BuildMeshNormals().
+ */
+void RecomputeNormals (const struct md5_mesh_t *mesh, const vec3_t *positions,
+                       vec3_t *normals, vec3_t *tangents) {
+	static const vec3_t noTangent = { 0.0f, 0.0f, 0.0f };
+	int i, j, k;
+
+	memset (normals, 0, sizeof (vec3_t) * mesh->num_verts);
+	if (tangents)
+		memset (tangents, 0, sizeof (vec3_t) * mesh->num_verts);
+
+	for (i = 0; i < mesh->num_tris; ++i) {
+		const int *index = mesh->triangles[i].index;
+		const float *p0 = positions[index[0]], *p1 = positions[index[1]], *p2 = positions[index[2]];
+		vec3_t e1 = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+		vec3_t e2 = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+
+		/* Doom 3 winds its triangles clockwise */
+		vec3_t n = {
+			e2[1] * e1[2] - e2[2] * e1[1],
+			e2[2] * e1[0] - e2[0] * e1[2],
+			e2[0] * e1[1] - e2[1] * e1[0]
+		};
+
+		for (j = 0; j < 3; ++j)
+			for (k = 0; k < 3; ++k)
+				normals[index[j]][k] += n[k];
+
+		if (tangents) {
+			const struct md5_tri_tangent_t *tan = &mesh->triTangents[i];
+			vec3_t t = {
+				tan->tan1 * e1[0] + tan->tan2 * e2[0],
+				tan->tan1 * e1[1] + tan->tan2 * e2[1],
+				tan->tan1 * e1[2] + tan->tan2 * e2[2]
+			};
+
+			for (j = 0; j < 3; ++j)
+				for (k = 0; k < 3; ++k)
+					tangents[index[j]][k] += t[k];
+		}
+	}
+
+	for (i = 0; i < mesh->num_verts; ++i)
+		FinishTangentSpace (normals[i], tangents ? tangents[i] : noTangent, normals[i], tangents ? tangents[i] : nullptr);
+}
+
+/**
+ * Work out what turns each triangle's edges into the direction the
+ * texture's s coordinate grows in, then the bind pose normals and
+ * tangents of the mesh's skin.
+ */
+void BuildMeshNormals (struct md5_mesh_t *mesh, const struct md5_joint_t *bindSkel) {
+	int i;
+
+	free (mesh->triTangents);
+	mesh->triTangents = (struct md5_tri_tangent_t *)malloc (sizeof (struct md5_tri_tangent_t) * (mesh->num_tris + 1));
+
+	for (i = 0; i < mesh->num_tris; ++i) {
+		const int *index = mesh->triangles[i].index;
+		const float *st0 = mesh->vertices[index[0]].st;
+		const float *st1 = mesh->vertices[index[1]].st;
+		const float *st2 = mesh->vertices[index[2]].st;
+		float ds1 = st1[0] - st0[0], dt1 = st1[1] - st0[1];
+		float ds2 = st2[0] - st0[0], dt2 = st2[1] - st0[1];
+		float det = ds1 * dt2 - ds2 * dt1;
+
+		/* solve e1 = ds1 T + dt1 B, e2 = ds2 T + dt2 B for T */
+		mesh->triTangents[i].tan1 = (det != 0.0f) ?  dt2 / det : 0.0f;
+		mesh->triTangents[i].tan2 = (det != 0.0f) ? -dt1 / det : 0.0f;
+	}
+
+	BuildSkinNormals (mesh, bindSkel, &mesh->skin);
+}
+
+/**
+ * Work out the bind pose normal and tangent of every vertex, and store
+ * them in the space of each joint weighing on it.  Skinning them with
+ * the joint matrices then gives back the bind pose exactly, and follows
+ * the joints as they move.  The skin may have fewer weights than the
+ * mesh, see BuildReducedMeshSkin().
+ */
+void BuildSkinNormals (const struct md5_mesh_t *mesh, const struct md5_joint_t *bindSkel,
+                       struct md5_skin_t *skin) {
+	vec3_t *positions, *normals, *tangents;
+	int i, j, k;
+
+	if (!mesh->triTangents)
+		return;
+
+	positions = (vec3_t *)malloc (sizeof (vec3_t) * (mesh->num_verts + 1));
+	normals = (vec3_t *)malloc (sizeof (vec3_t) * (mesh->num_verts + 1));
+	tangents = (vec3_t *)malloc (sizeof (vec3_t) * (mesh->num_verts + 1));
+
+	for (k = 0, i = 0; i < skin->num_verts; ++i) {
+		positions[i][0] = positions[i][1] = positions[i][2] = 0.0f;
+
+		for (j = 0; j < skin->count[i]; ++j, ++k) {
+			const struct md5_joint_t *joint = &bindSkel[skin->joint[k]];
+			vec3_t pos = { skin->posX[k], skin->posY[k], skin->posZ[k] };
+			vec3_t wv;
+
+			Quat_rotatePoint (joint->orient, pos, wv);
+			positions[i][0] += (joint->pos[0] + wv[0]) * skin->bias[k];
+			positions[i][1] += (joint->pos[1] + wv[1]) * skin->bias[k];
+			positions[i][2] += (joint->pos[2] + wv[2]) * skin->bias[k];
+		}
+	}
+
+	RecomputeNormals (mesh, positions, normals, tangents);
+
+	free (skin->normX); free (skin->normY); free (skin->normZ);
+	free (skin->tanX); free (skin->tanY); free (skin->tanZ);
+
+	skin->normX = (float *)malloc (sizeof (float) * (skin->num_weights + 1));
+	skin->normY = (float *)malloc (sizeof (float) * (skin->num_weights + 1));
+	skin->normZ = (float *)malloc (sizeof (float) * (skin->num_weights + 1));
+	skin->tanX = (float *)malloc (sizeof (float) * (skin->num_weights + 1));
+	skin->tanY = (float *)malloc (sizeof (float) * (skin->num_weights + 1));
+	skin->tanZ = (float *)malloc (sizeof (float) * (skin->num_weights + 1));
+
+	for (k = 0, i = 0; i < skin->num_verts; ++i) {
+		for (j = 0; j < skin->count[i]; ++j, ++k) {
+			const float *orient = bindSkel[skin->joint[k]].orient;
+			quat4_t inv = { -orient[X], -orient[Y], -orient[Z], orient[W] };
+			vec3_t n, t;
+
+			Quat_normalize (inv);
+			Quat_rotatePoint (inv, normals[i], n);
+			Quat_rotatePoint (inv, tangents[i], t);
+
+			skin->normX[k] = n[0]; skin->normY[k] = n[1]; skin->normZ[k] = n[2];
+			skin->tanX[k] = t[0]; skin->tanY[k] = t[1]; skin->tanZ[k] = t[2];
+		}
+	}
+
+	free (positions);
+	free (normals);
+	free (tangents);
+}
+
+/**
+ * Convert each joint of a skeleton to a 3x4 matrix.  The rotation is
+ * built from the unnormalized quaternion so it matches Quat_rotatePoint()
+ * exactly, including for joints whose orientation drifted off unit length.
+ */
+void BuildJointMatrices (const struct md5_joint_t *skeleton, int num_joints,
+                         struct md5_joint_mat_t *out) {
+	int i;
+
+	for (i = 0; i < num_joints; ++i) {
+		const float *q = skeleton[i].orient;
+		float (*col)[4] = out[i].col;
+
+		float xx = q[X] * q[X], yy = q[Y] * q[Y], zz = q[Z] * q[Z], ww = q[W] * q[W];
+		float xy = q[X] * q[Y], xz = q[X] * q[Z], yz = q[Y] * q[Z];
+		float wx = q[W] * q[X], wy = q[W] * q[Y], wz = q[W] * q[Z];
+
+		/* q * v * normalize (q^-1) scales the rotation by |q| */
+		float mag = sqrt (xx + yy + zz + ww);
+		float s = (mag > 0.0f) ? 1.0f / mag : 0.0f;
+
+		col[0][0] = (ww + xx - yy - zz) * s;
+		col[0][1] = 2.0f * (xy + wz) * s;
+		col[0][2] = 2.0f * (xz - wy) * s;
+		col[0][3] = 0.0f;
+
+		col[1][0] = 2.0f * (xy - wz) * s;
+		col[1][1] = (ww - xx + yy - zz) * s;
+		col[1][2] = 2.0f * (yz + wx) * s;
+		col[1][3] = 0.0f;
+
+		col[2][0] = 2.0f * (xz + wy) * s;
+		col[2][1] = 2.0f * (yz - wx) * s;
+		col[2][2] = (ww - xx - yy + zz) * s;
+		col[2][3] = 0.0f;
+
+		col[3][0] = skeleton[i].pos[0];
+		col[3][1] = skeleton[i].pos[1];
+		col[3][2] = skeleton[i].pos[2];
+		col[3][3] = 1.0f;
+	}
+}
+
+/**
+ * Reference kernel, one vertex at a time.
+ */
+static void SkinMeshScalar (const struct md5_skin_t *skin,
+                            const struct md5_joint_mat_t *jointMats, vec3_t *out) {
+	int i, j, k;
+
+	for (k = 0, i = 0; i < skin->num_verts; ++i) {
+		float x = 0.0f, y = 0.0f, z = 0.0f;
+
+		for (j = 0; j < skin->count[i]; ++j, ++k) {
+			const float (*col)[4] = jointMats[skin->joint[k]].col;
+			float px = skin->posX[k], py = skin->posY[k], pz = skin->posZ[k];
+			float bias = skin->bias[k];
+
+			x += (col[0][0] * px + col[1][0] * py + col[2][0] * pz + col[3][0]) * bias;
+			y += (col[0][1] * px + col[1][1] * py + col[2][1] * pz + col[3][1]) * bias;
+			z += (col[0][2] * px + col[1][2] * py + col[2][2] * pz + col[3][2]) * bias;
+		}
+
+		out[i][0] = x;
+		out[i][1] = y;
+		out[i][2] = z;
+	}
+}
+
+#ifdef MD5_SKIN_HAS_SSE
+/**
+ * SSE kernel, one weight per instruction with the matrix columns as vectors.
+ */
+static void SkinMeshSSE (const struct md5_skin_t *skin,
+                         const struct md5_joint_mat_t *jointMats, vec3_t *out) {
+	int i, j, k;
+	float result[4];
+
+	for (k = 0, i = 0; i < skin->num_verts; ++i) {
+		__m128 acc = _mm_setzero_ps ();
+
+		for (j = 0; j < skin->count[i]; ++j, ++k) {
+			const float *m = jointMats[skin->joint[k]].col[0];
+
+			__m128 p = _mm_add_ps (_mm_add_ps (_mm_mul_ps (_mm_loadu_ps (m), _mm_set1_ps (skin->posX[k])),
+			                                   _mm_mul_ps (_mm_loadu_ps (m + 4), _mm_set1_ps (skin->posY[k]))),
+			                       _mm_add_ps (_mm_mul_ps (_mm_loadu_ps (m + 8), _mm_set1_ps (skin->posZ[k])),
+			                                   _mm_loadu_ps (m + 12)));
+			acc = _mm_add_ps (acc, _mm_mul_ps (p, _mm_set1_ps (skin->bias[k])));
+		}
+
+		_mm_storeu_ps (result, acc);
+		out[i][0] = result[0];
+		out[i][1] = result[1];
+		out[i][2] = result[2];
+	}
+}
+#endif
+
+#ifdef MD5_SKIN_HAS_AVX2
+/* two 128-bit values as the low and high halves of one register */
+#define MD5_SKIN_PAIR(lo, hi) _mm256_insertf128_ps (_mm256_castps128_ps256 (lo), (hi), 1)
+
+/**
+ * AVX2 kernel, two weights per instruction with FMA.  Each half of a
+ * register holds the matrix column of one weight, the halves are added
+ * once the vertex is done.
+ */
+MD5_SKIN_TARGET_AVX2
+static void SkinMeshAVX2 (const struct md5_skin_t *skin,
+                          const struct md5_joint_mat_t *jointMats, vec3_t *out) {
+	int i, j, k;
+	float result[4];
+
+	for (k = 0, i = 0; i < skin->num_verts; ++i) {
+		__m256 acc = _mm256_setzero_ps ();
+		__m128 acc4;
+
+		for (j = 0; j + 2 <= skin->count[i]; j += 2, k += 2) {
+			const float *a = jointMats[skin->joint[k]].col[0];
+			const float *b = jointMats[skin->joint[k + 1]].col[0];
+
+			__m256 p = MD5_SKIN_PAIR (_mm_loadu_ps (a + 12), _mm_loadu_ps (b + 12));
+			p = _mm256_fmadd_ps (MD5_SKIN_PAIR (_mm_loadu_ps (a), _mm_loadu_ps (b)),
+			                     MD5_SKIN_PAIR (_mm_broadcast_ss (skin->posX + k), _mm_broadcast_ss (skin->posX + k + 1)), p);
+			p = _mm256_fmadd_ps (MD5_SKIN_PAIR (_mm_loadu_ps (a + 4), _mm_loadu_ps (b + 4)),
+			                     MD5_SKIN_PAIR (_mm_broadcast_ss (skin->posY + k), _mm_broadcast_ss (skin->posY + k + 1)), p);
+			p = _mm256_fmadd_ps (MD5_SKIN_PAIR (_mm_loadu_ps (a + 8), _mm_loadu_ps (b + 8)),
+			                     MD5_SKIN_PAIR (_mm_broadcast_ss (skin->posZ + k), _mm_broadcast_ss (skin->posZ + k + 1)), p);
+			acc = _mm256_fmadd_ps (p, MD5_SKIN_PAIR (_mm_broadcast_ss (skin->bias + k), _mm_broadcast_ss (skin->bias + k + 1)), acc);
+		}
+
+		acc4 = _mm_add_ps (_mm256_castps256_ps128 (acc), _mm256_extractf128_ps (acc, 1));
+
+		/* odd weight out */
+		if (j < skin->count[i]) {
+			const float *a = jointMats[skin->joint[k]].col[0];
+
+			__m128 p = _mm_loadu_ps (a + 12);
+			p = _mm_fmadd_ps (_mm_loadu_ps (a), _mm_broadcast_ss (skin->posX + k), p);
+			p = _mm_fmadd_ps (_mm_loadu_ps (a + 4), _mm_broadcast_ss (skin->posY + k), p);
+			p = _mm_fmadd_ps (_mm_loadu_ps (a + 8), _mm_broadcast_ss (skin->posZ + k), p);
+			acc4 = _mm_fmadd_ps (p, _mm_broadcast_ss (skin->bias + k), acc4);
+			++k;
+		}
+
+		_mm_storeu_ps (result, acc4);
+		out[i][0] = result[0];
+		out[i][1] = result[1];
+		out[i][2] = result[2];
+	}
+}
+#endif
+
+/**
+ * Reference kernel with normals, rotating the bind pose normal and
+ * tangent of each weight by the joint but not moving them.
+ */
+static void SkinMeshNormalsScalar (const struct md5_skin_t *skin, const struct md5_joint_mat_t *jointMats,
+                                   vec3_t *out, vec3_t *normals, vec3_t *tangents) {
+	int i, j, k;
+
+	for (k = 0, i = 0; i < skin->num_verts; ++i) {
+		vec3_t p = { 0.0f, 0.0f, 0.0f };
+		vec3_t n = { 0.0f, 0.0f, 0.0f };
+		vec3_t t = { 0.0f, 0.0f, 0.0f };
+
+		for (j = 0; j < skin->count[i]; ++j, ++k) {
+			const float (*col)[4] = jointMats[skin->joint[k]].col;
+			float bias = skin->bias[k];
+			int c;
+
+			for (c = 0; c < 3; ++c) {
+				p[c] += (col[0][c] * skin->posX[k] + col[1][c] * skin->posY[k] + col[2][c] * skin->posZ[k] + col[3][c]) * bias;
+				n[c] += (col[0][c] * skin->normX[k] + col[1][c] * skin->normY[k] + col[2][c] * skin->normZ[k]) * bias;
+				if (tangents)
+					t[c] += (col[0][c] * skin->tanX[k] + col[1][c] * skin->tanY[k] + col[2][c] * skin->tanZ[k]) * bias;
+			}
+		}
+
+		out[i][0] = p[0];
+		out[i][1] = p[1];
+		out[i][2] = p[2];
+		FinishTangentSpace (n, t, normals[i], tangents ? tangents[i] : nullptr);
+	}
+}
+
+#ifdef MD5_SKIN_HAS_SSE
+/**
+ * SSE kernel with normals, the direction columns only for normals and
+ * tangents.
+ */
+static void SkinMeshNormalsSSE (const struct md5_skin_t *skin, const struct md5_joint_mat_t *jointMats,
+                                vec3_t *out, vec3_t *normals, vec3_t *tangents) {
+	int i, j, k;
+	float result[4], n[4], t[4];
+
+	for (k = 0, i = 0; i < skin->num_verts; ++i) {
+		__m128 acc = _mm_setzero_ps ();
+		__m128 nacc = _mm_setzero_ps ();
+		__m128 tacc = _mm_setzero_ps ();
+
+		for (j = 0; j < skin->count[i]; ++j, ++k) {
+			const float *m = jointMats[skin->joint[k]].col[0];
+			__m128 c0 = _mm_loadu_ps (m), c1 = _mm_loadu_ps (m + 4), c2 = _mm_loadu_ps (m + 8);
+			__m128 bias = _mm_set1_ps (skin->bias[k]);
+
+			__m128 p = _mm_add_ps (_mm_add_ps (_mm_mul_ps (c0, _mm_set1_ps (skin->posX[k])),
+			                                   _mm_mul_ps (c1, _mm_set1_ps (skin->posY[k]))),
+			                       _mm_add_ps (_mm_mul_ps (c2, _mm_set1_ps (skin->posZ[k])),
+			                                   _mm_loadu_ps (m + 12)));
+			__m128 d = _mm_add_ps (_mm_add_ps (_mm_mul_ps (c0, _mm_set1_ps (skin->normX[k])),
+			                                   _mm_mul_ps (c1, _mm_set1_ps (skin->normY[k]))),
+			                       _mm_mul_ps (c2, _mm_set1_ps (skin->normZ[k])));
+			acc = _mm_add_ps (acc, _mm_mul_ps (p, bias));
+			nacc = _mm_add_ps (nacc, _mm_mul_ps (d, bias));
+
+			if (tangents) {
+				d = _mm_add_ps (_mm_add_ps (_mm_mul_ps (c0, _mm_set1_ps (skin->tanX[k])),
+				                            _mm_mul_ps (c1, _mm_set1_ps (skin->tanY[k]))),
+				                _mm_mul_ps (c2, _mm_set1_ps (skin->tanZ[k])));
+				tacc = _mm_add_ps (tacc, _mm_mul_ps (d, bias));
+			}
+		}
+
+		_mm_storeu_ps (result, acc);
+		_mm_storeu_ps (n, nacc);
+		_mm_storeu_ps (t, tacc);
+		out[i][0] = result[0];
+		out[i][1] = result[1];
+		out[i][2] = result[2];
+		FinishTangentSpace (n, t, normals[i], tangents ? tangents[i] : nullptr);
+	}
+}
+#endif
+
+#ifdef MD5_SKIN_HAS_AVX2
+/**
+ * AVX2 kernel with normals, two weights per instruction as in
+ * SkinMeshAVX2().
+ */
+MD5_SKIN_TARGET_AVX2
+static void SkinMeshNormalsAVX2 (const struct md5_skin_t *skin, const struct md5_joint_mat_t *jointMats,
+                                 vec3_t *out, vec3_t *normals, vec3_t *tangents) {
+	int i, j, k;
+	float result[4], n[4], t[4];
+
+	for (k = 0, i = 0; i < skin->num_verts; ++i) {
+		__m256 acc = _mm256_setzero_ps ();
+		__m256 nacc = _mm256_setzero_ps ();
+		__m256 tacc = _mm256_setzero_ps ();
+		__m128 acc4, nacc4, tacc4;
+
+		for (j = 0; j + 2 <= skin->count[i]; j += 2, k += 2) {
+			const float *a = jointMats[skin->joint[k]].col[0];
+			const float *b = jointMats[skin->joint[k + 1]].col[0];
+			__m256 c0 = MD5_SKIN_PAIR (_mm_loadu_ps (a), _mm_loadu_ps (b));
+			__m256 c1 = MD5_SKIN_PAIR (_mm_loadu_ps (a + 4), _mm_loadu_ps (b + 4));
+			__m256 c2 = MD5_SKIN_PAIR (_mm_loadu_ps (a + 8), _mm_loadu_ps (b + 8));
+			__m256 bias = MD5_SKIN_PAIR (_mm_broadcast_ss (skin->bias + k), _mm_broadcast_ss (skin->bias + k + 1));
+
+			__m256 p = MD5_SKIN_PAIR (_mm_loadu_ps (a + 12), _mm_loadu_ps (b + 12));
+			p = _mm256_fmadd_ps (c0, MD5_SKIN_PAIR (_mm_broadcast_ss (skin->posX + k), _mm_broadcast_ss (skin->posX + k + 1)), p);
+			p = _mm256_fmadd_ps (c1, MD5_SKIN_PAIR (_mm_broadcast_ss (skin->posY + k), _mm_broadcast_ss (skin->posY + k + 1)), p);
+			p = _mm256_fmadd_ps (c2, MD5_SKIN_PAIR (_mm_broadcast_ss (skin->posZ + k), _mm_broadcast_ss (skin->posZ + k + 1)), p);
+			acc = _mm256_fmadd_ps (p, bias, acc);
+
+			__m256 d = _mm256_mul_ps (c0, MD5_SKIN_PAIR (_mm_broadcast_ss (skin->normX + k), _mm_broadcast_ss (skin->normX + k + 1)));
+			d = _mm256_fmadd_ps (c1, MD5_SKIN_PAIR (_mm_broadcast_ss (skin->normY + k), _mm_broadcast_ss (skin->normY + k + 1)), d);
+			d = _mm256_fmadd_ps (c2, MD5_SKIN_PAIR (_mm_broadcast_ss (skin->normZ + k), _mm_broadcast_ss (skin->normZ + k + 1)), d);
+			nacc = _mm256_fmadd_ps (d, bias, nacc);
+
+			if (tangents) {
+				d = _mm256_mul_ps (c0, MD5_SKIN_PAIR (_mm_broadcast_ss (skin->tanX + k), _mm_broadcast_ss (skin->tanX + k + 1)));
+				d = _mm256_fmadd_ps (c1, MD5_SKIN_PAIR (_mm_broadcast_ss (skin->tanY + k), _mm_broadcast_ss (skin->tanY + k + 1)), d);
+				d = _mm256_fmadd_ps (c2, MD5_SKIN_PAIR (_mm_broadcast_ss (skin->tanZ + k), _mm_broadcast_ss (skin->tanZ + k + 1)), d);
+				tacc = _mm256_fmadd_ps (d, bias, tacc);
+			}
+		}
+
+		acc4 = _mm_add_ps (_mm256_castps256_ps128 (acc), _mm256_extractf128_ps (acc, 1));
+		nacc4 = _mm_add_ps (_mm256_castps256_ps128 (nacc), _mm256_extractf128_ps (nacc, 1));
+		tacc4 = _mm_add_ps (_mm256_castps256_ps128 (tacc), _mm256_extractf128_ps (tacc, 1));
+
+		/* odd weight out */
+		if (j < skin->count[i]) {
+			const float *a = jointMats[skin->joint[k]].col[0];
+			__m128 c0 = _mm_loadu_ps (a), c1 = _mm_loadu_ps (a + 4), c2 = _mm_loadu_ps (a + 8);
+			__m128 bias = _mm_broadcast_ss (skin->bias + k);
+
+			__m128 p = _mm_loadu_ps (a + 12);
+			p = _mm_fmadd_ps (c0, _mm_broadcast_ss (skin->posX + k), p);
+			p = _mm_fmadd_ps (c1, _mm_broadcast_ss (skin->posY + k), p);
+			p = _mm_fmadd_ps (c2, _mm_broadcast_ss (skin->posZ + k), p);
+			acc4 = _mm_fmadd_ps (p, bias, acc4);
+
+			__m128 d = _mm_mul_ps (c0, _mm_broadcast_ss (skin->normX + k));
+			d = _mm_fmadd_ps (c1, _mm_broadcast_ss (skin->normY + k), d);
+			d = _mm_fmadd_ps (c2, _mm_broadcast_ss (skin->normZ + k), d);
+			nacc4 = _mm_fmadd_ps (d, bias, nacc4);
+
+			if (tangents) {
+				d = _mm_mul_ps (c0, _mm_broadcast_ss (skin->tanX + k));
+				d = _mm_fmadd_ps (c1, _mm_broadcast_ss (skin->tanY + k), d);
+				d = _mm_fmadd_ps (c2, _mm_broadcast_ss (skin->tanZ + k), d);
+				tacc4 = _mm_fmadd_ps (d, bias, tacc4);
+			}
+			++k;
+		}
+
+		_mm_storeu_ps (result, acc4);
+		_mm_storeu_ps (n, nacc4);
+		_mm_storeu_ps (t, tacc4);
+		out[i][0] = result[0];
+		out[i][1] = result[1];
+		out[i][2] = result[2];
+		FinishTangentSpace (n, t, normals[i], tangents ? tangents[i] : nullptr);
+	}
+}
+#endif
+
+/**
+ * Check if a kernel was compiled in and can run on this CPU.
+ */
+int SkinKernelSupported (int kernel) {
+	switch (kernel) {
+		case MD5_SKIN_SCALAR:
+			return 1;
+
+#ifdef MD5_SKIN_HAS_SSE
+		case MD5_SKIN_SSE:
+			return 1;
+#endif
+
+#ifdef MD5_SKIN_HAS_AVX2
+		case MD5_SKIN_AVX2:
+			__builtin_cpu_init ();
+			return __builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma");
+#endif
+
+		default:
+			return 0;
+	}
+}
+
+/**
+ * Kernel used by SkinMesh(), the fastest supported one unless set.
+ */
+static int FastestSkinKernel () {
+	int kernel = MD5_SKIN_NUM_KERNELS - 1;
+	while (!SkinKernelSupported (kernel))
+		--kernel;
+
+	return kernel;
+}
+
+int GetSkinKernel () {
+	int kernel = skinKernel.load (std::memory_order_acquire);
+	if (kernel < 0) {
+		/* the CPU is checked once, by whichever thread gets here first */
+		static const int fastest = FastestSkinKernel ();
+
+		/* unless SetSkinKernel() got in first */
+		skinKernel.compare_exchange_strong (kernel, fastest, std::memory_order_acq_rel);
+		kernel = skinKernel.load (std::memory_order_acquire);
+	}
+
+	return kernel;
+}
+
+void SetSkinKernel (int kernel) {
+	if (SkinKernelSupported (kernel)) {
+		skinKernel.store (kernel, std::memory_order_release);
+	} else {
+		fprintf (stderr, "[.md5mesh]: %s skinning not supported, keeping %s\n",
+				GetSkinKernelName (kernel), GetSkinKernelName (GetSkinKernel ()));
+	}
+}
+
+const char *GetSkinKernelName (int kernel) {
+	switch (kernel) {
+		case MD5_SKIN_SCALAR: return "scalar";
+		case MD5_SKIN_SSE:    return "SSE";
+		case MD5_SKIN_AVX2:   return "AVX2";
+		default:              return "unknown";
+	}
+}
+
+/**
+ * Compute the final vertex positions of a mesh from the joint matrices
+ * of the current frame.
+ */
+void SkinMesh (const struct md5_skin_t *skin,
+               const struct md5_joint_mat_t *jointMats, vec3_t *out) {
+	switch (GetSkinKernel ()) {
+#ifdef MD5_SKIN_HAS_AVX2
+		case MD5_SKIN_AVX2:
+			SkinMeshAVX2 (skin, jointMats, out);
+			break;
+#endif
+
+#ifdef MD5_SKIN_HAS_SSE
+		case MD5_SKIN_SSE:
+			SkinMeshSSE (skin, jointMats, out);
+			break;
+#endif
+
+		default:
+			SkinMeshScalar (skin, jointMats, out);
+			break;
+	}
+}
+
+/**
+ * Same as SkinMesh() but also skins the normals, and the tangents
+ * unless null, in the same pass.  Without BuildSkinNormals() only the
+ * positions are skinned.
+ */
+void SkinMeshNormals (const struct md5_skin_t *skin, const struct md5_joint_mat_t *jointMats,
+                      vec3_t *out, vec3_t *normals, vec3_t *tangents) {
+	if (!skin->normX) {
+		SkinMesh (skin, jointMats, out);
+		return;
+	}
+
+	switch (GetSkinKernel ()) {
+#ifdef MD5_SKIN_HAS_AVX2
+		case MD5_SKIN_AVX2:
+			SkinMeshNormalsAVX2 (skin, jointMats, out, normals, tangents);
+			break;
+#endif
+
+#ifdef MD5_SKIN_HAS_SSE
+		case MD5_SKIN_SSE:
+			SkinMeshNormalsSSE (skin, jointMats, out, normals, tangents);
+			break;
+#endif
+
+		default:
+			SkinMeshNormalsScalar (skin, jointMats, out, normals, tangents);
+			break;
+	}
+}
+
+/**
+ * Prepare a mesh for drawing.  Compute mesh's final vertex positions
+ * given a skeleton.  Put the vertices in vertex arrays.
+ */
+void PrepareMesh (const struct md5_mesh_t *mesh, const struct md5_joint_t *skeleton) {
+	int i, j;
+
+	/* Setup vertices, indices and texture coordinates never change and
+	   were sent by AllocVertexArrays() */
+	for (i = 0; i < mesh->num_verts; ++i) {
+		vec3_t finalVertex = { 0.0f, 0.0f, 0.0f };
+
+		/* Calculate final vertex to draw with weights */
+		for (j = 0; j < mesh->vertices[i].count; ++j) {
+			const struct md5_weight_t *weight = &mesh->weights[mesh->vertices[i].start + j];
+			const struct md5_joint_t  *joint  = &skeleton[weight->joint];
+
+			/* Calculate transformed vertex for this weight */
+			vec3_t wv;
+			Quat_rotatePoint (joint->orient, weight->pos, wv);
+
+			/* The sum of all weight->bias should be 1.0 */
+			finalVertex[0] += (joint->pos[0] + wv[0]) * weight->bias;
+			finalVertex[1] += (joint->pos[1] + wv[1]) * weight->bias;
+			finalVertex[2] += (joint->pos[2] + wv[2]) * weight->bias;
+		}
+
+		vertexArray[i][0] = finalVertex[0];
+		vertexArray[i][1] = finalVertex[1];
+		vertexArray[i][2] = finalVertex[2];
+	}
+}
+
+/**
+ * Same as PrepareMesh() but skins the vertices with the joint matrices
+ * of the current frame, see BuildJointMatrices().
+ */
+void PrepareSkinnedMesh (const struct md5_mesh_t *mesh, const struct md5_joint_mat_t *jointMats) {
+	/* Setup vertices, and normals for lighting */
+	switch (meshNormals) {
+		case MD5_NORMALS_SKINNED:
+			SkinMeshNormals (&mesh->skin, jointMats, vertexArray, normalArray, nullptr);
+			break;
+
+		case MD5_NORMALS_RECOMPUTED:
+			SkinMesh (&mesh->skin, jointMats, vertexArray);
+			RecomputeNormals (mesh, vertexArray, normalArray, nullptr);
+			break;
+
+		default:
+			SkinMesh (&mesh->skin, jointMats, vertexArray);
+			break;
+	}
+}
+
+/**
+ * Pick where PrepareSkinnedMesh() gets normals from, MD5_NORMALS_NONE
+ * draws the model unlit.
+ */
+void SetMeshNormals (int normals) {
+	meshNormals = normals;
+}
+
+/**
+ * The arrays PrepareMesh() and PrepareSkinnedMesh() write to, without
+ * anything on the GPU, so a mesh can be skinned with no GL context.
+ */
+void AllocMeshArrays (const struct md5_model_t *mdl) {
+	int maxVerts = 0;
+	int i;
+
+	for (i = 0; i < mdl->num_meshes; ++i)
+		if (mdl->meshes[i].num_verts > maxVerts)
+			maxVerts = mdl->meshes[i].num_verts;
+
+	vertexArray = (vec3_t *)malloc (sizeof (vec3_t) * maxVerts);
+	normalArray = (vec3_t *)malloc (sizeof (vec3_t) * maxVerts);
+}
+
+void FreeMeshArrays () {
+	if (vertexArray) {
+		free (vertexArray);
+		vertexArray = nullptr;
+	}
+
+	if (normalArray) {
+		free (normalArray);
+		normalArray = nullptr;
+	}
+}
+
+/**
+ * Vertices of the mesh last prepared, and their normals unless
+ * SetMeshNormals() turned them off.
+ */
+const vec3_t *GetMeshVertices () {
+	return vertexArray;
+}
+
+const vec3_t *GetMeshNormals () {
+	return normalArray;
+}
@@ -0,0 +1,151 @@
+/*
+ * md5stream.c -- md5mesh model loader + animation
+ *
+ * Ring buffer for vertex data that changes every frame.  The buffer is
+ * split into MD5_STREAM_FRAMES regions, one per frame in flight, and a
+ * fence guards each region so the CPU only writes memory the GPU has
+ * finished drawing from.  With GL_ARB_buffer_storage the whole ring is
+ * mapped once and written directly, otherwise each write maps its range
+ * unsynchronized.
+ * Dependencies: md5model.h.
+ *
+ */
+
+#include <GL/glew.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "MD5/md5model.h"
+
+/* Streamed vertex ring */
+struct md5_stream_t
+{
+    GLuint vbo;
+
+    GLsizeiptr frameSize;
+    int frame; /* region written this frame */
+    int waited; /* region's fence already checked this frame */
+
+    unsigned char *mapped; /* persistent mapping, null without buffer storage */
+    GLsync fences[MD5_STREAM_FRAMES];
+
+    unsigned long bytesThisFrame;
+    unsigned long bytesLastFrame;
+};
+
+/**
+ * Create a ring with frameSize bytes for each frame in flight.
+ */
+struct md5_stream_t *AllocStream (long frameSize) {
+	struct md5_stream_t *stream = (struct md5_stream_t *)calloc (1, sizeof (struct md5_stream_t));
+	GLsizeiptr size = frameSize * MD5_STREAM_FRAMES;
+
+	stream->frameSize = frameSize;
+
+	glGenBuffers (1, &stream->vbo);
+	glBindBuffer (GL_ARRAY_BUFFER, stream->vbo);
+
+	if (GLEW_ARB_buffer_storage) {
+		const GLbitfield FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		glBufferStorage (GL_ARRAY_BUFFER, size, nullptr, FLAGS);
+		stream->mapped = (unsigned char *)glMapBufferRange (GL_ARRAY_BUFFER, 0, size, FLAGS);
+		if (!stream->mapped)
+			fprintf (stderr, "[.md5mesh]: Error: could not persistently map the vertex stream\n");
+	} else {
+		glBufferData (GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+	}
+
+	return stream;
+}
+
+/**
+ * Free resources allocated for the ring.
+ */
+void FreeStream (struct md5_stream_t *stream) {
+	int i;
+
+	if (!stream)
+		return;
+
+	for (i = 0; i < MD5_STREAM_FRAMES; ++i) {
+		if (stream->fences[i])
+			glDeleteSync (stream->fences[i]);
+	}
+
+	if (stream->mapped) {
+		glBindBuffer (GL_ARRAY_BUFFER, stream->vbo);
+		glUnmapBuffer (GL_ARRAY_BUFFER);
+	}
+	glDeleteBuffers (1, &stream->vbo);
+
+	free (stream);
+}
+
+/**
+ * Copy size bytes to offset within this frame's region.  Returns the
+ * byte offset of the data within the buffer, for glVertexAttribPointer.
+ * Leaves the ring bound to GL_ARRAY_BUFFER.
+ */
+unsigned long StreamWrite (struct md5_stream_t *stream, long offset, const void *data, long size) {
+	GLintptr start = stream->frame * stream->frameSize + offset;
+
+	/* only blocks if the GPU is more than MD5_STREAM_FRAMES - 1 frames behind */
+	if (!stream->waited) {
+		GLsync fence = stream->fences[stream->frame];
+
+		if (fence) {
+			while (glClientWaitSync (fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED)
+				;
+			glDeleteSync (fence);
+			stream->fences[stream->frame] = nullptr;
+		}
+		stream->waited = 1;
+	}
+
+	glBindBuffer (GL_ARRAY_BUFFER, stream->vbo);
+
+	if (stream->mapped) {
+		memcpy (stream->mapped + start, data, size);
+	} else {
+		/* the fence above already made this range safe to overwrite */
+		void *dst = glMapBufferRange (GL_ARRAY_BUFFER, start, size,
+				GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+
+		if (dst) {
+			memcpy (dst, data, size);
+			glUnmapBuffer (GL_ARRAY_BUFFER);
+		}
+	}
+
+	stream->bytesThisFrame += size;
+
+	return start;
+}
+
+/**
+ * Fence the draws that read this frame's region and move to the next one.
+ */
+void EndStreamFrame (struct md5_stream_t *stream) {
+	if (stream->waited)
+		stream->fences[stream->frame] = glFenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	stream->frame = (stream->frame + 1) % MD5_STREAM_FRAMES;
+	stream->waited = 0;
+
+	stream->bytesLastFrame = stream->bytesThisFrame;
+	stream->bytesThisFrame = 0;
+}
+
+unsigned int GetStreamBuffer (const struct md5_stream_t *stream) {
+	return stream->vbo;
+}
+
+/**
+ * Bytes written during the last finished frame.
+ */
+unsigned long GetStreamBytesUploaded (const struct md5_stream_t *stream) {
+	return stream->bytesLastFrame;
+}
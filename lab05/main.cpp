@@ -51,11 +51,9 @@ GLboolean keys[256] = {0};              // keep track of our key states
 
 GLfloat propAngle;                      // angle of rotation for our plane propeller
 
-struct BuildingData {                   // stores the information unique to a single building
-    glm::mat4 modelMatrix;                  // the translation/scale of each building
-    glm::vec3 color;                        // the color of each building
-};
-std::vector<BuildingData> buildings;    // information for all of our buildings
+std::vector<glm::mat4> buildingModelMatrices;   // the translation/scale of each building
+std::vector<glm::vec3> buildingColors;          // the color of each building
+std::vector<glm::mat3> buildingNormalMatrices;  // the normal matrix of each building
 
 GLuint groundVAO;                       // the VAO descriptor for our ground plane
 
@@ -72,11 +70,16 @@ struct LightingShaderUniforms {         // stores the locations of all of our sh
     GLint modelMatrix;
     GLint materialColor;
     GLint eyePos;
+    GLint viewProjectionMatrix;
+    GLint instanced;
 } lightingShaderUniforms;
 struct LightingShaderAttributes {       // stores the locations of all of our shader attributes
     // TODO #2 add variables to store the new attributes that were created
     GLint vertexNormal_attr_location;
     GLint vPos;
+    GLint instanceModelMatrix;
+    GLint instanceColor;
+    GLint instanceNormalMatrix;
 } lightingShaderAttributes;
 
 //*************************************************************************************
@@ -331,13 +334,16 @@ void renderScene( glm::mat4 viewMtx, glm::mat4 projMtx )  {
     //// END DRAWING THE GROUND PLANE ////
 
     //// BEGIN DRAWING THE BUILDINGS ////
-    for( const BuildingData& currentBuilding : buildings ) {
-        computeAndSendMatrixUniforms(currentBuilding.modelMatrix, viewMtx, projMtx);
+    // every building is the same cube, so draw the whole city in one call
+    glm::mat4 vpMtx = projMtx * viewMtx;
+    glUniformMatrix4fv(lightingShaderUniforms.viewProjectionMatrix, 1, GL_FALSE, &vpMtx[0][0]);
+    glUniform1i(lightingShaderUniforms.instanced, GL_TRUE);
 
-        glUniform3fv(lightingShaderUniforms.materialColor, 1, &currentBuilding.color[0]);
+    CSCI441::drawSolidCubeInstanced(1.0, (GLsizei)buildingModelMatrices.size(),
+                                    (const GLfloat*)buildingModelMatrices.data(), (const GLfloat*)buildingColors.data(),
+                                    (const GLfloat*)buildingNormalMatrices.data());
 
-        CSCI441::drawSolidCube(1.0);
-    }
+    glUniform1i(lightingShaderUniforms.instanced, GL_FALSE);
     //// END DRAWING THE BUILDINGS ////
 
     //// BEGIN DRAWING THE PLANE ////
@@ -431,10 +437,9 @@ void generateEnvironmentDL() {
                 glm::vec3 color( getRand(), getRand(), getRand() );
 
                 // store building properties
-                BuildingData currentBuilding;
-                currentBuilding.modelMatrix = modelMtx;
-                currentBuilding.color = color;
-                buildings.emplace_back( currentBuilding );
+                buildingModelMatrices.emplace_back( modelMtx );
+                buildingColors.emplace_back( color );
+                buildingNormalMatrices.emplace_back( glm::transpose( glm::inverse( glm::mat3( modelMtx ) ) ) );
             }
         }
     }
@@ -548,9 +553,14 @@ void setupShaders() {
     lightingShaderUniforms.normalMtx = lightingShader->getUniformLocation("normalMatrix");
     lightingShaderUniforms.eyePos        = lightingShader->getUniformLocation("eyePos");
     lightingShaderUniforms.spotLightTheta        = lightingShader->getUniformLocation("spotLightTheta");
+    lightingShaderUniforms.viewProjectionMatrix = lightingShader->getUniformLocation("viewProjectionMatrix");
+    lightingShaderUniforms.instanced     = lightingShader->getUniformLocation("instanced");
 
     lightingShaderAttributes.vPos         = lightingShader->getAttributeLocation("vPos");
     lightingShaderAttributes.vertexNormal_attr_location = lightingShader->getAttributeLocation("vertexNormal");
+    lightingShaderAttributes.instanceModelMatrix = lightingShader->getAttributeLocation("instanceModelMatrix");
+    lightingShaderAttributes.instanceColor = lightingShader->getAttributeLocation("instanceColor");
+    lightingShaderAttributes.instanceNormalMatrix = lightingShader->getAttributeLocation("instanceNormalMatrix");
     // TODO #10A get the location of our ModelViewProjection uniform and set it to the global variable mvp_uniform_location
 }
 
@@ -664,6 +674,9 @@ int main() {
     // TODO #5 connect the CSCI441 objects library to our shader attribute inputs
     // needed to connect our 3D Object Library to our shader
     CSCI441::setVertexAttributeLocations( lightingShaderAttributes.vPos, lightingShaderAttributes.vertexNormal_attr_location);
+    // and the per-building model matrix, color and normal matrix for the instanced city
+    CSCI441::setInstanceAttributeLocations( lightingShaderAttributes.instanceModelMatrix, lightingShaderAttributes.instanceColor,
+                                            lightingShaderAttributes.instanceNormalMatrix );
 
 
 	//  This is our draw loop - all rendering is done here.  We use a loop to keep the window open
@@ -16,19 +16,37 @@ uniform float spotLightTheta;
 // the direction the incident ray of light is traveling
 // the color of the light
 uniform vec3 materialColor;             // the material color for our vertex (& whole object)
+uniform mat4 viewProjectionMatrix;      // the View-Projection Matrix, used when drawing instances
+uniform bool instanced;                 // true when the model matrix and color come from the instance attributes
 
 // attribute inputs
 layout(location = 0) in vec3 vPos;      // the position of this specific vertex in object space
 // TODO #C add our vertex normal
 in vec3 vertexNormal;
 // the normal of this specific vertex in object space
+in mat4 instanceModelMatrix;            // the model matrix of this instance
+in vec3 instanceColor;                  // the material color of this instance
+in mat3 instanceNormalMatrix;           // the normal matrix of this instance, computed with its model matrix
 
 // varying outputs
 layout(location = 0) out vec3 color;    // color to apply to this vertex
 
 void main() {
+    mat4 model = modelMatrix;
+    mat3 normalMtx = normalMatrix;
+    vec3 objectColor = materialColor;
+    if( instanced ) {
+        model = instanceModelMatrix;
+        normalMtx = instanceNormalMatrix;
+        objectColor = instanceColor;
+    }
+
     // transform & output the vertex in clip space
-    gl_Position = mvpMatrix * vec4(vPos, 1.0);
+    if( instanced ) {
+        gl_Position = viewProjectionMatrix * model * vec4(vPos, 1.0);
+    } else {
+        gl_Position = mvpMatrix * vec4(vPos, 1.0);
+    }
 
     // TODO #B convert the light direction to our normalized light vector
 
@@ -41,20 +59,20 @@ void main() {
     float objectTheta = acos(dot(spotLightDirection, lightToPoint)/(spotMag * lightToPointDist));
     vec3 spotColor = vec3(0,0,0);
     // TODO #E transform the vertex normal in to world space
-    vec3 normalizedVertexNorm = normalMatrix * vertexNormal;
+    vec3 normalizedVertexNorm = normalMtx * vertexNormal;
     //specular reflectance math
-    vec4 tempVec = vec4(eyePos,1.0f) - modelMatrix * vec4(vPos, 1.0f);
+    vec4 tempVec = vec4(eyePos,1.0f) - model * vec4(vPos, 1.0f);
     float magnitude = sqrt(pow(tempVec.x, 2.0) + pow(tempVec.y, 2.0) + pow(tempVec.z, 2.0));
     vec3 viewVector = vec3(tempVec.x/magnitude, tempVec.y/magnitude, tempVec.z/magnitude);
 
     vec3 diffuse, specular, ambient;
     if (abs(objectTheta) <= spotLightTheta) {
         // TODO #F compute the diffuse component of the Phong Illumination Model
-        diffuse = diffuseSpotLightColor * materialColor * max(dot(normSpotLightDir, normalizedVertexNorm), 0);
+        diffuse = diffuseSpotLightColor * objectColor * max(dot(normSpotLightDir, normalizedVertexNorm), 0);
 
-        specular = specularSpotLightColor * materialColor * max(dot((normSpotLightDir + viewVector), normalizedVertexNorm), 0);
+        specular = specularSpotLightColor * objectColor * max(dot((normSpotLightDir + viewVector), normalizedVertexNorm), 0);
 
-        ambient = ambientSpotLightColor * materialColor;
+        ambient = ambientSpotLightColor * objectColor;
 
         float attenFact = 0.3 + 0.02*lightToPointDist + 0.01*pow(lightToPointDist, 2);
         // TODO #G output the illumination color of this vertex
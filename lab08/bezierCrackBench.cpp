@@ -0,0 +1,162 @@
+/*
+ *  CSCI 441, Computer Graphics, Fall 2020
+ *
+ *  Project: lab08
+ *  File: bezierCrackBench.cpp
+ *
+ *  Description:
+ *      Tessellates a 4x4 grid of bicubic patches whose orientation alternates
+ *      from patch to patch, so neighbors walk their shared edges in opposite
+ *      directions, once against an object space tolerance and once against a
+ *      screen space one.  Welds the vertices by exact position and checks the
+ *      mesh has no cracks: every edge used by only one triangle lies on the
+ *      outer border of the grid, no edge is used by more than two, the two
+ *      triangles on an edge walk it in opposite directions and every triangle
+ *      faces along its normals.  Also checks 1 and 4 threads build the same
+ *      mesh.  Needs no window or OpenGL context.
+ *
+ *  Usage: bezierCrackBench
+ *
+ */
+
+#include <CSCI441/BezierSurface.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <utility>
+#include <vector>
+
+const int GRID = 4;                         // patches along each side
+const int LATTICE = 3*GRID + 1;             // control points along each side
+
+// a lattice of control points in the xz plane, flat on one half and rough on the other so
+// neighboring patches pick different segment counts
+CSCI441::BezierSurface makeGrid() {
+    std::vector<float> points;
+    srand( 3 );
+    for( int i = 0; i < LATTICE; i++ ) {
+        for( int j = 0; j < LATTICE; j++ ) {
+            points.push_back( (float)i );
+            points.push_back( (rand() % 100) / 100.0f * (i > LATTICE / 2 ? 8.0f : 0.2f) );
+            points.push_back( (float)j );
+        }
+    }
+
+    // every other patch is turned half way around, running both u and v backwards, so the
+    // surface keeps facing up while neighbors walk their shared edges in opposite directions
+    std::vector<unsigned int> patches;
+    for( int a = 0; a < GRID; a++ ) {
+        for( int b = 0; b < GRID; b++ ) {
+            bool flipped = (a + b) % 2 == 1;
+            for( int i = 0; i < 4; i++ ) {
+                for( int j = 0; j < 4; j++ ) {
+                    int row = flipped ? 3 - i : i, column = flipped ? 3 - j : j;
+                    patches.push_back( (a*3 + row)*LATTICE + b*3 + column );
+                }
+            }
+        }
+    }
+
+    CSCI441::BezierSurface surface;
+    surface.setControlPoints( &points[0], points.size() / 3 );
+    surface.setPatches( &patches[0], GRID*GRID );
+    return surface;
+}
+
+bool onBorder( const std::array<float, 3> &p ) {
+    return fabsf( p[0] ) < 1e-4f || fabsf( p[0] - (LATTICE-1) ) < 1e-4f
+        || fabsf( p[2] ) < 1e-4f || fabsf( p[2] - (LATTICE-1) ) < 1e-4f;
+}
+
+// true when the mesh is watertight away from the border and wound consistently
+bool checkMesh( const CSCI441::MeshData &mesh ) {
+    // weld by exact position, a crack is any boundary vertex the two sides evaluated differently
+    std::map< std::array<float, 3>, unsigned int > welded;
+    std::vector<unsigned int> weldedId( mesh.numVertices() );
+    std::vector< std::array<float, 3> > weldedPositions;
+    for( size_t i = 0; i < mesh.numVertices(); i++ ) {
+        std::array<float, 3> p = { mesh.positions[i*3 + 0], mesh.positions[i*3 + 1], mesh.positions[i*3 + 2] };
+        std::map< std::array<float, 3>, unsigned int >::iterator found = welded.find( p );
+        if( found == welded.end() ) {
+            found = welded.insert( std::make_pair( p, (unsigned int)weldedPositions.size() ) ).first;
+            weldedPositions.push_back( p );
+        }
+        weldedId[i] = found->second;
+    }
+
+    // uses of each undirected edge, and the balance of its two directions
+    std::map< std::pair<unsigned int, unsigned int>, std::pair<int, int> > edges;
+    unsigned int backFacing = 0;
+    for( size_t t = 0; t < mesh.indices.size(); t += 3 ) {
+        for( int k = 0; k < 3; k++ ) {
+            unsigned int a = weldedId[ mesh.indices[t + k] ], b = weldedId[ mesh.indices[t + (k+1) % 3] ];
+            std::pair<int, int> &uses = edges[ std::make_pair( std::min( a, b ), std::max( a, b ) ) ];
+            uses.first++;
+            uses.second += a < b ? 1 : -1;
+        }
+
+        const float *p0 = &mesh.positions[ mesh.indices[t + 0]*3 ];
+        const float *p1 = &mesh.positions[ mesh.indices[t + 1]*3 ];
+        const float *p2 = &mesh.positions[ mesh.indices[t + 2]*3 ];
+        float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+        float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+        float n[3] = { e1[1]*e2[2] - e1[2]*e2[1], e1[2]*e2[0] - e1[0]*e2[2], e1[0]*e2[1] - e1[1]*e2[0] };
+        const float *vn = &mesh.normals[ mesh.indices[t + 0]*3 ];
+        if( n[0]*vn[0] + n[1]*vn[1] + n[2]*vn[2] < 0.0f ) backFacing++;
+    }
+
+    unsigned int border = 0, cracks = 0, overused = 0, miswound = 0;
+    std::map< std::pair<unsigned int, unsigned int>, std::pair<int, int> >::const_iterator edge;
+    for( edge = edges.begin(); edge != edges.end(); ++edge ) {
+        if( edge->second.first > 2 ) {
+            overused++;
+        } else if( edge->second.first == 2 ) {
+            if( edge->second.second != 0 ) miswound++;
+        } else if( onBorder( weldedPositions[ edge->first.first ] ) && onBorder( weldedPositions[ edge->first.second ] ) ) {
+            border++;
+        } else {
+            cracks++;
+        }
+    }
+
+    printf( " %10lu %10lu %8u %8u %10u %10u %12u", mesh.numVertices(), mesh.indices.size() / 3,
+            border, cracks, overused, miswound, backFacing );
+    return cracks == 0 && overused == 0 && miswound == 0 && backFacing == 0 && border > 0;
+}
+
+int main() {
+    CSCI441::BezierSurface surface = makeGrid();
+
+    // looking down on the grid from above, an orthographic camera a fifth of the grid across
+    const float mvpMatrix[16] = { 0.2f, 0.0f, 0.0f, 0.0f,
+                                  0.0f, 0.2f, 0.0f, 0.0f,
+                                  0.0f, 0.0f, 0.01f, 0.1f,
+                                  -1.0f, -1.0f, 0.0f, 1.0f };
+
+    printf( "[INFO]: %d x %d patches, alternating orientation\n", GRID, GRID );
+    printf( "[INFO]: %-12s %10s %10s %8s %8s %10s %10s %12s %10s\n", "tolerance", "vertices", "triangles",
+            "border", "cracks", "overused", "miswound", "back facing", "threads" );
+
+    bool passed = true;
+    for( int mode = 0; mode < 2; mode++ ) {
+        if( mode == 0 ) surface.setTolerance( 0.05f );
+        else            surface.setScreenTolerance( mvpMatrix, 640, 640, 0.5f );
+
+        CSCI441::MeshData single = surface.tessellate( 1 );
+        CSCI441::MeshData threaded = surface.tessellate( 4 );
+
+        printf( "[INFO]: %-12s", mode == 0 ? "0.05 units" : "0.5 pixels" );
+        bool watertight = checkMesh( single );
+        bool same = single.positions == threaded.positions && single.normals == threaded.normals
+                 && single.texCoords == threaded.texCoords && single.indices == threaded.indices;
+        printf( " %10s\n", same ? "same" : "DIFFERENT" );
+        passed = passed && watertight && same;
+    }
+
+    printf( "[INFO]: %s\n", passed ? "PASS" : "FAIL" );
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
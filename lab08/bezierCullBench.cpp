@@ -0,0 +1,153 @@
+/*
+ *  CSCI 441, Computer Graphics, Fall 2020
+ *
+ *  Project: lab08
+ *  File: bezierCullBench.cpp
+ *
+ *  Description:
+ *      Culls the teapot patches from 300 random cameras around it, half of
+ *      them aimed off center, first against the view frustum alone and then
+ *      with the eye's normal cone test as well.  Every culled patch is
+ *      tessellated at 24 segments per edge and checked: a patch outside the
+ *      frustum must have no sample inside the clip volume and a patch facing
+ *      away must have no sample whose normal faces the eye.  Reports how many
+ *      patches each test dropped and how long culling took.  Needs no window
+ *      or OpenGL context.
+ *
+ *  Usage: bezierCullBench [cameras]
+ *
+ */
+
+#include <GL/glew.h>
+
+#include <CSCI441/teapot.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef std::chrono::high_resolution_clock Clock;
+
+const int SAMPLE_SEGMENTS = 24;
+
+// column major perspective projection times a view looking from eye at target with z up
+void perspectiveLookAt( const float eye[3], const float target[3], float mvpMatrix[16] ) {
+    float f[3] = { target[0] - eye[0], target[1] - eye[1], target[2] - eye[2] };
+    float length = sqrtf( f[0]*f[0] + f[1]*f[1] + f[2]*f[2] );
+    for( int c = 0; c < 3; c++ ) f[c] /= length;
+    float s[3] = { f[1], -f[0], 0.0f };                                     // f x (0,0,1)
+    length = sqrtf( s[0]*s[0] + s[1]*s[1] );
+    for( int c = 0; c < 3; c++ ) s[c] /= length;
+    float u[3] = { s[1]*f[2] - s[2]*f[1], s[2]*f[0] - s[0]*f[2], s[0]*f[1] - s[1]*f[0] };
+
+    float view[16] = { s[0], u[0], -f[0], 0.0f,
+                       s[1], u[1], -f[1], 0.0f,
+                       s[2], u[2], -f[2], 0.0f,
+                       -(s[0]*eye[0] + s[1]*eye[1] + s[2]*eye[2]),
+                       -(u[0]*eye[0] + u[1]*eye[1] + u[2]*eye[2]),
+                       f[0]*eye[0] + f[1]*eye[1] + f[2]*eye[2], 1.0f };
+
+    const float fov = tanf( 0.3f ), zNear = 0.1f, zFar = 100.0f;
+    float projection[16] = { 1.0f / fov, 0.0f, 0.0f, 0.0f,
+                             0.0f, 1.0f / fov, 0.0f, 0.0f,
+                             0.0f, 0.0f, -(zFar + zNear) / (zFar - zNear), -1.0f,
+                             0.0f, 0.0f, -2.0f * zFar * zNear / (zFar - zNear), 0.0f };
+
+    for( int c = 0; c < 4; c++ ) {
+        for( int r = 0; r < 4; r++ ) {
+            float sum = 0.0f;
+            for( int k = 0; k < 4; k++ )
+                sum += projection[k*4 + r] * view[c*4 + k];
+            mvpMatrix[c*4 + r] = sum;
+        }
+    }
+}
+
+bool insideClipVolume( const float mvpMatrix[16], const float *p ) {
+    float clip[4];
+    for( int r = 0; r < 4; r++ )
+        clip[r] = mvpMatrix[r]*p[0] + mvpMatrix[4 + r]*p[1] + mvpMatrix[8 + r]*p[2] + mvpMatrix[12 + r];
+    return fabsf( clip[0] ) <= clip[3] && fabsf( clip[1] ) <= clip[3] && fabsf( clip[2] ) <= clip[3];
+}
+
+bool facesEye( const float eye[3], const float *p, const float *n ) {
+    return n[0]*(eye[0] - p[0]) + n[1]*(eye[1] - p[1]) + n[2]*(eye[2] - p[2]) > 1e-5f;
+}
+
+bool contains( const std::vector<unsigned int> &patches, unsigned int patch ) {
+    return std::find( patches.begin(), patches.end(), patch ) != patches.end();
+}
+
+int main( int argc, char *argv[] ) {
+    int numCameras = argc > 1 ? atoi( argv[1] ) : 300;
+    if( numCameras < 1 ) numCameras = 1;
+
+    CSCI441::BezierSurface surface = CSCI441::generateTeapotSurface();
+    surface.setSegmentRange( SAMPLE_SEGMENTS, SAMPLE_SEGMENTS );
+    const unsigned int numPatches = surface.getNumPatches();
+
+    unsigned int withCones = 0;
+    for( unsigned int p = 0; p < numPatches; p++ )
+        if( surface.getPatchBounds()[p].hasCone ) withCones++;
+
+    unsigned long frustumCulled = 0, backCulled = 0, violations = 0;
+    double cullSeconds = 0.0;
+    srand( 1 );
+    for( int camera = 0; camera < numCameras; camera++ ) {
+        // somewhere on a sphere around the teapot, 2 to 8 units out
+        float distance = 2.0f + (rand() % 60) / 10.0f;
+        float theta = rand() / (float)RAND_MAX * 6.28f, phi = rand() / (float)RAND_MAX * 3.1f - 1.55f;
+        float eye[3] = { distance * cosf( phi ) * cosf( theta ), distance * cosf( phi ) * sinf( theta ), 1.5f + distance * sinf( phi ) };
+        float target[3] = { 0.0f, 0.0f, 1.5f };
+        if( camera % 2 ) {
+            target[0] += (rand() % 200 - 100) / 50.0f;
+            target[1] += (rand() % 200 - 100) / 50.0f;
+        }
+        float mvpMatrix[16];
+        perspectiveLookAt( eye, target, mvpMatrix );
+
+        std::vector<unsigned int> inFrustum, visible;
+        Clock::time_point start = Clock::now();
+        surface.cullPatches( mvpMatrix, nullptr, inFrustum );
+        surface.cullPatches( mvpMatrix, eye, visible );
+        cullSeconds += std::chrono::duration<double>( Clock::now() - start ).count();
+
+        for( unsigned int p = 0; p < numPatches; p++ ) {
+            bool keptByFrustum = contains( inFrustum, p ), kept = contains( visible, p );
+            if( kept && !keptByFrustum ) {
+                fprintf( stderr, "[ERROR]: camera %d kept patch %u facing the eye but dropped it from the frustum\n", camera, p );
+                violations++;
+                continue;
+            }
+            if( kept ) continue;
+
+            CSCI441::MeshData samples = surface.tessellate( std::vector<unsigned int>( 1, p ), 1 );
+            for( size_t i = 0; i < samples.numVertices(); i++ ) {
+                const float *position = &samples.positions[i*3], *normal = &samples.normals[i*3];
+                bool wrong = keptByFrustum ? facesEye( eye, position, normal ) : insideClipVolume( mvpMatrix, position );
+                if( wrong ) {
+                    fprintf( stderr, "[ERROR]: camera %d culled patch %u %s but sample %lu is %s\n", camera, p,
+                             keptByFrustum ? "as facing away" : "outside the frustum", (unsigned long)i,
+                             keptByFrustum ? "facing the eye" : "inside the clip volume" );
+                    violations++;
+                    break;
+                }
+            }
+            if( keptByFrustum ) backCulled++;
+            else                frustumCulled++;
+        }
+    }
+
+    unsigned long total = (unsigned long)numCameras * numPatches;
+    printf( "[INFO]: %d cameras, %u patches, %u with a normal cone\n", numCameras, numPatches, withCones );
+    printf( "[INFO]: frustum culled %lu (%.1f%%), back culled %lu (%.1f%%) of %lu\n", frustumCulled, 100.0 * frustumCulled / total,
+            backCulled, 100.0 * backCulled / total, total );
+    printf( "[INFO]: %.3f us per cull of the whole teapot\n", cullSeconds / (2.0 * numCameras) * 1e6 );
+    printf( "[INFO]: %lu violations\n", violations );
+    printf( "[INFO]: %s\n", violations == 0 ? "PASS" : "FAIL" );
+
+    return violations == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
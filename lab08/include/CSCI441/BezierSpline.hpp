@@ -0,0 +1,297 @@
+/** @file BezierSpline.hpp
+ * @brief Piecewise cubic Bezier curve with constant speed traversal
+ * @date Last Edit: 19 Oct 2026
+ * @version 1.0
+ *
+ *	Holds a chain of cubic Bezier segments that share their end points.  The
+ *	segments are sampled once with forward differencing when the control
+ *	points change, and the samples are kept on the GPU until they change
+ *	again.  An arc length table built at the same time turns a distance along
+ *	the curve into a curve parameter with a binary search, so an object can be
+ *	moved along the curve at a constant speed.
+ *
+ *	@warning NOTE: This header file will only work with OpenGL 3.0+
+ *	@warning NOTE: This header file depends upon GLEW and glm
+ */
+
+#ifndef __CSCI441_BEZIERSPLINE_HPP__
+#define __CSCI441_BEZIERSPLINE_HPP__
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include "ResourceRegistry.hpp"
+
+#include <math.h>
+
+#include <algorithm>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////
+
+/** @namespace CSCI441
+  * @brief CSCI441 Helper Functions for OpenGL
+	*/
+namespace CSCI441 {
+
+    /** @class BezierSpline
+        * @brief Chain of cubic Bezier segments, cached on the CPU and GPU
+        *
+        * Control points 3i through 3i+3 form segment i, so n segments take 3n+1 points.
+        * The curve parameter t runs from 0 to the number of segments.
+        */
+    class BezierSpline {
+    public:
+        /** @brief Creates an empty spline
+            * @param GLuint resolution - line segments drawn per curve segment (default: 20)
+            */
+        BezierSpline( GLuint resolution = 20 );
+        /** @brief Deletes the spline's buffers from the GPU
+            */
+        ~BezierSpline();
+
+        /** @brief Copies the control points and samples the curve again
+          *
+            * A trailing point that does not complete a segment is ignored.
+            *
+            * @param const glm::vec3* points - control points, 3n+1 for n segments
+            * @param GLuint numPoints        - number of control points
+            */
+        void setControlPoints( const glm::vec3 *points, GLuint numPoints );
+        /** @brief Moves one control point and samples the curve again
+            * @param GLuint index     - index of the control point to move
+            * @param glm::vec3 point  - new position of the control point
+            */
+        void setControlPoint( GLuint index, glm::vec3 point );
+        /** @brief Changes the number of line segments drawn per curve segment
+            * @param GLuint resolution - line segments per curve segment
+            * @pre resolution must be greater than zero
+            */
+        void setResolution( GLuint resolution );
+
+        /** @brief Returns the number of control points */
+        GLuint getNumControlPoints() const { return _controlPoints.size(); }
+        /** @brief Returns a control point */
+        glm::vec3 getControlPoint( GLuint index ) const { return _controlPoints[index]; }
+        /** @brief Returns the number of cubic segments */
+        GLuint getNumSegments() const { return _coefficients.size() / 4; }
+        /** @brief Returns the length of the whole curve */
+        GLfloat getLength() const { return _arcLengths.empty() ? 0.0f : _arcLengths.back(); }
+
+        /** @brief Returns the point at a curve parameter
+            * @param GLfloat t - curve parameter, clamped to [0, getNumSegments()]
+            */
+        glm::vec3 evaluate( GLfloat t ) const;
+        /** @brief Returns the curve parameter a distance along the curve from its start
+          *
+            * Found with a binary search of the arc length table, so moving the distance
+            * on by the same amount each frame moves along the curve at a constant speed.
+            *
+            * @param GLfloat distance - distance from the start, wrapped to the length of the curve
+            */
+        GLfloat getParameterAtDistance( GLfloat distance ) const;
+        /** @brief Returns the point a distance along the curve from its start
+            * @param GLfloat distance - distance from the start, wrapped to the length of the curve
+            */
+        glm::vec3 getPointAtDistance( GLfloat distance ) const { return evaluate( getParameterAtDistance( distance ) ); }
+
+        /** @brief Draws the curve as a line strip
+          *
+            * Uploads the samples first if the control points changed since the last draw.
+            *
+            * @param GLint positionLocation - attribute location of the vertex position
+            */
+        void draw( GLint positionLocation );
+        /** @brief Draws the control cage as a line strip
+            * @param GLint positionLocation - attribute location of the vertex position
+            */
+        void drawCage( GLint positionLocation );
+
+    private:
+        // samples per segment in the arc length table, independent of how coarsely the curve is drawn
+        static const GLuint ARC_LENGTH_SAMPLES = 64;
+
+        std::vector<glm::vec3> _controlPoints;
+        std::vector<glm::vec3> _coefficients;       // a, b, c, d of a t^3 + b t^2 + c t + d per segment
+        std::vector<glm::vec3> _curvePoints;        // points drawn, resolution+1 per segment
+        std::vector<GLfloat> _arcLengths;           // distance from the start to each arc length sample
+        GLuint _resolution;
+
+        GLuint _vao, _vbo;
+        GLsizeiptr _vboSize;
+        bool _buffersDirty;
+
+        void _sampleCurve();
+        void _sampleSegment( GLuint segment, GLuint numSteps, std::vector<glm::vec3> &points ) const;
+        void _uploadBuffers();
+        void _bindPositions( GLint positionLocation, GLsizeiptr offset );
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+
+inline CSCI441::BezierSpline::BezierSpline( GLuint resolution ) :
+        _resolution( resolution ), _vao( 0 ), _vbo( 0 ), _vboSize( 0 ), _buffersDirty( true ) {
+}
+
+inline CSCI441::BezierSpline::~BezierSpline() {
+    if( _vbo != 0 ) {
+        glDeleteBuffers( 1, &_vbo );
+        CSCI441::ResourceRegistry::releaseBuffer( _vbo );
+    }
+    if( _vao != 0 ) {
+        glDeleteVertexArrays( 1, &_vao );
+    }
+}
+
+inline void CSCI441::BezierSpline::setControlPoints( const glm::vec3 *points, GLuint numPoints ) {
+    _controlPoints.assign( points, points + numPoints );
+    _sampleCurve();
+}
+
+inline void CSCI441::BezierSpline::setControlPoint( GLuint index, glm::vec3 point ) {
+    if( index >= _controlPoints.size() || _controlPoints[index] == point ) return;
+    _controlPoints[index] = point;
+    _sampleCurve();
+}
+
+inline void CSCI441::BezierSpline::setResolution( GLuint resolution ) {
+    if( resolution == _resolution ) return;
+    _resolution = resolution;
+    _sampleCurve();
+}
+
+inline glm::vec3 CSCI441::BezierSpline::evaluate( GLfloat t ) const {
+    if( _coefficients.empty() ) return _controlPoints.empty() ? glm::vec3( 0.0f ) : _controlPoints[0];
+
+    if( t < 0.0f ) t = 0.0f;
+    GLuint segment = (GLuint)t;
+    if( segment >= getNumSegments() ) segment = getNumSegments() - 1;
+    t -= segment;
+    if( t > 1.0f ) t = 1.0f;
+
+    const glm::vec3 *c = &_coefficients[segment * 4];
+    return ((c[0] * t + c[1]) * t + c[2]) * t + c[3];
+}
+
+inline GLfloat CSCI441::BezierSpline::getParameterAtDistance( GLfloat distance ) const {
+    if( _arcLengths.size() < 2 || getLength() <= 0.0f ) return 0.0f;
+
+    distance = fmodf( distance, getLength() );
+    if( distance < 0.0f ) distance += getLength();
+
+    // first sample at or past the distance, then interpolate back towards the one before it
+    GLuint i = std::lower_bound( _arcLengths.begin(), _arcLengths.end(), distance ) - _arcLengths.begin();
+    if( i == 0 ) return 0.0f;
+    if( i >= _arcLengths.size() ) i = _arcLengths.size() - 1;
+    GLfloat before = _arcLengths[i-1], after = _arcLengths[i];
+    GLfloat fraction = after > before ? (distance - before) / (after - before) : 0.0f;
+    return ( (i-1) + fraction ) / ARC_LENGTH_SAMPLES;
+}
+
+inline void CSCI441::BezierSpline::draw( GLint positionLocation ) {
+    if( _curvePoints.empty() ) return;
+    if( _buffersDirty ) _uploadBuffers();
+
+    _bindPositions( positionLocation, 0 );
+    glDrawArrays( GL_LINE_STRIP, 0, _curvePoints.size() );
+}
+
+inline void CSCI441::BezierSpline::drawCage( GLint positionLocation ) {
+    if( _controlPoints.empty() ) return;
+    if( _buffersDirty ) _uploadBuffers();
+
+    _bindPositions( positionLocation, _curvePoints.size() * sizeof(glm::vec3) );
+    glDrawArrays( GL_LINE_STRIP, 0, _controlPoints.size() );
+}
+
+inline void CSCI441::BezierSpline::_sampleCurve() {
+    GLuint numSegments = _controlPoints.size() < 4 ? 0 : (_controlPoints.size() - 1) / 3;
+
+    // power basis form of each segment, so evaluate() and the forward differences need no Bernstein terms
+    _coefficients.resize( numSegments * 4 );
+    for( GLuint s = 0; s < numSegments; s++ ) {
+        const glm::vec3 &p0 = _controlPoints[s*3], &p1 = _controlPoints[s*3 + 1], &p2 = _controlPoints[s*3 + 2], &p3 = _controlPoints[s*3 + 3];
+        _coefficients[s*4 + 0] = -p0 + 3.0f * p1 - 3.0f * p2 + p3;
+        _coefficients[s*4 + 1] = 3.0f * p0 - 6.0f * p1 + 3.0f * p2;
+        _coefficients[s*4 + 2] = -3.0f * p0 + 3.0f * p1;
+        _coefficients[s*4 + 3] = p0;
+    }
+
+    _curvePoints.clear();
+    _arcLengths.clear();
+    std::vector<glm::vec3> arcPoints;
+    for( GLuint s = 0; s < numSegments; s++ ) {
+        _sampleSegment( s, _resolution > 0 ? _resolution : 1, _curvePoints );
+        _sampleSegment( s, ARC_LENGTH_SAMPLES, arcPoints );
+        // neighboring segments share an end point, so only the first segment keeps its start
+        if( s + 1 < numSegments ) {
+            _curvePoints.pop_back();
+            arcPoints.pop_back();
+        }
+    }
+
+    _arcLengths.reserve( arcPoints.size() );
+    GLfloat length = 0.0f;
+    for( GLuint i = 0; i < arcPoints.size(); i++ ) {
+        if( i > 0 ) length += glm::length( arcPoints[i] - arcPoints[i-1] );
+        _arcLengths.push_back( length );
+    }
+
+    _buffersDirty = true;
+}
+
+// steps along a segment by adding its first, second and third differences, three vector adds per point
+inline void CSCI441::BezierSpline::_sampleSegment( GLuint segment, GLuint numSteps, std::vector<glm::vec3> &points ) const {
+    const glm::vec3 *c = &_coefficients[segment * 4];
+    GLfloat h = 1.0f / numSteps, h2 = h * h, h3 = h2 * h;
+
+    glm::vec3 point = c[3];
+    glm::vec3 delta1 = c[0] * h3 + c[1] * h2 + c[2] * h;
+    glm::vec3 delta2 = 6.0f * c[0] * h3 + 2.0f * c[1] * h2;
+    glm::vec3 delta3 = 6.0f * c[0] * h3;
+
+    points.push_back( point );
+    for( GLuint i = 1; i < numSteps; i++ ) {
+        point += delta1;
+        delta1 += delta2;
+        delta2 += delta3;
+        points.push_back( point );
+    }
+    // end exactly on the last control point rather than where the differences drifted to
+    points.push_back( _controlPoints[segment*3 + 3] );
+}
+
+inline void CSCI441::BezierSpline::_uploadBuffers() {
+    if( _vao == 0 ) {
+        glGenVertexArrays( 1, &_vao );
+        glGenBuffers( 1, &_vbo );
+    }
+
+    // curve samples followed by the control points
+    GLsizeiptr curveBytes = _curvePoints.size() * sizeof(glm::vec3);
+    GLsizeiptr cageBytes = _controlPoints.size() * sizeof(glm::vec3);
+
+    glBindVertexArray( _vao );
+    glBindBuffer( GL_ARRAY_BUFFER, _vbo );
+    if( curveBytes + cageBytes != _vboSize ) {
+        _vboSize = curveBytes + cageBytes;
+        glBufferData( GL_ARRAY_BUFFER, _vboSize, nullptr, GL_DYNAMIC_DRAW );
+        CSCI441::ResourceRegistry::registerBuffer( _vbo, GL_ARRAY_BUFFER, _vboSize, "CSCI441::BezierSpline", "bezier curve" );
+    }
+    glBufferSubData( GL_ARRAY_BUFFER, 0, curveBytes, _curvePoints.data() );
+    glBufferSubData( GL_ARRAY_BUFFER, curveBytes, cageBytes, _controlPoints.data() );
+
+    _buffersDirty = false;
+}
+
+inline void CSCI441::BezierSpline::_bindPositions( GLint positionLocation, GLsizeiptr offset ) {
+    glBindVertexArray( _vao );
+    glBindBuffer( GL_ARRAY_BUFFER, _vbo );
+    glEnableVertexAttribArray( positionLocation );
+    glVertexAttribPointer( positionLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)offset );
+    CSCI441::ResourceRegistry::touchBuffer( _vbo );
+}
+
+#endif // __CSCI441_BEZIERSPLINE_HPP__
@@ -0,0 +1,699 @@
+/** @file BezierSurface.hpp
+ * @brief CPU tessellation of bicubic Bezier patches
+ * @date Last Edit: 19 Oct 2026
+ * @version 1.0
+ *
+ *	Tessellates a set of bicubic Bezier patches that share one array of control
+ *	points into an indexed triangle mesh.  Each patch is subdivided only as
+ *	finely as its control net bends, measured either in object space or in
+ *	pixels once a camera is given.  Every patch edge is decided once and both
+ *	patches on either side of it use the same samples, so neighboring patches
+ *	meet without cracks even when their interiors are subdivided differently.
+ *	Patches are tessellated on parallel threads.
+ *
+ *	A patch lies inside the convex hull of its 16 control points, and its
+ *	normals inside the cone spanned by the cross products of the control net's
+ *	edges.  Both are kept for every patch so whole patches outside the view, or
+ *	facing away from it, can be skipped before they are tessellated.
+ *
+ *	The teapot hands out its patches as a BezierSurface, and the Bezier patch
+ *	lab falls back to it when the context cannot run tessellation shaders.
+ *
+ *	@warning NOTE: This header file does not depend upon OpenGL or GLEW
+ */
+
+#ifndef __CSCI441_BEZIERSURFACE_HPP__
+#define __CSCI441_BEZIERSURFACE_HPP__
+
+#include "MeshData.hpp"
+
+#include <math.h>						// for sqrtf(), ceilf(), acosf(), asinf()
+#include <stdio.h>						// for fprintf()
+
+#include <algorithm>					// for copy(), swap()
+#include <array>						// for array
+#include <atomic>						// for atomic
+#include <map>							// for map
+#include <thread>						// for thread
+#include <vector>						// for vector
+
+////////////////////////////////////////////////////////////////////////////////////
+
+/** @namespace CSCI441
+ * @brief CSCI441 Helper Functions for OpenGL
+ */
+namespace CSCI441 {
+
+    /** @brief bounds of one patch, found from its control net
+      */
+    struct BezierPatchBounds {
+        float boxMin[3], boxMax[3];         ///< axis aligned box around the control points
+        float center[3], radius;            ///< sphere around the control points
+        float coneAxis[3], coneAngle;       ///< every normal of the patch is within coneAngle radians of coneAxis
+        bool hasCone;                       ///< false when the normals may turn more than 90 degrees from the axis
+    };
+
+    /** @class BezierSurface
+      * @brief Tessellates bicubic Bezier patches into a MeshData
+      *
+      * A patch is 16 indices into the control points, stored row major so that
+      * patch point (u,v) is the sum of B_i(u) B_j(v) P[i*4 + j].  The mesh
+      * triangles are wound clockwise in (u,v) and the normals are dP/dv x dP/du,
+      * the same convention the teapot patches use.  Texture coordinates hold the
+      * (u,v) of each vertex within its patch.
+      */
+    class BezierSurface {
+    public:
+        /** @brief Creates a surface with no patches and a tolerance of 0.01 units
+          */
+        BezierSurface();
+
+        /** @brief Copies the control points shared by the patches
+          * @param const float* points      - x, y, z per control point
+          * @param unsigned int numPoints   - number of control points
+          */
+        void setControlPoints( const float *points, unsigned int numPoints );
+        /** @brief Copies the control point indices of each patch
+          * @param const unsigned int* indices  - 16 zero based control point indices per patch, row major
+          * @param unsigned int numPatches      - number of patches
+          * @return false, leaving the patches unchanged, if an index is past the end of the control points
+          * @pre setControlPoints() must have been called first
+          */
+        bool setPatches( const unsigned int *indices, unsigned int numPatches );
+        /** @brief bounds of each patch, updated whenever the control points or patches are set
+          */
+        const std::vector<BezierPatchBounds>& getPatchBounds() const { return _patchBounds; }
+
+        /** @brief number of control points shared by the patches
+          */
+        unsigned int getNumControlPoints() const { return _controlPoints.size() / 3; }
+        /** @brief number of patches in the surface
+          */
+        unsigned int getNumPatches() const { return _patches.size() / 16; }
+
+        /** @brief Subdivide until no triangle strays further than tolerance units from the surface
+          *
+          * Clears any screen space tolerance set earlier.
+          *
+          * @param float tolerance - largest allowed distance in object space
+          * @pre tolerance must be greater than zero
+          */
+        void setTolerance( float tolerance );
+        /** @brief Subdivide until no triangle strays further than a number of pixels from the surface
+          *
+          * Patches far from the camera are subdivided less than patches close to it.  A patch
+          * crossing the eye plane is subdivided as finely as allowed.
+          *
+          * @param const float* mvpMatrix   - column major model-view-projection matrix of the surface
+          * @param int viewportWidth        - width of the viewport in pixels
+          * @param int viewportHeight       - height of the viewport in pixels
+          * @param float pixels             - largest allowed distance on screen
+          * @pre pixels must be greater than zero
+          */
+        void setScreenTolerance( const float *mvpMatrix, int viewportWidth, int viewportHeight, float pixels );
+        /** @brief Limits the number of segments along any patch edge
+          *
+          * Setting both to the same value tessellates every patch uniformly.
+          *
+          * @param int minSegments - fewest segments along an edge (default: 1)
+          * @param int maxSegments - most segments along an edge (default: 64)
+          * @pre 1 <= minSegments <= maxSegments
+          */
+        void setSegmentRange( int minSegments, int maxSegments );
+
+        /** @brief Tessellates every patch
+          * @param int numThreads - threads to tessellate the patches on, or 0 to pick from the
+          *                         hardware and the amount of work (default: 0)
+          * @return indexed triangle list with positions, normals and (u,v) texture coordinates
+          */
+        MeshData tessellate( int numThreads = 0 ) const;
+        /** @brief Tessellates some of the patches
+          *
+          * Edges between two listed patches are still shared, so the mesh is crack free
+          * within the list.
+          *
+          * @param const std::vector<unsigned int>& patchList - patches to tessellate, each at most once
+          * @param int numThreads - threads to tessellate the patches on, or 0 to pick from the
+          *                         hardware and the amount of work (default: 0)
+          * @return indexed triangle list with positions, normals and (u,v) texture coordinates
+          */
+        MeshData tessellate( const std::vector<unsigned int> &patchList, int numThreads = 0 ) const;
+
+        /** @brief Lists the patches that may be visible
+          *
+          * A patch is dropped when its control points are all outside one plane of the view
+          * frustum.  When an eye position is given, a patch is also dropped when its cone of
+          * normals points away from every direction the eye could see it from.  The normals
+          * follow the dP/dv x dP/du convention above.
+          *
+          * @param const float* mvpMatrix   - column major model-view-projection matrix of the surface
+          * @param const float* eyePosition - x, y, z of the eye in the same space as the control points,
+          *                                   or nullptr to keep patches facing away
+          * @param std::vector<unsigned int>& visiblePatches - receives the patches to draw, in order
+          * @return number of patches kept
+          */
+        unsigned int cullPatches( const float *mvpMatrix, const float *eyePosition, std::vector<unsigned int> &visiblePatches ) const;
+
+    private:
+        std::vector<float> _controlPoints;
+        std::vector<unsigned int> _patches;
+        std::vector<BezierPatchBounds> _patchBounds;
+
+        float _tolerance;
+        bool _screenSpace;
+        float _mvpMatrix[16];
+        float _halfViewportWidth, _halfViewportHeight;
+        int _minSegments, _maxSegments;
+
+        int curveSegments( const unsigned int ids[4] ) const;
+        int clampSegments( int segments, int fewest ) const;
+        void updatePatchBounds();
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Internal helpers
+
+namespace CSCI441_INTERNAL {
+    // how finely one patch is cut, and which shared edge lies along each of its sides
+    // sides run v = 0, u = 1, v = 1, u = 0, each in the direction of increasing u or v
+    struct BezierPatchLayout {
+        int segmentsU, segmentsV;
+        unsigned int edges[4];
+        bool flipped[4];                    // true when the shared edge runs opposite to the side
+    };
+
+    // the vertices and triangles of one patch before they are joined into the mesh
+    struct BezierPatchMesh {
+        std::vector<float> positions, normals, texCoords;
+        std::vector<unsigned int> indices;
+    };
+
+    void evaluateBezierBasis( float t, float basis[4], float derivative[4] );
+    void evaluateBezierCurve( const float points[4][3], float t, float position[3] );
+    void evaluateBezierPatch( const float net[16][3], float u, float v, float position[3], float du[3], float dv[3] );
+    void evaluateBezierNormal( const float net[16][3], float u, float v, float normal[3] );
+    void tessellateBezierPatch( const float net[16][3], const BezierPatchLayout &layout, const float edgePoints[4][4][3],
+                                const int edgeSegments[4], BezierPatchMesh &mesh );
+    void stitchBezierSide( const std::vector<float> &outerT, const std::vector<unsigned int> &outer,
+                           const std::vector<float> &innerT, const std::vector<unsigned int> &inner, BezierPatchMesh &mesh );
+    void addBezierTriangle( unsigned int a, unsigned int b, unsigned int c, BezierPatchMesh &mesh );
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Outward facing function implementations
+
+inline CSCI441::BezierSurface::BezierSurface() :
+        _tolerance(0.01f), _screenSpace(false), _mvpMatrix{},
+        _halfViewportWidth(0.0f), _halfViewportHeight(0.0f), _minSegments(1), _maxSegments(64) {
+}
+
+inline void CSCI441::BezierSurface::setControlPoints( const float *points, unsigned int numPoints ) {
+    _controlPoints.assign( points, points + numPoints*3 );
+    // patches that now index past the end are dropped
+    for( unsigned int i = 0; i < _patches.size(); i++ ) {
+        if( _patches[i] >= getNumControlPoints() ) {
+            fprintf( stderr, "[ERROR]: Bezier patch %u uses control point %u but there are only %u\n", i / 16, _patches[i], getNumControlPoints() );
+            _patches.clear();
+        }
+    }
+    updatePatchBounds();
+}
+
+inline bool CSCI441::BezierSurface::setPatches( const unsigned int *indices, unsigned int numPatches ) {
+    for( unsigned int i = 0; i < numPatches*16; i++ ) {
+        if( indices[i] >= getNumControlPoints() ) {
+            fprintf( stderr, "[ERROR]: Bezier patch %u uses control point %u but there are only %u\n", i / 16, indices[i], getNumControlPoints() );
+            return false;
+        }
+    }
+    _patches.assign( indices, indices + numPatches*16 );
+    updatePatchBounds();
+    return true;
+}
+
+inline void CSCI441::BezierSurface::setTolerance( float tolerance ) {
+    _tolerance = tolerance;
+    _screenSpace = false;
+}
+
+inline void CSCI441::BezierSurface::setScreenTolerance( const float *mvpMatrix, int viewportWidth, int viewportHeight, float pixels ) {
+    for( int i = 0; i < 16; i++ ) _mvpMatrix[i] = mvpMatrix[i];
+    _halfViewportWidth = viewportWidth / 2.0f;
+    _halfViewportHeight = viewportHeight / 2.0f;
+    _tolerance = pixels;
+    _screenSpace = true;
+}
+
+inline void CSCI441::BezierSurface::setSegmentRange( int minSegments, int maxSegments ) {
+    _minSegments = minSegments;
+    _maxSegments = maxSegments;
+}
+
+inline CSCI441::MeshData CSCI441::BezierSurface::tessellate( int numThreads ) const {
+    std::vector<unsigned int> patchList( getNumPatches() );
+    for( unsigned int p = 0; p < patchList.size(); p++ ) patchList[p] = p;
+    return tessellate( patchList, numThreads );
+}
+
+inline CSCI441::MeshData CSCI441::BezierSurface::tessellate( const std::vector<unsigned int> &patchList, int numThreads ) const {
+    const unsigned int numPatches = patchList.size();
+
+    // where each side of a patch finds its four control points, in the direction of increasing u or v
+    const int SIDE_POINTS[4][4] = { { 0, 4, 8, 12 }, { 12, 13, 14, 15 }, { 3, 7, 11, 15 }, { 0, 1, 2, 3 } };
+
+    // decide every edge once, keyed on its control points in a fixed order, so the two patches
+    // either side of an edge are cut at the same samples
+    std::map< std::array<unsigned int, 4>, unsigned int > edgeLookup;
+    std::vector< std::array<unsigned int, 4> > edges;
+    std::vector<int> edgeSegments;
+    std::vector<CSCI441_INTERNAL::BezierPatchLayout> layouts( numPatches );
+    unsigned long int estimatedVertices = 0;
+
+    for( unsigned int p = 0; p < numPatches; p++ ) {
+        const unsigned int *patch = &_patches[ patchList[p]*16 ];
+        CSCI441_INTERNAL::BezierPatchLayout &layout = layouts[p];
+
+        // the interior is cut as finely as the most bent row or column of the control net needs
+        int segmentsU = 0, segmentsV = 0;
+        for( int k = 0; k < 4; k++ ) {
+            unsigned int column[4] = { patch[k], patch[4 + k], patch[8 + k], patch[12 + k] };
+            unsigned int row[4] = { patch[k*4], patch[k*4 + 1], patch[k*4 + 2], patch[k*4 + 3] };
+            int columnSegments = curveSegments( column ), rowSegments = curveSegments( row );
+            if( columnSegments > segmentsU ) segmentsU = columnSegments;
+            if( rowSegments > segmentsV ) segmentsV = rowSegments;
+        }
+        // two segments at least, so the interior has a ring of vertices to stitch the edges to
+        layout.segmentsU = clampSegments( segmentsU, 2 );
+        layout.segmentsV = clampSegments( segmentsV, 2 );
+
+        for( int side = 0; side < 4; side++ ) {
+            std::array<unsigned int, 4> ids;
+            for( int k = 0; k < 4; k++ ) ids[k] = patch[ SIDE_POINTS[side][k] ];
+            layout.flipped[side] = ids[3] < ids[0] || ( ids[3] == ids[0] && ids[2] < ids[1] );
+            if( layout.flipped[side] ) {
+                std::swap( ids[0], ids[3] );
+                std::swap( ids[1], ids[2] );
+            }
+
+            std::map< std::array<unsigned int, 4>, unsigned int >::iterator found = edgeLookup.find( ids );
+            if( found == edgeLookup.end() ) {
+                found = edgeLookup.insert( std::make_pair( ids, (unsigned int)edges.size() ) ).first;
+                edges.push_back( ids );
+                edgeSegments.push_back( clampSegments( curveSegments( ids.data() ), 1 ) );
+            }
+            layout.edges[side] = found->second;
+        }
+
+        estimatedVertices += (unsigned long int)(layout.segmentsU + 1) * (layout.segmentsV + 1);
+    }
+
+    // starting threads costs more than a small surface takes to tessellate
+    if( numThreads <= 0 ) {
+        numThreads = estimatedVertices < 16384 ? 1 : (int)std::thread::hardware_concurrency();
+        if( numThreads <= 0 ) numThreads = 1;
+    }
+    if( numThreads > (int)numPatches ) numThreads = numPatches;
+
+    // patches differ in cost, so each thread takes the next untouched patch until none are left
+    std::vector<CSCI441_INTERNAL::BezierPatchMesh> patchMeshes( numPatches );
+    std::atomic<unsigned int> nextPatch( 0 );
+    auto worker = [&]() {
+        for( unsigned int p = nextPatch++; p < numPatches; p = nextPatch++ ) {
+            const CSCI441_INTERNAL::BezierPatchLayout &layout = layouts[p];
+
+            float net[16][3];
+            for( int k = 0; k < 16; k++ )
+                for( int c = 0; c < 3; c++ )
+                    net[k][c] = _controlPoints[ _patches[ patchList[p]*16 + k ]*3 + c ];
+
+            float edgePoints[4][4][3];
+            int sideSegments[4];
+            for( int side = 0; side < 4; side++ ) {
+                const std::array<unsigned int, 4> &ids = edges[ layout.edges[side] ];
+                for( int k = 0; k < 4; k++ )
+                    for( int c = 0; c < 3; c++ )
+                        edgePoints[side][k][c] = _controlPoints[ ids[k]*3 + c ];
+                sideSegments[side] = edgeSegments[ layout.edges[side] ];
+            }
+
+            CSCI441_INTERNAL::tessellateBezierPatch( net, layout, edgePoints, sideSegments, patchMeshes[p] );
+        }
+    };
+    std::vector<std::thread> threads;
+    for( int t = 1; t < numThreads; t++ )
+        threads.push_back( std::thread( worker ) );
+    worker();
+    for( size_t t = 0; t < threads.size(); t++ )
+        threads[t].join();
+
+    // join the patches in order
+    unsigned long int numVertices = 0, numIndices = 0;
+    for( unsigned int p = 0; p < numPatches; p++ ) {
+        numVertices += patchMeshes[p].positions.size() / 3;
+        numIndices += patchMeshes[p].indices.size();
+    }
+
+    MeshData mesh;
+    CSCI441_INTERNAL::allocateMesh( mesh, numVertices, true, numIndices );
+    unsigned long int vertexOffset = 0, indexOffset = 0;
+    for( unsigned int p = 0; p < numPatches; p++ ) {
+        const CSCI441_INTERNAL::BezierPatchMesh &patchMesh = patchMeshes[p];
+        std::copy( patchMesh.positions.begin(), patchMesh.positions.end(), mesh.positions.begin() + vertexOffset*3 );
+        std::copy( patchMesh.normals.begin(), patchMesh.normals.end(), mesh.normals.begin() + vertexOffset*3 );
+        std::copy( patchMesh.texCoords.begin(), patchMesh.texCoords.end(), mesh.texCoords.begin() + vertexOffset*2 );
+        for( size_t i = 0; i < patchMesh.indices.size(); i++ )
+            mesh.indices[ indexOffset + i ] = vertexOffset + patchMesh.indices[i];
+        vertexOffset += patchMesh.positions.size() / 3;
+        indexOffset += patchMesh.indices.size();
+    }
+
+    mesh.primitive = MESH_TRIANGLES;
+    mesh.numStrips = numIndices > 0 ? 1 : 0;
+    mesh.stripLength = numIndices;
+    mesh.computeBounds();
+    return mesh;
+}
+
+// The segments a cubic needs so its polyline stays within the tolerance.  The second derivative of the
+// curve is bounded by 6 times the largest second difference of its control points, and a chord of
+// parameter length 1/n strays at most 1/8 n^-2 of that from the curve.  Both the second differences
+// and the projection treat the two ends alike, so an edge gets the same answer from either direction.
+inline int CSCI441::BezierSurface::curveSegments( const unsigned int ids[4] ) const {
+    float points[4][3];
+    for( int k = 0; k < 4; k++ ) {
+        const float *point = &_controlPoints[ ids[k]*3 ];
+        if( !_screenSpace ) {
+            points[k][0] = point[0]; points[k][1] = point[1]; points[k][2] = point[2];
+        } else {
+            const float *m = _mvpMatrix;
+            float x = m[0]*point[0] + m[4]*point[1] + m[8]*point[2]  + m[12];
+            float y = m[1]*point[0] + m[5]*point[1] + m[9]*point[2]  + m[13];
+            float w = m[3]*point[0] + m[7]*point[1] + m[11]*point[2] + m[15];
+            // behind or at the eye, so the projection says nothing about its size
+            if( w <= 1e-6f ) return _maxSegments;
+            points[k][0] = x / w * _halfViewportWidth;
+            points[k][1] = y / w * _halfViewportHeight;
+            points[k][2] = 0.0f;
+        }
+    }
+
+    float flatness = 0.0f;
+    for( int k = 0; k < 2; k++ ) {
+        float dx = points[k][0] - 2.0f*points[k+1][0] + points[k+2][0];
+        float dy = points[k][1] - 2.0f*points[k+1][1] + points[k+2][1];
+        float dz = points[k][2] - 2.0f*points[k+1][2] + points[k+2][2];
+        float length = sqrtf( dx*dx + dy*dy + dz*dz );
+        if( length > flatness ) flatness = length;
+    }
+
+    float segments = ceilf( sqrtf( 0.75f * flatness / _tolerance ) );
+    return segments < _maxSegments ? (int)segments : _maxSegments;
+}
+
+inline int CSCI441::BezierSurface::clampSegments( int segments, int fewest ) const {
+    if( fewest < _minSegments ) fewest = _minSegments;
+    if( segments < fewest ) segments = fewest;
+    if( segments > _maxSegments ) segments = _maxSegments > fewest ? _maxSegments : fewest;
+    return segments;
+}
+
+inline unsigned int CSCI441::BezierSurface::cullPatches( const float *mvpMatrix, const float *eyePosition, std::vector<unsigned int> &visiblePatches ) const {
+    const float *m = mvpMatrix;
+
+    // each plane is the last row of the matrix plus or minus another row, normals pointing into the view
+    float frustum[6][4];
+    for( int p = 0; p < 6; p++ ) {
+        int row = p / 2;
+        float sign = (p & 1) ? -1.0f : 1.0f;
+        for( int c = 0; c < 4; c++ )
+            frustum[p][c] = m[c*4 + 3] + sign * m[c*4 + row];
+        float length = sqrtf( frustum[p][0]*frustum[p][0] + frustum[p][1]*frustum[p][1] + frustum[p][2]*frustum[p][2] );
+        if( length > 0.0f )
+            for( int c = 0; c < 4; c++ )
+                frustum[p][c] /= length;
+    }
+
+    visiblePatches.clear();
+    for( unsigned int patch = 0; patch < _patchBounds.size(); patch++ ) {
+        const BezierPatchBounds &bounds = _patchBounds[patch];
+
+        bool outside = false;
+        for( int p = 0; p < 6 && !outside; p++ ) {
+            const float *plane = frustum[p];
+            // the sphere rejects most patches, the corner of the box furthest along the plane's normal the rest
+            float sphereDistance = plane[0]*bounds.center[0] + plane[1]*bounds.center[1] + plane[2]*bounds.center[2] + plane[3];
+            float boxDistance = plane[0] * (plane[0] > 0.0f ? bounds.boxMax[0] : bounds.boxMin[0])
+                              + plane[1] * (plane[1] > 0.0f ? bounds.boxMax[1] : bounds.boxMin[1])
+                              + plane[2] * (plane[2] > 0.0f ? bounds.boxMax[2] : bounds.boxMin[2]) + plane[3];
+            outside = sphereDistance < -bounds.radius || boxDistance < 0.0f;
+        }
+        if( outside ) continue;
+
+        // the eye sees the patch from directions within asin(radius / distance) of its center, so the patch
+        // faces away when its normal cone and that cone of view directions are more than 90 degrees apart
+        if( eyePosition && bounds.hasCone ) {
+            float toEye[3] = { eyePosition[0] - bounds.center[0], eyePosition[1] - bounds.center[1], eyePosition[2] - bounds.center[2] };
+            float distance = sqrtf( toEye[0]*toEye[0] + toEye[1]*toEye[1] + toEye[2]*toEye[2] );
+            if( distance > bounds.radius ) {
+                float spread = bounds.coneAngle + asinf( bounds.radius / distance );
+                float facing = ( bounds.coneAxis[0]*toEye[0] + bounds.coneAxis[1]*toEye[1] + bounds.coneAxis[2]*toEye[2] ) / distance;
+                if( spread < M_PI / 2.0f && facing < -sinf( spread ) ) continue;
+            }
+        }
+
+        visiblePatches.push_back( patch );
+    }
+    return visiblePatches.size();
+}
+
+inline void CSCI441::BezierSurface::updatePatchBounds() {
+    _patchBounds.resize( getNumPatches() );
+    for( unsigned int patch = 0; patch < getNumPatches(); patch++ ) {
+        BezierPatchBounds &bounds = _patchBounds[patch];
+        const float *net[16];
+        for( int k = 0; k < 16; k++ ) net[k] = &_controlPoints[ _patches[patch*16 + k]*3 ];
+
+        // the patch lies inside the convex hull of its control points
+        for( int c = 0; c < 3; c++ ) bounds.boxMin[c] = bounds.boxMax[c] = net[0][c];
+        for( int k = 1; k < 16; k++ ) {
+            for( int c = 0; c < 3; c++ ) {
+                if( net[k][c] < bounds.boxMin[c] ) bounds.boxMin[c] = net[k][c];
+                if( net[k][c] > bounds.boxMax[c] ) bounds.boxMax[c] = net[k][c];
+            }
+        }
+        bounds.radius = 0.0f;
+        for( int c = 0; c < 3; c++ ) bounds.center[c] = (bounds.boxMin[c] + bounds.boxMax[c]) / 2.0f;
+        for( int k = 0; k < 16; k++ ) {
+            float dx = net[k][0] - bounds.center[0], dy = net[k][1] - bounds.center[1], dz = net[k][2] - bounds.center[2];
+            float distance = sqrtf( dx*dx + dy*dy + dz*dz );
+            if( distance > bounds.radius ) bounds.radius = distance;
+        }
+
+        // dP/du is a positive blend of the 12 differences along u of the control net, and dP/dv of the 12
+        // along v, so every normal dP/dv x dP/du is a positive blend of the 144 cross products between them
+        std::vector< std::array<float, 3> > crosses;
+        float sum[3] = { 0.0f, 0.0f, 0.0f };
+        for( int a = 0; a < 12; a++ ) {
+            const float *u0 = net[ a % 4 + (a / 4)*4 ], *u1 = net[ a % 4 + (a / 4 + 1)*4 ];
+            float du[3] = { u1[0] - u0[0], u1[1] - u0[1], u1[2] - u0[2] };
+            for( int b = 0; b < 12; b++ ) {
+                const float *v0 = net[ (b % 4)*4 + b / 4 ], *v1 = net[ (b % 4)*4 + b / 4 + 1 ];
+                float dv[3] = { v1[0] - v0[0], v1[1] - v0[1], v1[2] - v0[2] };
+                std::array<float, 3> n = { dv[1]*du[2] - dv[2]*du[1], dv[2]*du[0] - dv[0]*du[2], dv[0]*du[1] - dv[1]*du[0] };
+                float length = sqrtf( n[0]*n[0] + n[1]*n[1] + n[2]*n[2] );
+                if( length < 1e-12f ) continue;
+                for( int c = 0; c < 3; c++ ) {
+                    n[c] /= length;
+                    sum[c] += n[c];
+                }
+                crosses.push_back( n );
+            }
+        }
+
+        float length = sqrtf( sum[0]*sum[0] + sum[1]*sum[1] + sum[2]*sum[2] );
+        bounds.hasCone = length > 1e-6f;
+        bounds.coneAngle = M_PI;
+        for( int c = 0; c < 3; c++ ) bounds.coneAxis[c] = bounds.hasCone ? sum[c] / length : 0.0f;
+        if( bounds.hasCone ) {
+            float smallestCosine = 1.0f;
+            for( size_t i = 0; i < crosses.size(); i++ ) {
+                float cosine = bounds.coneAxis[0]*crosses[i][0] + bounds.coneAxis[1]*crosses[i][1] + bounds.coneAxis[2]*crosses[i][2];
+                if( cosine < smallestCosine ) smallestCosine = cosine;
+            }
+            bounds.hasCone = smallestCosine > 0.0f;
+            bounds.coneAngle = acosf( smallestCosine < 1.0f ? smallestCosine : 1.0f );
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Internal function implementations
+
+inline void CSCI441_INTERNAL::evaluateBezierBasis( float t, float basis[4], float derivative[4] ) {
+    float s = 1.0f - t;
+    basis[0] = s*s*s;
+    basis[1] = 3.0f*t*s*s;
+    basis[2] = 3.0f*t*t*s;
+    basis[3] = t*t*t;
+    derivative[0] = -3.0f*s*s;
+    derivative[1] = 3.0f*s*s - 6.0f*t*s;
+    derivative[2] = 6.0f*t*s - 3.0f*t*t;
+    derivative[3] = 3.0f*t*t;
+}
+
+inline void CSCI441_INTERNAL::evaluateBezierCurve( const float points[4][3], float t, float position[3] ) {
+    float basis[4], derivative[4];
+    evaluateBezierBasis( t, basis, derivative );
+    for( int c = 0; c < 3; c++ )
+        position[c] = basis[0]*points[0][c] + basis[1]*points[1][c] + basis[2]*points[2][c] + basis[3]*points[3][c];
+}
+
+inline void CSCI441_INTERNAL::evaluateBezierPatch( const float net[16][3], float u, float v, float position[3], float du[3], float dv[3] ) {
+    float bu[4], dbu[4], bv[4], dbv[4];
+    evaluateBezierBasis( u, bu, dbu );
+    evaluateBezierBasis( v, bv, dbv );
+    for( int c = 0; c < 3; c++ ) position[c] = du[c] = dv[c] = 0.0f;
+    for( int i = 0; i < 4; i++ ) {
+        for( int j = 0; j < 4; j++ ) {
+            const float *cp = net[i*4 + j];
+            float b = bu[i] * bv[j], bdu = dbu[i] * bv[j], bdv = bu[i] * dbv[j];
+            for( int c = 0; c < 3; c++ ) {
+                position[c] += b * cp[c];
+                du[c] += bdu * cp[c];
+                dv[c] += bdv * cp[c];
+            }
+        }
+    }
+}
+
+inline void CSCI441_INTERNAL::evaluateBezierNormal( const float net[16][3], float u, float v, float normal[3] ) {
+    // a patch edge collapsed to a point, as at the top of the teapot lid, has no normal at the pole;
+    // take it from a sample a little way into the patch instead
+    const float NUDGE = 1e-3f;
+
+    float position[3], du[3], dv[3];
+    float length = 0.0f;
+    for( int attempt = 0; attempt < 2 && length < 1e-6f; attempt++ ) {
+        if( attempt == 0 ) {
+            evaluateBezierPatch( net, u, v, position, du, dv );
+        } else {
+            evaluateBezierPatch( net, u < 0.5f ? u + NUDGE : u - NUDGE, v < 0.5f ? v + NUDGE : v - NUDGE, position, du, dv );
+        }
+        normal[0] = dv[1]*du[2] - dv[2]*du[1];
+        normal[1] = dv[2]*du[0] - dv[0]*du[2];
+        normal[2] = dv[0]*du[1] - dv[1]*du[0];
+        length = sqrtf( normal[0]*normal[0] + normal[1]*normal[1] + normal[2]*normal[2] );
+    }
+    if( length > 0.0f ) {
+        normal[0] /= length; normal[1] /= length; normal[2] /= length;
+    }
+}
+
+inline void CSCI441_INTERNAL::tessellateBezierPatch( const float net[16][3], const BezierPatchLayout &layout, const float edgePoints[4][4][3],
+                                                     const int edgeSegments[4], BezierPatchMesh &mesh ) {
+    const int nu = layout.segmentsU, nv = layout.segmentsV;
+
+    auto addVertex = [&]( float u, float v, const float position[3] ) -> unsigned int {
+        float normal[3];
+        evaluateBezierNormal( net, u, v, normal );
+        mesh.positions.insert( mesh.positions.end(), position, position + 3 );
+        mesh.normals.insert( mesh.normals.end(), normal, normal + 3 );
+        mesh.texCoords.push_back( u );
+        mesh.texCoords.push_back( v );
+        return mesh.positions.size() / 3 - 1;
+    };
+
+    // interior grid, one ring in from the edges
+    unsigned int innerBase = 0;
+    for( int i = 1; i < nu; i++ ) {
+        for( int j = 1; j < nv; j++ ) {
+            float u = 1.0f * i / nu, v = 1.0f * j / nv;
+            float position[3], du[3], dv[3];
+            evaluateBezierPatch( net, u, v, position, du, dv );
+            unsigned int index = addVertex( u, v, position );
+            if( i == 1 && j == 1 ) innerBase = index;
+        }
+    }
+    auto inner = [&]( int i, int j ) -> unsigned int { return innerBase + (i-1)*(nv-1) + (j-1); };
+
+    for( int i = 1; i < nu-1; i++ ) {
+        for( int j = 1; j < nv-1; j++ ) {
+            addBezierTriangle( inner(i, j), inner(i, j+1), inner(i+1, j+1), mesh );
+            addBezierTriangle( inner(i+1, j+1), inner(i+1, j), inner(i, j), mesh );
+        }
+    }
+
+    // corners are the corner control points exactly, so every patch meeting there agrees on them
+    unsigned int corners[4];
+    const int CORNER_POINTS[4] = { 0, 12, 3, 15 };
+    const float CORNER_UV[4][2] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 0.0f, 1.0f }, { 1.0f, 1.0f } };
+    for( int k = 0; k < 4; k++ )
+        corners[k] = addVertex( CORNER_UV[k][0], CORNER_UV[k][1], net[ CORNER_POINTS[k] ] );
+
+    // side v = 0, u = 1, v = 1, u = 0: its two corners, and whether it runs along u
+    const int SIDE_CORNERS[4][2] = { { 0, 1 }, { 1, 3 }, { 2, 3 }, { 0, 2 } };
+    const bool SIDE_ALONG_U[4] = { true, false, true, false };
+    const float SIDE_FIXED[4] = { 0.0f, 1.0f, 1.0f, 0.0f };
+
+    for( int side = 0; side < 4; side++ ) {
+        const int segments = edgeSegments[side];
+        std::vector<float> outerT( 1, 0.0f ), innerT;
+        std::vector<unsigned int> outer( 1, corners[ SIDE_CORNERS[side][0] ] ), innerIds;
+
+        // samples along the edge come from the edge's own control points in their shared order,
+        // so the patch on the other side computes the very same positions
+        for( int k = 1; k < segments; k++ ) {
+            int sharedK = layout.flipped[side] ? segments - k : k;
+            float position[3];
+            evaluateBezierCurve( edgePoints[side], 1.0f * sharedK / segments, position );
+            float t = 1.0f * k / segments;
+            outerT.push_back( t );
+            outer.push_back( SIDE_ALONG_U[side] ? addVertex( t, SIDE_FIXED[side], position ) : addVertex( SIDE_FIXED[side], t, position ) );
+        }
+        outerT.push_back( 1.0f );
+        outer.push_back( corners[ SIDE_CORNERS[side][1] ] );
+
+        if( SIDE_ALONG_U[side] ) {
+            int j = side == 0 ? 1 : nv-1;
+            for( int i = 1; i < nu; i++ ) { innerT.push_back( 1.0f * i / nu ); innerIds.push_back( inner(i, j) ); }
+        } else {
+            int i = side == 3 ? 1 : nu-1;
+            for( int j = 1; j < nv; j++ ) { innerT.push_back( 1.0f * j / nv ); innerIds.push_back( inner(i, j) ); }
+        }
+
+        stitchBezierSide( outerT, outer, innerT, innerIds, mesh );
+    }
+}
+
+// fills the strip between an edge and the first interior row with triangles, stepping along
+// whichever of the two rows has the nearer next sample
+inline void CSCI441_INTERNAL::stitchBezierSide( const std::vector<float> &outerT, const std::vector<unsigned int> &outer,
+                                                const std::vector<float> &innerT, const std::vector<unsigned int> &inner, BezierPatchMesh &mesh ) {
+    size_t i = 0, j = 0;
+    const size_t lastOuter = outer.size() - 1, lastInner = inner.size() - 1;
+    while( i < lastOuter || j < lastInner ) {
+        if( j == lastInner || ( i < lastOuter && outerT[i] + outerT[i+1] <= innerT[j] + innerT[j+1] ) ) {
+            addBezierTriangle( outer[i], outer[i+1], inner[j], mesh );
+            i++;
+        } else {
+            addBezierTriangle( outer[i], inner[j+1], inner[j], mesh );
+            j++;
+        }
+    }
+}
+
+// adds a triangle wound clockwise in (u,v), so it faces the same way as the normals
+inline void CSCI441_INTERNAL::addBezierTriangle( unsigned int a, unsigned int b, unsigned int c, BezierPatchMesh &mesh ) {
+    const float *ta = &mesh.texCoords[a*2], *tb = &mesh.texCoords[b*2], *tc = &mesh.texCoords[c*2];
+    float area = (tb[0] - ta[0]) * (tc[1] - ta[1]) - (tb[1] - ta[1]) * (tc[0] - ta[0]);
+    if( area > 0.0f ) std::swap( b, c );
+    mesh.indices.push_back( a );
+    mesh.indices.push_back( b );
+    mesh.indices.push_back( c );
+}
+
+#endif // __CSCI441_BEZIERSURFACE_HPP__
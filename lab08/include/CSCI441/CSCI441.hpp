@@ -19,8 +19,10 @@
 #include "FramebufferUtils.hpp"     // to query common FBO information
 #include "modelLoader.hpp"          // to load OBJ, OFF, PLY, STL files
 #include "OpenGLUtils.hpp"          // to query OpenGL features
+#include "ResourceRegistry.hpp"     // to account for GPU memory used by textures and buffers
 #include "objects.hpp"              // include 3D objects (cube, cylinder, cone, torus, sphere, disk, teapot)
 #include "ShaderProgram.hpp"        // helper class to compile and use shaders
+#include "TextureUploader.hpp"      // helper class to stream textures through pixel buffers
 #include "TextureUtils.hpp"         // helper functions for registering textures
 
 #endif //CSCI441_CSCI441_H
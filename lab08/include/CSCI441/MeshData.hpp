@@ -0,0 +1,634 @@
+/** @file MeshData.hpp
+ * @brief CPU side generators for the CSCI441 procedural objects
+ * @date Last Edit: 19 Oct 2026
+ * @version 1.0
+ *
+ *	Builds the vertex and index arrays of the objects.hpp shapes without
+ *	touching OpenGL, so the geometry can be generated on a headless machine or
+ *	a worker thread, inspected, and written out as OBJ or PLY for debugging.
+ *	objects.hpp uploads the same arrays when an object is first drawn.
+ *
+ *	@warning NOTE: This header file does not depend upon OpenGL or GLEW
+ */
+
+#ifndef __CSCI441_MESHDATA_HPP__
+#define __CSCI441_MESHDATA_HPP__
+
+#include <math.h>						// for cos(), sin()
+#include <stdio.h>						// for fopen(), fprintf()
+
+#include <vector>						// for vector
+
+////////////////////////////////////////////////////////////////////////////////////
+
+/** @namespace CSCI441
+ * @brief CSCI441 Helper Functions for OpenGL
+ */
+namespace CSCI441 {
+    /** @brief how the indices (or vertices) of a mesh form triangles
+      */
+    enum MeshPrimitive {
+        MESH_TRIANGLES = 0,                 ///< every three indices form a triangle
+        MESH_TRIANGLE_STRIPS                ///< each strip of stripLength indices is a triangle strip
+    };
+
+    /** @brief vertex and index arrays of one procedural object
+      *
+      * Attributes are stored as separate arrays in the order objects.hpp places
+      * them in its vertex buffer.  When indices is empty the vertices are used in
+      * order.
+      */
+    struct MeshData {
+        MeshPrimitive primitive;
+        int numStrips, stripLength;         ///< strips are drawn one after another; triangle lists are a single strip
+        std::vector<float> positions;       ///< x, y, z per vertex
+        std::vector<float> normals;         ///< x, y, z per vertex
+        std::vector<float> texCoords;       ///< s, t per vertex, empty when the object has no texture coordinates
+        std::vector<unsigned int> indices;  ///< empty when the vertices are drawn in order
+        float boundsMin[3], boundsMax[3];   ///< axis aligned bounding box of the positions
+
+        MeshData() : primitive(MESH_TRIANGLES), numStrips(0), stripLength(0), boundsMin{0, 0, 0}, boundsMax{0, 0, 0} {}
+
+        /** @brief number of vertices in the mesh
+          */
+        unsigned long int numVertices() const { return positions.size() / 3; }
+
+        /** @brief recomputes boundsMin and boundsMax from the positions
+          */
+        void computeBounds();
+
+        /** @brief expands the strips into a triangle list
+          *
+          * Strip triangles are rewound so every triangle keeps the strip's
+          * facing, and degenerate triangles, including those between copies of
+          * one position such as the sphere's poles, are dropped.
+          *
+          * @param std::vector<unsigned int>& triangles - receives three vertex indices per triangle
+          */
+        void triangulate( std::vector<unsigned int> &triangles ) const;
+
+        /** @brief true when two vertices are the same vertex or sit at the same position
+          */
+        bool samePosition( unsigned int a, unsigned int b ) const {
+            return a == b || ( positions[a*3 + 0] == positions[b*3 + 0] && positions[a*3 + 1] == positions[b*3 + 1] && positions[a*3 + 2] == positions[b*3 + 2] );
+        }
+    };
+
+    /** @brief generates a cube with a separate set of vertices per face, with texture coordinates
+      * @param float sideLength - length of the edge of the cube
+      * @pre sideLength must be greater than zero
+      */
+    MeshData generateCubeFlatMesh( float sideLength );
+    /** @brief generates a cube with one vertex per corner and normals pointing out of the corners
+      * @param float sideLength - length of the edge of the cube
+      * @pre sideLength must be greater than zero
+      */
+    MeshData generateCubeIndexedMesh( float sideLength );
+    /** @brief generates an open ended cylinder along the positive Y axis
+      * @param float base   - radius at y = 0
+      * @param float top    - radius at y = height
+      * @param float height - length along the Y axis
+      * @param int stacks   - resolution along the Y axis
+      * @param int slices   - resolution around the Y axis
+      * @pre stacks must be greater than zero and slices greater than two
+      */
+    MeshData generateCylinderMesh( float base, float top, float height, int stacks, int slices );
+    /** @brief generates a partial disk in the Z = 0 plane facing the positive Z axis
+      * @param float inner  - inner radius
+      * @param float outer  - outer radius
+      * @param float start  - start angle of the disk in radians
+      * @param float sweep  - sweep angle of the disk in radians
+      * @param int slices   - resolution around the Z axis
+      * @param int rings    - resolution from the inner to the outer radius
+      * @pre slices must be greater than two and rings greater than zero
+      */
+    MeshData generateDiskMesh( float inner, float outer, float start, float sweep, int slices, int rings );
+    /** @brief generates a sphere centered at the origin
+      * @param float radius - radius of the sphere
+      * @param int stacks   - resolution along the Y axis
+      * @param int slices   - resolution around the Y axis
+      * @pre stacks must be greater than one and slices greater than two
+      */
+    MeshData generateSphereMesh( float radius, int stacks, int slices );
+    /** @brief generates a torus in the X-Y plane around the Z axis
+      * @param float innerRadius - radius of the tube
+      * @param float outerRadius - distance from the center of the torus to the center of the tube
+      * @param int sides         - resolution around the tube
+      * @param int rings         - resolution around the Z axis
+      * @pre sides and rings must be greater than two
+      */
+    MeshData generateTorusMesh( float innerRadius, float outerRadius, int sides, int rings );
+
+    /** @brief writes a mesh to a Wavefront OBJ file
+      * @param const MeshData& mesh      - mesh to write
+      * @param const char* filename      - file to create
+      * @return true if the file was written
+      */
+    bool exportMeshOBJ( const MeshData &mesh, const char* filename );
+    /** @brief writes a mesh to an ASCII PLY file
+      *
+      * Texture coordinates are written as the s and t vertex properties.
+      *
+      * @param const MeshData& mesh      - mesh to write
+      * @param const char* filename      - file to create
+      * @return true if the file was written
+      */
+    bool exportMeshPLY( const MeshData &mesh, const char* filename );
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Internal helpers shared with objects.hpp
+
+namespace CSCI441_INTERNAL {
+    void generateCircleTable( int steps, float start, float stepSize, float* cosTable, float* sinTable );
+    void generateGridIndices( int numStrips, int rowLength, unsigned int* indices );
+    void allocateMesh( CSCI441::MeshData &mesh, unsigned long int numVertices, bool hasTexCoords, unsigned long int numIndices );
+
+    // unit cubes, scaled to the requested size as they are copied out; the compiler
+    // builds the tables so they cost nothing the first time a cube is drawn
+    static constexpr float CUBE_FLAT_VERTICES[36][3] = {
+            // Left Face
+            {-0.5f, -0.5f, -0.5f}, {-0.5f, -0.5f,  0.5f}, {-0.5f,  0.5f, -0.5f},
+            {-0.5f,  0.5f, -0.5f}, {-0.5f, -0.5f,  0.5f}, {-0.5f,  0.5f,  0.5f},
+            // Right Face
+            { 0.5f,  0.5f,  0.5f}, { 0.5f, -0.5f,  0.5f}, { 0.5f,  0.5f, -0.5f},
+            { 0.5f,  0.5f, -0.5f}, { 0.5f, -0.5f,  0.5f}, { 0.5f, -0.5f, -0.5f},
+            // Top Face
+            {-0.5f,  0.5f, -0.5f}, {-0.5f,  0.5f,  0.5f}, { 0.5f,  0.5f, -0.5f},
+            { 0.5f,  0.5f, -0.5f}, {-0.5f,  0.5f,  0.5f}, { 0.5f,  0.5f,  0.5f},
+            // Bottom Face
+            { 0.5f, -0.5f,  0.5f}, {-0.5f, -0.5f,  0.5f}, { 0.5f, -0.5f, -0.5f},
+            { 0.5f, -0.5f, -0.5f}, {-0.5f, -0.5f,  0.5f}, {-0.5f, -0.5f, -0.5f},
+            // Back Face
+            { 0.5f,  0.5f, -0.5f}, { 0.5f, -0.5f, -0.5f}, {-0.5f,  0.5f, -0.5f},
+            {-0.5f,  0.5f, -0.5f}, { 0.5f, -0.5f, -0.5f}, {-0.5f, -0.5f, -0.5f},
+            // Front Face
+            {-0.5f, -0.5f,  0.5f}, { 0.5f, -0.5f,  0.5f}, {-0.5f,  0.5f,  0.5f},
+            {-0.5f,  0.5f,  0.5f}, { 0.5f, -0.5f,  0.5f}, { 0.5f,  0.5f,  0.5f}
+    };
+    static constexpr float CUBE_FLAT_TEX_COORDS[36][2] = {
+            // Left Face
+            {0.0f, 0.0f}, {1.0f, 0.0f}, {0.0f, 1.0f},
+            {0.0f, 1.0f}, {1.0f, 0.0f}, {1.0f, 1.0f},
+            // Right Face
+            {0.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 1.0f},
+            {1.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 0.0f},
+            // Top Face
+            {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 0.0f},
+            {0.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f},
+            // Bottom Face
+            {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 0.0f},
+            {0.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f},
+            // Back Face
+            {0.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 1.0f},
+            {1.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 0.0f},
+            // Front Face
+            {0.0f, 0.0f}, {1.0f, 0.0f}, {0.0f, 1.0f},
+            {0.0f, 1.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}
+    };
+    static constexpr float CUBE_FLAT_NORMALS[36][3] = {
+            // Left Face
+            {-1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f},
+            {-1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f},
+            // Right Face
+            {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f},
+            {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f},
+            // Top Face
+            {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f},
+            {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f},
+            // Bottom Face
+            {0.0f, -1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {0.0f, -1.0f, 0.0f},
+            {0.0f, -1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {0.0f, -1.0f, 0.0f},
+            // Back Face
+            {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f, -1.0f},
+            {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f, -1.0f},
+            // Front Face
+            {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f},
+            {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}
+    };
+    static constexpr float CUBE_INDEXED_VERTICES[8][3] = {
+            { -0.5f, -0.5f, -0.5f }, // 0 - bln
+            {  0.5f, -0.5f, -0.5f }, // 1 - brn
+            {  0.5f,  0.5f, -0.5f }, // 2 - trn
+            { -0.5f,  0.5f, -0.5f }, // 3 - tln
+            { -0.5f, -0.5f,  0.5f }, // 4 - blf
+            {  0.5f, -0.5f,  0.5f }, // 5 - brf
+            {  0.5f,  0.5f,  0.5f }, // 6 - trf
+            { -0.5f,  0.5f,  0.5f }  // 7 - tlf
+    };
+    static constexpr float CUBE_INDEXED_NORMALS[8][3] = {
+            {-1, -1, -1}, // 0 LBF
+            {-1,  1, -1}, // 1 LTF
+            { 1, -1, -1}, // 2 RBF
+            { 1,  1, -1}, // 3 RTF
+            {-1, -1,  1}, // 4 LBN
+            {-1,  1,  1}, // 5 LTN
+            { 1, -1,  1}, // 6 RBN
+            { 1,  1,  1}  // 7 RTN
+    };
+    static constexpr unsigned int CUBE_INDEXED_INDICES[36] = {
+            0, 1, 2,   0, 2, 3, // near
+            1, 5, 2,   5, 6, 2, // right
+            2, 6, 7,   3, 2, 7, // top
+            0, 1, 4,   1, 5, 4, // bottom
+            4, 5, 6,   4, 6, 7, // back
+            0, 4, 3,   4, 7, 3  // left
+    };
+
+    void copyScaled( const float* source, unsigned long int count, float scale, std::vector<float> &destination );
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Outward facing function implementations
+
+inline void CSCI441::MeshData::computeBounds() {
+    if( positions.empty() ) {
+        for( int j = 0; j < 3; j++ ) boundsMin[j] = boundsMax[j] = 0.0f;
+        return;
+    }
+    for( int j = 0; j < 3; j++ ) boundsMin[j] = boundsMax[j] = positions[j];
+    for( unsigned long int i = 1; i < numVertices(); i++ ) {
+        for( int j = 0; j < 3; j++ ) {
+            float value = positions[ i*3 + j ];
+            if( value < boundsMin[j] ) boundsMin[j] = value;
+            if( value > boundsMax[j] ) boundsMax[j] = value;
+        }
+    }
+}
+
+inline void CSCI441::MeshData::triangulate( std::vector<unsigned int> &triangles ) const {
+    triangles.clear();
+    for( int stripNum = 0; stripNum < numStrips; stripNum++ ) {
+        unsigned long int first = (unsigned long int)stripNum * stripLength;
+        unsigned int v[3];
+        if( primitive == MESH_TRIANGLES ) {
+            for( int i = 0; i + 2 < stripLength; i += 3 ) {
+                for( int k = 0; k < 3; k++ ) {
+                    v[k] = indices.empty() ? (unsigned int)(first + i + k) : indices[ first + i + k ];
+                }
+                triangles.insert( triangles.end(), v, v + 3 );
+            }
+        } else {
+            for( int i = 0; i + 2 < stripLength; i++ ) {
+                for( int k = 0; k < 3; k++ ) {
+                    v[k] = indices.empty() ? (unsigned int)(first + i + k) : indices[ first + i + k ];
+                }
+                if( samePosition( v[0], v[1] ) || samePosition( v[1], v[2] ) || samePosition( v[0], v[2] ) ) continue;
+                // every other triangle of a strip is wound backwards
+                if( i % 2 == 1 ) {
+                    unsigned int swap = v[0]; v[0] = v[1]; v[1] = swap;
+                }
+                triangles.insert( triangles.end(), v, v + 3 );
+            }
+        }
+    }
+}
+
+inline CSCI441::MeshData CSCI441::generateCubeFlatMesh( float sideLength ) {
+    MeshData mesh;
+    mesh.primitive = MESH_TRIANGLES;
+    mesh.numStrips = 1;
+    mesh.stripLength = 36;
+    CSCI441_INTERNAL::copyScaled( &CSCI441_INTERNAL::CUBE_FLAT_VERTICES[0][0], 36*3, sideLength, mesh.positions );
+    mesh.normals.assign( &CSCI441_INTERNAL::CUBE_FLAT_NORMALS[0][0], &CSCI441_INTERNAL::CUBE_FLAT_NORMALS[0][0] + 36*3 );
+    mesh.texCoords.assign( &CSCI441_INTERNAL::CUBE_FLAT_TEX_COORDS[0][0], &CSCI441_INTERNAL::CUBE_FLAT_TEX_COORDS[0][0] + 36*2 );
+    mesh.computeBounds();
+    return mesh;
+}
+
+inline CSCI441::MeshData CSCI441::generateCubeIndexedMesh( float sideLength ) {
+    MeshData mesh;
+    mesh.primitive = MESH_TRIANGLES;
+    mesh.numStrips = 1;
+    mesh.stripLength = 36;
+    CSCI441_INTERNAL::copyScaled( &CSCI441_INTERNAL::CUBE_INDEXED_VERTICES[0][0], 8*3, sideLength, mesh.positions );
+    mesh.normals.assign( &CSCI441_INTERNAL::CUBE_INDEXED_NORMALS[0][0], &CSCI441_INTERNAL::CUBE_INDEXED_NORMALS[0][0] + 8*3 );
+    mesh.indices.assign( CSCI441_INTERNAL::CUBE_INDEXED_INDICES, CSCI441_INTERNAL::CUBE_INDEXED_INDICES + 36 );
+    mesh.computeBounds();
+    return mesh;
+}
+
+inline CSCI441::MeshData CSCI441::generateCylinderMesh( float base, float top, float height, int stacks, int slices ) {
+    unsigned long int numVertices = (stacks+1) * (slices+1);
+
+    float sliceStep = 2.0 * M_PI / slices;
+    float stackStep = height / stacks;
+
+    MeshData mesh;
+    CSCI441_INTERNAL::allocateMesh( mesh, numVertices, true, stacks * (slices+1) * 2 );
+    float* vertices = mesh.positions.data();
+    float* normals = mesh.normals.data();
+    float* texCoords = mesh.texCoords.data();
+
+    std::vector<float> sliceCos(slices+1), sliceSin(slices+1);
+    CSCI441_INTERNAL::generateCircleTable( slices, 0.0f, sliceStep, sliceCos.data(), sliceSin.data() );
+
+    unsigned long int idx = 0;
+
+    // one ring of vertices per stack boundary, shared by the stacks above and below it
+    for( int stackNum = 0; stackNum <= stacks; stackNum++ ) {
+        float radius = base*(stacks-stackNum)/stacks + top*stackNum/stacks;
+
+        for( int sliceNum = 0; sliceNum <= slices; sliceNum++ ) {
+            normals[ idx*3 + 0 ] = sliceCos[ sliceNum ];
+            normals[ idx*3 + 1 ] = 0.0f;
+            normals[ idx*3 + 2 ] = sliceSin[ sliceNum ];
+
+            texCoords[ idx*2 + 0 ] = (float)sliceNum / slices;
+            texCoords[ idx*2 + 1 ] = (float)stackNum / stacks;
+
+            vertices[ idx*3 + 0 ] = sliceCos[ sliceNum ]*radius;
+            vertices[ idx*3 + 1 ] = stackNum * stackStep;
+            vertices[ idx*3 + 2 ] = sliceSin[ sliceNum ]*radius;
+
+            idx++;
+        }
+    }
+
+    CSCI441_INTERNAL::generateGridIndices( stacks, slices+1, mesh.indices.data() );
+
+    mesh.primitive = MESH_TRIANGLE_STRIPS;
+    mesh.numStrips = stacks;
+    mesh.stripLength = (slices+1)*2;
+    mesh.computeBounds();
+    return mesh;
+}
+
+inline CSCI441::MeshData CSCI441::generateDiskMesh( float inner, float outer, float start, float sweep, int slices, int rings ) {
+    unsigned long int numVertices = (rings+1) * (slices+1);
+
+    float sliceStep = sweep / slices;
+    float ringStep = (outer - inner) / rings;
+
+    MeshData mesh;
+    CSCI441_INTERNAL::allocateMesh( mesh, numVertices, true, rings * (slices+1) * 2 );
+    float* vertices = mesh.positions.data();
+    float* normals = mesh.normals.data();
+    float* texCoords = mesh.texCoords.data();
+
+    std::vector<float> sliceCos(slices+1), sliceSin(slices+1);
+    CSCI441_INTERNAL::generateCircleTable( slices, start, sliceStep, sliceCos.data(), sliceSin.data() );
+
+    unsigned long int idx = 0;
+
+    for( int ringNum = 0; ringNum <= rings; ringNum++ ) {
+        float radius = inner + ringNum*ringStep;
+
+        for( int i = 0; i <= slices; i++ ) {
+            normals[ idx*3 + 0 ] = 0.0f;
+            normals[ idx*3 + 1 ] = 0.0f;
+            normals[ idx*3 + 2 ] = 1.0f;
+
+            texCoords[ idx*2 + 0 ] = sliceCos[i]*(radius/outer);
+            texCoords[ idx*2 + 1 ] = sliceSin[i]*(radius/outer);
+
+            vertices[ idx*3 + 0 ] = sliceCos[i]*radius;
+            vertices[ idx*3 + 1 ] = sliceSin[i]*radius;
+            vertices[ idx*3 + 2 ] = 0.0f;
+
+            idx++;
+        }
+    }
+
+    CSCI441_INTERNAL::generateGridIndices( rings, slices+1, mesh.indices.data() );
+
+    mesh.primitive = MESH_TRIANGLE_STRIPS;
+    mesh.numStrips = rings;
+    mesh.stripLength = (slices+1)*2;
+    mesh.computeBounds();
+    return mesh;
+}
+
+inline CSCI441::MeshData CSCI441::generateSphereMesh( float radius, int stacks, int slices ) {
+    // one ring of vertices per stack boundary; the poles get a vertex per slice so
+    // their texture coordinates follow the slices like every other ring
+    unsigned long int numVertices = (stacks+1) * (slices+1);
+
+    float sliceStep = 2.0 * M_PI / slices;
+    float stackStep = M_PI / stacks;
+
+    MeshData mesh;
+    CSCI441_INTERNAL::allocateMesh( mesh, numVertices, true, stacks * (slices+1) * 2 );
+    float* vertices = mesh.positions.data();
+    float* normals = mesh.normals.data();
+    float* texCoords = mesh.texCoords.data();
+
+    std::vector<float> sliceCos(slices+1), sliceSin(slices+1);
+    std::vector<float> stackCos(stacks+1), stackSin(stacks+1);
+    CSCI441_INTERNAL::generateCircleTable( slices, 0.0f, sliceStep, sliceCos.data(), sliceSin.data() );
+    CSCI441_INTERNAL::generateCircleTable( stacks, 0.0f, stackStep, stackCos.data(), stackSin.data() );
+
+    unsigned long int idx = 0;
+
+    // from the bottom pole to the top pole
+    for( int stackNum = 0; stackNum <= stacks; stackNum++ ) {
+        float phi = stackStep * stackNum;
+        // exactly zero at the poles, so their normals point straight along the Y axis
+        float ringSin = (stackNum == 0 || stackNum == stacks) ? 0.0f : stackSin[ stackNum ];
+
+        for( int sliceNum = 0; sliceNum <= slices; sliceNum++ ) {
+            float theta = sliceStep * sliceNum;
+
+            normals[ idx*3 + 0 ] = -sliceCos[ sliceNum ]*ringSin;
+            normals[ idx*3 + 1 ] = -stackCos[ stackNum ];
+            normals[ idx*3 + 2 ] =  sliceSin[ sliceNum ]*ringSin;
+
+            texCoords[ idx*2 + 0 ] = theta / 6.28;
+            texCoords[ idx*2 + 1 ] = phi / 3.14;
+
+            vertices[ idx*3 + 0 ] = -sliceCos[ sliceNum ]*ringSin*radius;
+            vertices[ idx*3 + 1 ] = -stackCos[ stackNum ]*radius;
+            vertices[ idx*3 + 2 ] = sliceSin[ sliceNum ]*ringSin*radius;
+
+            idx++;
+        }
+    }
+
+    // one strip per stack, walking the slices backwards so every face winds outwards;
+    // in the cap strips every other triangle joins two copies of the pole and has no area
+    unsigned int* indices = mesh.indices.data();
+
+    idx = 0;
+    for( int stackNum = 0; stackNum < stacks; stackNum++ ) {
+        for( int sliceNum = slices; sliceNum >= 0; sliceNum-- ) {
+            indices[ idx++ ] = stackNum*(slices+1) + sliceNum;
+            indices[ idx++ ] = (stackNum+1)*(slices+1) + sliceNum;
+        }
+    }
+
+    mesh.primitive = MESH_TRIANGLE_STRIPS;
+    mesh.numStrips = stacks;
+    mesh.stripLength = (slices+1)*2;
+    mesh.computeBounds();
+    return mesh;
+}
+
+inline CSCI441::MeshData CSCI441::generateTorusMesh( float innerRadius, float outerRadius, int sides, int rings ) {
+    unsigned long int numVertices = (rings+1) * (sides+1);
+
+    MeshData mesh;
+    CSCI441_INTERNAL::allocateMesh( mesh, numVertices, true, rings * (sides+1) * 2 );
+    float* vertices = mesh.positions.data();
+    float* normals = mesh.normals.data();
+    float* texCoords = mesh.texCoords.data();
+
+    float sideStep = 2.0 * M_PI / sides;
+    float ringStep = 2.0 * M_PI / rings;
+
+    std::vector<float> sideCos(sides+1), sideSin(sides+1);
+    std::vector<float> ringCos(rings+1), ringSin(rings+1);
+    CSCI441_INTERNAL::generateCircleTable( sides, 0.0f, sideStep, sideCos.data(), sideSin.data() );
+    CSCI441_INTERNAL::generateCircleTable( rings, 0.0f, ringStep, ringCos.data(), ringSin.data() );
+
+    unsigned long int idx = 0;
+
+    for( int ringNum = 0; ringNum <= rings; ringNum++ ) {
+        for( int sideNum = 0; sideNum <= sides; sideNum++ ) {
+            normals[ idx*3 + 0 ] = sideCos[ sideNum ] * ringCos[ ringNum ];
+            normals[ idx*3 + 1 ] = sideCos[ sideNum ] * ringSin[ ringNum ];
+            normals[ idx*3 + 2 ] = sideSin[ sideNum ];
+
+            texCoords[ idx*2 + 0 ] = sideCos[ sideNum ] * ringCos[ ringNum ];
+            texCoords[ idx*2 + 1 ] = sideCos[ sideNum ] * ringSin[ ringNum ];
+
+            vertices[ idx*3 + 0 ] = ( outerRadius + innerRadius * sideCos[ sideNum ] ) * ringCos[ ringNum ];
+            vertices[ idx*3 + 1 ] = ( outerRadius + innerRadius * sideCos[ sideNum ] ) * ringSin[ ringNum ];
+            vertices[ idx*3 + 2 ] = innerRadius * sideSin[ sideNum ];
+
+            idx++;
+        }
+    }
+
+    CSCI441_INTERNAL::generateGridIndices( rings, sides+1, mesh.indices.data() );
+
+    mesh.primitive = MESH_TRIANGLE_STRIPS;
+    mesh.numStrips = rings;
+    mesh.stripLength = (sides+1)*2;
+    mesh.computeBounds();
+    return mesh;
+}
+
+inline bool CSCI441::exportMeshOBJ( const MeshData &mesh, const char* filename ) {
+    FILE* fp = fopen( filename, "w" );
+    if( !fp ) {
+        fprintf( stderr, "[.obj]: [ERROR]: Could not open \"%s\" for writing\n", filename );
+        return false;
+    }
+
+    unsigned long int numVertices = mesh.numVertices();
+    bool hasNormals = mesh.normals.size() == numVertices*3;
+    bool hasTexCoords = mesh.texCoords.size() == numVertices*2;
+
+    fprintf( fp, "# %lu vertices, bounds (%g %g %g) - (%g %g %g)\n", numVertices,
+             mesh.boundsMin[0], mesh.boundsMin[1], mesh.boundsMin[2], mesh.boundsMax[0], mesh.boundsMax[1], mesh.boundsMax[2] );
+    for( unsigned long int i = 0; i < numVertices; i++ ) {
+        fprintf( fp, "v %.9g %.9g %.9g\n", mesh.positions[i*3 + 0], mesh.positions[i*3 + 1], mesh.positions[i*3 + 2] );
+    }
+    if( hasTexCoords ) {
+        for( unsigned long int i = 0; i < numVertices; i++ ) {
+            fprintf( fp, "vt %.9g %.9g\n", mesh.texCoords[i*2 + 0], mesh.texCoords[i*2 + 1] );
+        }
+    }
+    if( hasNormals ) {
+        for( unsigned long int i = 0; i < numVertices; i++ ) {
+            fprintf( fp, "vn %.9g %.9g %.9g\n", mesh.normals[i*3 + 0], mesh.normals[i*3 + 1], mesh.normals[i*3 + 2] );
+        }
+    }
+
+    // OBJ indices start at one, and every attribute shares the vertex index
+    std::vector<unsigned int> triangles;
+    mesh.triangulate( triangles );
+    for( unsigned long int t = 0; t < triangles.size(); t += 3 ) {
+        fprintf( fp, "f" );
+        for( int k = 0; k < 3; k++ ) {
+            unsigned int v = triangles[t + k] + 1;
+            if( hasTexCoords && hasNormals )    fprintf( fp, " %u/%u/%u", v, v, v );
+            else if( hasNormals )               fprintf( fp, " %u//%u", v, v );
+            else if( hasTexCoords )             fprintf( fp, " %u/%u", v, v );
+            else                                fprintf( fp, " %u", v );
+        }
+        fprintf( fp, "\n" );
+    }
+
+    bool written = !ferror( fp );
+    fclose( fp );
+    return written;
+}
+
+inline bool CSCI441::exportMeshPLY( const MeshData &mesh, const char* filename ) {
+    FILE* fp = fopen( filename, "w" );
+    if( !fp ) {
+        fprintf( stderr, "[.ply]: [ERROR]: Could not open \"%s\" for writing\n", filename );
+        return false;
+    }
+
+    unsigned long int numVertices = mesh.numVertices();
+    bool hasNormals = mesh.normals.size() == numVertices*3;
+    bool hasTexCoords = mesh.texCoords.size() == numVertices*2;
+
+    std::vector<unsigned int> triangles;
+    mesh.triangulate( triangles );
+
+    fprintf( fp, "ply\nformat ascii 1.0\n" );
+    fprintf( fp, "element vertex %lu\n", numVertices );
+    fprintf( fp, "property float x\nproperty float y\nproperty float z\n" );
+    if( hasNormals )   fprintf( fp, "property float nx\nproperty float ny\nproperty float nz\n" );
+    if( hasTexCoords ) fprintf( fp, "property float s\nproperty float t\n" );
+    fprintf( fp, "element face %lu\n", (unsigned long int)(triangles.size() / 3) );
+    fprintf( fp, "property list uchar uint vertex_indices\n" );
+    fprintf( fp, "end_header\n" );
+
+    for( unsigned long int i = 0; i < numVertices; i++ ) {
+        fprintf( fp, "%.9g %.9g %.9g", mesh.positions[i*3 + 0], mesh.positions[i*3 + 1], mesh.positions[i*3 + 2] );
+        if( hasNormals )   fprintf( fp, " %.9g %.9g %.9g", mesh.normals[i*3 + 0], mesh.normals[i*3 + 1], mesh.normals[i*3 + 2] );
+        if( hasTexCoords ) fprintf( fp, " %.9g %.9g", mesh.texCoords[i*2 + 0], mesh.texCoords[i*2 + 1] );
+        fprintf( fp, "\n" );
+    }
+    for( unsigned long int t = 0; t < triangles.size(); t += 3 ) {
+        fprintf( fp, "3 %u %u %u\n", triangles[t + 0], triangles[t + 1], triangles[t + 2] );
+    }
+
+    bool written = !ferror( fp );
+    fclose( fp );
+    return written;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Internal function implementations
+
+inline void CSCI441_INTERNAL::generateCircleTable( int steps, float start, float stepSize, float* cosTable, float* sinTable ) {
+    for( int i = 0; i <= steps; i++ ) {
+        float angle = start + stepSize * i;
+        cosTable[i] = cos( angle );
+        sinTable[i] = sin( angle );
+    }
+}
+
+inline void CSCI441_INTERNAL::generateGridIndices( int numStrips, int rowLength, unsigned int* indices ) {
+    unsigned long int idx = 0;
+    for( int stripNum = 0; stripNum < numStrips; stripNum++ ) {
+        for( int i = 0; i < rowLength; i++ ) {
+            indices[ idx++ ] = stripNum*rowLength + i;
+            indices[ idx++ ] = (stripNum+1)*rowLength + i;
+        }
+    }
+}
+
+inline void CSCI441_INTERNAL::allocateMesh( CSCI441::MeshData &mesh, unsigned long int numVertices, bool hasTexCoords, unsigned long int numIndices ) {
+    mesh.positions.resize( numVertices*3 );
+    mesh.normals.resize( numVertices*3 );
+    mesh.texCoords.resize( hasTexCoords ? numVertices*2 : 0 );
+    mesh.indices.resize( numIndices );
+}
+
+inline void CSCI441_INTERNAL::copyScaled( const float* source, unsigned long int count, float scale, std::vector<float> &destination ) {
+    destination.resize( count );
+    for( unsigned long int i = 0; i < count; i++ ) {
+        destination[i] = source[i] * scale;
+    }
+}
+
+#endif // __CSCI441_MESHDATA_HPP__
@@ -0,0 +1,469 @@
+/** @file ResourceRegistry.hpp
+ * @brief Tracks the textures and buffers the CSCI441 helpers place on the GPU
+ * @date Last Edit: 19 Oct 2026
+ * @version 2.0
+ *
+ *	Every texture and buffer the helpers allocate is recorded here with its
+ *	size, format, owner, and the last frame it was used.  Totals can be queried
+ *	per category and the whole registry can be printed to find leaks - a
+ *	resource created every frame shows up as a growing list of entries from
+ *	the same owner.
+ *
+ *	A soft budget may be set.  When the registered total exceeds it,
+ *	nextFrame() calls the eviction callbacks of the least recently used
+ *	resources until the total fits again.
+ *
+ *	@warning NOTE: This header file depends upon GLEW
+ */
+
+#ifndef __CSCI441_RESOURCEREGISTRY_HPP__
+#define __CSCI441_RESOURCEREGISTRY_HPP__
+
+#include <GL/glew.h>
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////
+
+/** @namespace CSCI441
+  * @brief CSCI441 Helper Functions for OpenGL
+	*/
+namespace CSCI441 {
+    /** @namespace ResourceRegistry
+      * @brief Accounting of GPU memory used by textures and buffers
+      */
+    namespace ResourceRegistry {
+        /** @brief kinds of resources tracked by the registry
+          */
+        enum ResourceCategory {
+            TEXTURE_RESOURCE = 0,           ///< 2D textures and cube maps
+            VERTEX_BUFFER_RESOURCE,         ///< GL_ARRAY_BUFFER objects
+            INDEX_BUFFER_RESOURCE,          ///< GL_ELEMENT_ARRAY_BUFFER objects
+            PIXEL_BUFFER_RESOURCE,          ///< GL_PIXEL_UNPACK_BUFFER and GL_PIXEL_PACK_BUFFER objects
+            OTHER_BUFFER_RESOURCE,          ///< any other buffer target
+            NUM_RESOURCE_CATEGORIES
+        };
+
+        /** @brief called when a resource is chosen for eviction
+          *
+          * The callback must delete the OpenGL object.  The registry forgets the
+          * resource once the callback returns.
+          *
+          * @param GLuint handle   - handle of the texture or buffer to evict
+          * @param void* userData  - pointer given when the callback was set
+          */
+        typedef void (*EvictionCallback)( GLuint handle, void* userData );
+
+        /** @brief records a texture
+          *
+          * Registering a handle that is already registered replaces its entry.
+          *
+          * @param GLuint handle        - texture handle
+          * @param GLsizei width        - width of the base level
+          * @param GLsizei height       - height of the base level
+          * @param GLenum format        - internal format of the texture
+          * @param const char* owner    - helper or function that created the texture
+          * @param const char* label    - description such as a filename (default: "")
+          * @param bool mipmapped       - whether a full mipmap chain is allocated (default: false)
+          * @param GLuint numFaces      - number of faces, 6 for cube maps (default: 1)
+          */
+        void registerTexture( GLuint handle, GLsizei width, GLsizei height, GLenum format, const char* owner,
+                              const char* label = "", bool mipmapped = false, GLuint numFaces = 1 );
+
+        /** @brief records a buffer
+          *
+          * Registering a handle that is already registered replaces its entry.
+          *
+          * @param GLuint handle        - buffer handle
+          * @param GLenum target        - target the buffer was allocated with
+          * @param GLsizeiptr size      - size of the buffer's data store in bytes
+          * @param const char* owner    - helper or function that created the buffer
+          * @param const char* label    - description of the contents (default: "")
+          */
+        void registerBuffer( GLuint handle, GLenum target, GLsizeiptr size, const char* owner, const char* label = "" );
+
+        /** @brief forgets a texture - call alongside glDeleteTextures()
+          * @param GLuint handle - texture handle
+          */
+        void releaseTexture( GLuint handle );
+
+        /** @brief forgets a buffer - call alongside glDeleteBuffers()
+          * @param GLuint handle - buffer handle
+          */
+        void releaseBuffer( GLuint handle );
+
+        /** @brief marks a texture as used during the current frame
+          * @param GLuint handle - texture handle
+          */
+        void touchTexture( GLuint handle );
+
+        /** @brief marks a buffer as used during the current frame
+          * @param GLuint handle - buffer handle
+          */
+        void touchBuffer( GLuint handle );
+
+        /** @brief allows a texture to be evicted when the registry is over budget
+          * @param GLuint handle                - texture handle
+          * @param EvictionCallback callback    - called to delete the texture
+          * @param void* userData               - passed through to the callback (default: NULL)
+          */
+        void setTextureEvictionCallback( GLuint handle, EvictionCallback callback, void* userData = NULL );
+
+        /** @brief allows a buffer to be evicted when the registry is over budget
+          * @param GLuint handle                - buffer handle
+          * @param EvictionCallback callback    - called to delete the buffer
+          * @param void* userData               - passed through to the callback (default: NULL)
+          */
+        void setBufferEvictionCallback( GLuint handle, EvictionCallback callback, void* userData = NULL );
+
+        /** @brief sets the soft budget in bytes, 0 disables eviction
+          * @param size_t bytes - budget in bytes
+          */
+        void setBudget( size_t bytes );
+
+        /** @brief advances the frame counter and evicts resources if over budget
+          *
+          * Call once per frame.  Resources used during the frame that just ended are never evicted.
+          */
+        void nextFrame();
+
+        /** @brief returns the current frame number
+          * @return GLuint - number of calls to nextFrame()
+          */
+        GLuint getFrame();
+
+        /** @brief returns the bytes registered for a category
+          * @param ResourceCategory category - category to total
+          * @return size_t - bytes registered
+          */
+        size_t getTotalBytes( ResourceCategory category );
+
+        /** @brief returns the bytes registered across all categories
+          * @return size_t - bytes registered
+          */
+        size_t getTotalBytes();
+
+        /** @brief returns the number of resources registered for a category
+          * @param ResourceCategory category - category to count
+          * @return size_t - resources registered
+          */
+        size_t getNumResources( ResourceCategory category );
+
+        /** @brief prints every registered resource, largest first, followed by the totals
+          * @param FILE* out - stream to print to (default: stdout)
+          */
+        void dump( FILE* out = stdout );
+
+        /** @brief prints the totals for each category
+          * @param FILE* out - stream to print to (default: stdout)
+          */
+        void printTotals( FILE* out = stdout );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+
+/** @namespace CSCI441_INTERNAL
+  * @brief CSCI441 Helper Functions - do not need to be called directly
+	*/
+namespace CSCI441_INTERNAL {
+    struct RegisteredResource {
+        GLuint handle;
+        CSCI441::ResourceRegistry::ResourceCategory category;
+        size_t byteSize;
+        GLenum format;                              // internal format for textures, target for buffers
+        std::string owner;
+        std::string label;
+        GLuint lastUsedFrame;
+        CSCI441::ResourceRegistry::EvictionCallback evict;
+        void* evictData;
+    };
+
+    struct ResourceRegistryState {
+        std::map< GLuint, RegisteredResource > textures;
+        std::map< GLuint, RegisteredResource > buffers;
+        size_t categoryBytes[ CSCI441::ResourceRegistry::NUM_RESOURCE_CATEGORIES ];
+        size_t categoryCounts[ CSCI441::ResourceRegistry::NUM_RESOURCE_CATEGORIES ];
+        size_t budget;
+        bool overBudget;                            // true while eviction could not get under budget
+        GLuint frame;
+
+        ResourceRegistryState() : budget(0), overBudget(false), frame(0) {
+            for( int i = 0; i < CSCI441::ResourceRegistry::NUM_RESOURCE_CATEGORIES; i++ ) {
+                categoryBytes[i] = 0;
+                categoryCounts[i] = 0;
+            }
+        }
+    };
+
+    ResourceRegistryState& resourceRegistry();
+    void addResource( std::map< GLuint, RegisteredResource > &resources, const RegisteredResource &resource );
+    void removeResource( std::map< GLuint, RegisteredResource > &resources, GLuint handle );
+    GLuint bytesPerTexel( GLenum format );
+    const char* resourceCategoryName( CSCI441::ResourceRegistry::ResourceCategory category );
+    bool largerResource( const RegisteredResource *a, const RegisteredResource *b );
+    bool olderResource( const RegisteredResource &a, const RegisteredResource &b );
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Outward facing function implementations
+
+inline void CSCI441::ResourceRegistry::registerTexture( GLuint handle, GLsizei width, GLsizei height, GLenum format, const char* owner,
+                                                        const char* label, bool mipmapped, GLuint numFaces ) {
+    CSCI441_INTERNAL::RegisteredResource resource;
+    resource.handle = handle;
+    resource.category = TEXTURE_RESOURCE;
+    resource.byteSize = (size_t)width * height * CSCI441_INTERNAL::bytesPerTexel( format ) * numFaces;
+    if( mipmapped ) resource.byteSize = resource.byteSize * 4 / 3;     // a full mipmap chain adds one third
+    resource.format = format;
+    resource.owner = owner;
+    resource.label = label;
+    resource.lastUsedFrame = CSCI441_INTERNAL::resourceRegistry().frame;
+    resource.evict = NULL;
+    resource.evictData = NULL;
+
+    CSCI441_INTERNAL::addResource( CSCI441_INTERNAL::resourceRegistry().textures, resource );
+}
+
+inline void CSCI441::ResourceRegistry::registerBuffer( GLuint handle, GLenum target, GLsizeiptr size, const char* owner, const char* label ) {
+    CSCI441_INTERNAL::RegisteredResource resource;
+    resource.handle = handle;
+    switch( target ) {
+        case GL_ARRAY_BUFFER:           resource.category = VERTEX_BUFFER_RESOURCE; break;
+        case GL_ELEMENT_ARRAY_BUFFER:   resource.category = INDEX_BUFFER_RESOURCE;  break;
+        case GL_PIXEL_UNPACK_BUFFER:
+        case GL_PIXEL_PACK_BUFFER:      resource.category = PIXEL_BUFFER_RESOURCE;  break;
+        default:                        resource.category = OTHER_BUFFER_RESOURCE;  break;
+    }
+    resource.byteSize = (size_t)size;
+    resource.format = target;
+    resource.owner = owner;
+    resource.label = label;
+    resource.lastUsedFrame = CSCI441_INTERNAL::resourceRegistry().frame;
+    resource.evict = NULL;
+    resource.evictData = NULL;
+
+    CSCI441_INTERNAL::addResource( CSCI441_INTERNAL::resourceRegistry().buffers, resource );
+}
+
+inline void CSCI441::ResourceRegistry::releaseTexture( GLuint handle ) {
+    CSCI441_INTERNAL::removeResource( CSCI441_INTERNAL::resourceRegistry().textures, handle );
+}
+
+inline void CSCI441::ResourceRegistry::releaseBuffer( GLuint handle ) {
+    CSCI441_INTERNAL::removeResource( CSCI441_INTERNAL::resourceRegistry().buffers, handle );
+}
+
+inline void CSCI441::ResourceRegistry::touchTexture( GLuint handle ) {
+    CSCI441_INTERNAL::ResourceRegistryState &registry = CSCI441_INTERNAL::resourceRegistry();
+    std::map< GLuint, CSCI441_INTERNAL::RegisteredResource >::iterator iter = registry.textures.find( handle );
+    if( iter != registry.textures.end() ) iter->second.lastUsedFrame = registry.frame;
+}
+
+inline void CSCI441::ResourceRegistry::touchBuffer( GLuint handle ) {
+    CSCI441_INTERNAL::ResourceRegistryState &registry = CSCI441_INTERNAL::resourceRegistry();
+    std::map< GLuint, CSCI441_INTERNAL::RegisteredResource >::iterator iter = registry.buffers.find( handle );
+    if( iter != registry.buffers.end() ) iter->second.lastUsedFrame = registry.frame;
+}
+
+inline void CSCI441::ResourceRegistry::setTextureEvictionCallback( GLuint handle, EvictionCallback callback, void* userData ) {
+    CSCI441_INTERNAL::ResourceRegistryState &registry = CSCI441_INTERNAL::resourceRegistry();
+    std::map< GLuint, CSCI441_INTERNAL::RegisteredResource >::iterator iter = registry.textures.find( handle );
+    if( iter != registry.textures.end() ) {
+        iter->second.evict = callback;
+        iter->second.evictData = userData;
+    }
+}
+
+inline void CSCI441::ResourceRegistry::setBufferEvictionCallback( GLuint handle, EvictionCallback callback, void* userData ) {
+    CSCI441_INTERNAL::ResourceRegistryState &registry = CSCI441_INTERNAL::resourceRegistry();
+    std::map< GLuint, CSCI441_INTERNAL::RegisteredResource >::iterator iter = registry.buffers.find( handle );
+    if( iter != registry.buffers.end() ) {
+        iter->second.evict = callback;
+        iter->second.evictData = userData;
+    }
+}
+
+inline void CSCI441::ResourceRegistry::setBudget( size_t bytes ) {
+    CSCI441_INTERNAL::resourceRegistry().budget = bytes;
+}
+
+inline void CSCI441::ResourceRegistry::nextFrame() {
+    CSCI441_INTERNAL::ResourceRegistryState &registry = CSCI441_INTERNAL::resourceRegistry();
+    registry.frame++;
+
+    if( registry.budget == 0 || getTotalBytes() <= registry.budget ) {
+        registry.overBudget = false;
+        return;
+    }
+
+    // gather everything that can be evicted and was not used last frame, oldest first.  entries are
+    // copied since a callback may release other resources while we walk the list
+    std::vector< CSCI441_INTERNAL::RegisteredResource > candidates;
+    std::map< GLuint, CSCI441_INTERNAL::RegisteredResource >::iterator iter;
+    for( iter = registry.textures.begin(); iter != registry.textures.end(); iter++ ) {
+        if( iter->second.evict && iter->second.lastUsedFrame + 1 < registry.frame ) candidates.push_back( iter->second );
+    }
+    for( iter = registry.buffers.begin(); iter != registry.buffers.end(); iter++ ) {
+        if( iter->second.evict && iter->second.lastUsedFrame + 1 < registry.frame ) candidates.push_back( iter->second );
+    }
+    std::sort( candidates.begin(), candidates.end(), CSCI441_INTERNAL::olderResource );
+
+    for( size_t i = 0; i < candidates.size() && getTotalBytes() > registry.budget; i++ ) {
+        bool isTexture = candidates[i].category == TEXTURE_RESOURCE;
+        std::map< GLuint, CSCI441_INTERNAL::RegisteredResource > &resources = isTexture ? registry.textures : registry.buffers;
+        if( resources.find( candidates[i].handle ) == resources.end() )
+            continue;
+
+        candidates[i].evict( candidates[i].handle, candidates[i].evictData );
+        CSCI441_INTERNAL::removeResource( resources, candidates[i].handle );
+    }
+
+    // only report the first frame we are stuck over budget
+    bool overBudget = getTotalBytes() > registry.budget;
+    if( overBudget && !registry.overBudget ) {
+        fprintf( stderr, "[ERROR]: GPU resources use %lu KB, over the %lu KB budget, and no idle resource can be evicted\n",
+                 (unsigned long)(getTotalBytes() / 1024), (unsigned long)(registry.budget / 1024) );
+    }
+    registry.overBudget = overBudget;
+}
+
+inline GLuint CSCI441::ResourceRegistry::getFrame() {
+    return CSCI441_INTERNAL::resourceRegistry().frame;
+}
+
+inline size_t CSCI441::ResourceRegistry::getTotalBytes( ResourceCategory category ) {
+    return CSCI441_INTERNAL::resourceRegistry().categoryBytes[ category ];
+}
+
+inline size_t CSCI441::ResourceRegistry::getTotalBytes() {
+    size_t total = 0;
+    for( int i = 0; i < NUM_RESOURCE_CATEGORIES; i++ ) {
+        total += CSCI441_INTERNAL::resourceRegistry().categoryBytes[i];
+    }
+    return total;
+}
+
+inline size_t CSCI441::ResourceRegistry::getNumResources( ResourceCategory category ) {
+    return CSCI441_INTERNAL::resourceRegistry().categoryCounts[ category ];
+}
+
+inline void CSCI441::ResourceRegistry::dump( FILE* out ) {
+    CSCI441_INTERNAL::ResourceRegistryState &registry = CSCI441_INTERNAL::resourceRegistry();
+
+    std::vector< CSCI441_INTERNAL::RegisteredResource* > resources;
+    std::map< GLuint, CSCI441_INTERNAL::RegisteredResource >::iterator iter;
+    for( iter = registry.textures.begin(); iter != registry.textures.end(); iter++ ) resources.push_back( &(iter->second) );
+    for( iter = registry.buffers.begin(); iter != registry.buffers.end(); iter++ )   resources.push_back( &(iter->second) );
+    std::sort( resources.begin(), resources.end(), CSCI441_INTERNAL::largerResource );
+
+    fprintf( out, "[INFO]: /--------------------------------------------------------------------------------\n" );
+    fprintf( out, "[INFO]: | GPU Resources at frame %u\n", registry.frame );
+    fprintf( out, "[INFO]: |--------------------------------------------------------------------------------\n" );
+    fprintf( out, "[INFO]: | %-14s %6s %10s %7s %10s  %-20s %s\n", "Category", "Handle", "KB", "Format", "Last Used", "Owner", "Label" );
+    for( size_t i = 0; i < resources.size(); i++ ) {
+        fprintf( out, "[INFO]: | %-14s %6u %10.1f 0x%05X %10u  %-20s %s\n",
+                 CSCI441_INTERNAL::resourceCategoryName( resources[i]->category ),
+                 resources[i]->handle,
+                 resources[i]->byteSize / 1024.0f,
+                 resources[i]->format,
+                 resources[i]->lastUsedFrame,
+                 resources[i]->owner.c_str(),
+                 resources[i]->label.c_str() );
+    }
+    printTotals( out );
+}
+
+inline void CSCI441::ResourceRegistry::printTotals( FILE* out ) {
+    CSCI441_INTERNAL::ResourceRegistryState &registry = CSCI441_INTERNAL::resourceRegistry();
+
+    fprintf( out, "[INFO]: |--------------------------------------------------------------------------------\n" );
+    for( int i = 0; i < NUM_RESOURCE_CATEGORIES; i++ ) {
+        fprintf( out, "[INFO]: | %-14s %6lu resources %12.1f KB\n",
+                 CSCI441_INTERNAL::resourceCategoryName( (ResourceCategory)i ),
+                 (unsigned long)registry.categoryCounts[i],
+                 registry.categoryBytes[i] / 1024.0f );
+    }
+    fprintf( out, "[INFO]: | %-14s %23.1f KB", "Total", getTotalBytes() / 1024.0f );
+    if( registry.budget > 0 ) fprintf( out, " of %.1f KB budget", registry.budget / 1024.0f );
+    fprintf( out, "\n" );
+    fprintf( out, "[INFO]: \\--------------------------------------------------------------------------------\n" );
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Internal implementations
+
+// a single registry shared by every translation unit that includes this header
+inline CSCI441_INTERNAL::ResourceRegistryState& CSCI441_INTERNAL::resourceRegistry() {
+    static ResourceRegistryState registry;
+    return registry;
+}
+
+inline void CSCI441_INTERNAL::addResource( std::map< GLuint, RegisteredResource > &resources, const RegisteredResource &resource ) {
+    removeResource( resources, resource.handle );
+
+    resources[ resource.handle ] = resource;
+    resourceRegistry().categoryBytes[ resource.category ] += resource.byteSize;
+    resourceRegistry().categoryCounts[ resource.category ]++;
+}
+
+inline void CSCI441_INTERNAL::removeResource( std::map< GLuint, RegisteredResource > &resources, GLuint handle ) {
+    std::map< GLuint, RegisteredResource >::iterator iter = resources.find( handle );
+    if( iter == resources.end() ) return;
+
+    resourceRegistry().categoryBytes[ iter->second.category ] -= iter->second.byteSize;
+    resourceRegistry().categoryCounts[ iter->second.category ]--;
+    resources.erase( iter );
+}
+
+inline GLuint CSCI441_INTERNAL::bytesPerTexel( GLenum format ) {
+    switch( format ) {
+        case GL_RED:
+        case GL_R8:                 return 1;
+        case GL_RG:
+        case GL_RG8:
+        case GL_R16F:               return 2;
+        case GL_RGB:
+        case GL_RGB8:               return 3;
+        case GL_RGB16F:             return 6;
+        case GL_RGB32F:             return 12;
+        case GL_RGBA16F:
+        case GL_RG32F:              return 8;
+        case GL_RGBA32F:            return 16;
+        case GL_DEPTH_COMPONENT:
+        case GL_DEPTH_COMPONENT24:
+        case GL_DEPTH_COMPONENT32F:
+        case GL_DEPTH24_STENCIL8:
+        case GL_R32F:
+        case GL_RGBA:
+        case GL_RGBA8:
+        default:                    return 4;
+    }
+}
+
+inline const char* CSCI441_INTERNAL::resourceCategoryName( CSCI441::ResourceRegistry::ResourceCategory category ) {
+    switch( category ) {
+        case CSCI441::ResourceRegistry::TEXTURE_RESOURCE:          return "Texture";
+        case CSCI441::ResourceRegistry::VERTEX_BUFFER_RESOURCE:    return "Vertex Buffer";
+        case CSCI441::ResourceRegistry::INDEX_BUFFER_RESOURCE:     return "Index Buffer";
+        case CSCI441::ResourceRegistry::PIXEL_BUFFER_RESOURCE:     return "Pixel Buffer";
+        default:                                                   return "Other Buffer";
+    }
+}
+
+inline bool CSCI441_INTERNAL::largerResource( const RegisteredResource *a, const RegisteredResource *b ) {
+    return a->byteSize > b->byteSize;
+}
+
+inline bool CSCI441_INTERNAL::olderResource( const RegisteredResource &a, const RegisteredResource &b ) {
+    return a.lastUsedFrame < b.lastUsedFrame;
+}
+
+#endif // __CSCI441_RESOURCEREGISTRY_HPP__
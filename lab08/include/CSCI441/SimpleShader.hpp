@@ -103,8 +103,16 @@ namespace CSCI441 {
          */
         void setProjectionMatrix(const glm::mat4& PROJECTION_MATRIX);
 
+        /** @brief Multiplies the current model matrix by a transformation
+         *
+         * @desc The model matrix is sent to the shader the next time draw() is called.
+         *
+         * @param TRANSFORMATION_MATRIX
+         */
         void pushTransformation(const glm::mat4& TRANSFORMATION_MATRIX);
-
+        /** @brief Returns to the model matrix before the last pushTransformation()
+         *
+         */
         void popTransformation();
 
         void draw(const GLint PRIMITIVE_TYPE, const GLuint VAOD, const GLuint VERTEX_COUNT);
@@ -186,7 +194,17 @@ namespace CSCI441 {
         void setLightColor(const glm::vec3& LIGHT_COLOR);
         void setMaterialColor(const glm::vec3& MATERIAL_COLOR);
 
+        /** @brief Multiplies the current model matrix by a transformation
+         *
+         * @desc The model and normal matrices are sent to the shader the next time draw() or
+         * one of the CSCI441 object drawing functions is called.
+         *
+         * @param TRANSFORMATION_MATRIX
+         */
         void pushTransformation(const glm::mat4& TRANSFORMATION_MATRIX);
+        /** @brief Returns to the model matrix before the last pushTransformation()
+         *
+         */
         void popTransformation();
 
         /** @brief turns on lighting and applies Phong Illumination to fragment
@@ -200,6 +218,20 @@ namespace CSCI441 {
          */
         void disableLighting();
 
+        /** @brief takes the model matrix, normal matrix and color of each object from the
+         * per instance attributes, as fed by the CSCI441 draw*Instanced() functions
+         *
+         * @desc Each instance is placed by its own model matrix under the current transformation.
+         *
+         * @warning must call after to setupSimpleShader
+         */
+        void enableInstancing();
+        /** @brief returns to the model matrix and material color uniforms
+         *
+         * @warning must call after to setupSimpleShader
+         */
+        void disableInstancing();
+
         void draw(const GLint PRIMITIVE_TYPE, const GLuint VAOD, const GLuint VERTEX_COUNT);
     }
 }
@@ -218,6 +250,7 @@ namespace CSCI441_INTERNAL {
         void setProjectionMatrix(const glm::mat4& PROJECTION_MATRIX);
         void pushTransformation(const glm::mat4& TRANSFORMATION_MATRIX);
         void popTransformation();
+        void uploadModelMatrix();
         void draw(const GLint PRIMITIVE_TYPE, const GLuint VAOD, const GLuint VERTEX_COUNT);
 
         static GLboolean smoothShading = true;
@@ -228,8 +261,9 @@ namespace CSCI441_INTERNAL {
         static GLint vertexLocation = -1;
         static GLint colorLocation = -1;
 
-        static std::vector<glm::mat4> transformationStack;
-        static glm::mat4 modelMatrix(1.0);
+        // the whole model matrix at each depth, so a pop never has to undo a transformation
+        static std::vector<glm::mat4> transformationStack(1, glm::mat4(1.0));
+        static GLboolean modelMatrixDirty = true;
     }
 
     namespace SimpleShader3 {
@@ -245,9 +279,12 @@ namespace CSCI441_INTERNAL {
         void setMaterialColor(const glm::vec3& MATERIAL_COLOR);
         void pushTransformation(const glm::mat4& TRANSFORMATION_MATRIX);
         void popTransformation();
+        void uploadModelMatrix();
         void setNormalMatrix();
         void enableLighting();
         void disableLighting();
+        void enableInstancing();
+        void disableInstancing();
         void draw(const GLint PRIMITIVE_TYPE, const GLuint VAOD, const GLuint VERTEX_COUNT);
 
         static GLboolean smoothShading = true;
@@ -262,9 +299,14 @@ namespace CSCI441_INTERNAL {
         static GLint vertexLocation = -1;
         static GLint normalLocation = -1;
         static GLint useLightingLocation = -1;
-
-        static std::vector<glm::mat4> transformationStack;
-        static glm::mat4 modelMatrix(1.0);
+        static GLint useInstancingLocation = -1;
+        static GLint instanceModelLocation = -1;
+        static GLint instanceColorLocation = -1;
+        static GLint instanceNormalMtxLocation = -1;
+
+        // the whole model matrix at each depth, so a pop never has to undo a transformation
+        static std::vector<glm::mat4> transformationStack(1, glm::mat4(1.0));
+        static GLboolean modelMatrixDirty = true;
         static glm::mat4 viewMatrix(1.0);
     }
 }
@@ -381,6 +423,14 @@ inline void CSCI441::SimpleShader3::disableLighting() {
     CSCI441_INTERNAL::SimpleShader3::disableLighting();
 }
 
+inline void CSCI441::SimpleShader3::enableInstancing() {
+    CSCI441_INTERNAL::SimpleShader3::enableInstancing();
+}
+
+inline void CSCI441::SimpleShader3::disableInstancing() {
+    CSCI441_INTERNAL::SimpleShader3::disableInstancing();
+}
+
 inline void CSCI441::SimpleShader3::draw(const GLint PRIMITIVE_TYPE, const GLuint VAOD, const GLuint VERTEX_COUNT) {
     CSCI441_INTERNAL::SimpleShader3::draw(PRIMITIVE_TYPE, VAOD, VERTEX_COUNT);
 }
@@ -466,6 +516,7 @@ inline void CSCI441_INTERNAL::SimpleShader2::setupSimpleShader() {
     glUniformMatrix4fv(modelLocation, 1, GL_FALSE, &identity[0][0]);
     glUniformMatrix4fv(viewLocation, 1, GL_FALSE, &identity[0][0]);
     glUniformMatrix4fv(projectionLocation, 1, GL_FALSE, &identity[0][0]);
+    modelMatrixDirty = true;
 }
 
 inline GLuint CSCI441_INTERNAL::SimpleShader2::registerVertexArray(const GLuint NUM_POINTS, const glm::vec2 VERTEX_POINTS[], const glm::vec3 VERTEX_COLORS[0]) {
@@ -502,27 +553,29 @@ inline void CSCI441_INTERNAL::SimpleShader2::setProjectionMatrix(const glm::mat4
 }
 
 inline void CSCI441_INTERNAL::SimpleShader2::pushTransformation(const glm::mat4& TRANSFORMATION_MATRIX) {
-    glUseProgram(shaderProgramHandle);
-    transformationStack.emplace_back(TRANSFORMATION_MATRIX);
-
-    modelMatrix *= TRANSFORMATION_MATRIX;
-    glUniformMatrix4fv(modelLocation, 1, GL_FALSE, &modelMatrix[0][0]);
+    transformationStack.emplace_back(transformationStack.back() * TRANSFORMATION_MATRIX);
+    modelMatrixDirty = true;
 }
 
 inline void CSCI441_INTERNAL::SimpleShader2::popTransformation() {
-    // ensure there is a transformation stack to pop off
-    if( !transformationStack.empty() ) {
-        glUseProgram(shaderProgramHandle);
-        glm::mat4 lastTransformation = transformationStack.back();
+    // ensure there is a transformation stack to pop off, the bottom is the identity
+    if( transformationStack.size() > 1 ) {
         transformationStack.pop_back();
+        modelMatrixDirty = true;
+    }
+}
 
-        modelMatrix *= glm::inverse( lastTransformation );
-        glUniformMatrix4fv( modelLocation, 1, GL_FALSE, &modelMatrix[0][0] );
+// expects the program to be in use, as draw() makes it
+inline void CSCI441_INTERNAL::SimpleShader2::uploadModelMatrix() {
+    if( modelMatrixDirty ) {
+        glUniformMatrix4fv(modelLocation, 1, GL_FALSE, &transformationStack.back()[0][0]);
+        modelMatrixDirty = false;
     }
 }
 
 inline void CSCI441_INTERNAL::SimpleShader2::draw(const GLint PRIMITIVE_TYPE, const GLuint VAOD, const GLuint VERTEX_COUNT) {
     glUseProgram(shaderProgramHandle);
+    uploadModelMatrix();
     glBindVertexArray(VAOD);
     glDrawArrays(PRIMITIVE_TYPE, 0, VERTEX_COUNT);
 }
@@ -546,24 +599,37 @@ inline void CSCI441_INTERNAL::SimpleShader3::setupSimpleShader() {
                                     uniform vec3 lightColor;\n \
                                     uniform vec3 lightPosition;\n \
                                     uniform vec3 materialColor;\n \
+                                    uniform int useInstancing;\n \
                                     \n \
                                     layout(location=0) in vec3 vPos;\n \
                                     layout(location=2) in vec3 vNormal;\n \
+                                    layout(location=3) in mat4 instanceModel;\n \
+                                    layout(location=7) in vec3 instanceColor;\n \
+                                    layout(location=8) in mat3 instanceNormalMtx;\n \
                                     \n \
                                     layout(location=0) ";
     vertex_shader_src += (smoothShading ? "" : "flat ");
     vertex_shader_src += "out vec4 fragColor;\n \
+                                    layout(location=1) flat out vec3 objectColor;\n \
                                     \n \
                                     void main() {\n \
-                                        gl_Position = projection * view * model * vec4(vPos, 1.0);\n \
+                                        mat4 modelMtx = model;\n \
+                                        mat3 normalMatrix = normalMtx;\n \
+                                        objectColor = materialColor;\n \
+                                        if(useInstancing == 1) {\n \
+                                            modelMtx = model * instanceModel;\n \
+                                            normalMatrix = normalMtx * instanceNormalMtx;\n \
+                                            objectColor = instanceColor;\n \
+                                        }\n \
+                                        gl_Position = projection * view * modelMtx * vec4(vPos, 1.0);\n \
                                         \n \
-                                        vec3 vertexEye = (view * model * vec4(vPos, 1.0)).xyz;\n \
+                                        vec3 vertexEye = (view * modelMtx * vec4(vPos, 1.0)).xyz;\n \
                                         vec3 lightEye = (view * vec4(lightPosition, 1.0)).xyz;\n \
                                         vec3 lightVec = normalize( lightEye - vertexEye );\n \
-                                        vec3 normalVec = normalize( normalMtx * vNormal );\n \
+                                        vec3 normalVec = normalize( normalMatrix * vNormal );\n \
                                         float sDotN = max(dot(lightVec, normalVec), 0.0);\n \
-                                        vec3 diffColor = lightColor * materialColor * sDotN;\n \
-                                        vec3 ambColor = materialColor * 0.3;\
+                                        vec3 diffColor = lightColor * objectColor * sDotN;\n \
+                                        vec3 ambColor = objectColor * 0.3;\
                                         vec3 color = diffColor + ambColor;\n \
                                         fragColor = vec4(color, 1.0);\n \
                                     }";
@@ -571,12 +637,12 @@ inline void CSCI441_INTERNAL::SimpleShader3::setupSimpleShader() {
 
     std::string fragment_shader_src = "#version 410 core\n \
                                       \n \
-                                      uniform vec3 materialColor;\n \
                                       uniform int useLighting;\n \
                                       \n \
                                       layout(location=0) ";
     fragment_shader_src += (smoothShading ? "" : "flat ");
     fragment_shader_src += " in vec4 fragColor;\n \
+                                      layout(location=1) flat in vec3 objectColor;\n \
                                       \n \
                                       layout(location=0) out vec4 fragColorOut;\n \
                                       \n \
@@ -584,7 +650,7 @@ inline void CSCI441_INTERNAL::SimpleShader3::setupSimpleShader() {
                                           if(useLighting == 1) {\n \
                                               fragColorOut = fragColor;\n \
                                           } else {\n \
-                                              fragColorOut = vec4(materialColor, 1.0f);\n \
+                                              fragColorOut = vec4(objectColor, 1.0f);\n \
                                           }\n \
                                       }";
     const char* fragmentShaders[1] = { fragment_shader_src.c_str() };
@@ -621,9 +687,13 @@ inline void CSCI441_INTERNAL::SimpleShader3::setupSimpleShader() {
     lightColorLocation  = glGetUniformLocation(shaderProgramHandle, "lightColor");
     materialLocation    = glGetUniformLocation(shaderProgramHandle, "materialColor");
     useLightingLocation = glGetUniformLocation(shaderProgramHandle, "useLighting");
+    useInstancingLocation=glGetUniformLocation(shaderProgramHandle, "useInstancing");
 
     vertexLocation      = glGetAttribLocation(shaderProgramHandle, "vPos");
     normalLocation      = glGetAttribLocation(shaderProgramHandle, "vNormal");
+    instanceModelLocation=glGetAttribLocation(shaderProgramHandle, "instanceModel");
+    instanceColorLocation=glGetAttribLocation(shaderProgramHandle, "instanceColor");
+    instanceNormalMtxLocation=glGetAttribLocation(shaderProgramHandle, "instanceNormalMtx");
 
     glUseProgram(shaderProgramHandle);
 
@@ -640,8 +710,12 @@ inline void CSCI441_INTERNAL::SimpleShader3::setupSimpleShader() {
     glUniform3fv(lightPositionLocation, 1, &origin[0]);
 
     glUniform1i(useLightingLocation, 1);
+    glUniform1i(useInstancingLocation, 0);
+    modelMatrixDirty = true;
 
     CSCI441::setVertexAttributeLocations(vertexLocation, normalLocation);
+    CSCI441::setInstanceAttributeLocations(instanceModelLocation, instanceColorLocation, instanceNormalMtxLocation);
+    CSCI441_INTERNAL::DrawCallbacks::_beforeDraw = uploadModelMatrix;
 }
 
 inline GLuint CSCI441_INTERNAL::SimpleShader3::registerVertexArray(const GLuint NUM_POINTS, const glm::vec3 VERTEX_POINTS[], const glm::vec3 VERTEX_NORMALS[]) {
@@ -681,8 +755,9 @@ inline void CSCI441_INTERNAL::SimpleShader3::setViewMatrix(const glm::mat4& VIEW
     glUseProgram(shaderProgramHandle);
     glUniformMatrix4fv(viewLocation, 1, GL_FALSE, &VIEW_MATRIX[0][0]);
 
+    // the normal matrix follows the view, it is sent along with the model matrix
     viewMatrix = VIEW_MATRIX;
-    setNormalMatrix();
+    modelMatrixDirty = true;
 }
 
 inline void CSCI441_INTERNAL::SimpleShader3::setLightPosition(const glm::vec3& LIGHT_POSITION) {
@@ -701,32 +776,31 @@ inline void CSCI441_INTERNAL::SimpleShader3::setMaterialColor(const glm::vec3& M
 }
 
 inline void CSCI441_INTERNAL::SimpleShader3::pushTransformation(const glm::mat4& TRANSFORMATION_MATRIX) {
-    glUseProgram(shaderProgramHandle);
-    transformationStack.emplace_back(TRANSFORMATION_MATRIX);
-
-    modelMatrix *= TRANSFORMATION_MATRIX;
-    glUniformMatrix4fv(modelLocation, 1, GL_FALSE, &modelMatrix[0][0]);
-
-    setNormalMatrix();
+    transformationStack.emplace_back(transformationStack.back() * TRANSFORMATION_MATRIX);
+    modelMatrixDirty = true;
 }
 
 inline void CSCI441_INTERNAL::SimpleShader3::popTransformation() {
-    // ensure there is a transformation stack to pop off
-    if( !transformationStack.empty() ) {
-        glUseProgram(shaderProgramHandle);
-        glm::mat4 lastTransformation = transformationStack.back();
+    // ensure there is a transformation stack to pop off, the bottom is the identity
+    if( transformationStack.size() > 1 ) {
         transformationStack.pop_back();
+        modelMatrixDirty = true;
+    }
+}
 
-        modelMatrix *= glm::inverse( lastTransformation );
-        glUniformMatrix4fv( modelLocation, 1, GL_FALSE, &modelMatrix[0][0] );
+// also called by the CSCI441 objects before they draw, when another program may be in use
+inline void CSCI441_INTERNAL::SimpleShader3::uploadModelMatrix() {
+    if( modelMatrixDirty ) {
+        glProgramUniformMatrix4fv(shaderProgramHandle, modelLocation, 1, GL_FALSE, &transformationStack.back()[0][0]);
+        setNormalMatrix();
+        modelMatrixDirty = false;
     }
 }
 
 inline void CSCI441_INTERNAL::SimpleShader3::setNormalMatrix() {
-    glUseProgram(shaderProgramHandle);
-    glm::mat4 modelView = viewMatrix * modelMatrix;
+    glm::mat4 modelView = viewMatrix * transformationStack.back();
     glm::mat3 normalMatrix = glm::mat3( glm::transpose( glm::inverse( modelView ) ) );
-    glUniformMatrix3fv(normalMtxLocation, 1, GL_FALSE, &normalMatrix[0][0]);
+    glProgramUniformMatrix3fv(shaderProgramHandle, normalMtxLocation, 1, GL_FALSE, &normalMatrix[0][0]);
 }
 
 inline void CSCI441_INTERNAL::SimpleShader3::enableLighting() {
@@ -739,8 +813,19 @@ inline void CSCI441_INTERNAL::SimpleShader3::disableLighting() {
     glUniform1i(useLightingLocation, 0);
 }
 
+inline void CSCI441_INTERNAL::SimpleShader3::enableInstancing() {
+    glUseProgram(shaderProgramHandle);
+    glUniform1i(useInstancingLocation, 1);
+}
+
+inline void CSCI441_INTERNAL::SimpleShader3::disableInstancing() {
+    glUseProgram(shaderProgramHandle);
+    glUniform1i(useInstancingLocation, 0);
+}
+
 inline void CSCI441_INTERNAL::SimpleShader3::draw(const GLint PRIMITIVE_TYPE, const GLuint VAOD, const GLuint VERTEX_COUNT) {
     glUseProgram(shaderProgramHandle);
+    uploadModelMatrix();
     glBindVertexArray(VAOD);
     glDrawArrays(PRIMITIVE_TYPE, 0, VERTEX_COUNT);
 }
@@ -0,0 +1,382 @@
+/** @file TextureUploader.hpp
+ * @brief Streams texture data to the GPU through pixel unpack buffers
+ * @date Last Edit: 19 Oct 2026
+ * @version 2.0
+ *
+ *	Texture data is copied into a ring of pixel unpack buffers and handed
+ *	to OpenGL in sub-rectangles spread across frames, so a large image never
+ *	stalls the render thread.  Each staging slot is guarded by a fence and
+ *	is only reused once the GPU has finished reading from it.
+ *
+ *	When GL_ARB_buffer_storage is available the ring is mapped once and stays
+ *	mapped.  Otherwise each slot is mapped unsynchronized after its fence has
+ *	signaled, which is safe because the GPU is no longer reading from it.
+ *
+ *	@warning NOTE: This header file will only work with OpenGL 3.2+
+ *	@warning NOTE: This header file depends upon GLEW
+ */
+
+#ifndef __CSCI441_TEXTUREUPLOADER_HPP__
+#define __CSCI441_TEXTUREUPLOADER_HPP__
+
+#include <GL/glew.h>
+
+#include "ResourceRegistry.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <deque>
+#include <map>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////
+
+/** @namespace CSCI441
+  * @brief CSCI441 Helper Functions for OpenGL
+	*/
+namespace CSCI441 {
+
+    /** @class TextureUploader
+        * @brief Uploads 2D textures asynchronously through a fenced ring of pixel unpack buffers
+        */
+    class TextureUploader {
+    public:
+        /** @brief Creates the staging ring
+            * @param GLsizeiptr slotSize         - size in bytes of each staging slot (default: 4MB)
+            * @param GLuint numSlots             - number of staging slots in the ring (default: 3)
+            * @param GLsizeiptr bytesPerFrame    - most bytes handed to OpenGL per call to update() (default: one slot)
+            * @pre an OpenGL context must be current
+            */
+        TextureUploader( GLsizeiptr slotSize = 4*1024*1024, GLuint numSlots = 3, GLsizeiptr bytesPerFrame = 0 );
+        /** @brief Waits for outstanding copies and frees the staging ring
+            */
+        ~TextureUploader();
+
+        /** @brief Allocates storage for a texture and queues its pixel data to be uploaded
+          *
+            * The texture must already be generated and have its parameters set.  Its storage
+            * is allocated immediately; its contents arrive over the following calls to update().
+            * The pixel data must stay valid until the upload completes.  If freeData is not null
+            * it is called on the pixel data once the last sub-rectangle has been copied.
+            *
+            * @param GLuint texHandle              - handle of the 2D texture to fill
+            * @param unsigned char* data           - tightly packed pixel data, one byte per channel
+            * @param GLint width                   - width of the image
+            * @param GLint height                  - height of the image
+            * @param GLint channels                - number of channels in the image, one through four
+            * @param bool generateMipmaps          - generate mipmaps once the base level is complete (default: true)
+            * @param void (*freeData)(void*)       - called on data when it is no longer needed (default: nullptr)
+            */
+        void upload2DTexture( GLuint texHandle, unsigned char *data, GLint width, GLint height, GLint channels,
+                              bool generateMipmaps = true, void (*freeData)(void*) = nullptr );
+
+        /** @brief Drops any portion of a texture that has not been copied yet
+          *
+            * Use before deleting a texture that may still be queued
+            * @param GLuint texHandle - handle of the texture to cancel
+            */
+        void cancel( GLuint texHandle );
+
+        /** @brief Copies the next sub-rectangles into free staging slots and hands them to OpenGL
+          *
+            * Call once per frame.  Never waits on the GPU - a slot that is still being read
+            * is skipped until a later frame.
+            */
+        void update();
+
+        /** @brief Blocks until every queued texture has been handed to OpenGL
+            */
+        void flush();
+
+        /** @brief Returns whether the GPU has finished copying a texture
+            * @param GLuint texHandle - handle of the texture to check
+            * @return true if the texture is not queued and its last copy has completed
+            */
+        bool isUploadComplete( GLuint texHandle );
+
+        /** @brief Returns the number of textures still waiting to be copied
+            * @return GLuint - number of queued textures
+            */
+        GLuint getNumPendingUploads() const;
+
+        /** @brief Returns the number of bytes copied into the staging ring by the last call to update()
+            * @return GLsizeiptr - bytes staged last frame
+            */
+        GLsizeiptr getBytesUploadedLastFrame() const;
+
+    private:
+        struct PendingUpload {
+            GLuint texHandle;
+            unsigned char *data;
+            GLint width, height, channels;
+            GLint nextX, nextY;                         // corner of the next sub-rectangle to copy
+            GLint tileWidth, tileHeight;                // size of each sub-rectangle
+            bool generateMipmaps;
+            void (*freeData)(void*);
+        };
+        struct StagingSlot {
+            GLsync fence;
+            GLuint texHandle;                           // texture the last copy out of this slot went to
+        };
+
+        bool _stageNextRect( PendingUpload &upload, GLuint slot );
+        bool _slotIsFree( GLuint slot );
+        void _finishUpload( PendingUpload &upload );
+        GLenum _format( GLint channels ) const;
+
+        GLuint _pbo;
+        GLsizeiptr _slotSize;
+        GLuint _numSlots;
+        GLuint _nextSlot;
+        GLsizeiptr _bytesPerFrame;
+        GLsizeiptr _bytesLastFrame;
+        bool _persistent;
+        unsigned char *_persistentPtr;
+
+        std::vector< StagingSlot > _slots;
+        std::deque< PendingUpload > _pending;
+        std::map< GLuint, GLsync > _lastFence;          // fence of the final copy for each finished texture
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Outward facing function implementations
+
+inline CSCI441::TextureUploader::TextureUploader( GLsizeiptr slotSize, GLuint numSlots, GLsizeiptr bytesPerFrame ) {
+    _slotSize = slotSize;
+    _numSlots = numSlots;
+    _nextSlot = 0;
+    _bytesPerFrame = bytesPerFrame > 0 ? bytesPerFrame : slotSize;
+    _bytesLastFrame = 0;
+    _persistentPtr = nullptr;
+    _persistent = GLEW_ARB_buffer_storage;
+
+    StagingSlot emptySlot = { nullptr, 0 };
+    _slots.assign( _numSlots, emptySlot );
+
+    glGenBuffers( 1, &_pbo );
+    glBindBuffer( GL_PIXEL_UNPACK_BUFFER, _pbo );
+    if( _persistent ) {
+        const GLbitfield FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage( GL_PIXEL_UNPACK_BUFFER, _slotSize * _numSlots, nullptr, FLAGS );
+        _persistentPtr = (unsigned char*)glMapBufferRange( GL_PIXEL_UNPACK_BUFFER, 0, _slotSize * _numSlots, FLAGS );
+        if( _persistentPtr == nullptr ) {
+            fprintf( stderr, "[ERROR]: TextureUploader could not persistently map its staging ring\n" );
+        }
+    } else {
+        glBufferData( GL_PIXEL_UNPACK_BUFFER, _slotSize * _numSlots, nullptr, GL_STREAM_DRAW );
+    }
+    glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+    CSCI441::ResourceRegistry::registerBuffer( _pbo, GL_PIXEL_UNPACK_BUFFER, _slotSize * _numSlots, "CSCI441::TextureUploader", "staging ring" );
+}
+
+inline CSCI441::TextureUploader::~TextureUploader() {
+    flush();
+
+    for( GLuint i = 0; i < _numSlots; i++ ) {
+        if( _slots[i].fence ) glDeleteSync( _slots[i].fence );
+    }
+    for( std::map<GLuint, GLsync>::iterator iter = _lastFence.begin(); iter != _lastFence.end(); iter++ ) {
+        glDeleteSync( iter->second );
+    }
+
+    glBindBuffer( GL_PIXEL_UNPACK_BUFFER, _pbo );
+    if( _persistentPtr ) glUnmapBuffer( GL_PIXEL_UNPACK_BUFFER );
+    glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+    glDeleteBuffers( 1, &_pbo );
+    CSCI441::ResourceRegistry::releaseBuffer( _pbo );
+}
+
+inline void CSCI441::TextureUploader::upload2DTexture( GLuint texHandle, unsigned char *data, GLint width, GLint height, GLint channels,
+                                                       bool generateMipmaps, void (*freeData)(void*) ) {
+    const GLenum FORMAT = _format( channels );
+
+    // allocate storage now so the handle is immediately usable
+    glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+    glBindTexture( GL_TEXTURE_2D, texHandle );
+    glTexImage2D( GL_TEXTURE_2D, 0, FORMAT, width, height, 0, FORMAT, GL_UNSIGNED_BYTE, nullptr );
+    CSCI441::ResourceRegistry::registerTexture( texHandle, width, height, FORMAT, "CSCI441::TextureUploader", "", generateMipmaps );
+
+    // pick the largest sub-rectangle that fits in one slot, full rows when possible
+    PendingUpload upload;
+    upload.texHandle = texHandle;
+    upload.data = data;
+    upload.width = width;
+    upload.height = height;
+    upload.channels = channels;
+    upload.nextX = 0;
+    upload.nextY = 0;
+    upload.tileWidth = width;
+    if( (GLsizeiptr)upload.tileWidth * channels > _slotSize ) {
+        upload.tileWidth = (GLint)(_slotSize / channels);
+    }
+    upload.tileHeight = (GLint)(_slotSize / ((GLsizeiptr)upload.tileWidth * channels));
+    if( upload.tileHeight > height ) upload.tileHeight = height;
+    upload.generateMipmaps = generateMipmaps;
+    upload.freeData = freeData;
+
+    _pending.push_back( upload );
+}
+
+inline void CSCI441::TextureUploader::cancel( GLuint texHandle ) {
+    for( std::deque<PendingUpload>::iterator iter = _pending.begin(); iter != _pending.end(); ) {
+        if( iter->texHandle == texHandle ) {
+            if( iter->freeData ) iter->freeData( iter->data );
+            iter = _pending.erase( iter );
+        } else {
+            ++iter;
+        }
+    }
+
+    std::map<GLuint, GLsync>::iterator fence = _lastFence.find( texHandle );
+    if( fence != _lastFence.end() ) {
+        glDeleteSync( fence->second );
+        _lastFence.erase( fence );
+    }
+}
+
+inline void CSCI441::TextureUploader::update() {
+    _bytesLastFrame = 0;
+
+    while( !_pending.empty() && _bytesLastFrame < _bytesPerFrame ) {
+        if( !_slotIsFree( _nextSlot ) )
+            break;
+
+        PendingUpload &upload = _pending.front();
+        bool done = _stageNextRect( upload, _nextSlot );
+        _nextSlot = (_nextSlot + 1) % _numSlots;
+
+        if( done ) {
+            _finishUpload( upload );
+            _pending.pop_front();
+        }
+    }
+}
+
+inline void CSCI441::TextureUploader::flush() {
+    while( !_pending.empty() ) {
+        // wait for the slot we need next, then keep staging
+        StagingSlot &slot = _slots[_nextSlot];
+        if( slot.fence ) {
+            glClientWaitSync( slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED );
+        }
+        GLsizeiptr budget = _bytesPerFrame;
+        _bytesPerFrame = _slotSize * _numSlots;
+        update();
+        _bytesPerFrame = budget;
+    }
+}
+
+inline bool CSCI441::TextureUploader::isUploadComplete( GLuint texHandle ) {
+    for( std::deque<PendingUpload>::iterator iter = _pending.begin(); iter != _pending.end(); ++iter ) {
+        if( iter->texHandle == texHandle ) return false;
+    }
+
+    std::map<GLuint, GLsync>::iterator fence = _lastFence.find( texHandle );
+    if( fence == _lastFence.end() ) return true;
+
+    if( glClientWaitSync( fence->second, 0, 0 ) == GL_TIMEOUT_EXPIRED ) return false;
+
+    glDeleteSync( fence->second );
+    _lastFence.erase( fence );
+    return true;
+}
+
+inline GLuint CSCI441::TextureUploader::getNumPendingUploads() const {
+    return (GLuint)_pending.size();
+}
+
+inline GLsizeiptr CSCI441::TextureUploader::getBytesUploadedLastFrame() const {
+    return _bytesLastFrame;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Internal implementations
+
+inline bool CSCI441::TextureUploader::_slotIsFree( GLuint slot ) {
+    if( _slots[slot].fence == nullptr ) return true;
+
+    GLenum status = glClientWaitSync( _slots[slot].fence, 0, 0 );
+    if( status == GL_TIMEOUT_EXPIRED || status == GL_WAIT_FAILED ) return false;
+
+    glDeleteSync( _slots[slot].fence );
+    _slots[slot].fence = nullptr;
+    return true;
+}
+
+inline bool CSCI441::TextureUploader::_stageNextRect( PendingUpload &upload, GLuint slot ) {
+    GLint rectWidth  = upload.tileWidth;
+    GLint rectHeight = upload.tileHeight;
+    if( upload.nextX + rectWidth  > upload.width  ) rectWidth  = upload.width  - upload.nextX;
+    if( upload.nextY + rectHeight > upload.height ) rectHeight = upload.height - upload.nextY;
+
+    const GLsizeiptr ROW_BYTES = (GLsizeiptr)rectWidth * upload.channels;
+    const GLsizeiptr IMAGE_ROW_BYTES = (GLsizeiptr)upload.width * upload.channels;
+    const GLintptr OFFSET = (GLintptr)slot * _slotSize;
+
+    glBindBuffer( GL_PIXEL_UNPACK_BUFFER, _pbo );
+
+    unsigned char *dest;
+    if( _persistent ) {
+        dest = _persistentPtr + OFFSET;
+    } else {
+        // the fence has signaled, so nothing is reading this range anymore
+        dest = (unsigned char*)glMapBufferRange( GL_PIXEL_UNPACK_BUFFER, OFFSET, ROW_BYTES * rectHeight,
+                                                 GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT );
+    }
+
+    // pack the sub-rectangle tightly into the slot
+    const unsigned char *src = upload.data + upload.nextY * IMAGE_ROW_BYTES + (GLsizeiptr)upload.nextX * upload.channels;
+    for( GLint row = 0; row < rectHeight; row++ ) {
+        memcpy( dest + row * ROW_BYTES, src + row * IMAGE_ROW_BYTES, ROW_BYTES );
+    }
+
+    if( !_persistent ) glUnmapBuffer( GL_PIXEL_UNPACK_BUFFER );
+
+    glBindTexture( GL_TEXTURE_2D, upload.texHandle );
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+    glTexSubImage2D( GL_TEXTURE_2D, 0, upload.nextX, upload.nextY, rectWidth, rectHeight,
+                     _format( upload.channels ), GL_UNSIGNED_BYTE, (void*)OFFSET );
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+    glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+
+    _slots[slot].fence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+    _slots[slot].texHandle = upload.texHandle;
+    _bytesLastFrame += ROW_BYTES * rectHeight;
+
+    // advance across, then down
+    upload.nextX += rectWidth;
+    if( upload.nextX >= upload.width ) {
+        upload.nextX = 0;
+        upload.nextY += rectHeight;
+    }
+    return upload.nextY >= upload.height;
+}
+
+inline void CSCI441::TextureUploader::_finishUpload( PendingUpload &upload ) {
+    if( upload.generateMipmaps ) {
+        glBindTexture( GL_TEXTURE_2D, upload.texHandle );
+        glGenerateMipmap( GL_TEXTURE_2D );
+    }
+
+    // the texture is complete once everything issued so far has finished
+    std::map<GLuint, GLsync>::iterator fence = _lastFence.find( upload.texHandle );
+    if( fence != _lastFence.end() ) glDeleteSync( fence->second );
+    _lastFence[ upload.texHandle ] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+
+    if( upload.freeData ) upload.freeData( upload.data );
+}
+
+inline GLenum CSCI441::TextureUploader::_format( GLint channels ) const {
+    switch( channels ) {
+        case 1:  return GL_RED;
+        case 2:  return GL_RG;
+        case 3:  return GL_RGB;
+        default: return GL_RGBA;
+    }
+}
+
+#endif // __CSCI441_TEXTUREUPLOADER_HPP__
@@ -17,9 +17,13 @@
 
 #include <stb_image.h>
 
+#include "ResourceRegistry.hpp"
+#include "TextureUploader.hpp"
+
 #include <stdio.h>
 
 #include <string>
+#include <thread>
 using namespace std;
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -134,6 +138,85 @@ namespace CSCI441 {
 															  			GLenum magFilter = GL_LINEAR,
 																  		GLenum wrapS = GL_REPEAT,
 																	  	GLenum wrapT = GL_REPEAT );
+
+		/**	@brief loads a texture into memory and queues it to be uploaded through a TextureUploader
+			*
+			*  Behaves like loadAndRegister2DTexture() except the pixel data is handed to the
+			* uploader instead of being copied synchronously.  The returned handle is valid
+			* immediately but its contents arrive over the following calls to uploader.update().
+			* The decoded image is freed once it has been copied.
+			*
+			* @param TextureUploader &uploader - uploader that streams the pixel data
+			*	@param const char* filename - name of texture to load
+			* @param GLenum minFilter     - minification filter to apply (default: GL_LINEAR)
+			* @param GLenum magFilter     - magnification filter to apply (default: GL_LINEAR)
+			* @param GLenum wrapS         - wrapping to apply to S coordinate (default: GL_REPEAT)
+			* @param GLenum wrapT         - wrapping to apply to T coordinate (default: GL_REPEAT)
+			* @return GLuint 						  - texture handle corresponding to the texture
+			*/
+		GLuint loadAndRegister2DTextureAsync( TextureUploader &uploader,
+																				const char *filename,
+																				GLenum minFilter = GL_LINEAR,
+																				GLenum magFilter = GL_LINEAR,
+																				GLenum wrapS = GL_REPEAT,
+																				GLenum wrapT = GL_REPEAT );
+
+		/**	@brief sets whether stb_image flips images vertically as it decodes them
+			*
+			*  stb_image has no way to read this setting back, so the value last set here is
+			* remembered and returned to let a loader restore the setting it replaced.
+			*
+			* @param bool flip - true to decode images bottom row first, as glTexImage2D() expects
+			* @return bool - the setting before this call
+			*/
+		bool setFlipVerticallyOnLoad( bool flip );
+
+		/** @struct CubemapFaces
+			* @brief Decoded pixel data for the six faces of a cube map
+			*
+			* Faces are stored in OpenGL order: +X, -X, +Y, -Y, +Z, -Z
+			*/
+		struct CubemapFaces {
+			int width;                  ///< width of every face
+			int height;                 ///< height of every face
+			int channels;               ///< number of channels in every face
+			unsigned char* data[6];     ///< pixel data for each face, NULL if it could not be decoded
+		};
+
+		/**	@brief decodes the six faces of a cube map into memory
+			*
+			*  Each face is decoded on its own thread.  Does not touch OpenGL, so it may be
+			* called without a context.  Fails if any face cannot be read or if the faces
+			* are not all square and of the same size and channel count.  On failure no
+			* memory is left allocated.  Faces are decoded top row first, as cube maps
+			* address them, and the stb_image flip setting is restored before returning.
+			*
+			* @param[in] const char* faces[6]     - filenames in OpenGL order: +X, -X, +Y, -Y, +Z, -Z
+			* @param[out] CubemapFaces &cubemap   - will contain the decoded faces upon successful completion
+			* @return bool - true if every face decoded and the faces match, false otherwise
+			*/
+		bool loadCubemapFaces( const char* faces[6], CubemapFaces &cubemap );
+
+		/**	@brief frees the pixel data decoded by loadCubemapFaces()
+			* @param CubemapFaces &cubemap - faces to free
+			*/
+		void freeCubemapFaces( CubemapFaces &cubemap );
+
+		/**	@brief registers decoded faces as a GL_TEXTURE_CUBE_MAP
+			*
+			*  Faces are clamped to their edges and filtered linearly.
+			*
+			* @param const CubemapFaces &cubemap - faces from loadCubemapFaces()
+			* @return GLuint - texture handle corresponding to the cube map
+			*/
+		GLuint registerCubemap( const CubemapFaces &cubemap );
+
+		/**	@brief loads six images and registers them as a cube map returning a texture handle
+			*
+			* @param const char* faces[6] - filenames in OpenGL order: +X, -X, +Y, -Y, +Z, -Z
+			* @return GLuint 					  - texture handle corresponding to the cube map, 0 if loading failed
+			*/
+		GLuint loadCubemap( const char* faces[6] );
 	}
 }
 
@@ -447,7 +530,7 @@ inline GLuint CSCI441::TextureUtils::loadAndRegisterTexture( const char *filenam
 inline GLuint CSCI441::TextureUtils::loadAndRegister2DTexture( const char *filename, GLenum minFilter, GLenum magFilter, GLenum wrapS, GLenum wrapT ) {
     int imageWidth, imageHeight, imageChannels;
     GLuint texHandle = 0;
-    stbi_set_flip_vertically_on_load(true);
+    setFlipVerticallyOnLoad(true);
     unsigned char *data = stbi_load( filename, &imageWidth, &imageHeight, &imageChannels, 0);
 
 	if( !data ) {
@@ -462,10 +545,155 @@ inline GLuint CSCI441::TextureUtils::loadAndRegister2DTexture( const char *filen
         const GLint STORAGE_TYPE = (imageChannels == 4 ? GL_RGBA : GL_RGB);
         glTexImage2D( GL_TEXTURE_2D, 0, STORAGE_TYPE, imageWidth, imageHeight, 0, STORAGE_TYPE, GL_UNSIGNED_BYTE, data);
         glGenerateMipmap(GL_TEXTURE_2D);
+        CSCI441::ResourceRegistry::registerTexture( texHandle, imageWidth, imageHeight, STORAGE_TYPE, "CSCI441::TextureUtils", filename, true );
         printf( "[INFO]: Successfully loaded texture \"%s\" with handle %d\n", filename, texHandle );
     }
 
 	return texHandle;
 }
 
+// loadAndRegister2DTextureAsync() ///////////////////////////////////////////////
+//
+// Load a 2D texture and stream it to OpenGL through a pixel unpack buffer
+//
+////////////////////////////////////////////////////////////////////////////////
+inline GLuint CSCI441::TextureUtils::loadAndRegister2DTextureAsync( TextureUploader &uploader, const char *filename, GLenum minFilter, GLenum magFilter, GLenum wrapS, GLenum wrapT ) {
+    int imageWidth, imageHeight, imageChannels;
+    GLuint texHandle = 0;
+    setFlipVerticallyOnLoad(true);
+    unsigned char *data = stbi_load( filename, &imageWidth, &imageHeight, &imageChannels, 0);
+
+	if( !data ) {
+        printf( "[ERROR]: Could not load texture \"%s\"\n", filename );
+	} else {
+        glGenTextures(1, &texHandle );
+        glBindTexture(   GL_TEXTURE_2D,  texHandle );
+        glTexParameteri( GL_TEXTURE_2D,  GL_TEXTURE_MIN_FILTER, minFilter );
+        glTexParameteri( GL_TEXTURE_2D,  GL_TEXTURE_MAG_FILTER, magFilter );
+        glTexParameteri( GL_TEXTURE_2D,  GL_TEXTURE_WRAP_S,     wrapS );
+        glTexParameteri( GL_TEXTURE_2D,  GL_TEXTURE_WRAP_T,     wrapT );
+        uploader.upload2DTexture( texHandle, data, imageWidth, imageHeight, imageChannels, true, stbi_image_free );
+        CSCI441::ResourceRegistry::registerTexture( texHandle, imageWidth, imageHeight, imageChannels == 4 ? GL_RGBA : GL_RGB, "CSCI441::TextureUtils", filename, true );
+        printf( "[INFO]: Queued texture \"%s\" with handle %d for upload\n", filename, texHandle );
+    }
+
+	return texHandle;
+}
+
+// setFlipVerticallyOnLoad() /////////////////////////////////////////////////////
+//
+// Set stb_image's vertical flip and return the setting it replaces
+//
+////////////////////////////////////////////////////////////////////////////////
+inline bool CSCI441::TextureUtils::setFlipVerticallyOnLoad( bool flip ) {
+    static bool currentFlip = false;            // stb_image starts out not flipping
+    bool previousFlip = currentFlip;
+    currentFlip = flip;
+    stbi_set_flip_vertically_on_load(flip);
+    return previousFlip;
+}
+
+// loadCubemapFaces() ////////////////////////////////////////////////////////////
+//
+// Decode the six faces of a cube map, one thread per face
+//
+////////////////////////////////////////////////////////////////////////////////
+inline bool CSCI441::TextureUtils::loadCubemapFaces( const char* faces[6], CubemapFaces &cubemap ) {
+    int widths[6], heights[6], channels[6];
+
+    // cube map faces are addressed from their top left corner, and stb's flip is global so set it before starting
+    bool previousFlip = setFlipVerticallyOnLoad(false);
+
+    thread decoders[6];
+    for( int i = 0; i < 6; i++ ) {
+        decoders[i] = thread( [&cubemap, &widths, &heights, &channels, faces, i]() {
+            cubemap.data[i] = stbi_load( faces[i], &widths[i], &heights[i], &channels[i], 0 );
+        } );
+    }
+    for( int i = 0; i < 6; i++ ) {
+        decoders[i].join();
+    }
+    setFlipVerticallyOnLoad(previousFlip);
+
+    bool valid = true;
+    for( int i = 0; i < 6; i++ ) {
+        if( !cubemap.data[i] ) {
+            printf( "[ERROR]: Could not load cube map face \"%s\"\n", faces[i] );
+            valid = false;
+        } else if( widths[i] != heights[i] ) {
+            printf( "[ERROR]: Cube map face \"%s\" is %dx%d but faces must be square\n", faces[i], widths[i], heights[i] );
+            valid = false;
+        } else if( cubemap.data[0] && (widths[i] != widths[0] || channels[i] != channels[0]) ) {
+            printf( "[ERROR]: Cube map face \"%s\" does not match the size and channels of \"%s\"\n", faces[i], faces[0] );
+            valid = false;
+        }
+    }
+
+    if( !valid ) {
+        freeCubemapFaces( cubemap );
+        return false;
+    }
+
+    cubemap.width = widths[0];
+    cubemap.height = heights[0];
+    cubemap.channels = channels[0];
+    return true;
+}
+
+// freeCubemapFaces() ////////////////////////////////////////////////////////////
+//
+// Release the decoded faces of a cube map
+//
+////////////////////////////////////////////////////////////////////////////////
+inline void CSCI441::TextureUtils::freeCubemapFaces( CubemapFaces &cubemap ) {
+    for( int i = 0; i < 6; i++ ) {
+        if( cubemap.data[i] ) stbi_image_free( cubemap.data[i] );
+        cubemap.data[i] = NULL;
+    }
+}
+
+// registerCubemap() /////////////////////////////////////////////////////////////
+//
+// Send the decoded faces of a cube map to OpenGL
+//
+////////////////////////////////////////////////////////////////////////////////
+inline GLuint CSCI441::TextureUtils::registerCubemap( const CubemapFaces &cubemap ) {
+    GLuint texHandle = 0;
+    glGenTextures(1, &texHandle );
+    glBindTexture(   GL_TEXTURE_CUBE_MAP,  texHandle );
+    glTexParameteri( GL_TEXTURE_CUBE_MAP,  GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+    glTexParameteri( GL_TEXTURE_CUBE_MAP,  GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+    glTexParameteri( GL_TEXTURE_CUBE_MAP,  GL_TEXTURE_WRAP_S,     GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_CUBE_MAP,  GL_TEXTURE_WRAP_T,     GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_CUBE_MAP,  GL_TEXTURE_WRAP_R,     GL_CLAMP_TO_EDGE );
+
+    const GLint STORAGE_TYPE = (cubemap.channels == 4 ? GL_RGBA : GL_RGB);
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+    for( int i = 0; i < 6; i++ ) {
+        glTexImage2D( GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, STORAGE_TYPE, cubemap.width, cubemap.height, 0, STORAGE_TYPE, GL_UNSIGNED_BYTE, cubemap.data[i] );
+    }
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+    CSCI441::ResourceRegistry::registerTexture( texHandle, cubemap.width, cubemap.height, STORAGE_TYPE, "CSCI441::TextureUtils", "cube map", false, 6 );
+
+    return texHandle;
+}
+
+// loadCubemap() /////////////////////////////////////////////////////////////////
+//
+// Load six images and register them as a cube map with OpenGL
+//
+////////////////////////////////////////////////////////////////////////////////
+inline GLuint CSCI441::TextureUtils::loadCubemap( const char* faces[6] ) {
+    CubemapFaces cubemap;
+    GLuint texHandle = 0;
+
+    if( loadCubemapFaces( faces, cubemap ) ) {
+        texHandle = registerCubemap( cubemap );
+        freeCubemapFaces( cubemap );
+        printf( "[INFO]: Successfully loaded %dx%d cube map with handle %d\n", cubemap.width, cubemap.height, texHandle );
+    }
+
+	return texHandle;
+}
+
 #endif // __CSCI441_TEXTUREUTILS_H__
@@ -37,6 +37,8 @@ using namespace std;
 #include <time.h>
 
 #include <CSCI441/modelMaterial.hpp>
+#include <CSCI441/ResourceRegistry.hpp>
+#include <CSCI441/TextureUploader.hpp>
 
 ////////////////////////////////////////////////////////////////////////////////////
 
@@ -46,6 +48,7 @@ using namespace std;
 namespace CSCI441 {
 
     static bool AUTO_GEN_NORMALS = false;
+    static TextureUploader* TEXTURE_UPLOADER = NULL;
 
     /** @class ModelLoader
         * @brief Loads object models from file and renders using VBOs/VAOs
@@ -103,6 +106,18 @@ namespace CSCI441 {
             */
         static void disableAutoGenerateNormals();
 
+        /** @brief Stream diffuse texture maps through a TextureUploader
+          *
+            * When set, texture maps without an alpha mask are queued with the uploader
+            * instead of being copied synchronously while the material file is parsed.
+            * The uploader's update() must be called each frame for the maps to arrive.
+          *
+            * @param TextureUploader* uploader - uploader to use, or NULL to upload synchronously
+            * @note Must be called prior to loading in a model from file
+            * @note Textures are uploaded synchronously by default
+            */
+        static void setTextureUploader( TextureUploader* uploader );
+
     private:
         void _init();
         bool _loadMTLFile( const char *mtlFilename, bool INFO, bool ERRORS );
@@ -157,6 +172,8 @@ inline CSCI441::ModelLoader::~ModelLoader() {
     if( _indices ) 				free( _indices );
 
     glDeleteBuffers( 2, _vbods );
+    CSCI441::ResourceRegistry::releaseBuffer( _vbods[0] );
+    CSCI441::ResourceRegistry::releaseBuffer( _vbods[1] );
     glDeleteVertexArrays( 1, &_vaod );
 }
 
@@ -208,6 +225,8 @@ inline bool CSCI441::ModelLoader::draw( GLint positionLocation, GLint normalLoca
 
     glBindVertexArray( _vaod );
     glBindBuffer( GL_ARRAY_BUFFER, _vbods[0] );
+    CSCI441::ResourceRegistry::touchBuffer( _vbods[0] );
+    CSCI441::ResourceRegistry::touchBuffer( _vbods[1] );
 
     glEnableVertexAttribArray( positionLocation );
     glVertexAttribPointer( positionLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)0 );
@@ -249,6 +268,7 @@ inline bool CSCI441::ModelLoader::draw( GLint positionLocation, GLint normalLoca
                     if( material->map_Kd != -1 ) {
                         glActiveTexture( diffuseTexture );
                         glBindTexture( GL_TEXTURE_2D, material->map_Kd );
+                        CSCI441::ResourceRegistry::touchTexture( material->map_Kd );
                     }
                 }
 
@@ -694,12 +714,14 @@ inline bool CSCI441::ModelLoader::_loadOBJFile( bool INFO, bool ERRORS ) {
     glBindVertexArray( _vaod );
     glBindBuffer( GL_ARRAY_BUFFER, _vbods[0] );
     glBufferData( GL_ARRAY_BUFFER, sizeof(GLfloat) * _uniqueIndex * 8, NULL, GL_STATIC_DRAW );
+    CSCI441::ResourceRegistry::registerBuffer( _vbods[0], GL_ARRAY_BUFFER, sizeof(GLfloat) * _uniqueIndex * 8, "CSCI441::ModelLoader", _filename );
     glBufferSubData( GL_ARRAY_BUFFER, 0, 																  sizeof(GLfloat) * _uniqueIndex * 3, _vertices );
     glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * _uniqueIndex * 3, sizeof(GLfloat) * _uniqueIndex * 3, _normals );
     glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * _uniqueIndex * 6, sizeof(GLfloat) * _uniqueIndex * 2, _texCoords );
 
     glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, _vbods[1] );
     glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * indicesSeen, _indices, GL_STATIC_DRAW );
+    CSCI441::ResourceRegistry::registerBuffer( _vbods[1], GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * indicesSeen, "CSCI441::ModelLoader", _filename );
 
     time(&end);
     double seconds = difftime( end, start );
@@ -829,10 +851,17 @@ inline bool CSCI441::ModelLoader::_loadMTLFile( const char* mtlFilename, bool IN
                         glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
                         glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
-                        GLenum colorSpace = GL_RGB;
-                        if( textureChannels == 4 )
-                            colorSpace = GL_RGBA;
-                        glTexImage2D( GL_TEXTURE_2D, 0, colorSpace, texWidth, texHeight, 0, colorSpace, GL_UNSIGNED_BYTE, textureData );
+                        if( TEXTURE_UPLOADER != NULL ) {
+                            // the uploader frees textureData once it is copied.  uploads only advance in update(),
+                            // so an alpha map later in this file can still combine with it
+                            TEXTURE_UPLOADER->upload2DTexture( textureHandle, textureData, texWidth, texHeight, textureChannels, false, stbi_image_free );
+                        } else {
+                            GLenum colorSpace = GL_RGB;
+                            if( textureChannels == 4 )
+                                colorSpace = GL_RGBA;
+                            glTexImage2D( GL_TEXTURE_2D, 0, colorSpace, texWidth, texHeight, 0, colorSpace, GL_UNSIGNED_BYTE, textureData );
+                        }
+                        CSCI441::ResourceRegistry::registerTexture( textureHandle, texWidth, texHeight, textureChannels == 4 ? GL_RGBA : GL_RGB, "CSCI441::ModelLoader", tokens[1].c_str() );
 
                         currentMaterial->map_Kd = textureHandle;
                     } else {
@@ -852,6 +881,7 @@ inline bool CSCI441::ModelLoader::_loadMTLFile( const char* mtlFilename, bool IN
                         glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
                         glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, texWidth, texHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, fullData );
+                        CSCI441::ResourceRegistry::registerTexture( textureHandle, texWidth, texHeight, GL_RGBA, "CSCI441::ModelLoader", tokens[1].c_str() );
 
                         delete fullData;
 
@@ -882,6 +912,12 @@ inline bool CSCI441::ModelLoader::_loadMTLFile( const char* mtlFilename, bool IN
                         if( textureHandle == 0 )
                             glGenTextures( 1, &textureHandle );
 
+                        // the combined image replaces any color map still being streamed, cancelling frees its pixels
+                        if( TEXTURE_UPLOADER != NULL ) {
+                            TEXTURE_UPLOADER->cancel( textureHandle );
+                            textureData = NULL;
+                        }
+
                         glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
                         glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
@@ -889,6 +925,7 @@ inline bool CSCI441::ModelLoader::_loadMTLFile( const char* mtlFilename, bool IN
                         glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
                         glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, texWidth, texHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, fullData );
+                        CSCI441::ResourceRegistry::registerTexture( textureHandle, texWidth, texHeight, GL_RGBA, "CSCI441::ModelLoader", tokens[1].c_str() );
 
                         delete fullData;
                     }
@@ -1205,12 +1242,14 @@ inline bool CSCI441::ModelLoader::_loadOFFFile( bool INFO, bool ERRORS ) {
     glBindVertexArray( _vaod );
     glBindBuffer( GL_ARRAY_BUFFER, _vbods[0] );
     glBufferData( GL_ARRAY_BUFFER, sizeof(GLfloat) * _uniqueIndex * 8, NULL, GL_STATIC_DRAW );
+    CSCI441::ResourceRegistry::registerBuffer( _vbods[0], GL_ARRAY_BUFFER, sizeof(GLfloat) * _uniqueIndex * 8, "CSCI441::ModelLoader", _filename );
     glBufferSubData( GL_ARRAY_BUFFER, 0, 																  sizeof(GLfloat) * _uniqueIndex * 3, _vertices );
     glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * _uniqueIndex * 3, sizeof(GLfloat) * _uniqueIndex * 3, _normals );
     glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * _uniqueIndex * 6, sizeof(GLfloat) * _uniqueIndex * 2, _texCoords );
 
     glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, _vbods[1] );
     glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * _numIndices, _indices, GL_STATIC_DRAW );
+    CSCI441::ResourceRegistry::registerBuffer( _vbods[1], GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * _numIndices, "CSCI441::ModelLoader", _filename );
 
     time(&end);
     double seconds = difftime( end, start );
@@ -1530,12 +1569,14 @@ inline bool CSCI441::ModelLoader::_loadPLYFile( bool INFO, bool ERRORS ) {
     glBindVertexArray( _vaod );
     glBindBuffer( GL_ARRAY_BUFFER, _vbods[0] );
     glBufferData( GL_ARRAY_BUFFER, sizeof(GLfloat) * _uniqueIndex * 8, NULL, GL_STATIC_DRAW );
+    CSCI441::ResourceRegistry::registerBuffer( _vbods[0], GL_ARRAY_BUFFER, sizeof(GLfloat) * _uniqueIndex * 8, "CSCI441::ModelLoader", _filename );
     glBufferSubData( GL_ARRAY_BUFFER, 0, 																  sizeof(GLfloat) * _uniqueIndex * 3, _vertices );
     glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * _uniqueIndex * 3, sizeof(GLfloat) * _uniqueIndex * 3, _normals );
     glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * _uniqueIndex * 6, sizeof(GLfloat) * _uniqueIndex * 2, _texCoords );
 
     glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, _vbods[1] );
     glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * _numIndices, _indices, GL_STATIC_DRAW );
+    CSCI441::ResourceRegistry::registerBuffer( _vbods[1], GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * _numIndices, "CSCI441::ModelLoader", _filename );
 
     time(&end);
     double seconds = difftime( end, start );
@@ -1723,12 +1764,14 @@ inline bool CSCI441::ModelLoader::_loadSTLFile( bool INFO, bool ERRORS ) {
     glBindVertexArray( _vaod );
     glBindBuffer( GL_ARRAY_BUFFER, _vbods[0] );
     glBufferData( GL_ARRAY_BUFFER, sizeof(GLfloat) * _uniqueIndex * 8, NULL, GL_STATIC_DRAW );
+    CSCI441::ResourceRegistry::registerBuffer( _vbods[0], GL_ARRAY_BUFFER, sizeof(GLfloat) * _uniqueIndex * 8, "CSCI441::ModelLoader", _filename );
     glBufferSubData( GL_ARRAY_BUFFER, 0, 																  sizeof(GLfloat) * _uniqueIndex * 3, _vertices );
     glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * _uniqueIndex * 3, sizeof(GLfloat) * _uniqueIndex * 3, _normals );
     glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * _uniqueIndex * 6, sizeof(GLfloat) * _uniqueIndex * 2, _texCoords );
 
     glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, _vbods[1] );
     glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * _numIndices, _indices, GL_STATIC_DRAW );
+    CSCI441::ResourceRegistry::registerBuffer( _vbods[1], GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * _numIndices, "CSCI441::ModelLoader", _filename );
 
     time(&end);
     double seconds = difftime( end, start );
@@ -1750,6 +1793,10 @@ inline void CSCI441::ModelLoader::disableAutoGenerateNormals() {
     AUTO_GEN_NORMALS = false;
 }
 
+inline void CSCI441::ModelLoader::setTextureUploader( TextureUploader* uploader ) {
+    TEXTURE_UPLOADER = uploader;
+}
+
 //
 //  vector<string> tokenizeString(string input, string delimiters)
 //
@@ -1,5 +1,5 @@
 /** @file objects.hpp
- * @brief Helper functions to draw 3D OpenGL 3.0+ objects
+ * @brief Helper functions to draw 3D OpenGL 3.1+ objects
  * @author Dr. Jeffrey Paone
  * @date Last Edit: 12 Oct 2020
  * @version 2.3.0
@@ -8,9 +8,11 @@
  *
  *	These functions draw solid (or wireframe) 3D closed OpenGL
  *	objects.  All objects are constructed using triangles that
- *	have normals and texture coordinates properly set.
+ *	have normals and texture coordinates properly set.  The vertex
+ *	arrays come from the generators in MeshData.hpp.
  *
- *	@warning NOTE: This header file will only work with OpenGL 3.0+
+ *	@warning NOTE: This header file will only work with OpenGL 3.1+, strips are joined with primitive restart
+ *	@warning NOTE: The draw*Instanced() functions need OpenGL 3.3+
  *	@warning NOTE: This header file depends upon GLEW
  */
 
@@ -22,9 +24,13 @@
 #include <assert.h>   					// for assert()
 #include <math.h>						// for cos(), sin()
 
+#include "MeshData.hpp"                 // for the CPU side generators
+#include "ResourceRegistry.hpp"         // for GPU memory accounting
 #include "teapot.hpp"                   // for teapot()
 
-#include <map>							// for map
+#include <list>							// for list
+#include <unordered_map>				// for unordered_map
+#include <vector>						// for vector
 
 ////////////////////////////////////////////////////////////////////////////////////
 
@@ -42,16 +48,49 @@ namespace CSCI441 {
         */
     void setVertexAttributeLocations( GLint positionLocation, GLint normalLocation = -1, GLint texCoordLocation = -1 );
 
-    /** @brief deletes the VAOs stored for all object types
+    /** @brief deletes the VAOs and buffers stored for all object types
      *
      */
     void deleteObjectVAOs();
 
-    /** @brief deletes the VBOs stored for all object types
+    /** @brief deletes the VAOs and buffers stored for all object types
      *
+     *	Same as deleteObjectVAOs() - an object's VAO and buffers are cached together
      */
     void deleteObjectVBOs();
 
+    /** @brief counters for the cache of generated object geometry
+     */
+    struct ObjectCacheStats {
+        unsigned long int hits;         ///< draws that found their geometry already generated
+        unsigned long int misses;       ///< draws that had to generate their geometry
+        unsigned long int evictions;    ///< objects deleted to stay within the budget
+        size_t entries;                 ///< objects currently cached
+        size_t bytes;                   ///< bytes of vertex and index data currently cached
+        size_t budget;                  ///< most bytes kept before the least recently drawn are deleted
+    };
+
+    /** @brief sets how much generated object geometry is kept on the GPU
+     *
+     *	Each distinct combination of shape and parameters is generated once and cached.
+     *	When the cache grows past the budget, the least recently drawn objects are
+     *	deleted and are generated again if drawn later.  Defaults to 16 MB.
+     *
+     * @param size_t budget - bytes of vertex and index data to keep
+     */
+    void setObjectCacheBudget( size_t budget );
+
+    /** @brief returns the hit, miss, and eviction counts along with the cache size
+     *
+     * @return ObjectCacheStats - counters since the last resetObjectCacheStats()
+     */
+    ObjectCacheStats getObjectCacheStats();
+
+    /** @brief zeroes the hit, miss, and eviction counts
+     *
+     */
+    void resetObjectCacheStats();
+
     /**	@brief Draws a solid cone
       *
         *	Cone is oriented along the y-axis with the origin along the base of the cone
@@ -264,6 +303,15 @@ namespace CSCI441 {
         *	@pre size must be greater than zero
         */
     void drawWireTeapot( GLfloat size );
+    /** @brief Sets how finely the teapot is tessellated
+        *
+        *	Each of the 28 patches of the teapot is evaluated at resolution x resolution points.
+        *	Changing the resolution rebuilds the teapot the next time it is drawn.
+        *
+        *	@param GLint resolution	- samples along each edge of a patch (default: 10)
+        *	@pre resolution must be at least 2
+        */
+    void setTeapotResolution( GLint resolution );
 
     /** @brief Draws a solid torus
       *
@@ -293,6 +341,132 @@ namespace CSCI441 {
         * @pre rings must be greater than two
         */
     void drawWireTorus( GLfloat innerRadius, GLfloat outerRadius, GLint sides, GLint rings );
+
+    /**	@brief Sets the attribute locations for per instance model matrices, colors and normal matrices
+        *
+        *	Needed by the draw*Instanced() functions.  The model matrix is a mat4 attribute and so
+        *	occupies four consecutive locations beginning at modelMatrixLocation.  The normal matrix
+        *	is a mat3 attribute and occupies three consecutive locations beginning at normalMatrixLocation.
+        *
+        * @param GLint modelMatrixLocation	- location of the per instance model matrix attribute
+        * @param GLint colorLocation			- location of the per instance vec3 color attribute
+        * @param GLint normalMatrixLocation	- location of the per instance normal matrix attribute
+        */
+    void setInstanceAttributeLocations( GLint modelMatrixLocation, GLint colorLocation = -1, GLint normalMatrixLocation = -1 );
+
+    /**	@brief Draws many copies of a solid cone in one draw call
+        *
+        *	Each instance is placed by its own model matrix and colored by its own color, which are
+        *	streamed to the attribute locations given to setInstanceAttributeLocations()
+        *
+        * @param GLfloat base		- radius of the base of the cone
+        * @param GLfloat height	- height of the cone from the base to the tip
+        * @param GLint stacks			- resolution of the number of steps rotated around the central axis of the cone
+        * @param GLint slices			- resolution of the number of steps to take along the height
+        * @param GLsizei instanceCount	- number of copies to draw
+        * @param const GLfloat* modelMatrices	- 16 floats per instance, column major
+        * @param const GLfloat* colors			- 3 floats per instance, or nullptr to leave the color attribute alone
+        * @param const GLfloat* normalMatrices	- 9 floats per instance, column major, or nullptr to leave the normal matrix attribute alone
+        * @pre instanceCount must not be negative
+        */
+    void drawSolidConeInstanced( GLfloat base, GLfloat height, GLint stacks, GLint slices, GLsizei instanceCount, const GLfloat* modelMatrices, const GLfloat* colors = nullptr, const GLfloat* normalMatrices = nullptr );
+    /**	@brief Draws many copies of a solid cube in one draw call.  Instanced version of drawSolidCube()
+        *
+        * @param GLfloat sideLength - length of the edge of the cube
+        * @param GLsizei instanceCount	- number of copies to draw
+        * @param const GLfloat* modelMatrices	- 16 floats per instance, column major
+        * @param const GLfloat* colors			- 3 floats per instance, or nullptr to leave the color attribute alone
+        * @param const GLfloat* normalMatrices	- 9 floats per instance, column major, or nullptr to leave the normal matrix attribute alone
+        * @pre instanceCount must not be negative
+        */
+    void drawSolidCubeInstanced( GLfloat sideLength, GLsizei instanceCount, const GLfloat* modelMatrices, const GLfloat* colors = nullptr, const GLfloat* normalMatrices = nullptr );
+    /**	@brief Draws many copies of a solid open ended cylinder in one draw call
+        *
+        * @param GLfloat base		- radius of the base of the cylinder
+        * @param GLfloat top			- radius of the top of the cylinder
+        * @param GLfloat height	- height of the cylinder from the base to the top
+        * @param GLint stacks			- resolution of the number of steps rotated around the central axis of the cylinder
+        * @param GLint slices			- resolution of the number of steps to take along the height
+        * @param GLsizei instanceCount	- number of copies to draw
+        * @param const GLfloat* modelMatrices	- 16 floats per instance, column major
+        * @param const GLfloat* colors			- 3 floats per instance, or nullptr to leave the color attribute alone
+        * @param const GLfloat* normalMatrices	- 9 floats per instance, column major, or nullptr to leave the normal matrix attribute alone
+        * @pre instanceCount must not be negative
+        */
+    void drawSolidCylinderInstanced( GLfloat base, GLfloat top, GLfloat height, GLint stacks, GLint slices, GLsizei instanceCount, const GLfloat* modelMatrices, const GLfloat* colors = nullptr, const GLfloat* normalMatrices = nullptr );
+    /**	@brief Draws many copies of a solid disk in one draw call
+        *
+        * @param GLfloat inner	- equivalent to the width of the disk
+        * @param GLfloat outer	- radius from the center of the disk to the center of the ring
+        * @param GLint slices		- resolution of the number of steps rotated along the disk
+        * @param GLint rings		- resolution of the number of steps to take along the disk width
+        * @param GLsizei instanceCount	- number of copies to draw
+        * @param const GLfloat* modelMatrices	- 16 floats per instance, column major
+        * @param const GLfloat* colors			- 3 floats per instance, or nullptr to leave the color attribute alone
+        * @param const GLfloat* normalMatrices	- 9 floats per instance, column major, or nullptr to leave the normal matrix attribute alone
+        * @pre instanceCount must not be negative
+        */
+    void drawSolidDiskInstanced( GLfloat inner, GLfloat outer, GLint slices, GLint rings, GLsizei instanceCount, const GLfloat* modelMatrices, const GLfloat* colors = nullptr, const GLfloat* normalMatrices = nullptr );
+    /**	@brief Draws many copies of a solid sphere in one draw call
+        *
+        * @param GLfloat radius	- radius of the sphere
+        * @param GLint stacks		- resolution of the number of steps to take along theta (rotate around Y-axis)
+        * @param GLint slices		- resolution of the number of steps to take along phi (rotate around X- or Z-axis)
+        * @param GLsizei instanceCount	- number of copies to draw
+        * @param const GLfloat* modelMatrices	- 16 floats per instance, column major
+        * @param const GLfloat* colors			- 3 floats per instance, or nullptr to leave the color attribute alone
+        * @param const GLfloat* normalMatrices	- 9 floats per instance, column major, or nullptr to leave the normal matrix attribute alone
+        * @pre instanceCount must not be negative
+        */
+    void drawSolidSphereInstanced( GLfloat radius, GLint stacks, GLint slices, GLsizei instanceCount, const GLfloat* modelMatrices, const GLfloat* colors = nullptr, const GLfloat* normalMatrices = nullptr );
+    /** @brief Draws many copies of a solid torus in one draw call
+        *
+        * @param innerRadius 	- equivalent to the width of the torus ring
+        * @param outerRadius	- radius from the center of the torus to the center of the ring
+        * @param sides				- resolution of steps to take around the band of the ring
+        * @param rings				- resolution of steps to take around the torus
+        * @param GLsizei instanceCount	- number of copies to draw
+        * @param const GLfloat* modelMatrices	- 16 floats per instance, column major
+        * @param const GLfloat* colors			- 3 floats per instance, or nullptr to leave the color attribute alone
+        * @param const GLfloat* normalMatrices	- 9 floats per instance, column major, or nullptr to leave the normal matrix attribute alone
+        * @pre instanceCount must not be negative
+        */
+    void drawSolidTorusInstanced( GLfloat innerRadius, GLfloat outerRadius, GLint sides, GLint rings, GLsizei instanceCount, const GLfloat* modelMatrices, const GLfloat* colors = nullptr, const GLfloat* normalMatrices = nullptr );
+
+    /** @brief Sets how finely the draw*LOD() functions tessellate
+        *
+        *	The resolution around each object is chosen so that every segment covers about
+        *	pixelsPerEdge pixels on screen, rounded up to one of a few fixed tiers so that
+        *	the cache only ever holds a handful of versions of each object.
+        *
+        * @param GLfloat pixelsPerEdge	- target on screen length of a triangle edge (default: 8)
+        * @param GLint viewportWidth		- width of the viewport in pixels, or 0 to read GL_VIEWPORT on each draw (default: 0)
+        * @param GLint viewportHeight		- height of the viewport in pixels, or 0 to read GL_VIEWPORT on each draw (default: 0)
+        * @pre pixelsPerEdge must be greater than 0
+        */
+    void setObjectLODTarget( GLfloat pixelsPerEdge, GLint viewportWidth = 0, GLint viewportHeight = 0 );
+    /**	@brief Draws a solid open ended cylinder with a resolution chosen from its size on screen
+        *
+        * @param GLfloat base		- radius of the base of the cylinder
+        * @param GLfloat top			- radius of the top of the cylinder
+        * @param GLfloat height	- height of the cylinder from the base to the top
+        * @param const GLfloat* mvpMatrix	- the model-view-projection matrix the cylinder is drawn with, column major
+        */
+    void drawSolidCylinderLOD( GLfloat base, GLfloat top, GLfloat height, const GLfloat* mvpMatrix );
+    /**	@brief Draws a solid sphere with a resolution chosen from its size on screen
+        *
+        * @param GLfloat radius	- radius of the sphere
+        * @param const GLfloat* mvpMatrix	- the model-view-projection matrix the sphere is drawn with, column major
+        *	@pre radius must be greater than 0
+        */
+    void drawSolidSphereLOD( GLfloat radius, const GLfloat* mvpMatrix );
+    /** @brief Draws a solid torus with a resolution chosen from its size on screen
+        *
+        * @param innerRadius 	- equivalent to the width of the torus ring
+        * @param outerRadius	- radius from the center of the torus to the center of the ring
+        * @param const GLfloat* mvpMatrix	- the model-view-projection matrix the torus is drawn with, column major
+        */
+    void drawSolidTorusLOD( GLfloat innerRadius, GLfloat outerRadius, const GLfloat* mvpMatrix );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -313,131 +487,126 @@ namespace CSCI441_INTERNAL {
     void drawPartialDisk( GLfloat inner, GLfloat outer, GLint slices, GLint rings, GLfloat start, GLfloat sweep, GLenum renderMode );
     void drawSphere( GLfloat radius, GLint stacks, GLint slices, GLenum renderMode );
     void drawTorus( GLfloat innerRadius, GLfloat outerRadius, GLint sides, GLint rings, GLenum renderMode );
+    GLenum indexType( unsigned long int numVertices );
+    GLuint restartIndex( GLenum indexType );
 
     struct AttributeLocations {
         static GLint _positionLocation;
         static GLint _normalLocation;
         static GLint _texCoordLocation;
+        static GLint _instanceModelMatrixLocation;
+        static GLint _instanceColorLocation;
+        static GLint _instanceNormalMatrixLocation;
     };
 
-    void generateCubeVAOFlat( GLfloat sideLength );
-    void generateCubeVAOIndexed( GLfloat sideLength );
-    static std::map< GLfloat, GLuint > _cubeVAO;
-    static std::map< GLfloat, GLuint > _cubeVBO;
-    static std::map< GLfloat, GLuint > _cubeVAOIndexed;
-    static std::map< GLfloat, GLuint > _cubeVBOIndexed;
-
-    struct CylinderData {
-        GLfloat b, t, h;
-        GLint st, sl;
-        bool operator<( const CylinderData rhs ) const {
-            if( b < rhs.b ) {
-                return true;
-            } else if( fabs(b - rhs.b) <= 0.000001 ) {
-                if( t < rhs.t ) {
-                    return true;
-                } else if( fabs(t - rhs.t) <= 0.000001 ) {
-                    if( h < rhs.h ) {
-                        return true;
-                    } else if( fabs(h - rhs.h) <= 0.000001 ) {
-                        if( st < rhs.st ) {
-                            return true;
-                        } else if( st == rhs.st ) {
-                            if( sl < rhs.sl ) {
-                                return true;
-                            }
-                        }
-                    }
-                }
-            }
-            return false;
-        }
+    // lets a shader that defers its uniforms, as SimpleShader3 does with the model matrix, send them before a draw
+    struct DrawCallbacks {
+        static void (*_beforeDraw)();
     };
-    void generateCylinderVAO( CylinderData cylData );
-    static std::map< CylinderData, GLuint > _cylinderVAO;
-    static std::map< CylinderData, GLuint > _cylinderVBO;
-
-    struct DiskData {
-        GLfloat i, o, st, sw;
-        GLint sl, r;
-        bool operator<( const DiskData rhs ) const {
-            if( i < rhs.i ) {
-                return true;
-            } else if( fabs(i - rhs.i) <= 0.000001 ) {
-                if( o < rhs.o ) {
-                    return true;
-                } else if( fabs(o - rhs.o) <= 0.000001 ) {
-                    if( st < rhs.st ) {
-                        return true;
-                    } else if( fabs(st - rhs.st) <= 0.000001 ) {
-                        if( sw < rhs.sw ) {
-                            return true;
-                        } else if( fabs(sw - rhs.sw) <= 0.000001 ) {
-                            if( sl < rhs.sl ) {
-                                return true;
-                            } else if( sl == rhs.sl ) {
-                                if( r < rhs.r ) {
-                                    return true;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            return false;
-        }
+
+    enum GeometryShape {
+        CUBE_FLAT_GEOMETRY = 0,
+        CUBE_INDEXED_GEOMETRY,
+        CYLINDER_GEOMETRY,
+        DISK_GEOMETRY,
+        SPHERE_GEOMETRY,
+        TORUS_GEOMETRY
     };
-    void generateDiskVAO( DiskData diskData );
-    static std::map< DiskData, GLuint > _diskVAO;
-    static std::map< DiskData, GLuint > _diskVBO;
-
-    struct SphereData {
-        GLfloat r;
-        GLint st, sl;
-        bool operator<( const SphereData rhs ) const {
-            if( r < rhs.r ) {
-                return true;
-            } else if( fabs(r - rhs.r) <= 0.000001 ) {
-                if( st < rhs.st ) {
-                    return true;
-                } else if( st == rhs.st ) {
-                    if( sl < rhs.sl ) {
-                        return true;
-                    }
-                }
+
+    // shape plus its parameters, lengths and angles quantized so nearly equal values share geometry
+    struct GeometryKey {
+        GLint shape;
+        long long params[6];
+        bool operator==( const GeometryKey &rhs ) const {
+            if( shape != rhs.shape ) return false;
+            for( int i = 0; i < 6; i++ ) {
+                if( params[i] != rhs.params[i] ) return false;
             }
-            return false;
+            return true;
         }
     };
-    void generateSphereVAO( SphereData sphereData );
-    static std::map< SphereData, GLuint > _sphereVAO;
-    static std::map< SphereData, GLuint > _sphereVBO;
-
-    struct TorusData {
-        GLfloat i, o;
-        GLint s, r;
-        bool operator<( const TorusData rhs ) const {
-            if( i < rhs.i ) {
-                return true;
-            } else if( fabs(i - rhs.i) <= 0.000001 ) {
-                if( o < rhs.o ) {
-                    return true;
-                } else if( fabs(o - rhs.o) <= 0.000001 ) {
-                    if( s < rhs.s ) {
-                        return true;
-                    } else if( s == rhs.s ) {
-                        if( r < rhs.r ) {
-                            return true;
-                        }
-                    }
-                }
+
+    struct GeometryKeyHash {
+        size_t operator()( const GeometryKey &key ) const {
+            size_t hash = (size_t)key.shape;
+            for( int i = 0; i < 6; i++ ) {
+                hash ^= std::hash<long long>()( key.params[i] ) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
             }
-            return false;
+            return hash;
         }
     };
-    void generateTorusVAO( TorusData torusData );
-    static std::map< TorusData, GLuint > _torusVAO;
-    static std::map< TorusData, GLuint > _torusVBO;
+
+    struct CachedGeometry {
+        GLuint vao, vbo, ibo;                           // ibo is 0 for geometry drawn with glDrawArrays()
+        size_t byteSize;
+        GLenum primitive;
+        GLenum indexType;                               // GL_NONE for geometry drawn with glDrawArrays()
+        GLint numStrips, stripLength;
+        bool primitiveRestart;                          // strips are joined into one draw by the restart index
+        GLintptr normalOffset, texCoordOffset;          // texCoordOffset is -1 when there are no texture coordinates
+        GLint positionLocation, normalLocation, texCoordLocation;  // locations the VAO currently points at
+        std::list< GeometryKey >::iterator lruPosition;
+    };
+
+    struct GeometryCacheState {
+        std::unordered_map< GeometryKey, CachedGeometry, GeometryKeyHash > entries;
+        std::list< GeometryKey > lru;                   // most recently drawn first
+        size_t bytes;
+        size_t budget;
+        unsigned long int hits, misses, evictions;
+
+        GeometryCacheState() : bytes(0), budget(16*1024*1024), hits(0), misses(0), evictions(0) {}
+    };
+
+    GeometryCacheState& geometryCache();
+    long long quantizeGeometryParameter( GLfloat value );
+    CachedGeometry* findGeometry( const GeometryKey &key );
+    CachedGeometry* insertGeometry( const GeometryKey &key, const CachedGeometry &geometry );
+    void evictGeometry( size_t budget );
+    void deleteGeometry( CachedGeometry &geometry );
+    void drawGeometry( CachedGeometry &geometry, GLenum renderMode, GLsizei instanceCount = 0 );
+    void drawGeometryInstanced( CachedGeometry &geometry, GLsizei instanceCount, const GLfloat* modelMatrices, const GLfloat* colors, const GLfloat* normalMatrices );
+
+    CachedGeometry* cubeGeometry( GLfloat sideLength );
+    CachedGeometry* cubeFlatGeometry( GLfloat sideLength );
+    CachedGeometry* cylinderGeometry( GLfloat base, GLfloat top, GLfloat height, GLint stacks, GLint slices );
+    CachedGeometry* diskGeometry( GLfloat inner, GLfloat outer, GLfloat start, GLfloat sweep, GLint slices, GLint rings );
+    CachedGeometry* sphereGeometry( GLfloat radius, GLint stacks, GLint slices );
+    CachedGeometry* torusGeometry( GLfloat innerRadius, GLfloat outerRadius, GLint sides, GLint rings );
+
+    // one streaming buffer shared by every instanced draw, orphaned on each upload
+    struct InstanceBufferState {
+        GLuint vbo;
+        size_t capacity;
+
+        InstanceBufferState() : vbo(0), capacity(0) {}
+    };
+
+    InstanceBufferState& instanceBuffer();
+
+    struct LODState {
+        GLfloat pixelsPerEdge;
+        GLint viewportWidth, viewportHeight;            // 0 to read GL_VIEWPORT
+
+        LODState() : pixelsPerEdge(8.0f), viewportWidth(0), viewportHeight(0) {}
+    };
+
+    LODState& lodState();
+    GLfloat projectedPixelsPerUnit( const GLfloat* mvpMatrix, GLfloat centerX, GLfloat centerY, GLfloat centerZ, GLfloat boundingRadius );
+    GLint loopLOD( GLfloat circumference, GLfloat pixelsPerUnit );
+    GLint lengthLOD( GLfloat length, GLfloat pixelsPerUnit );
+
+    GLuint generateIndexBuffer( const GLuint* indices, unsigned long int numIndices, unsigned long int numVertices, const char* label );
+    CachedGeometry describeGeometry( GLuint vaod, GLuint vbod, GLuint ibod, unsigned long int numVertices, unsigned long int numIndices,
+                                     GLenum primitive, GLint numStrips, GLint stripLength, bool primitiveRestart, bool hasTexCoords );
+    CachedGeometry uploadMesh( const CSCI441::MeshData &mesh, const char* label );
+
+    CachedGeometry generateCubeVAOFlat( GLfloat sideLength );
+    CachedGeometry generateCubeVAOIndexed( GLfloat sideLength );
+    CachedGeometry generateCylinderVAO( GLfloat base, GLfloat top, GLfloat height, GLint stacks, GLint slices );
+    CachedGeometry generateDiskVAO( GLfloat inner, GLfloat outer, GLfloat start, GLfloat sweep, GLint slices, GLint rings );
+    CachedGeometry generateSphereVAO( GLfloat radius, GLint stacks, GLint slices );
+    CachedGeometry generateTorusVAO( GLfloat innerRadius, GLfloat outerRadius, GLint sides, GLint rings );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -447,6 +616,10 @@ namespace CSCI441_INTERNAL {
 inline GLint CSCI441_INTERNAL::AttributeLocations::_positionLocation = -1;
 inline GLint CSCI441_INTERNAL::AttributeLocations::_normalLocation = -1;
 inline GLint CSCI441_INTERNAL::AttributeLocations::_texCoordLocation = -1;
+inline GLint CSCI441_INTERNAL::AttributeLocations::_instanceModelMatrixLocation = -1;
+inline GLint CSCI441_INTERNAL::AttributeLocations::_instanceColorLocation = -1;
+inline GLint CSCI441_INTERNAL::AttributeLocations::_instanceNormalMatrixLocation = -1;
+inline void (*CSCI441_INTERNAL::DrawCallbacks::_beforeDraw)() = nullptr;
 
 inline void CSCI441::setVertexAttributeLocations( GLint positionLocation, GLint normalLocation, GLint texCoordLocation ) {
     CSCI441_INTERNAL::AttributeLocations::_positionLocation = positionLocation;
@@ -462,6 +635,31 @@ inline void CSCI441::deleteObjectVBOs() {
     CSCI441_INTERNAL::deleteObjectVBOs();
 }
 
+inline void CSCI441::setObjectCacheBudget( size_t budget ) {
+    CSCI441_INTERNAL::geometryCache().budget = budget;
+    CSCI441_INTERNAL::evictGeometry( budget );
+}
+
+inline CSCI441::ObjectCacheStats CSCI441::getObjectCacheStats() {
+    CSCI441_INTERNAL::GeometryCacheState &cache = CSCI441_INTERNAL::geometryCache();
+
+    ObjectCacheStats stats;
+    stats.hits = cache.hits;
+    stats.misses = cache.misses;
+    stats.evictions = cache.evictions;
+    stats.entries = cache.entries.size();
+    stats.bytes = cache.bytes;
+    stats.budget = cache.budget;
+    return stats;
+}
+
+inline void CSCI441::resetObjectCacheStats() {
+    CSCI441_INTERNAL::GeometryCacheState &cache = CSCI441_INTERNAL::geometryCache();
+    cache.hits = 0;
+    cache.misses = 0;
+    cache.evictions = 0;
+}
+
 inline void CSCI441::drawSolidCone( GLfloat base, GLfloat height, GLint stacks, GLint slices ) {
     assert( base > 0.0f );
     assert( height > 0.0f );
@@ -587,17 +785,28 @@ inline void CSCI441::drawWireSphere( GLfloat radius, GLint stacks, GLint slices
 inline void CSCI441::drawSolidTeapot( GLfloat size ) {
     assert( size > 0.0f );
 
+    if( CSCI441_INTERNAL::DrawCallbacks::_beforeDraw ) CSCI441_INTERNAL::DrawCallbacks::_beforeDraw();
     CSCI441_INTERNAL::teapot( size, CSCI441_INTERNAL::AttributeLocations::_positionLocation, CSCI441_INTERNAL::AttributeLocations::_normalLocation );
 }
 
 inline void CSCI441::drawWireTeapot( GLfloat size ) {
     assert( size > 0.0f );
 
+    if( CSCI441_INTERNAL::DrawCallbacks::_beforeDraw ) CSCI441_INTERNAL::DrawCallbacks::_beforeDraw();
     glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
     CSCI441_INTERNAL::teapot( size, CSCI441_INTERNAL::AttributeLocations::_positionLocation, CSCI441_INTERNAL::AttributeLocations::_normalLocation );
     glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
 }
 
+inline void CSCI441::setTeapotResolution( GLint resolution ) {
+    assert( resolution >= 2 );
+
+    if( resolution != CSCI441_INTERNAL::teapot_resolution ) {
+        CSCI441_INTERNAL::delete_resources();
+        CSCI441_INTERNAL::teapot_resolution = resolution;
+    }
+}
+
 inline void CSCI441::drawSolidTorus( GLfloat innerRadius, GLfloat outerRadius, GLint sides, GLint rings ) {
     assert( innerRadius > 0.0f );
     assert( outerRadius > 0.0f );
@@ -616,583 +825,509 @@ inline void CSCI441::drawWireTorus( GLfloat innerRadius, GLfloat outerRadius, GL
     CSCI441_INTERNAL::drawTorus( innerRadius, outerRadius, sides, rings, GL_LINE );
 }
 
-////////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////////
-// Internal function rendering implementations
-
-
-
-inline void CSCI441_INTERNAL::deleteObjectVAOs() {
-    for(std::map<GLfloat, GLuint>::iterator iter = _cubeVAO.begin(); iter != _cubeVAO.end(); iter++) {
-        glDeleteVertexArrays(1, &(iter->second));
-    }
-    for(std::map<GLfloat, GLuint>::iterator iter = _cubeVAOIndexed.begin(); iter != _cubeVAOIndexed.end(); iter++) {
-        glDeleteVertexArrays(1, &(iter->second));
-    }
-    for(std::map<CylinderData, GLuint>::iterator iter = _cylinderVAO.begin(); iter != _cylinderVAO.end(); iter++) {
-        glDeleteVertexArrays(1, &(iter->second));
-    }
-    for(std::map<DiskData, GLuint>::iterator iter = _diskVAO.begin(); iter != _diskVAO.end(); iter++) {
-        glDeleteVertexArrays(1, &(iter->second));
-    }
-    for(std::map<SphereData, GLuint>::iterator iter = _sphereVAO.begin(); iter != _sphereVAO.end(); iter++) {
-        glDeleteVertexArrays(1, &(iter->second));
-    }
-    for(std::map<TorusData, GLuint>::iterator iter = _torusVAO.begin(); iter != _torusVAO.end(); iter++) {
-        glDeleteVertexArrays(1, &(iter->second));
-    }
+inline void CSCI441::setInstanceAttributeLocations( GLint modelMatrixLocation, GLint colorLocation, GLint normalMatrixLocation ) {
+    CSCI441_INTERNAL::AttributeLocations::_instanceModelMatrixLocation = modelMatrixLocation;
+    CSCI441_INTERNAL::AttributeLocations::_instanceColorLocation = colorLocation;
+    CSCI441_INTERNAL::AttributeLocations::_instanceNormalMatrixLocation = normalMatrixLocation;
 }
 
-inline void CSCI441_INTERNAL::deleteObjectVBOs() {
-    for(std::map<GLfloat, GLuint>::iterator iter = _cubeVBO.begin(); iter != _cubeVBO.end(); iter++) {
-        glDeleteBuffers(1, &(iter->second));
-    }
-    for(std::map<GLfloat, GLuint>::iterator iter = _cubeVBOIndexed.begin(); iter != _cubeVBOIndexed.end(); iter++) {
-        glDeleteBuffers(1, &(iter->second));
-    }
-    for(std::map<CylinderData, GLuint>::iterator iter = _cylinderVBO.begin(); iter != _cylinderVBO.end(); iter++) {
-        glDeleteBuffers(1, &(iter->second));
-    }
-    for(std::map<DiskData, GLuint>::iterator iter = _diskVBO.begin(); iter != _diskVBO.end(); iter++) {
-        glDeleteBuffers(1, &(iter->second));
-    }
-    for(std::map<SphereData, GLuint>::iterator iter = _sphereVBO.begin(); iter != _sphereVBO.end(); iter++) {
-        glDeleteBuffers(1, &(iter->second));
-    }
-    for(std::map<TorusData, GLuint>::iterator iter = _torusVBO.begin(); iter != _torusVBO.end(); iter++) {
-        glDeleteBuffers(1, &(iter->second));
-    }
-}
+inline void CSCI441::drawSolidConeInstanced( GLfloat base, GLfloat height, GLint stacks, GLint slices, GLsizei instanceCount, const GLfloat* modelMatrices, const GLfloat* colors, const GLfloat* normalMatrices ) {
+    assert( base > 0.0f );
+    assert( height > 0.0f );
+    assert( stacks > 0 );
+    assert( slices > 2 );
+    assert( instanceCount >= 0 );
 
-inline void CSCI441_INTERNAL::drawCube( GLfloat sideLength, GLenum renderMode ) {
-    drawCubeIndexed(sideLength, renderMode);
+    CSCI441_INTERNAL::drawGeometryInstanced( *CSCI441_INTERNAL::cylinderGeometry( base, 0.0f, height, stacks, slices ), instanceCount, modelMatrices, colors, normalMatrices );
 }
 
-inline void CSCI441_INTERNAL::drawCubeFlat( GLfloat sideLength, GLenum renderMode ) {
-    if( CSCI441_INTERNAL::_cubeVAO.count( sideLength ) == 0 ) {
-        CSCI441_INTERNAL::generateCubeVAOFlat( sideLength );
-    }
-
-    glPolygonMode( GL_FRONT_AND_BACK, renderMode );
-    glBindVertexArray( CSCI441_INTERNAL::_cubeVAO.find( sideLength )->second );
-    glBindBuffer( GL_ARRAY_BUFFER, CSCI441_INTERNAL::_cubeVBO.find( sideLength )->second );
-    glEnableVertexAttribArray( CSCI441_INTERNAL::AttributeLocations::_positionLocation );
-    glVertexAttribPointer( CSCI441_INTERNAL::AttributeLocations::_positionLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)0 );
-    glEnableVertexAttribArray( CSCI441_INTERNAL::AttributeLocations::_normalLocation );
-    glVertexAttribPointer( CSCI441_INTERNAL::AttributeLocations::_normalLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(GLfloat)*36*3) );
-    glEnableVertexAttribArray( CSCI441_INTERNAL::AttributeLocations::_texCoordLocation );
-    glVertexAttribPointer( CSCI441_INTERNAL::AttributeLocations::_texCoordLocation, 2, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(GLfloat)*36*6) );
-    glDrawArrays( GL_TRIANGLES, 0, 36 );
+inline void CSCI441::drawSolidCubeInstanced( GLfloat sideLength, GLsizei instanceCount, const GLfloat* modelMatrices, const GLfloat* colors, const GLfloat* normalMatrices ) {
+    assert( sideLength > 0.0f );
+    assert( instanceCount >= 0 );
 
-    glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+    CSCI441_INTERNAL::drawGeometryInstanced( *CSCI441_INTERNAL::cubeGeometry( sideLength ), instanceCount, modelMatrices, colors, normalMatrices );
 }
 
-inline void CSCI441_INTERNAL::drawCubeIndexed( GLfloat sideLength, GLenum renderMode ) {
-    if( CSCI441_INTERNAL::_cubeVAOIndexed.count( sideLength ) == 0 ) {
-        CSCI441_INTERNAL::generateCubeVAOIndexed( sideLength );
-    }
-
-    glPolygonMode( GL_FRONT_AND_BACK, renderMode );
-    glBindVertexArray( CSCI441_INTERNAL::_cubeVAOIndexed.find( sideLength )->second );
-    glBindBuffer( GL_ARRAY_BUFFER, CSCI441_INTERNAL::_cubeVBOIndexed.find( sideLength )->second );
-    glEnableVertexAttribArray( CSCI441_INTERNAL::AttributeLocations::_positionLocation );
-    glVertexAttribPointer( CSCI441_INTERNAL::AttributeLocations::_positionLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)0 );
-    glEnableVertexAttribArray( CSCI441_INTERNAL::AttributeLocations::_normalLocation );
-    glVertexAttribPointer( CSCI441_INTERNAL::AttributeLocations::_normalLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(GLfloat)*8*3) );
-    glDrawElements( GL_TRIANGLES, 36, GL_UNSIGNED_SHORT, (void*)0 );
+inline void CSCI441::drawSolidCylinderInstanced( GLfloat base, GLfloat top, GLfloat height, GLint stacks, GLint slices, GLsizei instanceCount, const GLfloat* modelMatrices, const GLfloat* colors, const GLfloat* normalMatrices ) {
+    assert( (base >= 0.0f && top > 0.0f) || (base > 0.0f && top >= 0.0f) );
+    assert( height > 0.0f );
+    assert( stacks > 0 );
+    assert( slices > 2 );
+    assert( instanceCount >= 0 );
 
-    glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+    CSCI441_INTERNAL::drawGeometryInstanced( *CSCI441_INTERNAL::cylinderGeometry( base, top, height, stacks, slices ), instanceCount, modelMatrices, colors, normalMatrices );
 }
 
-inline void CSCI441_INTERNAL::drawCylinder( GLfloat base, GLfloat top, GLfloat height, GLint stacks, GLint slices, GLenum renderMode ) {
-    CylinderData cylData = { base, top, height, stacks, slices };
-    if( CSCI441_INTERNAL::_cylinderVAO.count( cylData ) == 0 ) {
-        CSCI441_INTERNAL::generateCylinderVAO( cylData );
-    }
-
-    unsigned long int numVertices = cylData.st * (cylData.sl+1) * 2;
-
-    glPolygonMode( GL_FRONT_AND_BACK, renderMode );
-    glBindVertexArray( CSCI441_INTERNAL::_cylinderVAO.find( cylData )->second );
-    glBindBuffer( GL_ARRAY_BUFFER, CSCI441_INTERNAL::_cylinderVBO.find( cylData )->second );
-    glEnableVertexAttribArray( CSCI441_INTERNAL::AttributeLocations::_positionLocation );
-    glVertexAttribPointer( CSCI441_INTERNAL::AttributeLocations::_positionLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)0 );
-    glEnableVertexAttribArray( CSCI441_INTERNAL::AttributeLocations::_normalLocation );
-    glVertexAttribPointer( CSCI441_INTERNAL::AttributeLocations::_normalLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(GLfloat) * numVertices * 3) );
-    glEnableVertexAttribArray( CSCI441_INTERNAL::AttributeLocations::_texCoordLocation );
-    glVertexAttribPointer( CSCI441_INTERNAL::AttributeLocations::_texCoordLocation, 2, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(GLfloat) * numVertices * 6) );
-
-    for( int stackNum = 0; stackNum < stacks; stackNum++ ) {
-        glDrawArrays( GL_TRIANGLE_STRIP, (slices+1)*2*stackNum, (slices+1)*2 );
-    }
+inline void CSCI441::drawSolidDiskInstanced( GLfloat inner, GLfloat outer, GLint slices, GLint rings, GLsizei instanceCount, const GLfloat* modelMatrices, const GLfloat* colors, const GLfloat* normalMatrices ) {
+    assert( inner >= 0.0f );
+    assert( outer > 0.0f );
+    assert( outer > inner );
+    assert( slices > 2 );
+    assert( rings > 0 );
+    assert( instanceCount >= 0 );
 
-    glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+    CSCI441_INTERNAL::drawGeometryInstanced( *CSCI441_INTERNAL::diskGeometry( inner, outer, 0, 2*M_PI, slices, rings ), instanceCount, modelMatrices, colors, normalMatrices );
 }
 
-inline void CSCI441_INTERNAL::drawPartialDisk( GLfloat inner, GLfloat outer, GLint slices, GLint rings, GLfloat start, GLfloat sweep, GLenum renderMode ) {
-    DiskData diskData = { inner, outer, start, sweep, slices, rings };
-    if( CSCI441_INTERNAL::_diskVAO.count( diskData ) == 0 ) {
-        CSCI441_INTERNAL::generateDiskVAO( diskData );
-    }
-
-    glPolygonMode( GL_FRONT_AND_BACK, renderMode );
-    glBindVertexArray( CSCI441_INTERNAL::_diskVAO.find( diskData )->second );
-    glBindBuffer( GL_ARRAY_BUFFER, CSCI441_INTERNAL::_diskVBO.find( diskData )->second );
-    glEnableVertexAttribArray( CSCI441_INTERNAL::AttributeLocations::_positionLocation );
-    glVertexAttribPointer( CSCI441_INTERNAL::AttributeLocations::_positionLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)0 );
-    glEnableVertexAttribArray( CSCI441_INTERNAL::AttributeLocations::_normalLocation );
-    glVertexAttribPointer( CSCI441_INTERNAL::AttributeLocations::_normalLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(GLfloat)*rings * (slices+1) * 2*3) );
-    glEnableVertexAttribArray( CSCI441_INTERNAL::AttributeLocations::_texCoordLocation );
-    glVertexAttribPointer( CSCI441_INTERNAL::AttributeLocations::_texCoordLocation, 2, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(GLfloat)*rings * (slices+1) * 2*6) );
-
-    for( int ringNum = 0; ringNum < rings; ringNum++ ) {
-        glDrawArrays( GL_TRIANGLE_STRIP, (slices+1)*2*ringNum, (slices+1)*2 );
-    }
+inline void CSCI441::drawSolidSphereInstanced( GLfloat radius, GLint stacks, GLint slices, GLsizei instanceCount, const GLfloat* modelMatrices, const GLfloat* colors, const GLfloat* normalMatrices ) {
+    assert( radius > 0.0f );
+    assert( stacks > 1 );
+    assert( slices > 2 );
+    assert( instanceCount >= 0 );
 
-    glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+    CSCI441_INTERNAL::drawGeometryInstanced( *CSCI441_INTERNAL::sphereGeometry( radius, stacks, slices ), instanceCount, modelMatrices, colors, normalMatrices );
 }
 
-inline void CSCI441_INTERNAL::drawSphere( GLfloat radius, GLint stacks, GLint slices, GLenum renderMode ) {
-    SphereData sphereData = { radius, stacks, slices };
-    if( CSCI441_INTERNAL::_sphereVAO.count( sphereData ) == 0 ) {
-        CSCI441_INTERNAL::generateSphereVAO( sphereData );
-    }
-
-    glPolygonMode( GL_FRONT_AND_BACK, renderMode );
-    glBindVertexArray( CSCI441_INTERNAL::_sphereVAO.find( sphereData )->second );
-    glBindBuffer( GL_ARRAY_BUFFER, CSCI441_INTERNAL::_sphereVBO.find( sphereData )->second );
-    glEnableVertexAttribArray( CSCI441_INTERNAL::AttributeLocations::_positionLocation );
-    glVertexAttribPointer( CSCI441_INTERNAL::AttributeLocations::_positionLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)0 );
-    glEnableVertexAttribArray( CSCI441_INTERNAL::AttributeLocations::_normalLocation );
-    glVertexAttribPointer( CSCI441_INTERNAL::AttributeLocations::_normalLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(GLfloat)*((slices + 2)*2 + ((stacks - 2)*(slices+1))*2) *3) );
-    glEnableVertexAttribArray( CSCI441_INTERNAL::AttributeLocations::_texCoordLocation );
-    glVertexAttribPointer( CSCI441_INTERNAL::AttributeLocations::_texCoordLocation, 2, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(GLfloat)*((slices + 2)*2 + ((stacks - 2)*(slices+1))*2) *6) );
-
-    glDrawArrays( GL_TRIANGLE_FAN, 0, slices+2 );
-
-    for( int stackNum = 1; stackNum < stacks-1; stackNum++ ) {
-        glDrawArrays( GL_TRIANGLE_STRIP, (slices+2) + (stackNum-1)*((slices+1)*2), (slices+1)*2 );
-    }
-
-    glDrawArrays( GL_TRIANGLE_FAN, (slices+2) + (stacks-2)*(slices+1)*2, slices+2 );
+inline void CSCI441::drawSolidTorusInstanced( GLfloat innerRadius, GLfloat outerRadius, GLint sides, GLint rings, GLsizei instanceCount, const GLfloat* modelMatrices, const GLfloat* colors, const GLfloat* normalMatrices ) {
+    assert( innerRadius > 0.0f );
+    assert( outerRadius > 0.0f );
+    assert( sides > 2 );
+    assert( rings > 2 );
+    assert( instanceCount >= 0 );
 
-    glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+    CSCI441_INTERNAL::drawGeometryInstanced( *CSCI441_INTERNAL::torusGeometry( innerRadius, outerRadius, sides, rings ), instanceCount, modelMatrices, colors, normalMatrices );
 }
 
-inline void CSCI441_INTERNAL::drawTorus( GLfloat innerRadius, GLfloat outerRadius, GLint sides, GLint rings, GLenum renderMode ) {
-    TorusData torusData = { innerRadius, outerRadius, sides, rings };
-    if( CSCI441_INTERNAL::_torusVAO.count( torusData ) == 0 ) {
-        CSCI441_INTERNAL::generateTorusVAO( torusData );
-    }
-
-    glPolygonMode( GL_FRONT_AND_BACK, renderMode );
-    glBindVertexArray( CSCI441_INTERNAL::_torusVAO.find( torusData )->second );
-    glBindBuffer( GL_ARRAY_BUFFER, CSCI441_INTERNAL::_torusVBO.find( torusData )->second );
-    glEnableVertexAttribArray( CSCI441_INTERNAL::AttributeLocations::_positionLocation );
-    glVertexAttribPointer( CSCI441_INTERNAL::AttributeLocations::_positionLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)0 );
-    glEnableVertexAttribArray( CSCI441_INTERNAL::AttributeLocations::_normalLocation );
-    glVertexAttribPointer( CSCI441_INTERNAL::AttributeLocations::_normalLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(GLfloat)*(sides*4*rings)*3) );
-    glEnableVertexAttribArray( CSCI441_INTERNAL::AttributeLocations::_texCoordLocation );
-    glVertexAttribPointer( CSCI441_INTERNAL::AttributeLocations::_texCoordLocation, 2, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(GLfloat)*(sides*4*rings)*6) );
-
-    for( int ringNum = 0; ringNum < rings; ringNum++ ) {
-        glDrawArrays( GL_TRIANGLE_STRIP, ringNum*sides*4, sides*4 );
-    }
+inline void CSCI441::setObjectLODTarget( GLfloat pixelsPerEdge, GLint viewportWidth, GLint viewportHeight ) {
+    assert( pixelsPerEdge > 0.0f );
 
-    glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+    CSCI441_INTERNAL::LODState &lod = CSCI441_INTERNAL::lodState();
+    lod.pixelsPerEdge = pixelsPerEdge;
+    lod.viewportWidth = viewportWidth;
+    lod.viewportHeight = viewportHeight;
 }
 
-inline void CSCI441_INTERNAL::generateCubeVAOFlat( GLfloat sideLength ) {
-    GLuint vaod;
-    glGenVertexArrays( 1, &vaod );
-    glBindVertexArray( vaod );
-
-    GLuint vbod;
-    glGenBuffers( 1, &vbod );
-    glBindBuffer( GL_ARRAY_BUFFER, vbod );
-
-    GLfloat cornerPoint = sideLength / 2.0f;
-
-    GLfloat vertices[36][3] = {
-            // Left Face
-            {-cornerPoint, -cornerPoint, -cornerPoint}, {-cornerPoint, -cornerPoint,  cornerPoint}, {-cornerPoint,  cornerPoint, -cornerPoint},
-            {-cornerPoint,  cornerPoint, -cornerPoint}, {-cornerPoint, -cornerPoint,  cornerPoint}, {-cornerPoint,  cornerPoint,  cornerPoint},
-            // Right Face
-            { cornerPoint,  cornerPoint,  cornerPoint}, { cornerPoint, -cornerPoint,  cornerPoint}, { cornerPoint,  cornerPoint, -cornerPoint},
-            { cornerPoint,  cornerPoint, -cornerPoint}, { cornerPoint, -cornerPoint,  cornerPoint}, { cornerPoint, -cornerPoint, -cornerPoint},
-            // Top Face
-            {-cornerPoint,  cornerPoint, -cornerPoint}, {-cornerPoint,  cornerPoint,  cornerPoint}, { cornerPoint,  cornerPoint, -cornerPoint},
-            { cornerPoint,  cornerPoint, -cornerPoint}, {-cornerPoint,  cornerPoint,  cornerPoint}, { cornerPoint,  cornerPoint,  cornerPoint},
-            // Bottom Face
-            { cornerPoint, -cornerPoint,  cornerPoint}, {-cornerPoint, -cornerPoint,  cornerPoint}, { cornerPoint, -cornerPoint, -cornerPoint},
-            { cornerPoint, -cornerPoint, -cornerPoint}, {-cornerPoint, -cornerPoint,  cornerPoint}, {-cornerPoint, -cornerPoint, -cornerPoint},
-            // Back Face
-            { cornerPoint,  cornerPoint, -cornerPoint}, { cornerPoint, -cornerPoint, -cornerPoint}, {-cornerPoint,  cornerPoint, -cornerPoint},
-            {-cornerPoint,  cornerPoint, -cornerPoint}, { cornerPoint, -cornerPoint, -cornerPoint}, {-cornerPoint, -cornerPoint, -cornerPoint},
-            // Front Face
-            {-cornerPoint, -cornerPoint,  cornerPoint}, { cornerPoint, -cornerPoint,  cornerPoint}, {-cornerPoint,  cornerPoint,  cornerPoint},
-            {-cornerPoint,  cornerPoint,  cornerPoint}, { cornerPoint, -cornerPoint,  cornerPoint}, { cornerPoint,  cornerPoint,  cornerPoint}
-    };
-    GLfloat texCoords[36][2] = {
-            // Left Face
-            {0.0f, 0.0f}, {1.0f, 0.0f}, {0.0f, 1.0f},
-            {0.0f, 1.0f}, {1.0f, 0.0f}, {1.0f, 1.0f},
-            // Right Face
-            {0.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 1.0f},
-            {1.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 0.0f},
-            // Top Face
-            {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 0.0f},
-            {0.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f},
-            // Bottom Face
-            {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 0.0f},
-            {0.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f},
-            // Back Face
-            {0.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 1.0f},
-            {1.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 0.0f},
-            // Front Face
-            {0.0f, 0.0f}, {1.0f, 0.0f}, {0.0f, 1.0f},
-            {0.0f, 1.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}
-    };
-    GLfloat normals[36][3] = {
-            // Left Face
-            {-1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f},
-            {-1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f},
-            // Right Face
-            {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f},
-            {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f},
-            // Top Face
-            {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f},
-            {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f},
-            // Bottom Face
-            {0.0f, -1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {0.0f, -1.0f, 0.0f},
-            {0.0f, -1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {0.0f, -1.0f, 0.0f},
-            // Back Face
-            {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f, -1.0f},
-            {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f, -1.0f},
-            // Front Face
-            {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f},
-            {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}
-    };
+inline void CSCI441::drawSolidCylinderLOD( GLfloat base, GLfloat top, GLfloat height, const GLfloat* mvpMatrix ) {
+    assert( (base >= 0.0f && top > 0.0f) || (base > 0.0f && top >= 0.0f) );
+    assert( height > 0.0f );
 
-    glBufferData( GL_ARRAY_BUFFER, sizeof(GLfloat) * 36 * 8, NULL, GL_STATIC_DRAW );
-    glBufferSubData( GL_ARRAY_BUFFER, 0, sizeof(GLfloat) * 36 * 3, vertices );
-    glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * 36 * 3, sizeof(GLfloat) * 36 * 3, normals );
-    glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * 36 * 6, sizeof(GLfloat) * 36 * 2, texCoords );
+    GLfloat radius = base > top ? base : top;
+    GLfloat pixelsPerUnit = CSCI441_INTERNAL::projectedPixelsPerUnit( mvpMatrix, 0.0f, height/2.0f, 0.0f, sqrt( radius*radius + height*height/4.0f ) );
+    GLint slices = CSCI441_INTERNAL::loopLOD( 2.0f * M_PI * radius, pixelsPerUnit );
+    GLint stacks = CSCI441_INTERNAL::lengthLOD( height, pixelsPerUnit );
 
-    CSCI441_INTERNAL::_cubeVAO.insert( std::pair<GLfloat, GLuint>( sideLength, vaod ) );
-    CSCI441_INTERNAL::_cubeVBO.insert( std::pair<GLfloat, GLuint>( sideLength, vbod ) );
+    CSCI441_INTERNAL::drawGeometry( *CSCI441_INTERNAL::cylinderGeometry( base, top, height, stacks, slices ), GL_FILL );
 }
 
-inline void CSCI441_INTERNAL::generateCubeVAOIndexed( GLfloat sideLength ) {
-    const GLfloat CORNER_POINT = sideLength / 2.0f;
-
-    GLfloat vertices[8][3] = {
-            { -CORNER_POINT, -CORNER_POINT, -CORNER_POINT }, // 0 - bln
-            {  CORNER_POINT, -CORNER_POINT, -CORNER_POINT }, // 1 - brn
-            {  CORNER_POINT,  CORNER_POINT, -CORNER_POINT }, // 2 - trn
-            { -CORNER_POINT,  CORNER_POINT, -CORNER_POINT }, // 3 - tln
-            { -CORNER_POINT, -CORNER_POINT,  CORNER_POINT }, // 4 - blf
-            {  CORNER_POINT, -CORNER_POINT,  CORNER_POINT }, // 5 - brf
-            {  CORNER_POINT,  CORNER_POINT,  CORNER_POINT }, // 6 - trf
-            { -CORNER_POINT,  CORNER_POINT,  CORNER_POINT }  // 7 - tlf
-    };
-    GLfloat normals[8][3] = {
-            {-1, -1, -1}, // 0 LBF
-            {-1,  1, -1}, // 1 LTF
-            { 1, -1, -1}, // 2 RBF
-            { 1,  1, -1}, // 3 RTF
-            {-1, -1,  1}, // 4 LBN
-            {-1,  1,  1}, // 5 LTN
-            { 1, -1,  1}, // 6 RBN
-            { 1,  1,  1}  // 7 RTN
-    };
-    unsigned short indices[36] = {
-            0, 1, 2,   0, 2, 3, // near
-            1, 5, 2,   5, 6, 2, // right
-            2, 6, 7,   3, 2, 7, // top
-            0, 1, 4,   1, 5, 4, // bottom
-            4, 5, 6,   4, 6, 7, // back
-            0, 4, 3,   4, 7, 3  // left
-    };
+inline void CSCI441::drawSolidSphereLOD( GLfloat radius, const GLfloat* mvpMatrix ) {
+    assert( radius > 0.0f );
 
-    GLuint vaod;
-    glGenVertexArrays( 1, &vaod );
-    glBindVertexArray( vaod );
+    GLfloat pixelsPerUnit = CSCI441_INTERNAL::projectedPixelsPerUnit( mvpMatrix, 0.0f, 0.0f, 0.0f, radius );
+    GLint slices = CSCI441_INTERNAL::loopLOD( 2.0f * M_PI * radius, pixelsPerUnit );
 
-    GLuint vbods[2];
-    glGenBuffers( 2, vbods );
+    // stacks only run half way around
+    CSCI441_INTERNAL::drawGeometry( *CSCI441_INTERNAL::sphereGeometry( radius, slices/2, slices ), GL_FILL );
+}
 
-    glBindBuffer( GL_ARRAY_BUFFER, vbods[0] );
-    glBufferData( GL_ARRAY_BUFFER, sizeof(GLfloat) * 8 * 6, nullptr, GL_STATIC_DRAW );
-    glBufferSubData( GL_ARRAY_BUFFER, 0, sizeof(GLfloat) * 8 * 3, vertices );
-    glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * 8 * 3, sizeof(GLfloat) * 8 * 3, normals );
+inline void CSCI441::drawSolidTorusLOD( GLfloat innerRadius, GLfloat outerRadius, const GLfloat* mvpMatrix ) {
+    assert( innerRadius > 0.0f );
+    assert( outerRadius > 0.0f );
 
-    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, vbods[1] );
-    glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW) ;
+    GLfloat pixelsPerUnit = CSCI441_INTERNAL::projectedPixelsPerUnit( mvpMatrix, 0.0f, 0.0f, 0.0f, innerRadius + outerRadius );
+    GLint sides = CSCI441_INTERNAL::loopLOD( 2.0f * M_PI * innerRadius, pixelsPerUnit );
+    GLint rings = CSCI441_INTERNAL::loopLOD( 2.0f * M_PI * (innerRadius + outerRadius), pixelsPerUnit );
 
-    CSCI441_INTERNAL::_cubeVAOIndexed.insert( std::pair<GLfloat, GLuint>( sideLength, vaod ) );
-    CSCI441_INTERNAL::_cubeVBOIndexed.insert( std::pair<GLfloat, GLuint>( sideLength, vbods[0] ) );
+    CSCI441_INTERNAL::drawGeometry( *CSCI441_INTERNAL::torusGeometry( innerRadius, outerRadius, sides, rings ), GL_FILL );
 }
 
-inline void CSCI441_INTERNAL::generateCylinderVAO( CylinderData cylData ) {
-    GLuint vaod;
-    glGenVertexArrays( 1, &vaod );
-    glBindVertexArray( vaod );
-
-    GLuint vbod;
-    glGenBuffers( 1, &vbod );
-    glBindBuffer( GL_ARRAY_BUFFER, vbod );
+////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////
+// Internal function rendering implementations
 
-    unsigned long int numVertices = cylData.st * (cylData.sl+1) * 2;
 
-    GLfloat sliceStep = 2.0 * M_PI / cylData.sl;
-    GLfloat stackStep = cylData.h / cylData.st;
 
-    GLfloat* vertices = (GLfloat*)malloc(sizeof(GLfloat)*numVertices*3);
-    GLfloat* texCoords = (GLfloat*)malloc(sizeof(GLfloat)*numVertices*2);
-    GLfloat* normals = (GLfloat*)malloc(sizeof(GLfloat)*numVertices*3);
+inline void CSCI441_INTERNAL::deleteObjectVAOs() {
+    evictGeometry( 0 );
+}
 
-    unsigned long int idx = 0;
+inline void CSCI441_INTERNAL::deleteObjectVBOs() {
+    evictGeometry( 0 );
+
+    InstanceBufferState &buffer = instanceBuffer();
+    if( buffer.vbo != 0 ) {
+        glDeleteBuffers( 1, &buffer.vbo );
+        CSCI441::ResourceRegistry::releaseBuffer( buffer.vbo );
+        buffer.vbo = 0;
+        buffer.capacity = 0;
+    }
+}
 
-    for( int stackNum = 0; stackNum < cylData.st; stackNum++ ) {
-        GLfloat botRadius = cylData.b*(cylData.st-stackNum)/cylData.st + cylData.t*stackNum/cylData.st;
-        GLfloat topRadius = cylData.b*(cylData.st-stackNum-1)/cylData.st + cylData.t*(stackNum+1)/cylData.st;
+inline void CSCI441_INTERNAL::drawCube( GLfloat sideLength, GLenum renderMode ) {
+    drawCubeIndexed(sideLength, renderMode);
+}
 
-        for( int sliceNum = 0; sliceNum <= cylData.sl; sliceNum++ ) {
-            normals[ idx*3 + 0 ] = cos( sliceNum * sliceStep );
-            normals[ idx*3 + 1 ] = 0.0f;
-            normals[ idx*3 + 2 ] = sin( sliceNum * sliceStep );
+inline void CSCI441_INTERNAL::drawCubeFlat( GLfloat sideLength, GLenum renderMode ) {
+    drawGeometry( *cubeFlatGeometry( sideLength ), renderMode );
+}
 
-            texCoords[ idx*2 + 0 ] = (GLfloat)sliceNum / cylData.sl;
-            texCoords[ idx*2 + 1 ] = (GLfloat)stackNum / cylData.st;
+inline void CSCI441_INTERNAL::drawCubeIndexed( GLfloat sideLength, GLenum renderMode ) {
+    drawGeometry( *cubeGeometry( sideLength ), renderMode );
+}
 
-            vertices[ idx*3 + 0 ] = cos( sliceNum * sliceStep )*botRadius;
-            vertices[ idx*3 + 1 ] = stackNum * stackStep;
-            vertices[ idx*3 + 2 ] = sin( sliceNum * sliceStep )*botRadius;
+inline void CSCI441_INTERNAL::drawCylinder( GLfloat base, GLfloat top, GLfloat height, GLint stacks, GLint slices, GLenum renderMode ) {
+    drawGeometry( *cylinderGeometry( base, top, height, stacks, slices ), renderMode );
+}
 
-            idx++;
+inline void CSCI441_INTERNAL::drawPartialDisk( GLfloat inner, GLfloat outer, GLint slices, GLint rings, GLfloat start, GLfloat sweep, GLenum renderMode ) {
+    drawGeometry( *diskGeometry( inner, outer, start, sweep, slices, rings ), renderMode );
+}
 
-            normals[ idx*3 + 0 ] = cos( sliceNum * sliceStep );
-            normals[ idx*3 + 1 ] = 0.0f;
-            normals[ idx*3 + 2 ] = sin( sliceNum * sliceStep );
+inline void CSCI441_INTERNAL::drawSphere( GLfloat radius, GLint stacks, GLint slices, GLenum renderMode ) {
+    drawGeometry( *sphereGeometry( radius, stacks, slices ), renderMode );
+}
 
-            texCoords[ idx*2 + 0 ] = (GLfloat)sliceNum / cylData.sl;
-            texCoords[ idx*2 + 1 ] = (GLfloat)(stackNum+1) / cylData.st;
+inline void CSCI441_INTERNAL::drawTorus( GLfloat innerRadius, GLfloat outerRadius, GLint sides, GLint rings, GLenum renderMode ) {
+    drawGeometry( *torusGeometry( innerRadius, outerRadius, sides, rings ), renderMode );
+}
 
-            vertices[ idx*3 + 0 ] = cos( sliceNum * sliceStep )*topRadius;
-            vertices[ idx*3 + 1 ] = (stackNum+1) * stackStep;
-            vertices[ idx*3 + 2 ] = sin( sliceNum * sliceStep )*topRadius;
+inline CSCI441_INTERNAL::CachedGeometry* CSCI441_INTERNAL::cubeFlatGeometry( GLfloat sideLength ) {
+    GeometryKey key = { CUBE_FLAT_GEOMETRY, { quantizeGeometryParameter( sideLength ), 0, 0, 0, 0, 0 } };
+    CachedGeometry* geometry = findGeometry( key );
+    if( geometry == NULL ) {
+        geometry = insertGeometry( key, generateCubeVAOFlat( sideLength ) );
+    }
+    return geometry;
+}
 
-            idx++;
-        }
+inline CSCI441_INTERNAL::CachedGeometry* CSCI441_INTERNAL::cubeGeometry( GLfloat sideLength ) {
+    GeometryKey key = { CUBE_INDEXED_GEOMETRY, { quantizeGeometryParameter( sideLength ), 0, 0, 0, 0, 0 } };
+    CachedGeometry* geometry = findGeometry( key );
+    if( geometry == NULL ) {
+        geometry = insertGeometry( key, generateCubeVAOIndexed( sideLength ) );
     }
+    return geometry;
+}
 
-    glBufferData( GL_ARRAY_BUFFER, sizeof(GLfloat) * numVertices * 8, NULL, GL_STATIC_DRAW );
-    glBufferSubData( GL_ARRAY_BUFFER, 0, 								 sizeof(GLfloat) * numVertices * 3, vertices );
-    glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * numVertices * 3, sizeof(GLfloat) * numVertices * 3, normals );
-    glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * numVertices * 6, sizeof(GLfloat) * numVertices * 2, texCoords );
+inline CSCI441_INTERNAL::CachedGeometry* CSCI441_INTERNAL::cylinderGeometry( GLfloat base, GLfloat top, GLfloat height, GLint stacks, GLint slices ) {
+    GeometryKey key = { CYLINDER_GEOMETRY, { quantizeGeometryParameter( base ), quantizeGeometryParameter( top ), quantizeGeometryParameter( height ), stacks, slices, 0 } };
+    CachedGeometry* geometry = findGeometry( key );
+    if( geometry == NULL ) {
+        geometry = insertGeometry( key, generateCylinderVAO( base, top, height, stacks, slices ) );
+    }
+    return geometry;
+}
 
-    CSCI441_INTERNAL::_cylinderVAO.insert( std::pair<CylinderData, GLuint>( cylData, vaod ) );
-    CSCI441_INTERNAL::_cylinderVBO.insert( std::pair<CylinderData, GLuint>( cylData, vbod ) );
+inline CSCI441_INTERNAL::CachedGeometry* CSCI441_INTERNAL::diskGeometry( GLfloat inner, GLfloat outer, GLfloat start, GLfloat sweep, GLint slices, GLint rings ) {
+    GeometryKey key = { DISK_GEOMETRY, { quantizeGeometryParameter( inner ), quantizeGeometryParameter( outer ), quantizeGeometryParameter( start ), quantizeGeometryParameter( sweep ), slices, rings } };
+    CachedGeometry* geometry = findGeometry( key );
+    if( geometry == NULL ) {
+        geometry = insertGeometry( key, generateDiskVAO( inner, outer, start, sweep, slices, rings ) );
+    }
+    return geometry;
 }
 
-inline void CSCI441_INTERNAL::generateDiskVAO( DiskData diskData ) {
-    GLuint vaod;
-    glGenVertexArrays( 1, &vaod );
-    glBindVertexArray( vaod );
+inline CSCI441_INTERNAL::CachedGeometry* CSCI441_INTERNAL::sphereGeometry( GLfloat radius, GLint stacks, GLint slices ) {
+    GeometryKey key = { SPHERE_GEOMETRY, { quantizeGeometryParameter( radius ), stacks, slices, 0, 0, 0 } };
+    CachedGeometry* geometry = findGeometry( key );
+    if( geometry == NULL ) {
+        geometry = insertGeometry( key, generateSphereVAO( radius, stacks, slices ) );
+    }
+    return geometry;
+}
 
-    GLuint vbod;
-    glGenBuffers( 1, &vbod );
-    glBindBuffer( GL_ARRAY_BUFFER, vbod );
+inline CSCI441_INTERNAL::CachedGeometry* CSCI441_INTERNAL::torusGeometry( GLfloat innerRadius, GLfloat outerRadius, GLint sides, GLint rings ) {
+    GeometryKey key = { TORUS_GEOMETRY, { quantizeGeometryParameter( innerRadius ), quantizeGeometryParameter( outerRadius ), sides, rings, 0, 0 } };
+    CachedGeometry* geometry = findGeometry( key );
+    if( geometry == NULL ) {
+        geometry = insertGeometry( key, generateTorusVAO( innerRadius, outerRadius, sides, rings ) );
+    }
+    return geometry;
+}
 
-    unsigned long int numVertices = diskData.r * (diskData.sl+1) * 2;
+inline GLenum CSCI441_INTERNAL::indexType( unsigned long int numVertices ) {
+    // the largest index of each type is kept free for the restart index
+    return numVertices < 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
 
-    GLfloat sliceStep = diskData.sw / diskData.sl;
-    GLfloat ringStep = (diskData.o - diskData.i) / diskData.r;
+inline GLuint CSCI441_INTERNAL::restartIndex( GLenum indexType ) {
+    return indexType == GL_UNSIGNED_SHORT ? 0xFFFF : 0xFFFFFFFF;
+}
 
-    GLfloat* vertices = (GLfloat*)malloc(sizeof(GLfloat)*numVertices*3);
-    GLfloat* texCoords = (GLfloat*)malloc(sizeof(GLfloat)*numVertices*2);
-    GLfloat* normals = (GLfloat*)malloc(sizeof(GLfloat)*numVertices*3);
+inline CSCI441_INTERNAL::GeometryCacheState& CSCI441_INTERNAL::geometryCache() {
+    static GeometryCacheState cache;
+    return cache;
+}
 
-    unsigned long int idx = 0;
+inline long long CSCI441_INTERNAL::quantizeGeometryParameter( GLfloat value ) {
+    // same tolerance the ordered map comparisons used
+    return llround( value * 1000000.0 );
+}
 
-    for( int ringNum = 0; ringNum < diskData.r; ringNum++ ) {
-        GLfloat currRadius = diskData.i + ringNum*ringStep;
-        GLfloat nextRadius = diskData.i + (ringNum+1)*ringStep;
+inline CSCI441_INTERNAL::CachedGeometry* CSCI441_INTERNAL::findGeometry( const GeometryKey &key ) {
+    GeometryCacheState &cache = geometryCache();
 
-        GLfloat theta = diskData.st;
-        for( int i = 0; i <= diskData.sl; i++, theta += sliceStep ) {
-            normals[ idx*3 + 0 ] = 0.0f;
-            normals[ idx*3 + 1 ] = 0.0f;
-            normals[ idx*3 + 2 ] = 1.0f;
+    std::unordered_map< GeometryKey, CachedGeometry, GeometryKeyHash >::iterator iter = cache.entries.find( key );
+    if( iter == cache.entries.end() ) {
+        cache.misses++;
+        return NULL;
+    }
 
-            texCoords[ idx*2 + 0 ] = cos(theta)*(currRadius/diskData.o);
-            texCoords[ idx*2 + 1 ] = sin(theta)*(currRadius/diskData.o);
+    cache.hits++;
+    cache.lru.splice( cache.lru.begin(), cache.lru, iter->second.lruPosition );
+    return &(iter->second);
+}
 
-            vertices[ idx*3 + 0 ] = cos(theta)*currRadius;
-            vertices[ idx*3 + 1 ] = sin(theta)*currRadius;
-            vertices[ idx*3 + 2 ] = 0.0f;
+inline CSCI441_INTERNAL::CachedGeometry* CSCI441_INTERNAL::insertGeometry( const GeometryKey &key, const CachedGeometry &geometry ) {
+    GeometryCacheState &cache = geometryCache();
 
-            idx++;
+    // make room first so the new entry is never the one evicted
+    evictGeometry( cache.budget > geometry.byteSize ? cache.budget - geometry.byteSize : 0 );
 
-            normals[ idx*3 + 0 ] = 0.0f;
-            normals[ idx*3 + 1 ] = 0.0f;
-            normals[ idx*3 + 2 ] = 1.0f;
+    cache.lru.push_front( key );
+    CachedGeometry &entry = cache.entries[ key ];
+    entry = geometry;
+    entry.lruPosition = cache.lru.begin();
+    cache.bytes += geometry.byteSize;
 
-            texCoords[ idx*2 + 0 ] = cos(theta)*(nextRadius/diskData.o);
-            texCoords[ idx*2 + 1 ] = sin(theta)*(nextRadius/diskData.o);
+    return &entry;
+}
 
-            vertices[ idx*3 + 0 ] = cos(theta)*nextRadius;
-            vertices[ idx*3 + 1 ] = sin(theta)*nextRadius;
-            vertices[ idx*3 + 2 ] = 0.0f;
+inline void CSCI441_INTERNAL::evictGeometry( size_t budget ) {
+    GeometryCacheState &cache = geometryCache();
 
-            idx++;
-        }
+    while( cache.bytes > budget && !cache.lru.empty() ) {
+        std::unordered_map< GeometryKey, CachedGeometry, GeometryKeyHash >::iterator iter = cache.entries.find( cache.lru.back() );
+        cache.bytes -= iter->second.byteSize;
+        deleteGeometry( iter->second );
+        cache.entries.erase( iter );
+        cache.lru.pop_back();
+        cache.evictions++;
     }
-
-    glBufferData( GL_ARRAY_BUFFER, sizeof(GLfloat) * numVertices * 8, NULL, GL_STATIC_DRAW );
-    glBufferSubData( GL_ARRAY_BUFFER, 0, 																  sizeof(GLfloat) * numVertices * 3, vertices );
-    glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * numVertices * 3, sizeof(GLfloat) * numVertices * 3, normals );
-    glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * numVertices * 6, sizeof(GLfloat) * numVertices * 2, texCoords );
-
-    CSCI441_INTERNAL::_diskVAO.insert( std::pair<DiskData, GLuint>( diskData, vaod ) );
-    CSCI441_INTERNAL::_diskVBO.insert( std::pair<DiskData, GLuint>( diskData, vbod ) );
 }
 
-inline void CSCI441_INTERNAL::generateSphereVAO( SphereData sphereData ) {
-    GLuint vaod;
-    glGenVertexArrays( 1, &vaod );
-    glBindVertexArray( vaod );
-
-    GLuint vbod;
-    glGenBuffers( 1, &vbod );
-    glBindBuffer( GL_ARRAY_BUFFER, vbod );
-
-    unsigned long int numVertices = (sphereData.sl + 2)*2 + ((sphereData.st - 2)*(sphereData.sl+1))*2;
-
-    GLfloat sliceStep = 2.0 * M_PI / sphereData.sl;
-    GLfloat stackStep = M_PI / sphereData.st;
-
-    GLfloat* vertices = (GLfloat*)malloc(sizeof(GLfloat)*numVertices*3);
-    GLfloat* texCoords = (GLfloat*)malloc(sizeof(GLfloat)*numVertices*2);
-    GLfloat* normals = (GLfloat*)malloc(sizeof(GLfloat)*numVertices*3);
-
-    unsigned long int idx = 0;
+inline void CSCI441_INTERNAL::deleteGeometry( CachedGeometry &geometry ) {
+    glDeleteVertexArrays( 1, &geometry.vao );
+    glDeleteBuffers( 1, &geometry.vbo );
+    CSCI441::ResourceRegistry::releaseBuffer( geometry.vbo );
+    if( geometry.ibo != 0 ) {
+        glDeleteBuffers( 1, &geometry.ibo );
+        CSCI441::ResourceRegistry::releaseBuffer( geometry.ibo );
+    }
+}
 
-    // sphere top
-    GLfloat phi = stackStep * sphereData.st;
-    GLfloat phiNext = stackStep * (sphereData.st-1);
+inline void CSCI441_INTERNAL::drawGeometry( CachedGeometry &geometry, GLenum renderMode, GLsizei instanceCount ) {
+    if( DrawCallbacks::_beforeDraw ) DrawCallbacks::_beforeDraw();
+    glPolygonMode( GL_FRONT_AND_BACK, renderMode );
+    glBindVertexArray( geometry.vao );
+    if( geometry.primitiveRestart ) {
+        glEnable( GL_PRIMITIVE_RESTART );
+        glPrimitiveRestartIndex( restartIndex( geometry.indexType ) );
+    }
 
-    normals[ idx*3 + 0 ] = 0.0f;
-    normals[ idx*3 + 1 ] = 1.0f;
-    normals[ idx*3 + 2 ] = 0.0f;
+    // the VAO keeps its attribute pointers, so they only need setting when the locations change
+    if( geometry.positionLocation != AttributeLocations::_positionLocation
+        || geometry.normalLocation != AttributeLocations::_normalLocation
+        || geometry.texCoordLocation != AttributeLocations::_texCoordLocation ) {
+        glBindBuffer( GL_ARRAY_BUFFER, geometry.vbo );
+        glEnableVertexAttribArray( AttributeLocations::_positionLocation );
+        glVertexAttribPointer( AttributeLocations::_positionLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)0 );
+        glEnableVertexAttribArray( AttributeLocations::_normalLocation );
+        glVertexAttribPointer( AttributeLocations::_normalLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)geometry.normalOffset );
+        if( geometry.texCoordOffset >= 0 ) {
+            glEnableVertexAttribArray( AttributeLocations::_texCoordLocation );
+            glVertexAttribPointer( AttributeLocations::_texCoordLocation, 2, GL_FLOAT, GL_FALSE, 0, (void*)geometry.texCoordOffset );
+        }
 
-    texCoords[ idx*2 + 0 ] = 0.5f;
-    texCoords[ idx*2 + 1 ] = 1.0f;
+        geometry.positionLocation = AttributeLocations::_positionLocation;
+        geometry.normalLocation = AttributeLocations::_normalLocation;
+        geometry.texCoordLocation = AttributeLocations::_texCoordLocation;
+    }
 
-    vertices[ idx*3 + 0 ] = 0.0f;
-    vertices[ idx*3 + 1 ] = -cos( phi )*sphereData.r;
-    vertices[ idx*3 + 2 ] = 0.0f;
+    if( geometry.indexType == GL_NONE ) {
+        for( int stripNum = 0; stripNum < geometry.numStrips; stripNum++ ) {
+            if( instanceCount > 0 ) {
+                glDrawArraysInstanced( geometry.primitive, geometry.stripLength*stripNum, geometry.stripLength, instanceCount );
+            } else {
+                glDrawArrays( geometry.primitive, geometry.stripLength*stripNum, geometry.stripLength );
+            }
+        }
+    } else {
+        unsigned long int indexSize = (geometry.indexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint));
+        for( int stripNum = 0; stripNum < geometry.numStrips; stripNum++ ) {
+            if( instanceCount > 0 ) {
+                glDrawElementsInstanced( geometry.primitive, geometry.stripLength, geometry.indexType, (void*)(indexSize * geometry.stripLength * stripNum), instanceCount );
+            } else {
+                glDrawElements( geometry.primitive, geometry.stripLength, geometry.indexType, (void*)(indexSize * geometry.stripLength * stripNum) );
+            }
+        }
+    }
 
-    idx++;
+    if( geometry.primitiveRestart ) {
+        glDisable( GL_PRIMITIVE_RESTART );
+    }
+    glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+}
 
-    for( int sliceNum = sphereData.sl; sliceNum >= 0; sliceNum-- ) {
-        GLfloat theta = sliceStep * sliceNum;
+inline CSCI441_INTERNAL::InstanceBufferState& CSCI441_INTERNAL::instanceBuffer() {
+    static InstanceBufferState buffer;
+    return buffer;
+}
 
-        normals[ idx*3 + 0 ] = -cos( theta )*sin( phiNext );
-        normals[ idx*3 + 1 ] = -cos( phiNext );
-        normals[ idx*3 + 2 ] = sin( theta )*sin( phiNext );
+inline void CSCI441_INTERNAL::drawGeometryInstanced( CachedGeometry &geometry, GLsizei instanceCount, const GLfloat* modelMatrices, const GLfloat* colors, const GLfloat* normalMatrices ) {
+    if( instanceCount == 0 ) return;
 
-        texCoords[ idx*2 + 0 ] = (sphereData.st-1.0f) / sphereData.st;
-        texCoords[ idx*2 + 1 ] = sliceNum / sphereData.sl;
+    GLint matrixLocation = AttributeLocations::_instanceModelMatrixLocation;
+    GLint colorLocation = (colors != nullptr ? AttributeLocations::_instanceColorLocation : -1);
+    GLint normalLocation = (normalMatrices != nullptr ? AttributeLocations::_instanceNormalMatrixLocation : -1);
+    assert( matrixLocation >= 0 );
 
-        vertices[ idx*3 + 0 ] = -cos( theta )*sin( phiNext )*sphereData.r;
-        vertices[ idx*3 + 1 ] = -cos( phiNext )*sphereData.r;
-        vertices[ idx*3 + 2 ] = sin( theta )*sin( phiNext )*sphereData.r;
+    // matrices for every instance followed by their colors and then their normal matrices
+    size_t matrixBytes = sizeof(GLfloat) * 16 * instanceCount;
+    size_t colorBytes = (colorLocation >= 0 ? sizeof(GLfloat) * 3 * instanceCount : 0);
+    size_t normalBytes = (normalLocation >= 0 ? sizeof(GLfloat) * 9 * instanceCount : 0);
 
-        idx++;
+    InstanceBufferState &buffer = instanceBuffer();
+    if( buffer.vbo == 0 ) {
+        glGenBuffers( 1, &buffer.vbo );
+    }
+    glBindBuffer( GL_ARRAY_BUFFER, buffer.vbo );
+    size_t totalBytes = matrixBytes + colorBytes + normalBytes;
+    if( totalBytes > buffer.capacity ) {
+        buffer.capacity = (totalBytes > buffer.capacity * 2 ? totalBytes : buffer.capacity * 2);
+        CSCI441::ResourceRegistry::registerBuffer( buffer.vbo, GL_ARRAY_BUFFER, buffer.capacity, "CSCI441::objects", "instances" );
+    }
+    // orphan the previous contents so the upload does not wait on draws still reading them
+    glBufferData( GL_ARRAY_BUFFER, buffer.capacity, NULL, GL_STREAM_DRAW );
+    glBufferSubData( GL_ARRAY_BUFFER, 0, matrixBytes, modelMatrices );
+    if( colorBytes > 0 ) {
+        glBufferSubData( GL_ARRAY_BUFFER, matrixBytes, colorBytes, colors );
+    }
+    if( normalBytes > 0 ) {
+        glBufferSubData( GL_ARRAY_BUFFER, matrixBytes + colorBytes, normalBytes, normalMatrices );
     }
 
-    // sphere stacks
-    for( int stackNum = 1; stackNum < sphereData.st-1; stackNum++ ) {
-        phi = stackStep * stackNum;
-        phiNext = stackStep * (stackNum + 1);
-
-        for( int sliceNum = sphereData.sl; sliceNum >= 0; sliceNum-- ) {
-            GLfloat theta = sliceStep * sliceNum;
-
-            normals[ idx*3 + 0 ] = -cos( theta )*sin( phi );
-            normals[ idx*3 + 1 ] = -cos( phi );
-            normals[ idx*3 + 2 ] =  sin( theta )*sin( phi );
-
-            texCoords[ idx*2 + 0 ] = theta / 6.28;
-            texCoords[ idx*2 + 1 ] = phi / 3.14;
+    glBindVertexArray( geometry.vao );
+    for( int column = 0; column < 4; column++ ) {
+        glEnableVertexAttribArray( matrixLocation + column );
+        glVertexAttribPointer( matrixLocation + column, 4, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * 16, (void*)(sizeof(GLfloat) * 4 * column) );
+        glVertexAttribDivisor( matrixLocation + column, 1 );
+    }
+    if( colorLocation >= 0 ) {
+        glEnableVertexAttribArray( colorLocation );
+        glVertexAttribPointer( colorLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)matrixBytes );
+        glVertexAttribDivisor( colorLocation, 1 );
+    }
+    if( normalLocation >= 0 ) {
+        for( int column = 0; column < 3; column++ ) {
+            glEnableVertexAttribArray( normalLocation + column );
+            glVertexAttribPointer( normalLocation + column, 3, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * 9, (void*)(matrixBytes + colorBytes + sizeof(GLfloat) * 3 * column) );
+            glVertexAttribDivisor( normalLocation + column, 1 );
+        }
+    }
 
-            vertices[ idx*3 + 0 ] = -cos( theta )*sin( phi )*sphereData.r;
-            vertices[ idx*3 + 1 ] = -cos( phi )*sphereData.r;
-            vertices[ idx*3 + 2 ] = sin( theta )*sin( phi )*sphereData.r;
+    drawGeometry( geometry, GL_FILL, instanceCount );
 
-            idx++;
+    // leave the VAO as the non-instanced draws expect it
+    glBindVertexArray( geometry.vao );
+    for( int column = 0; column < 4; column++ ) {
+        glVertexAttribDivisor( matrixLocation + column, 0 );
+        glDisableVertexAttribArray( matrixLocation + column );
+    }
+    if( colorLocation >= 0 ) {
+        glVertexAttribDivisor( colorLocation, 0 );
+        glDisableVertexAttribArray( colorLocation );
+    }
+    if( normalLocation >= 0 ) {
+        for( int column = 0; column < 3; column++ ) {
+            glVertexAttribDivisor( normalLocation + column, 0 );
+            glDisableVertexAttribArray( normalLocation + column );
+        }
+    }
+}
 
-            normals[ idx*3 + 0 ] = -cos( theta )*sin( phiNext );
-            normals[ idx*3 + 1 ] = -cos( phiNext );
-            normals[ idx*3 + 2 ] =  sin( theta )*sin( phiNext );
+inline CSCI441_INTERNAL::LODState& CSCI441_INTERNAL::lodState() {
+    static LODState lod;
+    return lod;
+}
 
-            texCoords[ idx*2 + 0 ] = theta / 6.28;
-            texCoords[ idx*2 + 1 ] = phiNext / 3.14;
+inline GLfloat CSCI441_INTERNAL::projectedPixelsPerUnit( const GLfloat* mvpMatrix, GLfloat centerX, GLfloat centerY, GLfloat centerZ, GLfloat boundingRadius ) {
+    const GLfloat NEAR_CAMERA = 1e30f;
 
-            vertices[ idx*3 + 0 ] = -cos( theta )*sin( phiNext )*sphereData.r;
-            vertices[ idx*3 + 1 ] = -cos( phiNext )*sphereData.r;
-            vertices[ idx*3 + 2 ] = sin( theta )*sin( phiNext )*sphereData.r;
+    LODState &lod = lodState();
+    GLfloat halfWidth = lod.viewportWidth / 2.0f, halfHeight = lod.viewportHeight / 2.0f;
+    if( lod.viewportWidth <= 0 || lod.viewportHeight <= 0 ) {
+        GLint viewport[4];
+        glGetIntegerv( GL_VIEWPORT, viewport );
+        halfWidth = viewport[2] / 2.0f;
+        halfHeight = viewport[3] / 2.0f;
+    }
 
-            idx++;
+    // project the center and a point one bounding radius along each model axis,
+    // and keep the longest offset in pixels
+    GLfloat point[4][3] = {
+            { centerX, centerY, centerZ },
+            { centerX + boundingRadius, centerY, centerZ },
+            { centerX, centerY + boundingRadius, centerZ },
+            { centerX, centerY, centerZ + boundingRadius }
+    };
+    GLfloat screen[4][2];
+    for( int p = 0; p < 4; p++ ) {
+        GLfloat clip[4];
+        for( int row = 0; row < 4; row++ ) {
+            clip[row] = mvpMatrix[row] * point[p][0] + mvpMatrix[4 + row] * point[p][1] + mvpMatrix[8 + row] * point[p][2] + mvpMatrix[12 + row];
         }
+        // the camera is inside or behind the object, so it may cover the whole screen
+        if( clip[3] <= boundingRadius * 1e-3f ) return NEAR_CAMERA;
+        screen[p][0] = clip[0] / clip[3] * halfWidth;
+        screen[p][1] = clip[1] / clip[3] * halfHeight;
     }
 
-    // sphere bottom
-    phi = 0;
-    phiNext = stackStep;
-
-    normals[ idx*3 + 0 ] =  0.0f;
-    normals[ idx*3 + 1 ] = -1.0f;
-    normals[ idx*3 + 2 ] =  0.0f;
+    GLfloat longest = 0.0f;
+    for( int p = 1; p < 4; p++ ) {
+        GLfloat dx = screen[p][0] - screen[0][0], dy = screen[p][1] - screen[0][1];
+        GLfloat length = sqrt( dx*dx + dy*dy );
+        if( length > longest ) longest = length;
+    }
+    return longest / boundingRadius;
+}
 
-    texCoords[ idx*2 + 0 ] = 0.5f;
-    texCoords[ idx*2 + 1 ] = 0.0f;
+inline GLint CSCI441_INTERNAL::loopLOD( GLfloat circumference, GLfloat pixelsPerUnit ) {
+    static const GLint TIERS[] = { 8, 12, 16, 24, 32, 48, 64 };
+    const int NUM_TIERS = sizeof(TIERS) / sizeof(TIERS[0]);
 
-    vertices[ idx*3 + 0 ] = 0.0f;
-    vertices[ idx*3 + 1 ] = -cos( phi )*sphereData.r;
-    vertices[ idx*3 + 2 ] = 0.0f;
+    GLfloat segments = circumference * pixelsPerUnit / lodState().pixelsPerEdge;
+    for( int i = 0; i < NUM_TIERS; i++ ) {
+        if( segments <= TIERS[i] ) return TIERS[i];
+    }
+    return TIERS[ NUM_TIERS-1 ];
+}
 
-    idx++;
+inline GLint CSCI441_INTERNAL::lengthLOD( GLfloat length, GLfloat pixelsPerUnit ) {
+    static const GLint TIERS[] = { 1, 2, 4, 8, 16, 32 };
+    const int NUM_TIERS = sizeof(TIERS) / sizeof(TIERS[0]);
 
-    for( int sliceNum = sphereData.sl; sliceNum >= 0; sliceNum-- ) {
-        GLfloat theta = sliceStep * sliceNum;
+    GLfloat segments = length * pixelsPerUnit / lodState().pixelsPerEdge;
+    for( int i = 0; i < NUM_TIERS; i++ ) {
+        if( segments <= TIERS[i] ) return TIERS[i];
+    }
+    return TIERS[ NUM_TIERS-1 ];
+}
 
-        normals[ idx*3 + 0 ] = -cos( theta )*sin( phiNext );
-        normals[ idx*3 + 1 ] = -cos( phiNext );
-        normals[ idx*3 + 2 ] = sin( theta )*sin( phiNext );
+inline CSCI441_INTERNAL::CachedGeometry CSCI441_INTERNAL::generateCubeVAOFlat( GLfloat sideLength ) {
+    return CSCI441_INTERNAL::uploadMesh( CSCI441::generateCubeFlatMesh( sideLength ), "cube" );
+}
 
-        texCoords[ idx*2 + 0 ] = 1.0f / sphereData.st;
-        texCoords[ idx*2 + 1 ] = sliceNum / sphereData.sl;
+inline CSCI441_INTERNAL::CachedGeometry CSCI441_INTERNAL::generateCubeVAOIndexed( GLfloat sideLength ) {
+    return CSCI441_INTERNAL::uploadMesh( CSCI441::generateCubeIndexedMesh( sideLength ), "cube" );
+}
 
-        vertices[ idx*3 + 0 ] = -cos( theta )*sin( phiNext )*sphereData.r;
-        vertices[ idx*3 + 1 ] = -cos( phiNext )*sphereData.r;
-        vertices[ idx*3 + 2 ] = sin( theta )*sin( phiNext )*sphereData.r;
+inline CSCI441_INTERNAL::CachedGeometry CSCI441_INTERNAL::generateCylinderVAO( GLfloat base, GLfloat top, GLfloat height, GLint stacks, GLint slices ) {
+    return CSCI441_INTERNAL::uploadMesh( CSCI441::generateCylinderMesh( base, top, height, stacks, slices ), "cylinder" );
+}
 
-        idx++;
-    }
+inline CSCI441_INTERNAL::CachedGeometry CSCI441_INTERNAL::generateDiskVAO( GLfloat inner, GLfloat outer, GLfloat start, GLfloat sweep, GLint slices, GLint rings ) {
+    return CSCI441_INTERNAL::uploadMesh( CSCI441::generateDiskMesh( inner, outer, start, sweep, slices, rings ), "disk" );
+}
 
-    glBufferData( GL_ARRAY_BUFFER, sizeof(GLfloat) * numVertices * 8, NULL, GL_STATIC_DRAW );
-    glBufferSubData( GL_ARRAY_BUFFER, 0, 																  sizeof(GLfloat) * numVertices * 3, vertices );
-    glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * numVertices * 3, sizeof(GLfloat) * numVertices * 3, normals );
-    glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * numVertices * 6, sizeof(GLfloat) * numVertices * 2, texCoords );
+inline CSCI441_INTERNAL::CachedGeometry CSCI441_INTERNAL::generateSphereVAO( GLfloat radius, GLint stacks, GLint slices ) {
+    return CSCI441_INTERNAL::uploadMesh( CSCI441::generateSphereMesh( radius, stacks, slices ), "sphere" );
+}
 
-    CSCI441_INTERNAL::_sphereVAO.insert( std::pair<SphereData, GLuint>( sphereData, vaod ) );
-    CSCI441_INTERNAL::_sphereVBO.insert( std::pair<SphereData, GLuint>( sphereData, vbod ) );
+inline CSCI441_INTERNAL::CachedGeometry CSCI441_INTERNAL::generateTorusVAO( GLfloat innerRadius, GLfloat outerRadius, GLint sides, GLint rings ) {
+    return CSCI441_INTERNAL::uploadMesh( CSCI441::generateTorusMesh( innerRadius, outerRadius, sides, rings ), "torus" );
 }
 
-inline void CSCI441_INTERNAL::generateTorusVAO( TorusData torusData ) {
+inline CSCI441_INTERNAL::CachedGeometry CSCI441_INTERNAL::uploadMesh( const CSCI441::MeshData &mesh, const char* label ) {
     GLuint vaod;
     glGenVertexArrays( 1, &vaod );
     glBindVertexArray( vaod );
@@ -1201,86 +1336,91 @@ inline void CSCI441_INTERNAL::generateTorusVAO( TorusData torusData ) {
     glGenBuffers( 1, &vbod );
     glBindBuffer( GL_ARRAY_BUFFER, vbod );
 
-    unsigned long int numVertices = torusData.s * 4 * torusData.r;
-
-    GLfloat* vertices = (GLfloat*)malloc(sizeof(GLfloat)*numVertices*3);
-    GLfloat* texCoords = (GLfloat*)malloc(sizeof(GLfloat)*numVertices*2);
-    GLfloat* normals = (GLfloat*)malloc(sizeof(GLfloat)*numVertices*3);
-
-    unsigned long int idx = 0;
-
-    GLfloat sideStep = 2.0 * M_PI / torusData.s;
-    GLfloat ringStep = 2.0 * M_PI / torusData.r;
-
-    for( int ringNum = 0; ringNum < torusData.r; ringNum++ ) {
-        GLfloat currTheta = ringStep * ringNum;
-        GLfloat nextTheta = ringStep * (ringNum+1);
-
-        for( int sideNum = 0; sideNum < torusData.s; sideNum++ ) {
-            GLfloat currPhi = sideStep * sideNum;
-            GLfloat nextPhi = sideStep * (sideNum+1);
-
-            normals[ idx*3 + 0 ] = cos( currPhi ) * cos( currTheta );
-            normals[ idx*3 + 1 ] = cos( currPhi ) * sin( currTheta );
-            normals[ idx*3 + 2 ] = sin( currPhi );
-
-            texCoords[ idx*2 + 0 ] = cos( currPhi ) * cos( currTheta );
-            texCoords[ idx*2 + 1 ] = cos( currPhi ) * sin( currTheta );
-
-            vertices[ idx*3 + 0 ] = ( torusData.o + torusData.i * cos( currPhi ) ) * cos( currTheta );
-            vertices[ idx*3 + 1 ] = ( torusData.o + torusData.i * cos( currPhi ) ) * sin( currTheta );
-            vertices[ idx*3 + 2 ] = torusData.i * sin( currPhi );
-
-            idx++;
-
-            normals[ idx*3 + 0 ] = cos( currPhi ) * cos( nextTheta );
-            normals[ idx*3 + 1 ] = cos( currPhi ) * sin( nextTheta );
-            normals[ idx*3 + 2 ] = sin( currPhi );
-
-            texCoords[ idx*2 + 0 ] = cos( currPhi ) * cos( nextTheta );
-            texCoords[ idx*2 + 1 ] = cos( currPhi ) * sin( nextTheta );
-
-            vertices[ idx*3 + 0 ] = ( torusData.o + torusData.i * cos( currPhi ) ) * cos( nextTheta );
-            vertices[ idx*3 + 1 ] = ( torusData.o + torusData.i * cos( currPhi ) ) * sin( nextTheta );
-            vertices[ idx*3 + 2 ] = torusData.i * sin( currPhi );
-
-            idx++;
-
-            normals[ idx*3 + 0 ] = cos( nextPhi ) * cos( currTheta );
-            normals[ idx*3 + 1 ] = cos( nextPhi ) * sin( currTheta );
-            normals[ idx*3 + 2 ] = sin( nextPhi );
-
-            texCoords[ idx*2 + 0 ] = cos( nextPhi ) * cos( currTheta );
-            texCoords[ idx*2 + 1 ] = cos( nextPhi ) * sin( currTheta );
-
-            vertices[ idx*3 + 0 ] = ( torusData.o + torusData.i * cos( nextPhi ) ) * cos( currTheta );
-            vertices[ idx*3 + 1 ] = ( torusData.o + torusData.i * cos( nextPhi ) ) * sin( currTheta );
-            vertices[ idx*3 + 2 ] = torusData.i * sin( nextPhi );
+    unsigned long int numVertices = mesh.numVertices();
+    bool hasTexCoords = !mesh.texCoords.empty();
+    GLsizeiptr size = sizeof(GLfloat) * numVertices * (hasTexCoords ? 8 : 6);
+
+    // positions, then normals, then texture coordinates
+    glBufferData( GL_ARRAY_BUFFER, size, NULL, GL_STATIC_DRAW );
+    CSCI441::ResourceRegistry::registerBuffer( vbod, GL_ARRAY_BUFFER, size, "CSCI441::objects", label );
+    glBufferSubData( GL_ARRAY_BUFFER, 0,                                  sizeof(GLfloat) * numVertices * 3, mesh.positions.data() );
+    glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * numVertices * 3, sizeof(GLfloat) * numVertices * 3, mesh.normals.data() );
+    if( hasTexCoords ) {
+        glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * numVertices * 6, sizeof(GLfloat) * numVertices * 2, mesh.texCoords.data() );
+    }
 
-            idx++;
+    unsigned long int numIndices = mesh.indices.size();
+    GLint numStrips = mesh.numStrips, stripLength = mesh.stripLength;
+    bool primitiveRestart = false;
+    GLuint ibod = 0;
+    if( numIndices > 0 && mesh.primitive == CSCI441::MESH_TRIANGLE_STRIPS && numStrips > 1 ) {
+        // join the strips with the restart index so every draw of the mesh is a single call
+        GLuint restart = CSCI441_INTERNAL::restartIndex( CSCI441_INTERNAL::indexType( numVertices ) );
+        std::vector<GLuint> joined;
+        joined.reserve( numIndices + numStrips - 1 );
+        for( int stripNum = 0; stripNum < numStrips; stripNum++ ) {
+            if( stripNum > 0 ) joined.push_back( restart );
+            joined.insert( joined.end(), mesh.indices.begin() + (unsigned long int)stripNum * stripLength, mesh.indices.begin() + (unsigned long int)(stripNum+1) * stripLength );
+        }
 
-            normals[ idx*3 + 0 ] = cos( nextPhi ) * cos( nextTheta );
-            normals[ idx*3 + 1 ] = cos( nextPhi ) * sin( nextTheta );
-            normals[ idx*3 + 2 ] = sin( nextPhi );
+        numIndices = joined.size();
+        numStrips = 1;
+        stripLength = numIndices;
+        primitiveRestart = true;
+        ibod = CSCI441_INTERNAL::generateIndexBuffer( joined.data(), numIndices, numVertices, label );
+    } else if( numIndices > 0 ) {
+        ibod = CSCI441_INTERNAL::generateIndexBuffer( mesh.indices.data(), numIndices, numVertices, label );
+    }
 
-            texCoords[ idx*2 + 0 ] = cos( nextPhi ) * cos( nextTheta );
-            texCoords[ idx*2 + 1 ] = cos( nextPhi ) * sin( nextTheta );
+    return CSCI441_INTERNAL::describeGeometry( vaod, vbod, ibod, numVertices, numIndices,
+                                               mesh.primitive == CSCI441::MESH_TRIANGLES ? GL_TRIANGLES : GL_TRIANGLE_STRIP,
+                                               numStrips, stripLength, primitiveRestart, hasTexCoords );
+}
 
-            vertices[ idx*3 + 0 ] = ( torusData.o + torusData.i * cos( nextPhi ) ) * cos( nextTheta );
-            vertices[ idx*3 + 1 ] = ( torusData.o + torusData.i * cos( nextPhi ) ) * sin( nextTheta );
-            vertices[ idx*3 + 2 ] = torusData.i * sin( nextPhi );
+inline CSCI441_INTERNAL::CachedGeometry CSCI441_INTERNAL::describeGeometry( GLuint vaod, GLuint vbod, GLuint ibod, unsigned long int numVertices, unsigned long int numIndices,
+                                                                           GLenum primitive, GLint numStrips, GLint stripLength, bool primitiveRestart, bool hasTexCoords ) {
+    CachedGeometry geometry;
+    geometry.vao = vaod;
+    geometry.vbo = vbod;
+    geometry.ibo = ibod;
+    geometry.primitive = primitive;
+    geometry.indexType = (ibod == 0 ? GL_NONE : CSCI441_INTERNAL::indexType( numVertices ));
+    geometry.numStrips = numStrips;
+    geometry.stripLength = stripLength;
+    geometry.primitiveRestart = primitiveRestart;
+    geometry.normalOffset = sizeof(GLfloat) * numVertices * 3;
+    geometry.texCoordOffset = (hasTexCoords ? (GLintptr)(sizeof(GLfloat) * numVertices * 6) : -1);
+    geometry.byteSize = sizeof(GLfloat) * numVertices * (hasTexCoords ? 8 : 6);
+    if( ibod != 0 ) {
+        geometry.byteSize += numIndices * (geometry.indexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint));
+    }
+    // not pointed at any attribute locations until first drawn
+    geometry.positionLocation = geometry.normalLocation = geometry.texCoordLocation = -2;
+    return geometry;
+}
 
-            idx++;
+inline GLuint CSCI441_INTERNAL::generateIndexBuffer( const GLuint* indices, unsigned long int numIndices, unsigned long int numVertices, const char* label ) {
+    // the VAO is still bound and records the element buffer with it
+    GLuint ibod;
+    glGenBuffers( 1, &ibod );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, ibod );
+
+    GLsizeiptr size;
+    if( CSCI441_INTERNAL::indexType( numVertices ) == GL_UNSIGNED_SHORT ) {
+        size = sizeof(GLushort) * numIndices;
+        GLushort* shortIndices = (GLushort*)malloc(size);
+        for( unsigned long int i = 0; i < numIndices; i++ ) {
+            shortIndices[i] = (GLushort)indices[i];
         }
+        glBufferData( GL_ELEMENT_ARRAY_BUFFER, size, shortIndices, GL_STATIC_DRAW );
+        free( shortIndices );
+    } else {
+        size = sizeof(GLuint) * numIndices;
+        glBufferData( GL_ELEMENT_ARRAY_BUFFER, size, indices, GL_STATIC_DRAW );
     }
+    CSCI441::ResourceRegistry::registerBuffer( ibod, GL_ELEMENT_ARRAY_BUFFER, size, "CSCI441::objects", label );
 
-    glBufferData( GL_ARRAY_BUFFER, sizeof(GLfloat) * numVertices * 8, NULL, GL_STATIC_DRAW );
-    glBufferSubData( GL_ARRAY_BUFFER, 0, 																  sizeof(GLfloat) * numVertices * 3, vertices );
-    glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * numVertices * 3, sizeof(GLfloat) * numVertices * 3, normals );
-    glBufferSubData( GL_ARRAY_BUFFER, sizeof(GLfloat) * numVertices * 6, sizeof(GLfloat) * numVertices * 2, texCoords );
-
-    CSCI441_INTERNAL::_torusVAO.insert( std::pair<TorusData, GLuint>( torusData, vaod ) );
-    CSCI441_INTERNAL::_torusVBO.insert( std::pair<TorusData, GLuint>( torusData, vbod ) );
+    return ibod;
 }
 
 #endif // __CSCI441_OBJECTS_HPP__
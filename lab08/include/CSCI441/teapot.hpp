@@ -15,6 +15,7 @@
  * https://gitlab.com/wikibooks-opengl/modern-tutorials/blob/master/bezier_teapot/teapot.cpp
  * Contributors: Sylvain Beucler
  */
+#include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
@@ -22,13 +23,42 @@
 /* Use glew.h instead of gl.h to get all the GL prototypes declared */
 #include <GL/glew.h>
 
+#include "BezierSurface.hpp"
+#include "MeshData.hpp"
+#include "ResourceRegistry.hpp"
+
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace CSCI441 {
+    /** @brief generates the vertex and index arrays of the teapot without touching OpenGL
+      *
+      * The 28 bicubic patches are evaluated from precomputed Bernstein basis and
+      * derivative tables, with normals from the cross product of the partial derivatives.
+      *
+      * @param int resolution  - samples along each edge of a patch (default: 10)
+      * @param int numThreads  - threads to evaluate the patches on, or 0 to pick from the
+      *                          hardware and the amount of work (default: 0)
+      * @return resolution x resolution vertices per patch, as a triangle list
+      * @pre resolution must be at least 2
+      */
+    CSCI441::MeshData generateTeapotMesh( int resolution = 10, int numThreads = 0 );
+    /** @brief returns the 28 bicubic patches of the teapot, ready for adaptive tessellation
+      *
+      * The surface shares its edges between patches, so a tessellation that follows the
+      * tolerance set on it has no cracks where neighboring patches are cut differently.
+      */
+    CSCI441::BezierSurface generateTeapotSurface();
+}
+
 namespace CSCI441_INTERNAL {
 
     static GLuint vao_teapot;
     static GLuint vbo_teapot_vertices, ibo_teapot_elements;
 
     struct vertex { GLfloat x, y, z; };
-    static struct vertex teapot_cp_vertices[] = {
+    static constexpr struct vertex teapot_cp_vertices[] = {
             // 1
             {  1.4   ,   0.0   ,  2.4     },
             {  1.4   ,  -0.784 ,  2.4     },
@@ -328,7 +358,7 @@ namespace CSCI441_INTERNAL {
     };
 #define TEAPOT_NB_PATCHES 28
 #define ORDER 3
-    static GLushort teapot_patches[TEAPOT_NB_PATCHES][ORDER+1][ORDER+1] = {
+    static constexpr GLushort teapot_patches[TEAPOT_NB_PATCHES][ORDER+1][ORDER+1] = {
             // rim
             { {   1,   2,   3,   4 }, {   5,   6,   7,   8 }, {   9,  10,  11,  12 }, {  13,  14,  15,  16, } },
             { {   4,  17,  18,  19 }, {   8,  20,  21,  22 }, {  12,  23,  24,  25 }, {  16,  26,  27,  28, } },
@@ -364,119 +394,301 @@ namespace CSCI441_INTERNAL {
             { { 229, 232, 233, 212 }, { 257, 264, 265, 234 }, { 260, 266, 267, 238 }, { 263, 268, 269, 242, } },
             // no bottom!
     };
-#define RESU 10
-#define RESV 10
-    static struct vertex teapot_vertices[TEAPOT_NB_PATCHES * RESU*RESV*2];
-    static GLushort teapot_elements[TEAPOT_NB_PATCHES * (RESU-1)*(RESV-1) * 2*3];
+#define TEAPOT_DEFAULT_RESOLUTION 10
+
+    static GLsizei teapot_num_elements = 0;
+    static GLenum teapot_index_type = GL_UNSIGNED_SHORT;
+    static GLintptr teapot_normal_offset = 0;
+    static int teapot_resolution = TEAPOT_DEFAULT_RESOLUTION;
 
     static bool teapotBuilt = false;
 
-    void build_control_points_k(int p, struct vertex control_points_k[][ORDER+1]);
-    struct vertex compute_position(struct vertex control_points_k[][ORDER+1], float u, float v);
-    struct vertex compute_normal(struct vertex control_points_k[][ORDER+1], float u, float v);
-    float bernstein_polynomial(int i, int n, float u);
-    float binomial_coefficient(int i, int n);
-    int factorial(int n);
+    // cubic Bernstein basis and its derivative at each of the samples along a patch edge
+    struct bernstein_table {
+        std::vector<float> basis, derivative;   // ORDER+1 values per sample
+    };
+
+    void build_bernstein_table(int resolution, struct bernstein_table &table);
+    constexpr void evaluate_bernstein(float t, float basis[ORDER+1], float derivative[ORDER+1]);
+    constexpr void build_control_points_k(int p, struct vertex control_points_k[][ORDER+1]);
+    template<typename Index> constexpr void build_teapot_elements(int resolution, Index *elements);
+    void evaluate_patches(const struct bernstein_table &table, int resolution, int firstPatch, int lastPatch, CSCI441::MeshData &mesh);
+    constexpr void evaluate_row(const struct vertex control_points_k[][ORDER+1], const float *bu, const float *dbu,
+                                struct vertex row[ORDER+1], struct vertex row_du[ORDER+1]);
+    constexpr void evaluate_point(const struct vertex row[ORDER+1], const struct vertex row_du[ORDER+1], const float *bv, const float *dbv,
+                                  struct vertex &position, struct vertex &du, struct vertex &dv);
+    template<typename Root> constexpr void evaluate_vertex(const struct vertex control_points_k[][ORDER+1], const struct vertex row[ORDER+1],
+                                                           const struct vertex row_du[ORDER+1], const float *bv, const float *dbv, float u, float v,
+                                                           Root root, struct vertex &position, struct vertex &normal);
+    constexpr float teapot_sqrt(float x);
+    void upload_teapot(const GLfloat *positions, const GLfloat *normals, GLsizeiptr vertexBytes,
+                       const void *elements, GLenum indexType, GLsizeiptr elementBytes, GLsizei numElements);
+
+    inline CSCI441::MeshData build_teapot(int resolution, int numThreads) {
+        const int VERTS_PER_PATCH = resolution*resolution;
+
+        CSCI441::MeshData mesh;
+        CSCI441_INTERNAL::allocateMesh( mesh, TEAPOT_NB_PATCHES * VERTS_PER_PATCH, false, TEAPOT_NB_PATCHES * (resolution-1)*(resolution-1) * 2*3 );
 
-    inline void build_teapot() {
         // Vertices
-        for (int p = 0; p < TEAPOT_NB_PATCHES; p++) {
-            struct vertex control_points_k[ORDER+1][ORDER+1];
-            build_control_points_k(p, control_points_k);
-            for (int ru = 0; ru <= RESU-1; ru++) {
-                float u = 1.0 * ru / (RESU-1);
-                for (int rv = 0; rv <= RESV-1; rv++) {
-                    float v = 1.0 * rv / (RESV-1);
-                    teapot_vertices[p*RESU*RESV + ru*RESV + rv] = compute_position(control_points_k, u, v);
-                    teapot_vertices[TEAPOT_NB_PATCHES * RESU*RESV + p*RESU*RESV + ru*RESV + rv] = compute_normal(control_points_k, u, v);
-                }
-            }
+        struct bernstein_table table;
+        build_bernstein_table(resolution, table);
+
+        // starting threads costs more than a small teapot takes to evaluate
+        if (numThreads <= 0) {
+            numThreads = mesh.numVertices() < 16384 ? 1 : (int)std::thread::hardware_concurrency();
+            if (numThreads <= 0) numThreads = 1;
         }
+        if (numThreads > TEAPOT_NB_PATCHES) numThreads = TEAPOT_NB_PATCHES;
+
+        // each thread writes the vertices of its own run of patches
+        std::vector<std::thread> threads;
+        for (int t = 1; t < numThreads; t++)
+            threads.push_back( std::thread( evaluate_patches, std::cref(table), resolution,
+                                            TEAPOT_NB_PATCHES * t / numThreads, TEAPOT_NB_PATCHES * (t+1) / numThreads, std::ref(mesh) ) );
+        evaluate_patches(table, resolution, 0, TEAPOT_NB_PATCHES / numThreads, mesh);
+        for (size_t t = 0; t < threads.size(); t++)
+            threads[t].join();
 
         // Elements
-        int n = 0;
-        for (int p = 0; p < TEAPOT_NB_PATCHES; p++)
-            for (int ru = 0; ru < RESU-1; ru++)
-                for (int rv = 0; rv < RESV-1; rv++) {
-                    // 1 square ABCD = 2 triangles ABC + CDA
-                    // ABC
-                    teapot_elements[n] = p*RESU*RESV +  ru   *RESV +  rv   ; n++;
-                    teapot_elements[n] = p*RESU*RESV +  ru   *RESV + (rv+1); n++;
-                    teapot_elements[n] = p*RESU*RESV + (ru+1)*RESV + (rv+1); n++;
-                    // CDA
-                    teapot_elements[n] = p*RESU*RESV + (ru+1)*RESV + (rv+1); n++;
-                    teapot_elements[n] = p*RESU*RESV + (ru+1)*RESV +  rv   ; n++;
-                    teapot_elements[n] = p*RESU*RESV +  ru   *RESV +  rv   ; n++;
-                }
+        build_teapot_elements(resolution, mesh.indices.data());
 
+        mesh.primitive = CSCI441::MESH_TRIANGLES;
+        mesh.numStrips = 1;
+        mesh.stripLength = mesh.indices.size();
+        mesh.computeBounds();
+        return mesh;
     }
 
-    inline void build_control_points_k(int p, struct vertex control_points_k[][ORDER+1]) {
+    inline void build_bernstein_table(int resolution, struct bernstein_table &table) {
+        table.basis.resize(resolution * (ORDER+1));
+        table.derivative.resize(resolution * (ORDER+1));
+        for (int r = 0; r < resolution; r++)
+            evaluate_bernstein(1.0f * r / (resolution-1), &table.basis[r * (ORDER+1)], &table.derivative[r * (ORDER+1)]);
+    }
+
+    constexpr void evaluate_bernstein(float t, float basis[ORDER+1], float derivative[ORDER+1]) {
+        float s = 1.0f - t;
+        basis[0] = s*s*s;
+        basis[1] = 3.0f*t*s*s;
+        basis[2] = 3.0f*t*t*s;
+        basis[3] = t*t*t;
+        derivative[0] = -3.0f*s*s;
+        derivative[1] = 3.0f*s*s - 6.0f*t*s;
+        derivative[2] = 6.0f*t*s - 3.0f*t*t;
+        derivative[3] = 3.0f*t*t;
+    }
+
+    constexpr void build_control_points_k(int p, struct vertex control_points_k[][ORDER+1]) {
         for (int i = 0; i <= ORDER; i++)
             for (int j = 0; j <= ORDER; j++)
                 control_points_k[i][j] = teapot_cp_vertices[teapot_patches[p][i][j] - 1];
     }
 
-    inline struct vertex compute_position(struct vertex control_points_k[][ORDER+1], float u, float v) {
-        struct vertex result = { 0.0, 0.0, 0.0 };
-        for (int i = 0; i <= ORDER; i++) {
-            float poly_i = bernstein_polynomial(i, ORDER, u);
-            for (int j = 0; j <= ORDER; j++) {
-                float poly_j = bernstein_polynomial(j, ORDER, v);
-                result.x += poly_i * poly_j * control_points_k[i][j].x;
-                result.y += poly_i * poly_j * control_points_k[i][j].y;
-                result.z += poly_i * poly_j * control_points_k[i][j].z;
+    template<typename Index>
+    constexpr void build_teapot_elements(int resolution, Index *elements) {
+        const int VERTS_PER_PATCH = resolution*resolution;
+
+        unsigned long int n = 0;
+        for (int p = 0; p < TEAPOT_NB_PATCHES; p++)
+            for (int ru = 0; ru < resolution-1; ru++)
+                for (int rv = 0; rv < resolution-1; rv++) {
+                    // 1 square ABCD = 2 triangles ABC + CDA
+                    // ABC
+                    elements[n] = p*VERTS_PER_PATCH +  ru   *resolution +  rv   ; n++;
+                    elements[n] = p*VERTS_PER_PATCH +  ru   *resolution + (rv+1); n++;
+                    elements[n] = p*VERTS_PER_PATCH + (ru+1)*resolution + (rv+1); n++;
+                    // CDA
+                    elements[n] = p*VERTS_PER_PATCH + (ru+1)*resolution + (rv+1); n++;
+                    elements[n] = p*VERTS_PER_PATCH + (ru+1)*resolution +  rv   ; n++;
+                    elements[n] = p*VERTS_PER_PATCH +  ru   *resolution +  rv   ; n++;
+                }
+    }
+
+    inline void evaluate_patches(const struct bernstein_table &table, int resolution, int firstPatch, int lastPatch, CSCI441::MeshData &mesh) {
+        for (int p = firstPatch; p < lastPatch; p++) {
+            struct vertex control_points_k[ORDER+1][ORDER+1];
+            build_control_points_k(p, control_points_k);
+            for (int ru = 0; ru < resolution; ru++) {
+                struct vertex row[ORDER+1], row_du[ORDER+1];
+                evaluate_row(control_points_k, &table.basis[ru * (ORDER+1)], &table.derivative[ru * (ORDER+1)], row, row_du);
+                for (int rv = 0; rv < resolution; rv++) {
+                    struct vertex position, normal;
+                    evaluate_vertex(control_points_k, row, row_du, &table.basis[rv * (ORDER+1)], &table.derivative[rv * (ORDER+1)],
+                                    1.0f * ru / (resolution-1), 1.0f * rv / (resolution-1), sqrtf, position, normal);
+
+                    unsigned long int idx = (unsigned long int)p*resolution*resolution + ru*resolution + rv;
+                    mesh.positions[idx*3 + 0] = position.x; mesh.positions[idx*3 + 1] = position.y; mesh.positions[idx*3 + 2] = position.z;
+                    mesh.normals[idx*3 + 0] = normal.x;     mesh.normals[idx*3 + 1] = normal.y;     mesh.normals[idx*3 + 2] = normal.z;
+                }
             }
         }
-        return result;
     }
 
-    // TODO compute normal based on partial derivatives of surface patch
-    inline struct vertex compute_normal(struct vertex control_points_k[][ORDER+1], float u, float v) {
-        struct vertex result = { 0.0, 0.0, 0.0 };
-        for (int i = 0; i <= ORDER; i++) {
-            float poly_i = bernstein_polynomial(i, ORDER, u);
-            for (int j = 0; j <= ORDER; j++) {
-                float poly_j = bernstein_polynomial(j, ORDER, v);
-                result.x += poly_i * poly_j * control_points_k[i][j].x;
-                result.y += poly_i * poly_j * control_points_k[i][j].y;
-                result.z += poly_i * poly_j * control_points_k[i][j].z;
+    // sums each column of control points against the u basis, leaving one cubic in v for the whole row of samples
+    constexpr void evaluate_row(const struct vertex control_points_k[][ORDER+1], const float *bu, const float *dbu,
+                                struct vertex row[ORDER+1], struct vertex row_du[ORDER+1]) {
+        for (int j = 0; j <= ORDER; j++) {
+            row[j].x = row[j].y = row[j].z = 0.0f;
+            row_du[j].x = row_du[j].y = row_du[j].z = 0.0f;
+            for (int i = 0; i <= ORDER; i++) {
+                const struct vertex &cp = control_points_k[i][j];
+                row[j].x += bu[i] * cp.x;      row[j].y += bu[i] * cp.y;      row[j].z += bu[i] * cp.z;
+                row_du[j].x += dbu[i] * cp.x;  row_du[j].y += dbu[i] * cp.y;  row_du[j].z += dbu[i] * cp.z;
             }
         }
-        return result;
     }
 
-    inline float bernstein_polynomial(int i, int n, float u) {
-        return binomial_coefficient(i, n) * powf(u, i) * powf(1-u, n-i);
+    constexpr void evaluate_point(const struct vertex row[ORDER+1], const struct vertex row_du[ORDER+1], const float *bv, const float *dbv,
+                                  struct vertex &position, struct vertex &du, struct vertex &dv) {
+        position.x = position.y = position.z = 0.0f;
+        du.x = du.y = du.z = 0.0f;
+        dv.x = dv.y = dv.z = 0.0f;
+        for (int j = 0; j <= ORDER; j++) {
+            position.x += bv[j] * row[j].x;   position.y += bv[j] * row[j].y;   position.z += bv[j] * row[j].z;
+            du.x += bv[j] * row_du[j].x;      du.y += bv[j] * row_du[j].y;      du.z += bv[j] * row_du[j].z;
+            dv.x += dbv[j] * row[j].x;        dv.y += dbv[j] * row[j].y;        dv.z += dbv[j] * row[j].z;
+        }
     }
 
-    inline float binomial_coefficient(int i, int n) {
-        assert(i >= 0); assert(n >= 0);
-        return 1.0f * factorial(n) / (factorial(i) * factorial(n-i));
+    // root is sqrtf() at run time and teapot_sqrt() when the compiler evaluates the default teapot
+    template<typename Root>
+    constexpr void evaluate_vertex(const struct vertex control_points_k[][ORDER+1], const struct vertex row[ORDER+1],
+                                   const struct vertex row_du[ORDER+1], const float *bv, const float *dbv, float u, float v,
+                                   Root root, struct vertex &position, struct vertex &normal) {
+        // a patch edge collapsed to a point, as at the top of the lid, has no normal at the pole;
+        // take it from a sample a little way into the patch instead
+        const float NUDGE = 1e-3f;
+
+        struct vertex du = {0.0f, 0.0f, 0.0f}, dv = {0.0f, 0.0f, 0.0f};
+        evaluate_point(row, row_du, bv, dbv, position, du, dv);
+
+        // dv x du faces out of the teapot, the same way the triangles are wound
+        float nx = dv.y*du.z - dv.z*du.y;
+        float ny = dv.z*du.x - dv.x*du.z;
+        float nz = dv.x*du.y - dv.y*du.x;
+        float length = root(nx*nx + ny*ny + nz*nz);
+        if (length < 1e-6f) {
+            float nbu[ORDER+1] = {}, ndbu[ORDER+1] = {}, nbv[ORDER+1] = {}, ndbv[ORDER+1] = {};
+            evaluate_bernstein(u < 0.5f ? u + NUDGE : u - NUDGE, nbu, ndbu);
+            evaluate_bernstein(v < 0.5f ? v + NUDGE : v - NUDGE, nbv, ndbv);
+            struct vertex nudged_row[ORDER+1] = {}, nudged_row_du[ORDER+1] = {};
+            evaluate_row(control_points_k, nbu, ndbu, nudged_row, nudged_row_du);
+            struct vertex nudged = {0.0f, 0.0f, 0.0f};
+            evaluate_point(nudged_row, nudged_row_du, nbv, ndbv, nudged, du, dv);
+            nx = dv.y*du.z - dv.z*du.y;
+            ny = dv.z*du.x - dv.x*du.z;
+            nz = dv.x*du.y - dv.y*du.x;
+            length = root(nx*nx + ny*ny + nz*nz);
+        }
+        if (length > 0.0f) {
+            nx /= length; ny /= length; nz /= length;
+        }
+        normal.x = nx; normal.y = ny; normal.z = nz;
     }
-    inline int factorial(int n) {
-        assert(n >= 0);
-        int result = 1;
-        for (int i = n; i > 1; i--)
-            result *= i;
-        return result;
+
+    // Newton's method from above in double precision, close enough that it rounds to the float sqrtf() returns
+    constexpr float teapot_sqrt(float x) {
+        if (x <= 0.0f) return 0.0f;
+        double root = x > 1.0f ? x : 1.0;
+        for (int i = 0; i < 64; i++) {
+            double next = 0.5 * (root + x / root);
+            if (next >= root) break;
+            root = next;
+        }
+        return (float)root;
     }
 
-    inline int init_resources() {
-        build_teapot();
+    // the teapot at the default resolution, evaluated while compiling so the first draw only has to upload it
+    struct teapot_table {
+        static constexpr int NUM_VERTICES = TEAPOT_NB_PATCHES * TEAPOT_DEFAULT_RESOLUTION*TEAPOT_DEFAULT_RESOLUTION;
+        static constexpr int NUM_ELEMENTS = TEAPOT_NB_PATCHES * (TEAPOT_DEFAULT_RESOLUTION-1)*(TEAPOT_DEFAULT_RESOLUTION-1) * 2*3;
+
+        GLfloat positions[NUM_VERTICES * 3];
+        GLfloat normals[NUM_VERTICES * 3];
+        GLushort elements[NUM_ELEMENTS];
+    };
+
+    constexpr struct teapot_table build_teapot_table() {
+        const int RESOLUTION = TEAPOT_DEFAULT_RESOLUTION;
+
+        struct teapot_table table = {};
+        float basis[RESOLUTION][ORDER+1] = {}, derivative[RESOLUTION][ORDER+1] = {};
+        for (int r = 0; r < RESOLUTION; r++)
+            evaluate_bernstein(1.0f * r / (RESOLUTION-1), basis[r], derivative[r]);
+
+        for (int p = 0; p < TEAPOT_NB_PATCHES; p++) {
+            struct vertex control_points_k[ORDER+1][ORDER+1] = {};
+            build_control_points_k(p, control_points_k);
+            for (int ru = 0; ru < RESOLUTION; ru++) {
+                struct vertex row[ORDER+1] = {}, row_du[ORDER+1] = {};
+                evaluate_row(control_points_k, basis[ru], derivative[ru], row, row_du);
+                for (int rv = 0; rv < RESOLUTION; rv++) {
+                    struct vertex position = {0.0f, 0.0f, 0.0f}, normal = {0.0f, 0.0f, 0.0f};
+                    evaluate_vertex(control_points_k, row, row_du, basis[rv], derivative[rv],
+                                    1.0f * ru / (RESOLUTION-1), 1.0f * rv / (RESOLUTION-1), teapot_sqrt, position, normal);
+
+                    int idx = p*RESOLUTION*RESOLUTION + ru*RESOLUTION + rv;
+                    table.positions[idx*3 + 0] = position.x; table.positions[idx*3 + 1] = position.y; table.positions[idx*3 + 2] = position.z;
+                    table.normals[idx*3 + 0] = normal.x;     table.normals[idx*3 + 1] = normal.y;     table.normals[idx*3 + 2] = normal.z;
+                }
+            }
+        }
+
+        build_teapot_elements(RESOLUTION, table.elements);
+        return table;
+    }
+
+    static constexpr struct teapot_table teapot_default_table = build_teapot_table();
+
+    inline void upload_teapot(const GLfloat *positions, const GLfloat *normals, GLsizeiptr vertexBytes,
+                              const void *elements, GLenum indexType, GLsizeiptr elementBytes, GLsizei numElements) {
+        teapot_normal_offset = vertexBytes;
+        teapot_num_elements = numElements;
+        teapot_index_type = indexType;
 
         glGenVertexArrays(1, &vao_teapot);
         glBindVertexArray(vao_teapot);
 
+        // positions followed by normals
         glGenBuffers(1, &vbo_teapot_vertices);
         glBindBuffer(GL_ARRAY_BUFFER, vbo_teapot_vertices);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(teapot_vertices), teapot_vertices, GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, vertexBytes * 2, NULL, GL_STATIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, vertexBytes, positions);
+        glBufferSubData(GL_ARRAY_BUFFER, vertexBytes, vertexBytes, normals);
+        CSCI441::ResourceRegistry::registerBuffer(vbo_teapot_vertices, GL_ARRAY_BUFFER, vertexBytes * 2, "CSCI441::teapot", "teapot");
 
         glGenBuffers(1, &ibo_teapot_elements);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_teapot_elements);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(teapot_elements), teapot_elements, GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, elementBytes, elements, GL_STATIC_DRAW);
+        CSCI441::ResourceRegistry::registerBuffer(ibo_teapot_elements, GL_ELEMENT_ARRAY_BUFFER, elementBytes, "CSCI441::teapot", "teapot");
 
         teapotBuilt = true;
+    }
+
+    inline int init_resources() {
+        if (teapot_resolution == TEAPOT_DEFAULT_RESOLUTION) {
+            upload_teapot(teapot_default_table.positions, teapot_default_table.normals, sizeof(teapot_default_table.positions),
+                          teapot_default_table.elements, GL_UNSIGNED_SHORT, sizeof(teapot_default_table.elements), teapot_table::NUM_ELEMENTS);
+            return 1;
+        }
+
+        CSCI441::MeshData mesh = build_teapot(teapot_resolution, 0);
+        GLsizeiptr vertexBytes = sizeof(GLfloat) * mesh.positions.size();
+
+        // shorts while every vertex can be addressed by one
+        GLsizei numElements = mesh.indices.size();
+        GLenum indexType = mesh.numVertices() <= 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        GLsizeiptr elementBytes = sizeof(GLuint) * numElements;
+        void* elements = mesh.indices.data();
+        std::vector<GLushort> shortElements;
+        if (indexType == GL_UNSIGNED_SHORT) {
+            shortElements.assign(mesh.indices.begin(), mesh.indices.end());
+            elementBytes = sizeof(GLushort) * numElements;
+            elements = shortElements.data();
+        }
+
+        upload_teapot(mesh.positions.data(), mesh.normals.data(), vertexBytes, elements, indexType, elementBytes, numElements);
 
         return 1;
     }
@@ -505,11 +717,52 @@ namespace CSCI441_INTERNAL {
                 GL_FLOAT,          // the type of each element
                 GL_FALSE,          // take our values as-is
                 0,                 // no extra data between each position
-                (void*)(TEAPOT_NB_PATCHES * RESU*RESV)                  // offset of first element
+                (void*)teapot_normal_offset  // offset of first element
         );
 
-        glDrawElements(GL_TRIANGLES, sizeof(teapot_elements)/sizeof(teapot_elements[0]), GL_UNSIGNED_SHORT, 0);
+        glDrawElements(GL_TRIANGLES, teapot_num_elements, teapot_index_type, 0);
+    }
+
+    inline void delete_resources() {
+        if( !teapotBuilt ) return;
+
+        glDeleteBuffers(1, &vbo_teapot_vertices);
+        glDeleteBuffers(1, &ibo_teapot_elements);
+        CSCI441::ResourceRegistry::releaseBuffer(vbo_teapot_vertices);
+        CSCI441::ResourceRegistry::releaseBuffer(ibo_teapot_elements);
+        glDeleteVertexArrays(1, &vao_teapot);
+
+        teapotBuilt = false;
+    }
+}
+
+inline CSCI441::MeshData CSCI441::generateTeapotMesh( int resolution, int numThreads ) {
+    assert( resolution >= 2 );
+
+    return CSCI441_INTERNAL::build_teapot( resolution, numThreads );
+}
+
+inline CSCI441::BezierSurface CSCI441::generateTeapotSurface() {
+    const unsigned int NUM_POINTS = sizeof( CSCI441_INTERNAL::teapot_cp_vertices ) / sizeof( CSCI441_INTERNAL::vertex );
+
+    std::vector<float> points;
+    for( unsigned int i = 0; i < NUM_POINTS; i++ ) {
+        points.push_back( CSCI441_INTERNAL::teapot_cp_vertices[i].x );
+        points.push_back( CSCI441_INTERNAL::teapot_cp_vertices[i].y );
+        points.push_back( CSCI441_INTERNAL::teapot_cp_vertices[i].z );
     }
+
+    // the patch table counts control points from one
+    std::vector<unsigned int> patches;
+    for( int p = 0; p < TEAPOT_NB_PATCHES; p++ )
+        for( int i = 0; i <= ORDER; i++ )
+            for( int j = 0; j <= ORDER; j++ )
+                patches.push_back( CSCI441_INTERNAL::teapot_patches[p][i][j] - 1 );
+
+    CSCI441::BezierSurface surface;
+    surface.setControlPoints( points.data(), NUM_POINTS );
+    surface.setPatches( patches.data(), TEAPOT_NB_PATCHES );
+    return surface;
 }
 
 
@@ -24,8 +24,10 @@
 #include <cstdio>				        // for printf functionality
 #include <cstdlib>				        // for exit functionality
 
+#include <CSCI441/BezierSpline.hpp>     // cached Bezier curve with constant speed traversal
 #include <CSCI441/OpenGLUtils.hpp>      // prints OpenGL information
 #include <CSCI441/objects.hpp>          // draws 3D objects
+#include <CSCI441/ResourceRegistry.hpp> // tracks GPU memory used by our buffers
 #include <CSCI441/ShaderProgram.hpp>    // wrapper class for GLSL shader programs
 #include <vector>
 
@@ -54,15 +56,13 @@ GLuint lightType;                       // type of the light - 0 point 1 directi
 
 // keep track of our objects
 GLuint platformVAO, platformVBOs[2];    // the ground platform everything is hovering over
-GLfloat currentSpherePos = 0;
+GLfloat sphereDistance = 0.0f;          // distance the sphere has traveled along the curve
+const GLfloat SPHERE_SPEED = 0.075f;    // distance the sphere travels along the curve each frame
 // Bezier Curve Information
 GLuint numControlPoints;                // number of control points in the curve system
 GLuint numCurves;                       // number of curves in the system
 glm::vec3 *controlPoints = nullptr;     // control points array
-GLuint bezierCageVAO, bezierCageVBO;    // the bezier control cage VAO
-GLuint numEvalPoints;                   // number of points evaluated
-GLuint bezierCurveVAO, bezierCurveVBO;  // the actual curve VAO
-int *resolution;
+CSCI441::BezierSpline *bezierCurve = nullptr;   // the curve and its cage, sampled once and kept on the GPU
 
 // gourad with phong illumination shader program
 CSCI441::ShaderProgram *gouradShaderProgram = nullptr;
@@ -191,22 +191,6 @@ void loadControlPointsFromFile(const char* FILENAME, GLuint *numBezierPoints, GL
     fclose(file);
 }
 
-/// evalBezierCurve() //////////////////////////////////////////////////////////
-///
-/// This function solves the Bezier curve equation for four given control
-/// points at a given location t.
-///
-////////////////////////////////////////////////////////////////////////////////
-glm::vec3 evalBezierCurve(glm::vec3 p0, glm::vec3 p1, glm::vec3 p2, glm::vec3 p3, GLfloat t) {
-    // TODO #01 - solve our Bezier Curve equation
-    glm::vec3 curvePoint(0.0f);
-    //f(t) = (-p0 + 3p1 - 3p2 + p3)*t^3 + (3p0 - 6p1 + 3p2)*t^2 + (-3p0 + 3p1)*t + p0
-    curvePoint = (-1.0f * p0 + 3.0f * p1 - 3.0f * p2 + p3) * float(pow(t, 3))
-            + (3.0f * p0 - 6.0f * p1 + 3.0f * p2) * float(pow(t, 2))
-            + (-3.0f * p0 + 3.0f * p1)*t + p0;
-    return curvePoint;
-}
-
 ///***********************************************************************************************************************************************************
 //
 // Event Callbacks
@@ -246,6 +230,11 @@ static void key_callback(GLFWwindow* window, int key, int scancode, int action,
                 gouradShaderProgram->useProgram();
                 glUniform1i(gouradShaderProgramUniforms.lightType, lightType);
                 break;
+
+            // print every buffer and texture currently on the GPU
+            case GLFW_KEY_R:
+                CSCI441::ResourceRegistry::dump();
+                break;
             default: break;
         }
     }
@@ -439,51 +428,6 @@ void setupShaders() {
     flatShaderProgramAttributes.vPos                = flatShaderProgram->getAttributeLocation("vPos");
 }
 
-void genCurve() {
-//    fprintf( stdout, "[INFO]: Read in %u points comprising %u curves\n", numControlPoints, numCurves );
-
-    // --------------------------------------------------------------------------------------------------
-    // generate cage
-
-    glGenVertexArrays( 1, &bezierCageVAO );
-    glBindVertexArray( bezierCageVAO );
-
-    glGenBuffers( 1, &bezierCageVBO );
-    glBindBuffer( GL_ARRAY_BUFFER, bezierCageVBO );
-    glBufferData( GL_ARRAY_BUFFER, numControlPoints * sizeof(glm::vec3), controlPoints, GL_STATIC_DRAW );
-
-    glEnableVertexAttribArray( flatShaderProgramAttributes.vPos );
-    glVertexAttribPointer( flatShaderProgramAttributes.vPos, 3, GL_FLOAT, GL_FALSE, 0, (void*) 0 );
-
-//    fprintf( stdout, "[INFO]: control points cage read in with VAO %d\n", bezierCageVAO );
-
-    // --------------------------------------------------------------------------------------------------
-    // generate curve
-
-    // TODO #02 - generate the curve for a given resolution
-
-    numEvalPoints = *resolution + 1;
-    std::vector<glm::vec3> calcPoints;
-    for (int i = 0; i < numControlPoints; i += 3) {
-        glm::vec3 p0 = controlPoints[0 + i], p1 = controlPoints[1 + i],
-                p2 = controlPoints[2 + i], p3 = controlPoints[3 + i];
-        for (int j = 0; j < numEvalPoints; ++j) {
-            float time = float(j) / float(*resolution);
-            calcPoints.emplace_back(evalBezierCurve(p0, p1, p2, p3, time));
-        }
-    }
-    glGenVertexArrays( 1,  &bezierCurveVAO);
-    glBindVertexArray( bezierCurveVAO );
-
-    glGenBuffers( 1, &bezierCurveVBO );
-    glBindBuffer( GL_ARRAY_BUFFER, bezierCurveVBO );
-    glBufferData( GL_ARRAY_BUFFER, numCurves * numEvalPoints * sizeof(glm::vec3), &calcPoints[0], GL_STATIC_DRAW );
-
-    glEnableVertexAttribArray( flatShaderProgramAttributes.vPos );
-    glVertexAttribPointer( flatShaderProgramAttributes.vPos, 3, GL_FLOAT, GL_FALSE, 0, (void*) 0 );
-//    fprintf( stdout, "[INFO]: bezier curve read in with VAO %d\n", bezierCurveVAO );
-}
-
 /// setupBuffers() //////////////////////////////////////////////////////////////
 ///
 ///      Create our VAOs & VBOs. Send vertex data to the GPU for future rendering
@@ -517,6 +461,7 @@ void setupBuffers() {
 
 	glBindBuffer( GL_ARRAY_BUFFER, platformVBOs[0] );
 	glBufferData( GL_ARRAY_BUFFER, sizeof( platformVertices ), platformVertices, GL_STATIC_DRAW );
+	CSCI441::ResourceRegistry::registerBuffer( platformVBOs[0], GL_ARRAY_BUFFER, sizeof( platformVertices ), "setupBuffers", "platform" );
 
 	glEnableVertexAttribArray( gouradShaderProgramAttributes.vPos );
 	glVertexAttribPointer( gouradShaderProgramAttributes.vPos, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) 0 );
@@ -526,6 +471,7 @@ void setupBuffers() {
 
 	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, platformVBOs[1] );
 	glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof( platformIndices ), platformIndices, GL_STATIC_DRAW );
+	CSCI441::ResourceRegistry::registerBuffer( platformVBOs[1], GL_ELEMENT_ARRAY_BUFFER, sizeof( platformIndices ), "setupBuffers", "platform" );
 
 	fprintf( stdout, "[INFO]: platform read in with VAO %d\n", platformVAO );
 
@@ -537,13 +483,20 @@ void setupBuffers() {
 	fscanf( stdin, "%s", filename );
 	loadControlPointsFromFile(filename, &numControlPoints, &numCurves, controlPoints);
 
+	// without control points the curve stays empty, with no length and nothing to draw
+	bezierCurve = new CSCI441::BezierSpline();
+
 	if(!controlPoints) {
 	    fprintf( stderr, "[ERROR]: Error loading control points from file\n" );
 	} else {
         fprintf( stdout, "\nEnter the desired resolution of the Bezier Curve: " );
-        resolution = (int*)malloc(sizeof(int)*256);
-        fscanf( stdin, "%d", resolution );
-        genCurve();
+        GLuint resolution = 20;
+        fscanf( stdin, "%u", &resolution );
+
+        // the curve is sampled here and only again if its control points change
+        bezierCurve->setResolution( resolution > 0 ? resolution : 1 );
+        bezierCurve->setControlPoints( controlPoints, numControlPoints );
+        fprintf( stdout, "[INFO]: %u curves with a length of %f\n", bezierCurve->getNumSegments(), bezierCurve->getLength() );
 	}
 }
 
@@ -658,17 +611,17 @@ void cleanupBuffers() {
     fprintf( stdout, "[INFO]: ...deleting VBOs....\n" );
 
     glDeleteBuffers( 2, platformVBOs );
-    glDeleteBuffers( 1, &bezierCageVBO );
-    glDeleteBuffers( 1, &bezierCurveVBO );
+    CSCI441::ResourceRegistry::releaseBuffer( platformVBOs[0] );
+    CSCI441::ResourceRegistry::releaseBuffer( platformVBOs[1] );
     CSCI441::deleteObjectVBOs();
 
     fprintf( stdout, "[INFO]: ...deleting VAOs....\n" );
 
     glDeleteVertexArrays( 1, &platformVAO );
-    glDeleteVertexArrays( 1, &bezierCageVAO );
-    glDeleteVertexArrays( 1, &bezierCurveVAO );
     CSCI441::deleteObjectVAOs();
 
+    delete bezierCurve;
+
     free(controlPoints);
 }
 
@@ -693,6 +646,8 @@ void shutdown(GLFWwindow* window) {
     cleanupShaders();                                   // delete shaders from GPU
     cleanupBuffers();                                   // delete VAOs/VBOs from GPU
     cleanupTextures();                                  // delete textures from GPU
+    fprintf( stdout, "[INFO]: ...resources still registered were never deleted:\n" );
+    CSCI441::ResourceRegistry::dump();                  // anything left over has leaked
     fprintf( stdout, "[INFO]: ...closing GLFW.....\n" );
     glfwTerminate();						            // shut down GLFW to clean up our context
     fprintf( stdout, "[INFO]: ..shut down complete!\n" );
@@ -747,8 +702,6 @@ void renderScene( glm::mat4 viewMatrix, glm::mat4 projectionMatrix ) {
         }
     }
 
-    genCurve();
-
     // use the ruby material
     sendMaterialProperties(materialRuby,
                            gouradShaderProgramUniforms.materialDiffColor,
@@ -762,7 +715,9 @@ void renderScene( glm::mat4 viewMatrix, glm::mat4 projectionMatrix ) {
                                              gouradShaderProgramUniforms.mvpMatrix,
                                              gouradShaderProgramUniforms.modelMatrix,
                                              gouradShaderProgramUniforms.normalMtx);
-        CSCI441::drawSolidSphere(0.25f, 16, 16);
+        // far away control points are only a few pixels wide and get a coarser sphere
+        glm::mat4 mvpMatrix = projectionMatrix * viewMatrix * modelMatrix;
+        CSCI441::drawSolidSphereLOD(0.25f, &mvpMatrix[0][0]);
     }
 
     // use the bronze material
@@ -771,16 +726,15 @@ void renderScene( glm::mat4 viewMatrix, glm::mat4 projectionMatrix ) {
                            gouradShaderProgramUniforms.materialSpecColor, gouradShaderProgramUniforms.materialShininess,
                            gouradShaderProgramUniforms.materialAmbColor);
 
-    // TODO #03 - evaluate the current position along the curve system and draw a sphere at the current point
-    GLint curveNum = floor(currentSpherePos);
-    glm::vec3 posOnCurve = evalBezierCurve(controlPoints[0 + 3 * curveNum], controlPoints[1 + 3 * curveNum],
-        controlPoints[2 + 3 * curveNum], controlPoints[3 + 3 * curveNum], currentSpherePos - GLfloat(curveNum));
+    // place the sphere by distance along the curve rather than by curve parameter, so it moves at a constant speed
+    glm::vec3 posOnCurve = bezierCurve->getPointAtDistance(sphereDistance);
     modelMatrix = glm::translate(glm::mat4(1.0f), posOnCurve);
     computeAndSendTransformationMatrices(modelMatrix, viewMatrix, projectionMatrix,
                                          gouradShaderProgramUniforms.mvpMatrix,
                                          gouradShaderProgramUniforms.modelMatrix,
                                          gouradShaderProgramUniforms.normalMtx);
-    CSCI441::drawSolidSphere(0.25f, 16, 16);
+    glm::mat4 mvpMatrix = projectionMatrix * viewMatrix * modelMatrix;
+    CSCI441::drawSolidSphereLOD(0.25f, &mvpMatrix[0][0]);
 
 
     // use the flat shader to draw lines
@@ -790,12 +744,10 @@ void renderScene( glm::mat4 viewMatrix, glm::mat4 projectionMatrix ) {
                                          flatShaderProgramUniforms.mvpMatrix);
 
     // draw the curve control cage
-    glBindVertexArray( bezierCageVAO );
-    glDrawArrays(GL_LINE_STRIP, 0, numControlPoints);
+    bezierCurve->drawCage( flatShaderProgramAttributes.vPos );
 
     // LOOKHERE #1 draw the curve itself
-    glBindVertexArray( bezierCurveVAO );
-    glDrawArrays(GL_LINE_STRIP, 0, numCurves * numEvalPoints);
+    bezierCurve->draw( flatShaderProgramAttributes.vPos );
 }
 
 /// updateScene() ////////////////////////////////////////////////////////////////
@@ -804,10 +756,9 @@ void renderScene( glm::mat4 viewMatrix, glm::mat4 projectionMatrix ) {
 ///
 ////////////////////////////////////////////////////////////////////////////////
 void updateScene() {
-    if (currentSpherePos > numCurves)
-        currentSpherePos = 0.0f;
-    else
-        currentSpherePos += 0.005f;
+    sphereDistance += SPHERE_SPEED;
+    if (sphereDistance > bezierCurve->getLength())
+        sphereDistance -= bezierCurve->getLength();
 }
 
 /// run() ///////////////////////////////////////////////////////////////////////
@@ -831,6 +782,7 @@ void run(GLFWwindow* window) {
 
         // update the viewport - tell OpenGL we want to render to the whole window
         glViewport( 0, 0, framebufferWidth, framebufferHeight );
+        CSCI441::setObjectLODTarget( 8.0f, framebufferWidth, framebufferHeight );
 
         // set the projection matrix based on the window size
         // use a perspective projection that ranges
@@ -849,6 +801,7 @@ void run(GLFWwindow* window) {
 
         glfwSwapBuffers(window);                        // flush the OpenGL commands and make sure they get rendered!
         glfwPollEvents();				                // check for any events and signal to redraw screen
+        CSCI441::ResourceRegistry::nextFrame();         // advance the frame our GPU resources are tracked against
 
         updateScene();                                  // update the objects in our scene
     }
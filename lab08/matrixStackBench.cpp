@@ -0,0 +1,176 @@
+/*
+ *  CSCI 441, Computer Graphics, Fall 2020
+ *
+ *  Project: lab08
+ *  File: matrixStackBench.cpp
+ *
+ *  Description:
+ *      Draws a 10 level hierarchy 10000 times, first with the transformation
+ *      stack SimpleShader3 used to keep - each pop multiplied by the inverse of
+ *      the last push and every push and pop sent to the shader right away - and
+ *      then with SimpleShader3 itself.  Reports how long each takes and how far
+ *      the model matrix has drifted from the identity once everything is popped.
+ *
+ *  Usage: matrixStackBench [hierarchies]
+ *
+ */
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <CSCI441/SimpleShader.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef std::chrono::high_resolution_clock Clock;
+
+const int NUM_LEVELS = 10;
+
+// the original stack - the model matrix is undone with an inverse and uploaded on every push and pop
+namespace InverseStack {
+    std::vector<glm::mat4> transformationStack;
+    glm::mat4 modelMatrix(1.0);
+    glm::mat4 viewMatrix(1.0);
+
+    void setNormalMatrix() {
+        glUseProgram(CSCI441_INTERNAL::SimpleShader3::shaderProgramHandle);
+        glm::mat4 modelView = viewMatrix * modelMatrix;
+        glm::mat3 normalMatrix = glm::mat3( glm::transpose( glm::inverse( modelView ) ) );
+        glUniformMatrix3fv(CSCI441_INTERNAL::SimpleShader3::normalMtxLocation, 1, GL_FALSE, &normalMatrix[0][0]);
+    }
+
+    void pushTransformation(const glm::mat4& TRANSFORMATION_MATRIX) {
+        glUseProgram(CSCI441_INTERNAL::SimpleShader3::shaderProgramHandle);
+        transformationStack.emplace_back(TRANSFORMATION_MATRIX);
+
+        modelMatrix *= TRANSFORMATION_MATRIX;
+        glUniformMatrix4fv(CSCI441_INTERNAL::SimpleShader3::modelLocation, 1, GL_FALSE, &modelMatrix[0][0]);
+
+        setNormalMatrix();
+    }
+
+    void popTransformation() {
+        if( !transformationStack.empty() ) {
+            glUseProgram(CSCI441_INTERNAL::SimpleShader3::shaderProgramHandle);
+            glm::mat4 lastTransformation = transformationStack.back();
+            transformationStack.pop_back();
+
+            modelMatrix *= glm::inverse( lastTransformation );
+            glUniformMatrix4fv(CSCI441_INTERNAL::SimpleShader3::modelLocation, 1, GL_FALSE, &modelMatrix[0][0]);
+        }
+    }
+
+    void draw(const GLint PRIMITIVE_TYPE, const GLuint VAOD, const GLuint VERTEX_COUNT) {
+        glUseProgram(CSCI441_INTERNAL::SimpleShader3::shaderProgramHandle);
+        glBindVertexArray(VAOD);
+        glDrawArrays(PRIMITIVE_TYPE, 0, VERTEX_COUNT);
+    }
+}
+
+// a limb at every level, each turned, moved out and scaled from its parent like the joints of a character
+void buildLevels( glm::mat4 levels[NUM_LEVELS] ) {
+    for( int i = 0; i < NUM_LEVELS; i++ ) {
+        glm::mat4 transformation = glm::rotate( glm::mat4(1.0), 0.3f + 0.1f * i, glm::vec3( 0.3f, 1.0f, 0.2f ) );
+        transformation = glm::translate( transformation, glm::vec3( 0.5f, 0.25f * (i % 3), -0.1f ) );
+        levels[i] = glm::scale( transformation, glm::vec3( 0.9f, 1.1f, 0.95f ) );
+    }
+}
+
+float distanceFromIdentity( const glm::mat4 &matrix ) {
+    float maxError = 0.0f;
+    for( int c = 0; c < 4; c++ )
+        for( int r = 0; r < 4; r++ )
+            maxError = fmaxf( maxError, fabsf( matrix[c][r] - (c == r ? 1.0f : 0.0f) ) );
+    return maxError;
+}
+
+double secondsSince( Clock::time_point start ) {
+    return std::chrono::duration<double>( Clock::now() - start ).count();
+}
+
+int main( int argc, char *argv[] ) {
+    int numHierarchies = argc > 1 ? atoi( argv[1] ) : 10000;
+    if( numHierarchies < 1 ) numHierarchies = 1;
+
+    if( !glfwInit() ) {
+        fprintf( stderr, "[ERROR]: Could not initialize GLFW\n" );
+        exit( EXIT_FAILURE );
+    }
+    glfwWindowHint( GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE );
+    glfwWindowHint( GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE );
+    glfwWindowHint( GLFW_CONTEXT_VERSION_MAJOR, 4 );
+    glfwWindowHint( GLFW_CONTEXT_VERSION_MINOR, 1 );
+    GLFWwindow *window = glfwCreateWindow( 640, 640, "Matrix Stack Benchmark", nullptr, nullptr );
+    if( !window ) {
+        fprintf( stderr, "[ERROR]: Could not open window\n" );
+        glfwTerminate();
+        exit( EXIT_FAILURE );
+    }
+    glfwMakeContextCurrent( window );
+    glfwSwapInterval( 0 );
+
+    glewExperimental = GL_TRUE;
+    if( glewInit() != GLEW_OK ) {
+        fprintf( stderr, "[ERROR]: Could not initialize GLEW\n" );
+        exit( EXIT_FAILURE );
+    }
+
+    CSCI441::SimpleShader3::setupSimpleShader();
+    glm::mat4 viewMatrix = glm::lookAt( glm::vec3( 0.0f, 2.0f, 8.0f ), glm::vec3( 0.0f ), glm::vec3( 0.0f, 1.0f, 0.0f ) );
+    CSCI441::SimpleShader3::setProjectionMatrix( glm::perspective( 45.0f, 1.0f, 0.1f, 100.0f ) );
+    CSCI441::SimpleShader3::setViewMatrix( viewMatrix );
+    InverseStack::viewMatrix = viewMatrix;
+
+    std::vector<glm::vec3> points = { glm::vec3( 0.0f, 0.0f, 0.0f ), glm::vec3( 0.1f, 0.0f, 0.0f ), glm::vec3( 0.0f, 0.1f, 0.0f ) };
+    std::vector<glm::vec3> normals( 3, glm::vec3( 0.0f, 0.0f, 1.0f ) );
+    GLuint vaod = CSCI441::SimpleShader3::registerVertexArray( points, normals );
+
+    glm::mat4 levels[NUM_LEVELS];
+    buildLevels( levels );
+
+    printf( "[INFO]: %d hierarchies of %d levels\n", numHierarchies, NUM_LEVELS );
+
+    glFinish();
+    Clock::time_point start = Clock::now();
+    for( int h = 0; h < numHierarchies; h++ ) {
+        for( int i = 0; i < NUM_LEVELS; i++ ) {
+            InverseStack::pushTransformation( levels[i] );
+            InverseStack::draw( GL_TRIANGLES, vaod, 3 );
+        }
+        for( int i = 0; i < NUM_LEVELS; i++ )
+            InverseStack::popTransformation();
+    }
+    glFinish();
+    double inverseSeconds = secondsSince( start );
+    float inverseDrift = distanceFromIdentity( InverseStack::modelMatrix );
+
+    start = Clock::now();
+    for( int h = 0; h < numHierarchies; h++ ) {
+        for( int i = 0; i < NUM_LEVELS; i++ ) {
+            CSCI441::SimpleShader3::pushTransformation( levels[i] );
+            CSCI441::SimpleShader3::draw( GL_TRIANGLES, vaod, 3 );
+        }
+        for( int i = 0; i < NUM_LEVELS; i++ )
+            CSCI441::SimpleShader3::popTransformation();
+    }
+    glFinish();
+    double stackSeconds = secondsSince( start );
+    float stackDrift = distanceFromIdentity( CSCI441_INTERNAL::SimpleShader3::transformationStack.back() );
+
+    printf( "[INFO]: %-14s %10s %14s %12s\n", "", "total ms", "us/hierarchy", "drift" );
+    printf( "[INFO]: %-14s %10.3f %14.3f %12.3g\n", "inverse pop", inverseSeconds * 1e3, inverseSeconds / numHierarchies * 1e6, inverseDrift );
+    printf( "[INFO]: %-14s %10.3f %14.3f %12.3g\n", "SimpleShader3", stackSeconds * 1e3, stackSeconds / numHierarchies * 1e6, stackDrift );
+    printf( "[INFO]: %.1fx faster\n", inverseSeconds / stackSeconds );
+
+    glfwDestroyWindow( window );
+    glfwTerminate();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,145 @@
+/*
+ *  CSCI 441, Computer Graphics, Fall 2020
+ *
+ *  Project: lab08
+ *  File: teapotBench.cpp
+ *
+ *  Description:
+ *      Tessellates the teapot at 10, 64 and 256 samples per patch edge with
+ *      the per vertex Bernstein evaluation it used to use, and with the
+ *      precomputed basis tables on one thread and on every core.  Checks the
+ *      positions agree and reports how long each takes, then checks the teapot
+ *      the compiler evaluates at the default resolution matches the run time one.
+ *
+ *  Usage: teapotBench [repeats]
+ *
+ */
+
+#include <GL/glew.h>
+
+#include <CSCI441/teapot.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::high_resolution_clock Clock;
+
+const int RESOLUTIONS[] = { 10, 64, 256 };
+
+// the original evaluator - binomial coefficients from factorials and powf() for every term of every vertex
+int factorial( int n ) {
+    int result = 1;
+    for( int i = n; i > 1; i-- )
+        result *= i;
+    return result;
+}
+
+float bernsteinPolynomial( int i, int n, float u ) {
+    return 1.0f * factorial( n ) / ( factorial( i ) * factorial( n - i ) ) * powf( u, i ) * powf( 1 - u, n - i );
+}
+
+CSCI441_INTERNAL::vertex evaluatePatch( CSCI441_INTERNAL::vertex controlPoints[][ORDER+1], float u, float v ) {
+    CSCI441_INTERNAL::vertex result = { 0.0f, 0.0f, 0.0f };
+    for( int i = 0; i <= ORDER; i++ ) {
+        float polyI = bernsteinPolynomial( i, ORDER, u );
+        for( int j = 0; j <= ORDER; j++ ) {
+            float polyJ = bernsteinPolynomial( j, ORDER, v );
+            result.x += polyI * polyJ * controlPoints[i][j].x;
+            result.y += polyI * polyJ * controlPoints[i][j].y;
+            result.z += polyI * polyJ * controlPoints[i][j].z;
+        }
+    }
+    return result;
+}
+
+// positions and the old stand in normals, which were the same sum evaluated a second time
+void referenceTeapot( int resolution, std::vector<CSCI441_INTERNAL::vertex> &positions, std::vector<CSCI441_INTERNAL::vertex> &normals ) {
+    positions.resize( TEAPOT_NB_PATCHES * resolution * resolution );
+    normals.resize( TEAPOT_NB_PATCHES * resolution * resolution );
+    for( int p = 0; p < TEAPOT_NB_PATCHES; p++ ) {
+        CSCI441_INTERNAL::vertex controlPoints[ORDER+1][ORDER+1];
+        CSCI441_INTERNAL::build_control_points_k( p, controlPoints );
+        for( int ru = 0; ru < resolution; ru++ ) {
+            float u = 1.0f * ru / ( resolution - 1 );
+            for( int rv = 0; rv < resolution; rv++ ) {
+                float v = 1.0f * rv / ( resolution - 1 );
+                size_t idx = (size_t)p * resolution * resolution + ru * resolution + rv;
+                positions[idx] = evaluatePatch( controlPoints, u, v );
+                normals[idx] = evaluatePatch( controlPoints, u, v );
+            }
+        }
+    }
+}
+
+double secondsSince( Clock::time_point start ) {
+    return std::chrono::duration<double>( Clock::now() - start ).count();
+}
+
+int main( int argc, char *argv[] ) {
+    int repeats = argc > 1 ? atoi( argv[1] ) : 5;
+    if( repeats < 1 ) repeats = 1;
+    int cores = (int)std::thread::hardware_concurrency();
+    if( cores < 1 ) cores = 1;
+
+    printf( "[INFO]: %d repeats, %d cores\n", repeats, cores );
+    printf( "[INFO]: %10s %10s %12s %12s %12s %8s %12s\n", "samples", "vertices", "powf ms", "table ms", "threads ms", "speedup", "max error" );
+
+    bool passed = true;
+    for( int resolution : RESOLUTIONS ) {
+        std::vector<CSCI441_INTERNAL::vertex> reference, referenceNormals;
+        CSCI441::MeshData single, threaded;
+        double referenceSeconds = 0.0, singleSeconds = 0.0, threadedSeconds = 0.0;
+
+        for( int r = 0; r < repeats; r++ ) {
+            Clock::time_point start = Clock::now();
+            referenceTeapot( resolution, reference, referenceNormals );
+            referenceSeconds += secondsSince( start );
+
+            start = Clock::now();
+            single = CSCI441::generateTeapotMesh( resolution, 1 );
+            singleSeconds += secondsSince( start );
+
+            start = Clock::now();
+            threaded = CSCI441::generateTeapotMesh( resolution, cores );
+            threadedSeconds += secondsSince( start );
+        }
+
+        // the closed form basis rounds differently to powf(), so the positions only agree closely
+        float maxError = 0.0f;
+        for( size_t i = 0; i < reference.size(); i++ ) {
+            maxError = fmaxf( maxError, fabsf( reference[i].x - single.positions[i*3 + 0] ) );
+            maxError = fmaxf( maxError, fabsf( reference[i].y - single.positions[i*3 + 1] ) );
+            maxError = fmaxf( maxError, fabsf( reference[i].z - single.positions[i*3 + 2] ) );
+        }
+        bool same = maxError < 1e-5f && single.positions == threaded.positions && single.normals == threaded.normals
+                 && single.indices == threaded.indices;
+        passed = passed && same;
+
+        printf( "[INFO]: %10d %10lu %12.3f %12.3f %12.3f %7.1fx %12.3g %s\n", resolution, single.numVertices(),
+                referenceSeconds / repeats * 1e3, singleSeconds / repeats * 1e3, threadedSeconds / repeats * 1e3,
+                referenceSeconds / threadedSeconds, maxError, same ? "" : "DIFFERENT" );
+    }
+
+    // the compiled table rounds its square roots separately, so the normals only agree closely
+    const CSCI441_INTERNAL::teapot_table &table = CSCI441_INTERNAL::teapot_default_table;
+    CSCI441::MeshData runtime = CSCI441::generateTeapotMesh( TEAPOT_DEFAULT_RESOLUTION, 1 );
+    float tableError = 0.0f;
+    bool sameElements = runtime.indices.size() == (size_t)CSCI441_INTERNAL::teapot_table::NUM_ELEMENTS;
+    for( size_t i = 0; i < runtime.positions.size(); i++ ) {
+        tableError = fmaxf( tableError, fabsf( runtime.positions[i] - table.positions[i] ) );
+        tableError = fmaxf( tableError, fabsf( runtime.normals[i] - table.normals[i] ) );
+    }
+    for( size_t i = 0; sameElements && i < runtime.indices.size(); i++ )
+        sameElements = runtime.indices[i] == table.elements[i];
+    bool tableMatches = tableError < 1e-6f && sameElements;
+    passed = passed && tableMatches;
+
+    printf( "[INFO]: compiled table at %d samples, max error %g %s\n", TEAPOT_DEFAULT_RESOLUTION, tableError, tableMatches ? "" : "DIFFERENT" );
+    printf( "[INFO]: %s\n", passed ? "PASS" : "FAIL" );
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,198 @@
+/*
+ *  CSCI 441, Computer Graphics, Fall 2020
+ *
+ *  Project: lab08
+ *  File: textureUploadBench.cpp
+ *
+ *  Description:
+ *      Measures frame times while 50 large textures are sent to the GPU, first
+ *      with glTexImage2D directly and then through CSCI441::TextureUploader.
+ *
+ *  Usage: textureUploadBench [textureSize]
+ *
+ */
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <CSCI441/TextureUploader.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+const GLint NUM_TEXTURES = 50;
+
+const char *VERTEX_SHADER =
+    "#version 410 core\n"
+    "out vec2 texCoord;\n"
+    "void main() {\n"
+    "    vec2 corner = vec2( gl_VertexID & 1, gl_VertexID >> 1 );\n"
+    "    texCoord = corner;\n"
+    "    gl_Position = vec4( corner * 2.0 - 1.0, 0.0, 1.0 );\n"
+    "}\n";
+const char *FRAGMENT_SHADER =
+    "#version 410 core\n"
+    "uniform sampler2D tex;\n"
+    "in vec2 texCoord;\n"
+    "out vec4 fragColorOut;\n"
+    "void main() {\n"
+    "    fragColorOut = texture( tex, texCoord );\n"
+    "}\n";
+
+GLuint compileProgram() {
+    GLuint vs = glCreateShader( GL_VERTEX_SHADER );
+    glShaderSource( vs, 1, &VERTEX_SHADER, nullptr );
+    glCompileShader( vs );
+    GLuint fs = glCreateShader( GL_FRAGMENT_SHADER );
+    glShaderSource( fs, 1, &FRAGMENT_SHADER, nullptr );
+    glCompileShader( fs );
+
+    GLuint program = glCreateProgram();
+    glAttachShader( program, vs );
+    glAttachShader( program, fs );
+    glLinkProgram( program );
+    glDeleteShader( vs );
+    glDeleteShader( fs );
+    return program;
+}
+
+// procedural RGBA image so the benchmark does not depend on files on disk
+std::vector<unsigned char> makeImage( GLint size, GLint seed ) {
+    std::vector<unsigned char> pixels( (size_t)size * size * 4 );
+    for( GLint j = 0; j < size; j++ ) {
+        for( GLint i = 0; i < size; i++ ) {
+            unsigned char *p = &pixels[ ((size_t)j*size + i) * 4 ];
+            p[0] = (unsigned char)(i + seed * 13);
+            p[1] = (unsigned char)(j + seed * 29);
+            p[2] = (unsigned char)((i ^ j) + seed);
+            p[3] = 255;
+        }
+    }
+    return pixels;
+}
+
+GLuint createTexture() {
+    GLuint texHandle;
+    glGenTextures( 1, &texHandle );
+    glBindTexture( GL_TEXTURE_2D, texHandle );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+    return texHandle;
+}
+
+void drawFrame( GLFWwindow *window, GLuint texHandle ) {
+    glClear( GL_COLOR_BUFFER_BIT );
+    glBindTexture( GL_TEXTURE_2D, texHandle );
+    glDrawArrays( GL_TRIANGLE_STRIP, 0, 4 );
+    glfwSwapBuffers( window );
+    glfwPollEvents();
+}
+
+void printFrameTimes( const char *label, std::vector<double> frameTimes ) {
+    std::sort( frameTimes.begin(), frameTimes.end() );
+    double total = 0.0;
+    for( size_t i = 0; i < frameTimes.size(); i++ ) total += frameTimes[i];
+    printf( "[INFO]: %-16s frames: %4lu  avg: %7.3f ms  p99: %7.3f ms  max: %7.3f ms  total: %8.1f ms\n",
+            label, (unsigned long)frameTimes.size(), total / frameTimes.size(),
+            frameTimes[ (frameTimes.size() * 99) / 100 ], frameTimes.back(), total );
+}
+
+int main( int argc, char *argv[] ) {
+    GLint textureSize = argc > 1 ? atoi( argv[1] ) : 1024;
+
+    if( !glfwInit() ) {
+        fprintf( stderr, "[ERROR]: Could not initialize GLFW\n" );
+        exit( EXIT_FAILURE );
+    }
+    glfwWindowHint( GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE );
+    glfwWindowHint( GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE );
+    glfwWindowHint( GLFW_CONTEXT_VERSION_MAJOR, 4 );
+    glfwWindowHint( GLFW_CONTEXT_VERSION_MINOR, 1 );
+    GLFWwindow *window = glfwCreateWindow( 640, 640, "Texture Upload Benchmark", nullptr, nullptr );
+    if( !window ) {
+        fprintf( stderr, "[ERROR]: Could not open window\n" );
+        glfwTerminate();
+        exit( EXIT_FAILURE );
+    }
+    glfwMakeContextCurrent( window );
+    glfwSwapInterval( 0 );                  // measure our own frame time, not the display's
+
+    glewExperimental = GL_TRUE;
+    if( glewInit() != GLEW_OK ) {
+        fprintf( stderr, "[ERROR]: Could not initialize GLEW\n" );
+        exit( EXIT_FAILURE );
+    }
+
+    GLuint program = compileProgram();
+    GLuint vao;
+    glGenVertexArrays( 1, &vao );
+    glBindVertexArray( vao );
+    glUseProgram( program );
+
+    printf( "[INFO]: Generating %d %dx%d RGBA images...\n", NUM_TEXTURES, textureSize, textureSize );
+    std::vector< std::vector<unsigned char> > images;
+    for( GLint i = 0; i < NUM_TEXTURES; i++ ) {
+        images.push_back( makeImage( textureSize, i ) );
+    }
+
+    typedef std::chrono::high_resolution_clock Clock;
+    GLuint syncTextures[NUM_TEXTURES], asyncTextures[NUM_TEXTURES];
+
+    // one glTexImage2D per frame - the driver copies the whole image before returning
+    std::vector<double> syncFrameTimes;
+    for( GLint i = 0; i < NUM_TEXTURES; i++ ) {
+        Clock::time_point start = Clock::now();
+        syncTextures[i] = createTexture();
+        glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, textureSize, textureSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, &images[i][0] );
+        glGenerateMipmap( GL_TEXTURE_2D );
+        drawFrame( window, syncTextures[i] );
+        syncFrameTimes.push_back( std::chrono::duration<double, std::milli>( Clock::now() - start ).count() );
+    }
+    glFinish();
+
+    // everything queued at once, the uploader spreads the copies across frames
+    std::vector<double> asyncFrameTimes, asyncLatencies;
+    {
+        CSCI441::TextureUploader uploader;
+        for( GLint i = 0; i < NUM_TEXTURES; i++ ) {
+            asyncTextures[i] = createTexture();
+            uploader.upload2DTexture( asyncTextures[i], &images[i][0], textureSize, textureSize, 4 );
+        }
+
+        // nothing has landed yet - latencies count from when the first image was queued and
+        // the last resident texture stands in until the uploader finishes one
+        Clock::time_point submitTime = Clock::now();
+        GLint lastComplete = -1;
+        while( uploader.getNumPendingUploads() > 0 || !uploader.isUploadComplete( asyncTextures[NUM_TEXTURES-1] ) ) {
+            Clock::time_point start = Clock::now();
+            uploader.update();
+            while( lastComplete < NUM_TEXTURES-1 && uploader.isUploadComplete( asyncTextures[lastComplete+1] ) ) {
+                lastComplete++;
+                asyncLatencies.push_back( std::chrono::duration<double, std::milli>( Clock::now() - submitTime ).count() );
+            }
+            drawFrame( window, lastComplete < 0 ? syncTextures[NUM_TEXTURES-1] : asyncTextures[lastComplete] );
+            asyncFrameTimes.push_back( std::chrono::duration<double, std::milli>( Clock::now() - start ).count() );
+        }
+        glFinish();
+    }
+
+    printf( "[INFO]: Persistent mapping %s\n", GLEW_ARB_buffer_storage ? "available" : "unavailable, mapping each slot" );
+    printFrameTimes( "glTexImage2D", syncFrameTimes );
+    printFrameTimes( "TextureUploader", asyncFrameTimes );
+    if( !asyncLatencies.empty() ) {
+        printf( "[INFO]: TextureUploader  first texture ready after %7.3f ms  last after %8.1f ms\n",
+                asyncLatencies.front(), asyncLatencies.back() );
+    }
+
+    glDeleteTextures( NUM_TEXTURES, syncTextures );
+    glDeleteTextures( NUM_TEXTURES, asyncTextures );
+    glDeleteVertexArrays( 1, &vao );
+    glDeleteProgram( program );
+    glfwDestroyWindow( window );
+    glfwTerminate();
+
+    return EXIT_SUCCESS;
+}
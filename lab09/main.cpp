@@ -7,6 +7,10 @@
  *  Description:
  *      This file contains the start to render a Bezier curve.
  *
+ *  Usage: lab09 [--cpu]
+ *      --cpu tessellates the patches on the CPU instead of with the
+ *      tessellation shaders.  T switches between the two while running.
+ *
  *  Author: Dr. Paone, Colorado School of Mines, 2020
  *
  */
@@ -23,7 +27,11 @@
 
 #include <cstdio>				        // for printf functionality
 #include <cstdlib>				        // for exit functionality
+#include <cstring>                      // for strcmp
+#include <algorithm>                    // for copy and equal
+#include <vector>                       // for vector
 
+#include <CSCI441/BezierSurface.hpp>    // tessellates Bezier patches on the CPU
 #include <CSCI441/materials.hpp>        // our pre-defined material properties
 #include <CSCI441/OpenGLUtils.hpp>      // prints OpenGL information
 #include <CSCI441/objects.hpp>          // draws 3D objects
@@ -54,9 +62,9 @@ GLuint lightType;                       // type of the light - 0 point 1 directi
 
 // all drawing information
 const struct VAO_IDS {
-    GLuint CAGE = 0, PATCH = 1;         // unique idenfitiers for each VAO
+    GLuint CAGE = 0, PATCH = 1, SURFACE = 2;    // unique idenfitiers for each VAO
 } VAOS;
-const GLuint NUM_VAOS = 2;
+const GLuint NUM_VAOS = 3;
 GLuint vaos[NUM_VAOS];                  // an array of our VAO descriptors
 GLuint vbos[NUM_VAOS];                  // an array of our VBO descriptors
 GLuint ibos[NUM_VAOS];                  // an array of our IBO descriptors
@@ -66,8 +74,23 @@ const GLuint POINTS_PER_PATCH = 16;     // the number of control points per patc
 GLuint numControlPoints;                // number of control points in the patch system
 glm::vec3 *controlPoints = nullptr;     // control points array
 GLuint numSurfaces;                     // the total number of surfaces to draw
+GLushort *patchIndices = nullptr;       // control point indices of each patch
 GLboolean drawPoints, drawCage;         // flags to draw the control points and/or cage
 
+// Patch culling information
+std::vector<GLuint> visiblePatches;     // patches inside the view this frame
+std::vector<GLuint> drawnPatches;       // patches currently in the patch IBO
+std::vector<GLushort> visibleIndices;   // control point indices of the visible patches
+GLboolean cullBackPatches;              // if patches facing away from the camera are skipped
+
+// CPU tessellation of the patches, used when the context has no tessellation shaders
+GLboolean useTessellationShaders;       // if the patches are tessellated on the GPU
+GLboolean forceCPUTessellation = false; // set by --cpu to tessellate on the CPU even when the GPU can
+CSCI441::BezierSurface bezierSurface;   // the patches to tessellate on the CPU
+GLuint numSurfaceIndices = 0;           // number of indices in the CPU tessellated surface
+glm::mat4 surfaceMVPMatrix(0.0f);       // the MVP Matrix the surface was last tessellated for
+GLint surfaceViewport[4] = {0, 0, 0, 0};// the viewport the surface was last tessellated for
+
 // gourad with phong illumination shader program
 CSCI441::ShaderProgram *gouradShaderProgram = nullptr;
 struct GouradShaderProgramUniforms {
@@ -215,6 +238,40 @@ void loadControlPointsFromFile(const char* FILENAME, GLuint* numBezierPoints, GL
     fclose(file);
 }
 
+/// tessellateSurface() /////////////////////////////////////////////////////////
+///
+/// This function tessellates the given Bezier patches on the CPU finely enough
+/// that no triangle strays more than half a pixel from the surface when drawn
+/// with the given MVP Matrix into the given viewport, and sends the triangles
+/// to the GPU.
+///
+////////////////////////////////////////////////////////////////////////////////
+void tessellateSurface( glm::mat4 mvpMatrix, const GLint viewport[4], const std::vector<GLuint> &patches ) {
+    bezierSurface.setScreenTolerance( &mvpMatrix[0][0], viewport[2], viewport[3], 0.5f );
+    CSCI441::MeshData surface = bezierSurface.tessellate( patches );
+    GLsizeiptr vertexBytes = surface.positions.size() * sizeof(GLfloat);
+
+    glBindVertexArray( vaos[VAOS.SURFACE] );
+
+    // positions followed by normals
+    glBindBuffer( GL_ARRAY_BUFFER, vbos[VAOS.SURFACE] );
+    glBufferData( GL_ARRAY_BUFFER, vertexBytes * 2, nullptr, GL_DYNAMIC_DRAW );
+    glBufferSubData( GL_ARRAY_BUFFER, 0, vertexBytes, surface.positions.data() );
+    glBufferSubData( GL_ARRAY_BUFFER, vertexBytes, vertexBytes, surface.normals.data() );
+
+    glEnableVertexAttribArray( gouradShaderProgramAttributes.vPos );
+    glVertexAttribPointer( gouradShaderProgramAttributes.vPos, 3, GL_FLOAT, GL_FALSE, 0, (void*) 0 );
+    glEnableVertexAttribArray( gouradShaderProgramAttributes.vNormal );
+    glVertexAttribPointer( gouradShaderProgramAttributes.vNormal, 3, GL_FLOAT, GL_FALSE, 0, (void*) vertexBytes );
+
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, ibos[VAOS.SURFACE] );
+    glBufferData( GL_ELEMENT_ARRAY_BUFFER, surface.indices.size() * sizeof(GLuint), surface.indices.data(), GL_DYNAMIC_DRAW );
+
+    numSurfaceIndices = surface.indices.size();
+    surfaceMVPMatrix = mvpMatrix;
+    std::copy( viewport, viewport + 4, surfaceViewport );
+}
+
 ///***********************************************************************************************************************************************************
 //
 // Event Callbacks
@@ -253,6 +310,21 @@ static void key_callback(GLFWwindow* window, int key, int scancode, int action,
                 drawPoints = !drawPoints;
                 break;
 
+            case GLFW_KEY_B:
+                cullBackPatches = !cullBackPatches;
+                // the CPU tessellation needs redoing for the new set of patches
+                surfaceMVPMatrix = glm::mat4(0.0f);
+                break;
+
+            case GLFW_KEY_T:
+                // switch between GPU and CPU tessellation, only possible when the GPU can tessellate
+                if( bezierShaderProgram != nullptr ) {
+                    useTessellationShaders = !useTessellationShaders;
+                    surfaceMVPMatrix = glm::mat4(0.0f);
+                    fprintf( stdout, "[INFO]: tessellating patches on the %s\n", useTessellationShaders ? "GPU" : "CPU" );
+                }
+                break;
+
                 // toggle between light types
             case GLFW_KEY_1:    // point light
             case GLFW_KEY_2:    // directional light
@@ -405,8 +477,14 @@ void setupOpenGL() {
 
     glClearColor( 0.0f, 0.0f, 0.0f, 1.0f );	// clear the frame buffer to black
 
-    // set the number of control points per patch
-    glPatchParameteri( GL_PATCH_VERTICES, POINTS_PER_PATCH);
+    // tessellation shaders need OpenGL 4.0, otherwise the patches are tessellated on the CPU
+    useTessellationShaders = GLEW_VERSION_4_0 || GLEW_ARB_tessellation_shader;
+    if( useTessellationShaders ) {
+        // set the number of control points per patch
+        glPatchParameteri( GL_PATCH_VERTICES, POINTS_PER_PATCH);
+    } else {
+        fprintf( stdout, "[INFO]: Tessellation shaders are not supported, tessellating patches on the CPU\n" );
+    }
 }
 
 /// setupGLEW() /////////////////////////////////////////////////////////////////
@@ -458,10 +536,12 @@ void setupShaders() {
     flatShaderProgramUniforms.color                 = flatShaderProgram->getUniformLocation("color");
     flatShaderProgramAttributes.vPos                = flatShaderProgram->getAttributeLocation("vPos");
 
-    bezierShaderProgram = new CSCI441::ShaderProgram( "shaders/bezierPatch.v.glsl", "shaders/bezierPatch.tc.glsl",
-        "shaders/bezierPatch.te.glsl","shaders/bezierPatch.f.glsl" );
-    bezierShaderProgramUniforms.mvpMatrix           = bezierShaderProgram->getUniformLocation("mvpMatrix");
-    bezierShaderProgramAttributes.vPos              = bezierShaderProgram->getAttributeLocation("vPos");
+    if( useTessellationShaders ) {
+        bezierShaderProgram = new CSCI441::ShaderProgram( "shaders/bezierPatch.v.glsl", "shaders/bezierPatch.tc.glsl",
+            "shaders/bezierPatch.te.glsl","shaders/bezierPatch.f.glsl" );
+        bezierShaderProgramUniforms.mvpMatrix       = bezierShaderProgram->getUniformLocation("mvpMatrix");
+        bezierShaderProgramAttributes.vPos          = bezierShaderProgram->getAttributeLocation("vPos");
+    }
 }
 
 /// setupBuffers() //////////////////////////////////////////////////////////////
@@ -479,7 +559,6 @@ void setupBuffers() {
     // ------------------------------------------------------------------------------------------------------
     // read in the control points
 
-    GLushort* patchIndices = nullptr;
     loadControlPointsFromFile("assets/models/surface.txt", &numControlPoints, &numSurfaces, controlPoints, patchIndices);
     if(!controlPoints) {
         fprintf( stderr, "[ERROR]: Error loading control points from file\n" );
@@ -523,12 +602,26 @@ void setupBuffers() {
         glEnableVertexAttribArray( bezierShaderProgramAttributes.vPos );
         glVertexAttribPointer( bezierShaderProgramAttributes.vPos, 3, GL_FLOAT, GL_FALSE, 0, (void*) 0 );
 
+        // the patches that are visible are copied to the front of the buffer every frame
         glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, ibos[VAOS.PATCH] );
-        glBufferData( GL_ELEMENT_ARRAY_BUFFER, numSurfaces * POINTS_PER_PATCH * sizeof(GLushort), patchIndices, GL_STATIC_DRAW );
-
-        free(patchIndices);
+        glBufferData( GL_ELEMENT_ARRAY_BUFFER, numSurfaces * POINTS_PER_PATCH * sizeof(GLushort), patchIndices, GL_DYNAMIC_DRAW );
+        for(GLuint i = 0; i < numSurfaces; i++) {
+            drawnPatches.push_back(i);
+        }
 
         fprintf( stdout, "[INFO]: surface control points read in with VAO %d\n", vaos[VAOS.PATCH] );
+
+        // --------------------------------------------------------------------------------------------------
+        // hand the patches to the CPU tessellator, which also bounds each patch for culling
+
+        GLuint* surfaceIndices = (GLuint*)malloc(sizeof(GLuint)*numSurfaces*POINTS_PER_PATCH);
+        for(GLuint i = 0; i < numSurfaces * POINTS_PER_PATCH; i++) {
+            surfaceIndices[i] = patchIndices[i];
+        }
+        bezierSurface.setControlPoints( &(controlPoints[0].x), numControlPoints );
+        bezierSurface.setPatches( surfaceIndices, numSurfaces );
+
+        free(surfaceIndices);
     }
 }
 
@@ -559,6 +652,12 @@ void setupScene() {
     arcballCam.upVector       = glm::vec3(    0.0f,  1.0f,  0.0f );
     updateCameraDirection();
 
+    // the tessellation shaders are still built so T can switch back to them
+    if( forceCPUTessellation && useTessellationShaders ) {
+        useTessellationShaders = GL_FALSE;
+        fprintf( stdout, "[INFO]: --cpu given, tessellating patches on the CPU\n" );
+    }
+
     // set up light info
     glm::vec3 lightColor(1.0f, 1.0f, 1.0f);
     glm::vec3 lightPos(5.0f, 15.0f, 5.0f);
@@ -579,6 +678,8 @@ void setupScene() {
     // setup drawing info
     drawCage = GL_TRUE;
     drawPoints = GL_TRUE;
+    // the surface is open and its back is drawn in its own colors, so keep back patches until asked
+    cullBackPatches = GL_FALSE;
 }
 
 /// initialize() /////////////////////////////////////////////////////////////////
@@ -644,6 +745,7 @@ void cleanupBuffers() {
     CSCI441::deleteObjectVAOs();
 
     free(controlPoints);
+    free(patchIndices);
 }
 
 /// cleanupTextures() ///////////////////////////////////////////////////////////
@@ -734,13 +836,53 @@ void renderScene( glm::mat4 viewMatrix, glm::mat4 projectionMatrix ) {
         }
     }
 
-    // use the bezier shader to draw surface
-    bezierShaderProgram->useProgram();
     modelMatrix = glm::mat4(1.0f);
-    computeAndSendTransformationMatrices(modelMatrix, viewMatrix, projectionMatrix,
-                                         bezierShaderProgramUniforms.mvpMatrix);
-    glBindVertexArray( vaos[VAOS.PATCH] );
-    glDrawElements(GL_PATCHES, numSurfaces * POINTS_PER_PATCH, GL_UNSIGNED_SHORT, (void*)0);
+    glm::mat4 mvpMatrix = projectionMatrix * viewMatrix * modelMatrix;
+
+    // skip the patches whose control points are all outside the view, or that face away from the camera
+    // the surface has no model transformation, so the camera position is already in its space
+    bezierSurface.cullPatches( &mvpMatrix[0][0], cullBackPatches ? &(arcballCam.eyePos[0]) : nullptr, visiblePatches );
+
+    if( useTessellationShaders ) {
+        // pack the visible patches to the front of the patch IBO when they change
+        glBindVertexArray( vaos[VAOS.PATCH] );
+        if( visiblePatches != drawnPatches ) {
+            visibleIndices.clear();
+            for( GLuint patch : visiblePatches ) {
+                visibleIndices.insert( visibleIndices.end(), patchIndices + patch * POINTS_PER_PATCH, patchIndices + (patch + 1) * POINTS_PER_PATCH );
+            }
+            glBufferSubData( GL_ELEMENT_ARRAY_BUFFER, 0, visibleIndices.size() * sizeof(GLushort), visibleIndices.data() );
+            drawnPatches = visiblePatches;
+        }
+
+        // use the bezier shader to draw surface
+        bezierShaderProgram->useProgram();
+        computeAndSendTransformationMatrices(modelMatrix, viewMatrix, projectionMatrix,
+                                             bezierShaderProgramUniforms.mvpMatrix);
+        glDrawElements(GL_PATCHES, drawnPatches.size() * POINTS_PER_PATCH, GL_UNSIGNED_SHORT, (void*)0);
+    } else {
+        // tessellate on the CPU again only when the camera has moved or the framebuffer has been resized
+        GLint viewport[4];
+        glGetIntegerv( GL_VIEWPORT, viewport );
+        if( mvpMatrix != surfaceMVPMatrix || !std::equal( viewport, viewport + 4, surfaceViewport ) ) {
+            tessellateSurface( mvpMatrix, viewport, visiblePatches );
+        }
+
+        // use the gourad shader to draw the tessellated surface
+        gouradShaderProgram->useProgram();
+        glUniform3fv( gouradShaderProgramUniforms.eyePos, 1, &(arcballCam.eyePos[0]));
+        sendMaterialProperties( CSCI441::Materials::JADE,
+                                gouradShaderProgramUniforms.materialDiffColor,
+                                gouradShaderProgramUniforms.materialSpecColor,
+                                gouradShaderProgramUniforms.materialShininess,
+                                gouradShaderProgramUniforms.materialAmbColor );
+        computeAndSendTransformationMatrices( modelMatrix, viewMatrix, projectionMatrix,
+                                              gouradShaderProgramUniforms.mvpMatrix,
+                                              gouradShaderProgramUniforms.modelMatrix,
+                                              gouradShaderProgramUniforms.normalMtx );
+        glBindVertexArray( vaos[VAOS.SURFACE] );
+        glDrawElements( GL_TRIANGLES, numSurfaceIndices, GL_UNSIGNED_INT, (void*)0 );
+    }
 
 }
 
@@ -804,7 +946,14 @@ void run(GLFWwindow* window) {
 /// main() //////////////////////////////////////////////////////////////////////
 ///
 ////////////////////////////////////////////////////////////////////////////////
-int main() {
+int main( int argc, char *argv[] ) {
+    // --cpu tessellates the patches on the CPU even when tessellation shaders are available
+    for( int i = 1; i < argc; i++ ) {
+        if( strcmp( argv[i], "--cpu" ) == 0 ) {
+            forceCPUTessellation = true;
+        }
+    }
+
     GLFWwindow *window = initialize();                  // create OpenGL context and setup EVERYTHING for our program
     run(window);                                        // enter our draw loop and run our program
     shutdown(window);                                   // free up all the memory used and close OpenGL context
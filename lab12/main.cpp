@@ -52,18 +52,18 @@ struct CameraParameters {
 } arcballCam;
 
 // all drawing information
-const GLuint NUM_VAOS = 8;
+const GLuint NUM_VAOS = 3;
 const struct VAO_IDS {
-    const GLuint SKYBOX = 0;            // skybox is in order 0-5 (Back, Right, Front, Left, Bottom, Top)
-    const GLuint PLATFORM = 6;
-    const GLuint TEXTURED_QUAD = 7;
+    const GLuint SKYBOX = 0;            // a single cube sampled with the skybox cube map
+    const GLuint PLATFORM = 1;
+    const GLuint TEXTURED_QUAD = 2;
 } VAOS;
 GLuint vaos[NUM_VAOS];                  // an array of our VAO descriptors
 GLuint vbos[NUM_VAOS];                  // an array of our VBO descriptors
 GLuint ibos[NUM_VAOS];                  // an array of our IBO descriptors
 
 // skybox information
-GLuint skyboxHandles[6];                // all of our skybox texture handles in order 0-5 (Back, Right, Front, Left, Bottom, Top)
+GLuint skyboxCubemapHandle;             // cube map holding all six skybox faces
 
 // platform information
 GLuint platformTextureHandle;           // handle for the platform texture
@@ -75,7 +75,7 @@ GLuint fbo, rbo;                        // handles for the FBO and RBO
 const GLint FBO_WIDTH = 1024, FBO_HEIGHT = 1024;  // FBO dimensions
 GLuint fboTextureHandle;        // texture handle to render the FBO to
 
-// Texture shader program for skybox and ground
+// Texture shader program for ground
 CSCI441::ShaderProgram *textureShaderProgram = nullptr;
 struct TextureShaderProgramUniforms {
     GLint mvpMtx;                       // the MVP Matrix to apply
@@ -86,6 +86,16 @@ struct TextureShaderProgramAttributes {
     GLint vTexCoord;                    // the vertex texture coordinate
 } textureShaderProgramAttributes;
 
+// Skybox shader program for the cube mapped sky
+CSCI441::ShaderProgram *skyboxShaderProgram = nullptr;
+struct SkyboxShaderProgramUniforms {
+    GLint viewProjectionMtx;            // the View-Projection Matrix with the camera translation removed
+    GLint cubemap;                      // the cube map to apply
+} skyboxShaderProgramUniforms;
+struct SkyboxShaderProgramAttributes {
+    GLint vPos;                         // the vertex position, also the cube map direction
+} skyboxShaderProgramAttributes;
+
 // Phong shader program for object model
 CSCI441::ShaderProgram *modelPhongShaderProgram = nullptr;
 struct ModelPhongShaderProgramUniforms {
@@ -387,6 +397,13 @@ void setupShaders() {
     textureShaderProgram->useProgram();
     glUniform1i(textureShaderProgramUniforms.tex, 0);
 
+    skyboxShaderProgram = new CSCI441::ShaderProgram( "shaders/skybox.v.glsl", "shaders/skybox.f.glsl" );
+    skyboxShaderProgramUniforms.viewProjectionMtx       = skyboxShaderProgram->getUniformLocation( "viewProjectionMtx" );
+    skyboxShaderProgramUniforms.cubemap                 = skyboxShaderProgram->getUniformLocation( "cubemap" );
+    skyboxShaderProgramAttributes.vPos                  = skyboxShaderProgram->getAttributeLocation( "vPos" );
+    skyboxShaderProgram->useProgram();
+    glUniform1i(skyboxShaderProgramUniforms.cubemap, 0);
+
     modelPhongShaderProgram = new CSCI441::ShaderProgram( "shaders/texturingPhong.v.glsl", "shaders/texturingPhong.f.glsl" );
     modelPhongShaderProgramUniforms.modelViewMtx 	    = modelPhongShaderProgram->getUniformLocation( "modelviewMtx" );
     modelPhongShaderProgramUniforms.viewMtx 		    = modelPhongShaderProgram->getUniformLocation( "viewMtx" );
@@ -469,68 +486,34 @@ void setupBuffers() {
     //
     // SKYBOX
 
-    const GLfloat SKYBOX_SIZE = 40.0f;
-    const VertexTextured SKYBOX_VERTICES[6][4] = {
-            { // back
-                    {glm::vec3(-SKYBOX_SIZE, -SKYBOX_SIZE, -SKYBOX_SIZE), glm::vec2( 0.0f, 0.0f) }, // 0 - BL
-                    {glm::vec3(-SKYBOX_SIZE, -SKYBOX_SIZE,  SKYBOX_SIZE), glm::vec2(-1.0f, 0.0f) }, // 1 - BR
-                    {glm::vec3(-SKYBOX_SIZE,  SKYBOX_SIZE, -SKYBOX_SIZE), glm::vec2( 0.0f, 1.0f) }, // 2 - TL
-                    {glm::vec3(-SKYBOX_SIZE,  SKYBOX_SIZE,  SKYBOX_SIZE), glm::vec2(-1.0f, 1.0f) }  // 3 - TR
-            },
-
-            { // right
-                    {glm::vec3(-SKYBOX_SIZE, -SKYBOX_SIZE,  SKYBOX_SIZE), glm::vec2( 0.0f, 0.0f) }, // 0 - BL
-                    {glm::vec3( SKYBOX_SIZE, -SKYBOX_SIZE,  SKYBOX_SIZE), glm::vec2(-1.0f, 0.0f) }, // 1 - BR
-                    {glm::vec3(-SKYBOX_SIZE,  SKYBOX_SIZE,  SKYBOX_SIZE), glm::vec2( 0.0f, 1.0f) }, // 2 - TL
-                    {glm::vec3( SKYBOX_SIZE,  SKYBOX_SIZE,  SKYBOX_SIZE), glm::vec2(-1.0f, 1.0f) }  // 3 - TR
-            },
-
-            { // front
-                    { glm::vec3(SKYBOX_SIZE, -SKYBOX_SIZE, -SKYBOX_SIZE), glm::vec2(0.0f,  0.0f) }, // 0 - BL
-                    { glm::vec3(SKYBOX_SIZE, -SKYBOX_SIZE,  SKYBOX_SIZE), glm::vec2(1.0f,  0.0f) }, // 1 - BR
-                    { glm::vec3(SKYBOX_SIZE,  SKYBOX_SIZE, -SKYBOX_SIZE), glm::vec2(0.0f,  1.0f) }, // 2 - TL
-                    { glm::vec3(SKYBOX_SIZE,  SKYBOX_SIZE,  SKYBOX_SIZE), glm::vec2(1.0f,  1.0f) }  // 3 - TR
-            },
-
-            { // left
-                    {glm::vec3(-SKYBOX_SIZE, -SKYBOX_SIZE, -SKYBOX_SIZE), glm::vec2(0.0f,  0.0f) }, // 0 - BL
-                    {glm::vec3( SKYBOX_SIZE, -SKYBOX_SIZE, -SKYBOX_SIZE), glm::vec2(1.0f,  0.0f) }, // 1 - BR
-                    {glm::vec3(-SKYBOX_SIZE,  SKYBOX_SIZE, -SKYBOX_SIZE), glm::vec2(0.0f,  1.0f) }, // 2 - TL
-                    {glm::vec3( SKYBOX_SIZE,  SKYBOX_SIZE, -SKYBOX_SIZE), glm::vec2(1.0f,  1.0f) }  // 3 - TR
-            },
-
-            { // bottom
-                    {glm::vec3(-SKYBOX_SIZE, -SKYBOX_SIZE, -SKYBOX_SIZE), glm::vec2(0.0f,  0.0f) }, // 0 - BL
-                    {glm::vec3( SKYBOX_SIZE, -SKYBOX_SIZE, -SKYBOX_SIZE), glm::vec2(0.0f,  1.0f) }, // 1 - BR
-                    {glm::vec3(-SKYBOX_SIZE, -SKYBOX_SIZE,  SKYBOX_SIZE), glm::vec2(1.0f,  0.0f) }, // 2 - TL
-                    {glm::vec3( SKYBOX_SIZE, -SKYBOX_SIZE,  SKYBOX_SIZE), glm::vec2(1.0f,  1.0f) }  // 3 - TR
-            },
-
-            { // top
-                    {glm::vec3(-SKYBOX_SIZE,  SKYBOX_SIZE, -SKYBOX_SIZE), glm::vec2(-1.0f, 1.0f) }, // 0 - BL
-                    {glm::vec3( SKYBOX_SIZE,  SKYBOX_SIZE, -SKYBOX_SIZE), glm::vec2(-1.0f, 0.0f) }, // 1 - BR
-                    {glm::vec3(-SKYBOX_SIZE,  SKYBOX_SIZE,  SKYBOX_SIZE), glm::vec2( 0.0f, 1.0f) }, // 2 - TL
-                    {glm::vec3( SKYBOX_SIZE,  SKYBOX_SIZE,  SKYBOX_SIZE), glm::vec2( 0.0f, 0.0f) }  // 3 - TR
-            }
+    // the shader removes the camera translation and pushes every vertex to the far plane,
+    // so a unit cube is enough to surround the scene
+    const glm::vec3 SKYBOX_VERTICES[8] = {
+            glm::vec3(-1.0f, -1.0f, -1.0f), glm::vec3( 1.0f, -1.0f, -1.0f),
+            glm::vec3(-1.0f,  1.0f, -1.0f), glm::vec3( 1.0f,  1.0f, -1.0f),
+            glm::vec3(-1.0f, -1.0f,  1.0f), glm::vec3( 1.0f, -1.0f,  1.0f),
+            glm::vec3(-1.0f,  1.0f,  1.0f), glm::vec3( 1.0f,  1.0f,  1.0f)
     };
 
-    const unsigned short SKYBOX_INDICES[4] = {0, 1, 2, 3 };
+    const unsigned short SKYBOX_INDICES[36] = {
+            0, 1, 2,   2, 1, 3,     // -Z
+            4, 6, 5,   5, 6, 7,     // +Z
+            0, 2, 4,   4, 2, 6,     // -X
+            1, 5, 3,   3, 5, 7,     // +X
+            0, 4, 1,   1, 4, 5,     // -Y
+            2, 3, 6,   6, 3, 7      // +Y
+    };
 
-    for( int i = 0; i < 6; i++ ) {
-        glBindVertexArray( vaos[VAOS.SKYBOX + i] );
+    glBindVertexArray( vaos[VAOS.SKYBOX] );
 
-        glBindBuffer( GL_ARRAY_BUFFER, vbos[VAOS.SKYBOX + i] );
-        glBufferData( GL_ARRAY_BUFFER, sizeof(SKYBOX_VERTICES[i]), SKYBOX_VERTICES[i], GL_STATIC_DRAW );
+    glBindBuffer( GL_ARRAY_BUFFER, vbos[VAOS.SKYBOX] );
+    glBufferData( GL_ARRAY_BUFFER, sizeof(SKYBOX_VERTICES), SKYBOX_VERTICES, GL_STATIC_DRAW );
 
-        glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, ibos[VAOS.SKYBOX + i] );
-        glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof(SKYBOX_INDICES), SKYBOX_INDICES, GL_STATIC_DRAW );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, ibos[VAOS.SKYBOX] );
+    glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof(SKYBOX_INDICES), SKYBOX_INDICES, GL_STATIC_DRAW );
 
-        glEnableVertexAttribArray( textureShaderProgramAttributes.vPos );
-        glVertexAttribPointer( textureShaderProgramAttributes.vPos, 3, GL_FLOAT, GL_FALSE, sizeof(VertexTextured), (void*) 0 );
-
-        glEnableVertexAttribArray( textureShaderProgramAttributes.vTexCoord );
-        glVertexAttribPointer( textureShaderProgramAttributes.vTexCoord, 2, GL_FLOAT, GL_FALSE, sizeof(VertexTextured), (void*) (sizeof(GLfloat) * 3) );
-    }
+    glEnableVertexAttribArray( skyboxShaderProgramAttributes.vPos );
+    glVertexAttribPointer( skyboxShaderProgramAttributes.vPos, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*) 0 );
 
     // ////////////////////////////////////////
     //
@@ -568,15 +551,20 @@ void setupBuffers() {
 void setupTextures() {
     platformTextureHandle = CSCI441::TextureUtils::loadAndRegisterTexture( "assets/textures/ground.png" );
 
-    // get handles for our full skybox
+    // get a handle for our full skybox - faces are in cube map order +X, -X, +Y, -Y, +Z, -Z
+    // the skybox shader looks up along (z, y, x), so the front lands on +X and the right on +Z
+    // with the same orientation the old skybox quads gave them
     printf( "[INFO]: registering skybox...\n" );
     fflush( stdout );
-    skyboxHandles[0] = CSCI441::TextureUtils::loadAndRegisterTexture( "assets/textures/skybox/DOOM16BK.png"   );
-    skyboxHandles[1] = CSCI441::TextureUtils::loadAndRegisterTexture( "assets/textures/skybox/DOOM16RT.png"   );
-    skyboxHandles[2] = CSCI441::TextureUtils::loadAndRegisterTexture( "assets/textures/skybox/DOOM16FT.png"  );
-    skyboxHandles[3] = CSCI441::TextureUtils::loadAndRegisterTexture( "assets/textures/skybox/DOOM16LF.png"  );
-    skyboxHandles[4] = CSCI441::TextureUtils::loadAndRegisterTexture( "assets/textures/skybox/DOOM16DN.png" );
-    skyboxHandles[5] = CSCI441::TextureUtils::loadAndRegisterTexture( "assets/textures/skybox/DOOM16UP.png"    );
+    const char* SKYBOX_FACES[6] = {
+            "assets/textures/skybox/DOOM16RT.png",
+            "assets/textures/skybox/DOOM16LF.png",
+            "assets/textures/skybox/DOOM16UP.png",
+            "assets/textures/skybox/DOOM16DN.png",
+            "assets/textures/skybox/DOOM16FT.png",
+            "assets/textures/skybox/DOOM16BK.png"
+    };
+    skyboxCubemapHandle = CSCI441::TextureUtils::loadCubemap( SKYBOX_FACES );
     printf( "[INFO]: skybox textures read in and registered!\n\n" );
 }
 
@@ -669,6 +657,7 @@ void cleanupShaders() {
     fprintf( stdout, "[INFO]: ...deleting shaders.\n" );
 
     delete textureShaderProgram;
+    delete skyboxShaderProgram;
     delete modelPhongShaderProgram;
     delete postprocessingShaderProgram;
 }
@@ -701,7 +690,7 @@ void cleanupTextures() {
     fprintf( stdout, "[INFO]: ...deleting textures\n" );
 
     glDeleteTextures(1, &platformTextureHandle);
-    glDeleteTextures(6, skyboxHandles);
+    glDeleteTextures(1, &skyboxCubemapHandle);
 }
 
 void cleanupFramebuffers() {
@@ -746,7 +735,7 @@ void renderScene( glm::mat4 viewMatrix, glm::mat4 projectionMatrix ) {
 
     // ///////////////////////
     //
-    // Draw Textured Skybox
+    // Draw Textured Platform
 
     textureShaderProgram->useProgram();
     computeAndSendTransformationMatrices(modelMatrix, viewMatrix, projectionMatrix,
@@ -755,16 +744,6 @@ void renderScene( glm::mat4 viewMatrix, glm::mat4 projectionMatrix ) {
                                          textureShaderProgramUniforms.mvpMtx,
                                          -1);
 
-    for( unsigned int i = 0; i < 6; i++ ) {
-        glBindVertexArray( vaos[VAOS.SKYBOX + i] );
-        glBindTexture( GL_TEXTURE_2D, skyboxHandles[i] );
-        glDrawElements(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_SHORT, (void*)0);
-    }
-
-    // ///////////////////////
-    //
-    // Draw Textured Platform
-
     glBindVertexArray( vaos[VAOS.PLATFORM] );
     glBindTexture( GL_TEXTURE_2D, platformTextureHandle );
     glDrawElements( GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_SHORT, (void*)0 );
@@ -785,6 +764,21 @@ void renderScene( glm::mat4 viewMatrix, glm::mat4 projectionMatrix ) {
     townModel->draw( modelPhongShaderProgramAttributes.vPos, modelPhongShaderProgramAttributes.vNormal, modelPhongShaderProgramAttributes.vTextureCoord,
                      modelPhongShaderProgramUniforms.materialDiffuse, modelPhongShaderProgramUniforms.materialSpecular, modelPhongShaderProgramUniforms.materialShininess, modelPhongShaderProgramUniforms.materialAmbient,
                      GL_TEXTURE0 );
+
+    // ///////////////////////
+    //
+    // Draw Cube Mapped Skybox
+    // drawn last so every pixel already covered by the scene fails the depth test before shading
+
+    skyboxShaderProgram->useProgram();
+    glm::mat4 skyboxViewProjection = projectionMatrix * glm::mat4( glm::mat3( viewMatrix ) );
+    glUniformMatrix4fv( skyboxShaderProgramUniforms.viewProjectionMtx, 1, GL_FALSE, &skyboxViewProjection[0][0] );
+
+    glDepthFunc( GL_LEQUAL );                           // the sky sits exactly on the far plane
+    glBindVertexArray( vaos[VAOS.SKYBOX] );
+    glBindTexture( GL_TEXTURE_CUBE_MAP, skyboxCubemapHandle );
+    glDrawElements( GL_TRIANGLES, 36, GL_UNSIGNED_SHORT, (void*)0 );
+    glDepthFunc( GL_LESS );
 }
 
 // /////////////////////////////////////////////////////////////////////////////
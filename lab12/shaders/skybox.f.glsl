@@ -0,0 +1,11 @@
+#version 410 core
+
+uniform samplerCube cubemap;
+
+layout(location = 0) in vec3 texCoord;
+
+layout(location = 0) out vec4 fragColorOut;
+
+void main() {
+  fragColorOut = texture( cubemap, texCoord );
+}
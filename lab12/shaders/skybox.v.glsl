@@ -0,0 +1,15 @@
+#version 410 core
+
+uniform mat4 viewProjectionMtx;
+
+layout(location = 0) in vec3 vPos;
+
+layout(location = 0) out vec3 texCoord;
+
+void main() {
+    // z = w places every sky fragment on the far plane after the perspective divide
+    gl_Position = (viewProjectionMtx * vec4(vPos, 1.0)).xyww;
+    // the sky was painted for quads with the front on +X and the right on +Z, so swap x and z
+    // to look the faces up where those quads showed them rather than mirrored
+    texCoord = vPos.zyx;
+}